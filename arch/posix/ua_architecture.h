@@ -171,6 +171,51 @@ static UA_INLINE void
 UA_LOCK_ASSERT(UA_Lock *lock, int num) {
     UA_assert(lock->mutexCounter == num);
 }
+
+/* Threads and condition variables for the worker threads of the server */
+typedef pthread_t UA_Thread;
+typedef void *(*UA_ThreadCallback)(void *context);
+#define UA_THREAD_CALLBACK(name) static void * name(void *context)
+
+static UA_INLINE int
+UA_THREAD_CREATE(UA_Thread *thread, UA_ThreadCallback callback, void *context) {
+    return pthread_create(thread, NULL, callback, context);
+}
+
+static UA_INLINE void
+UA_THREAD_JOIN(UA_Thread *thread) {
+    pthread_join(*thread, NULL);
+}
+
+typedef pthread_cond_t UA_Cond;
+
+static UA_INLINE void
+UA_COND_INIT(UA_Cond *cond) {
+    pthread_cond_init(cond, NULL);
+}
+
+static UA_INLINE void
+UA_COND_DESTROY(UA_Cond *cond) {
+    pthread_cond_destroy(cond);
+}
+
+/* The lock is released while waiting */
+static UA_INLINE void
+UA_COND_WAIT(UA_Cond *cond, UA_Lock *lock) {
+    UA_assert(--(lock->mutexCounter) == 0);
+    pthread_cond_wait(cond, &lock->mutex);
+    UA_assert(++(lock->mutexCounter) == 1);
+}
+
+static UA_INLINE void
+UA_COND_SIGNAL(UA_Cond *cond) {
+    pthread_cond_signal(cond);
+}
+
+static UA_INLINE void
+UA_COND_BROADCAST(UA_Cond *cond) {
+    pthread_cond_broadcast(cond);
+}
 #else
 #define UA_EMPTY_STATEMENT                                                               \
     do {                                                                                 \
@@ -192,6 +192,53 @@ static UA_INLINE void
 UA_LOCK_ASSERT(UA_Lock *lock, int num) {
     UA_assert(lock->mutexCounter == num);
 }
+
+/* Threads and condition variables for the worker threads of the server */
+typedef HANDLE UA_Thread;
+typedef DWORD (WINAPI *UA_ThreadCallback)(LPVOID context);
+#define UA_THREAD_CALLBACK(name) static DWORD WINAPI name(LPVOID context)
+
+static UA_INLINE int
+UA_THREAD_CREATE(UA_Thread *thread, UA_ThreadCallback callback, void *context) {
+    *thread = CreateThread(NULL, 0, callback, context, 0, NULL);
+    return (*thread == NULL) ? -1 : 0;
+}
+
+static UA_INLINE void
+UA_THREAD_JOIN(UA_Thread *thread) {
+    WaitForSingleObject(*thread, INFINITE);
+    CloseHandle(*thread);
+}
+
+typedef CONDITION_VARIABLE UA_Cond;
+
+static UA_INLINE void
+UA_COND_INIT(UA_Cond *cond) {
+    InitializeConditionVariable(cond);
+}
+
+static UA_INLINE void
+UA_COND_DESTROY(UA_Cond *cond) {
+    (void)cond;
+}
+
+/* The lock is released while waiting */
+static UA_INLINE void
+UA_COND_WAIT(UA_Cond *cond, UA_Lock *lock) {
+    UA_assert(--(lock->mutexCounter) == 0);
+    SleepConditionVariableCS(cond, &lock->mutex, INFINITE);
+    UA_assert(++(lock->mutexCounter) == 1);
+}
+
+static UA_INLINE void
+UA_COND_SIGNAL(UA_Cond *cond) {
+    WakeConditionVariable(cond);
+}
+
+static UA_INLINE void
+UA_COND_BROADCAST(UA_Cond *cond) {
+    WakeAllConditionVariable(cond);
+}
 #else
 #define UA_LOCK_INIT(lock)
 #define UA_LOCK_DESTROY(lock)
@@ -133,6 +133,15 @@ typedef struct {
     UA_UInt32 connectivityCheckInterval;     /* Connectivity check interval in ms.
                                               * 0 = background task disabled */
 
+    /* Maximum number of async requests from the application that are sent and
+     * wait for the response. Further requests are queued in the client and
+     * sent in order when responses arrive. The timeout of a queued request
+     * includes the time spent in the queue. Set this below the number of
+     * requests the server processes in parallel for a SecureChannel. Internal
+     * requests (PublishRequests, Session management) are not limited.
+     * 0 = unlimited */
+    UA_UInt32 maxRequestsInFlight;
+
     /* EventLoop */
     UA_EventLoop *eventLoop;
     UA_Boolean externalEventLoop; /* The EventLoop is not deleted with the config */
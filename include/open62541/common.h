@@ -215,6 +215,8 @@ typedef struct {
     size_t channelTimeoutCount; /* only used by servers */
     size_t channelAbortCount;
     size_t channelPurgeCount;   /* only used by servers */
+    size_t queuedHandshakeCount;   /* only used by servers */
+    size_t deferredHandshakeCount; /* only used by servers */
 } UA_SecureChannelStatistics;
 
 typedef struct {
@@ -263,7 +263,9 @@ typedef union {
 static UA_INLINE void
 UA_NodePointer_init(UA_NodePointer *np) { np->immediate = 0; }
 
-/* NodeId and ExpandedNodeId targets are freed */
+/* NodeId and ExpandedNodeId targets are freed. An owned NodeId target must
+ * come from UA_NodePointer_copy. Its identifier lives in the same allocation
+ * and is not freed separately. */
 void UA_EXPORT
 UA_NodePointer_clear(UA_NodePointer *np);
 
@@ -334,13 +336,22 @@ typedef struct {
  * reference target structure internally. The nodestore implementations may
  * switch internally when a node is updated.
  *
- * The recommendation is to switch to a tree once the number of refs > 8. */
+ * The recommendation is to switch to a tree once the number of refs > 8.
+ *
+ * Most nodes have only a single target per ReferenceKind (e.g. the
+ * HasTypeDefinition and the inverse reference to the parent). The SDK stores
+ * such a single target inline in targets.single instead of in an allocated
+ * array and sets hasRefInline. Code that accesses targets.array directly has
+ * to check hasRefInline first. Without the flag, targets.array is valid for
+ * every targetsSize, including 1. Prefer UA_NodeReferenceKind_iterate and
+ * UA_NodeReferenceKind_findTarget, which handle all representations. */
 typedef struct {
     union {
         /* Organize the references in an array. Uses less memory, but incurs
          * lookups in linear time. Recommended if the number of references is
          * known to be small. */
-        UA_ReferenceTarget *array;
+        UA_ReferenceTarget *array;   /* !hasRefTree && !hasRefInline */
+        UA_ReferenceTarget single;   /* hasRefInline (targetsSize == 1) */
 
         /* Organize the references in a tree for fast lookup */
         struct {
@@ -350,6 +361,7 @@ typedef struct {
     } targets;
     size_t targetsSize;
     UA_Boolean hasRefTree; /* RefTree or RefArray? */
+    UA_Boolean hasRefInline; /* Single target stored in targets.single? */
     UA_Byte referenceTypeIndex;
     UA_Boolean isInverse;
 } UA_NodeReferenceKind;
@@ -374,10 +386,29 @@ UA_NodeReferenceKind_findTarget(const UA_NodeReferenceKind *rk,
 UA_EXPORT UA_StatusCode
 UA_NodeReferenceKind_switch(UA_NodeReferenceKind *rk);
 
+/* Interned strings
+ * ~~~~~~~~~~~~~~~~
+ * The server interns the BrowseName and the LocalizedText of DisplayName and
+ * Description when a node is added. An interned string points into the
+ * reference-counted string pool of the server and is flagged in the node
+ * (``internedBrowseName`` and ``interned``). The following rules apply:
+ *
+ * - The string data of an interned string is immutable and must not be freed
+ *   directly. UA_Node_clear releases the reference to the pool.
+ * - To modify an interned string, clear it with UA_Node_clear or replace it
+ *   with a heap-allocated string *and* reset the flag. Otherwise the pool
+ *   reference leaks and the new string is not freed.
+ * - UA_Node_copy makes deep copies of the strings. The flags are not set in
+ *   the copy.
+ * - Nodestores never set the flags themselves. Interned strings can outlive
+ *   the server. They are then freed with their last release. */
+
 /* Singly-linked LocalizedText list */
 typedef struct UA_LocalizedTextListEntry {
     struct UA_LocalizedTextListEntry *next;
     UA_LocalizedText localizedText;
+    UA_Boolean interned; /* The text is shared from the server's string pool
+                          * (see the rules for interned strings above) */
 } UA_LocalizedTextListEntry;
 
 /* Every Node starts with these attributes */
@@ -403,6 +434,9 @@ struct UA_NodeHead {
     /* Members specific to open62541 */
     void *context;
     UA_Boolean constructed; /* Constructors were called */
+    UA_Boolean internedBrowseName; /* The name of the browseName is shared
+                                    * from the server's string pool (see the
+                                    * rules for interned strings above) */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     UA_MonitoredItem *monitoredItems; /* MonitoredItems for Events and immediate
                                        * DataChanges (no sampling interval). */
@@ -456,6 +490,13 @@ typedef struct {
                     const UA_DataValue *data);
 } UA_ValueCallback;
 
+/* Value read from a DataSource as part of a batch */
+typedef struct {
+    const UA_NodeId *nodeId;
+    void *nodeContext;
+    const UA_NumericRange *range; /* NULL if the full value is read */
+} UA_DataSourceReadItem;
+
 typedef struct {
     /* Copies the data from the source into the provided value.
      *
@@ -521,6 +562,36 @@ typedef struct {
                            const UA_DataValue *value);
 } UA_DataSource;
 
+/* Read several values of DataSource variables in one call. The batch method is
+ * set for a variable node with UA_Server_setVariableNode_dataSourceBatch. The
+ * Read service collects the value reads of a request for all DataSource
+ * variables that share the same batch method and calls it once (with the
+ * service mutex released). Then, for example, the values of a device can be
+ * fetched in a single round trip. If the read method of the DataSource is
+ * NULL, the batch method is also used for reading single values.
+ *
+ * @param server The server executing the callback
+ * @param sessionId The identifier of the session
+ * @param sessionContext Additional data attached to the session in the
+ *        access control layer
+ * @param itemsSize The number of values to read
+ * @param items The nodes being read from with their context and the
+ *        optional numeric range
+ * @param includeSourceTimeStamp If true, then the datasource is expected to
+ *        set the source timestamp in the returned values
+ * @param values The (non-null) array of itemsSize initialized DataValues.
+ *        The same semantics as for the individual read apply, including
+ *        zero-copy values.
+ * @return Returns a status code for logging. If an error is returned, then
+ *         all values of the batch are released and get the error status
+ *         code */
+typedef UA_StatusCode
+(*UA_DataSourceReadBatch)(UA_Server *server, const UA_NodeId *sessionId,
+                          void *sessionContext, size_t itemsSize,
+                          const UA_DataSourceReadItem *items,
+                          UA_Boolean includeSourceTimeStamp,
+                          UA_DataValue *values);
+
 /**
  * .. _value-callback:
  *
@@ -611,6 +682,14 @@ typedef struct {
                            * background. Only dynamic variables conserve source
                            * and server timestamp for the value attribute.
                            * Static variables have timestamps of "now". */
+#if UA_MULTITHREADING >= 100
+    UA_Boolean async; /* The value is read and written by async operations */
+#endif
+    UA_DataSourceReadBatch readBatch; /* Batched reads from the DataSource.
+                                       * Can be NULL. */
+    UA_Boolean sessionSpecificValue; /* The DataSource returns different values
+                                      * for different sessions. Cached values
+                                      * are not shared between sessions. */
 } UA_VariableNode;
 
 /**
@@ -811,6 +890,12 @@ typedef struct {
     /* Execute a callback for every node in the nodestore. */
     void (*iterate)(void *nsCtx, UA_NodestoreVisitor visitor,
                     void *visitorCtx);
+
+    /* Prepare the nodestore for the insertion of (at least) the given number
+     * of additional nodes. For example by allocating the internal structures
+     * upfront instead of growing them step by step. This is only a hint. Can
+     * be NULL if the nodestore does not benefit from it. */
+    UA_StatusCode (*reserve)(void *nsCtx, size_t additionalNodes);
 } UA_Nodestore;
 
 /* Attributes must be of a matching type (VariableAttributes, ObjectAttributes,
@@ -219,6 +219,14 @@ struct UA_ServerConfig {
      * ModellingRule of their InstanceDeclaration */
     UA_Boolean modellingRulesOnInstances;
 
+    /**
+     * Nodestore snapshot created with ``UA_Server_saveNodestoreSnapshot``. If
+     * set, the nodes are restored from the snapshot during the creation of
+     * the server instead of building namespace zero from scratch. The
+     * snapshot can point to a memory-mapped file. It is only accessed during
+     * ``UA_Server_newWithConfig`` and is not freed with the configuration. */
+    UA_ByteString nodestoreSnapshot;
+
     /**
      * Limits
      * ^^^^^^ */
@@ -226,6 +234,14 @@ struct UA_ServerConfig {
     UA_UInt16 maxSecureChannels;
     UA_UInt32 maxSecurityTokenLifetime; /* in ms */
 
+    /* Maximum number of OpenSecureChannel handshakes processed per EventLoop
+     * iteration. They are expensive with asymmetric encryption. Additional
+     * handshakes are queued and processed in the next iterations. This keeps
+     * the established SecureChannels responsive when many clients reconnect
+     * at the same time. Token renewals of open SecureChannels are not
+     * limited. 0 -> unlimited. */
+    UA_UInt16 maxHandshakesPerIteration;
+
     /* Limits for Sessions */
     UA_UInt16 maxSessions;
     UA_Double maxSessionTimeout; /* in ms */
@@ -243,6 +259,28 @@ struct UA_ServerConfig {
     /* Limits for Requests */
     UA_UInt32 maxReferencesPerNode;
 
+    /* Memory limit (in bytes) for cached values of DataSource variables. Read
+     * requests with a maxAge > 0 (and the sampling of MonitoredItems) reuse
+     * cached values that are recent enough instead of calling the DataSource.
+     * The cached values are shared between sessions. So many clients reading
+     * the same variable cause a single DataSource read. For variables that
+     * return session-specific values, see
+     * UA_Server_setVariableNode_sessionSpecificValue. Writing the value
+     * invalidates the cache entries. 0 disables the cache. */
+    size_t maxValueCacheSize;
+
+    /* Memory limit (in bytes) for cached Browse results. Browse operations
+     * that return all references without a ContinuationPoint are cached. An
+     * identical Browse operation reuses the result until references or
+     * attributes in the information model change. 0 disables the cache. */
+    size_t maxBrowseCacheSize;
+
+    /* Memory limit (in bytes) for the cached results of the
+     * TranslateBrowsePathsToNodeIds service. A resolved BrowsePath is reused
+     * until references in the information model change. 0 disables the
+     * cache. */
+    size_t maxBrowsePathCacheSize;
+
     /**
      * Async Operations
      * ^^^^^^^^^^^^^^^^
@@ -252,6 +290,9 @@ struct UA_ServerConfig {
     size_t maxAsyncOperationQueueSize; /* 0 => unlimited */
     /* Notify workers when an async operation was enqueued */
     UA_Server_AsyncOperationNotifyCallback asyncOperationNotifyCallback;
+    /* Number of worker threads started by the server to execute the async
+     * operations. 0 => the application retrieves the operations itself. */
+    UA_UInt16 asyncOperationWorkers;
 #endif
 
     /**
@@ -290,6 +331,12 @@ struct UA_ServerConfig {
     UA_UInt32 maxNotificationsPerPublish;
     UA_Boolean enableRetransmissionQueue;
     UA_UInt32 maxRetransmissionQueueSize; /* 0 -> unlimited size */
+
+    /* Memory budget in bytes for the queued Notifications and retransmission
+     * messages of all Subscriptions in a Session. Retransmission messages are
+     * released first if the budget is exhausted. Then new Notifications are
+     * dropped. 0 -> unlimited */
+    size_t maxSessionMemoryUsage;
 # ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     UA_UInt32 maxEventsPerNode; /* 0 -> unlimited size */
 # endif
@@ -890,6 +937,30 @@ UA_StatusCode UA_EXPORT UA_THREADSAFE
 UA_Server_browseRecursive(UA_Server *server, const UA_BrowseDescription *bd,
                           size_t *resultsSize, UA_ExpandedNodeId **results);
 
+/* Streaming version of UA_Server_browseRecursive. Instead of returning an
+ * array with all results, the callback is called for every matching node as
+ * soon as it is found. As for UA_Server_browseRecursive, every matching node
+ * is reported at most once and nodes that do not match the NodeClassMask are
+ * still recursed into. For UA_BROWSEDIRECTION_BOTH, the forward and the inverse
+ * direction are browsed one after the other. A node that was already reached
+ * in the forward direction is still recursed into in the inverse direction.
+ * The nodes are visited breadth-first and there is no limit on the depth of
+ * the hierarchy.
+ *
+ * The server is not locked while the callback runs. So the callback can use
+ * the server API and the server remains responsive during long traversals.
+ * Changes of the information model during the browse may or may not be
+ * reflected in the results. Returning a bad StatusCode from the callback
+ * stops the browse. This StatusCode is then returned. */
+typedef UA_StatusCode
+(*UA_BrowseRecursiveCallback)(UA_Server *server, const UA_ExpandedNodeId *nodeId,
+                              void *context);
+
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_browseRecursiveCallback(UA_Server *server, const UA_BrowseDescription *bd,
+                                  UA_BrowseRecursiveCallback callback,
+                                  void *context);
+
 UA_BrowsePathResult UA_EXPORT UA_THREADSAFE
 UA_Server_translateBrowsePathToNodeIds(UA_Server *server,
                                        const UA_BrowsePath *browsePath);
@@ -1084,6 +1155,23 @@ UA_StatusCode UA_EXPORT UA_THREADSAFE
 UA_Server_setVariableNode_dataSource(UA_Server *server, const UA_NodeId nodeId,
                                      const UA_DataSource dataSource);
 
+/* Set the method for batched reads (see UA_DataSourceReadBatch) in a variable
+ * node. The batch method is used when the value comes from a DataSource. Set
+ * to NULL to read every value individually again. A DataSource without a read
+ * method can only be set after the batch method. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_setVariableNode_dataSourceBatch(UA_Server *server, const UA_NodeId nodeId,
+                                          UA_DataSourceReadBatch readBatch);
+
+/* Values read from a DataSource are cached for reads with a maxAge (see
+ * maxValueCacheSize in the server config) and shared between sessions. Set
+ * this if the DataSource returns different values depending on the session.
+ * Then a cached value is only reused by the session that read it. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_setVariableNode_sessionSpecificValue(UA_Server *server,
+                                               const UA_NodeId nodeId,
+                                               UA_Boolean sessionSpecific);
+
 UA_StatusCode UA_EXPORT UA_THREADSAFE
 UA_Server_setVariableNode_valueCallback(UA_Server *server,
                                         const UA_NodeId nodeId,
@@ -1471,6 +1559,42 @@ UA_Server_addNode_begin(UA_Server *server, const UA_NodeClass nodeClass,
 UA_StatusCode UA_EXPORT UA_THREADSAFE
 UA_Server_addNode_finish(UA_Server *server, const UA_NodeId nodeId);
 
+/* Add many nodes at once. This is considerably faster than adding the nodes
+ * one by one, for example to populate a large information model during
+ * startup:
+ *
+ * - The nodestore is prepared upfront for the number of new nodes.
+ * - The items can be in any order. A parent or type definition may be defined
+ *   later in the same batch. The consistency checks for a node are retried
+ *   until no more progress is made.
+ * - The reverse direction of the references (e.g. the forward reference from
+ *   the parent to the new node) is collected and inserted at the end of the
+ *   batch with a single edit per target node.
+ * - The _finish step (instantiation of children, constructors) is performed
+ *   for all nodes after all nodes and references are in place.
+ *
+ * The nodeContexts array is optional. Otherwise it must contain itemsSize
+ * entries. The results array must have itemsSize entries. It contains the
+ * StatusCode and the NodeId of every added node. Nodes that fail are removed
+ * again without affecting the remaining nodes of the batch. A bad StatusCode
+ * is returned only if the batch could not be processed at all. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_addNodes_bulk(UA_Server *server, size_t itemsSize,
+                        const UA_AddNodesItem *items, void **nodeContexts,
+                        UA_AddNodesResult *results);
+
+/* Encode the nodes of the nodestore and the namespace array into a binary
+ * snapshot. The snapshot can be set as ``nodestoreSnapshot`` in the server
+ * configuration to skip the (re-)creation of namespace zero and of other
+ * information models on the next start. Pointers are not part of the
+ * snapshot. That is, node contexts, DataSources, value callbacks, method
+ * callbacks and type lifecycles need to be set again after the server was
+ * created from the snapshot. The callbacks of namespace zero are set
+ * automatically. The returned ByteString needs to be cleaned up by the
+ * caller. */
+UA_StatusCode UA_EXPORT UA_THREADSAFE
+UA_Server_saveNodestoreSnapshot(UA_Server *server, UA_ByteString *snapshot);
+
 #ifdef UA_ENABLE_METHODCALLS
 
 UA_StatusCode UA_EXPORT UA_THREADSAFE
@@ -1810,8 +1934,22 @@ UA_Server_getNamespaceByIndex(UA_Server *server, const size_t namespaceIndex,
 * ready. See the examples in ``/examples/tutorial_server_method_async.c`` for
 * the usage.
 *
+* The same applies to reading and writing the value attribute of variables
+* marked as async. The access rights are checked before the operation is
+* queued. The worker can then use ``UA_Server_read`` and ``UA_Server_write`` to
+* access the variable (and its DataSource) outside of the server thread. The
+* TimestampsToReturn of the ReadRequest are applied to the returned DataValue.
+*
 * Note that the operation can time out (see the asyncOperationTimeout setting in
-* the server config) also when it has been retrieved by the worker. */
+* the server config) also when it has been retrieved by the worker.
+*
+* Instead of running its own workers, the application can let the server start
+* a pool of worker threads (see the asyncOperationWorkers setting in the server
+* config). The server workers execute the method callbacks and the read/write
+* of the variables in parallel and return the results. The number of operations
+* of a method that are executed at the same time can be limited with
+* ``UA_Server_setMethodNodeAsyncConcurrency``. The limit applies to all workers,
+* also those of the application. */
 
 #if UA_MULTITHREADING >= 100
 
@@ -1820,23 +1958,36 @@ UA_StatusCode UA_EXPORT
 UA_Server_setMethodNodeAsync(UA_Server *server, const UA_NodeId id,
                              UA_Boolean isAsync);
 
+/* Limit the number of operations of an async method that are executed by the
+ * workers at the same time. Further calls remain queued until a running
+ * operation has returned its result. 0 => unlimited (the default). */
+UA_StatusCode UA_EXPORT
+UA_Server_setMethodNodeAsyncConcurrency(UA_Server *server, const UA_NodeId id,
+                                        UA_UInt32 maxConcurrency);
+
+/* Set the async flag in a variable node. Reading and writing the value
+ * attribute with the Read and Write service is then done by the workers. */
+UA_StatusCode UA_EXPORT
+UA_Server_setVariableNodeAsync(UA_Server *server, const UA_NodeId id,
+                               UA_Boolean isAsync);
+
 typedef enum {
     UA_ASYNCOPERATIONTYPE_INVALID, /* 0, the default */
-    UA_ASYNCOPERATIONTYPE_CALL
-    /* UA_ASYNCOPERATIONTYPE_READ, */
-    /* UA_ASYNCOPERATIONTYPE_WRITE, */
+    UA_ASYNCOPERATIONTYPE_CALL,
+    UA_ASYNCOPERATIONTYPE_READ,
+    UA_ASYNCOPERATIONTYPE_WRITE
 } UA_AsyncOperationType;
 
 typedef union {
     UA_CallMethodRequest callMethodRequest;
-    /* UA_ReadValueId readValueId; */
-    /* UA_WriteValue writeValue; */
+    UA_ReadValueId readValueId;
+    UA_WriteValue writeValue;
 } UA_AsyncOperationRequest;
 
 typedef union {
     UA_CallMethodResult callMethodResult;
-    /* UA_DataValue readResult; */
-    /* UA_StatusCode writeResult; */
+    UA_DataValue readResult;
+    UA_StatusCode writeResult;
 } UA_AsyncOperationResponse;
 
 /* Get the next async operation without blocking
@@ -1878,14 +2029,55 @@ UA_Server_setAsyncOperationResult(UA_Server *server,
  * Statistic counters keeping track of the current state of the stack. Counters
  * are structured per OPC UA communication layer. */
 
+typedef struct {
+    size_t hits;    /* Browse operations answered from the cache */
+    size_t misses;  /* Browse operations not answered from the cache */
+    size_t entries; /* Cached Browse results */
+    size_t memory;  /* Approximate memory of the cached results in bytes */
+    size_t pathHits;    /* Resolved BrowsePaths answered from the cache */
+    size_t pathMisses;  /* Resolved BrowsePaths not answered from the cache */
+    size_t pathEntries; /* Cached BrowsePath results */
+    size_t pathMemory;  /* Approximate memory of the cached BrowsePaths */
+} UA_BrowseCacheStatistics;
+
 typedef struct {
    UA_SecureChannelStatistics scs;
    UA_SessionStatistics ss;
+   UA_BrowseCacheStatistics bcs;
 } UA_ServerStatistics;
 
 UA_ServerStatistics UA_EXPORT
 UA_Server_getStatistics(UA_Server *server);
 
+/* Memory used by the nodes in the information model, per NodeClass. The
+ * numbers are computed from the node structures. They are approximate and do
+ * not include the allocator overhead, the internal structures of the nodestore
+ * and nested allocations inside variable values (e.g. the content of String
+ * arrays). */
+typedef struct {
+    size_t nodes;           /* Number of nodes */
+    size_t references;      /* Number of reference targets */
+    size_t nodeMemory;      /* Node structures and attributes in bytes */
+    size_t referenceMemory; /* ReferenceKinds and targets in bytes */
+} UA_NodeClassMemoryUsage;
+
+typedef struct {
+    UA_NodeClassMemoryUsage objects;
+    UA_NodeClassMemoryUsage variables;
+    UA_NodeClassMemoryUsage methods;
+    UA_NodeClassMemoryUsage objectTypes;
+    UA_NodeClassMemoryUsage variableTypes;
+    UA_NodeClassMemoryUsage referenceTypes;
+    UA_NodeClassMemoryUsage dataTypes;
+    UA_NodeClassMemoryUsage views;
+    UA_NodeClassMemoryUsage total;
+} UA_NodestoreMemoryUsage;
+
+/* Iterates over all nodes. This can take some time for large information
+ * models. */
+UA_NodestoreMemoryUsage UA_EXPORT
+UA_Server_getNodestoreMemoryUsage(UA_Server *server);
+
 /**
   * Reverse Connect
   * ---------------
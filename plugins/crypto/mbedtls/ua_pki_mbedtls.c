@@ -687,4 +687,15 @@ UA_CertificateVerification_CertFolders(UA_CertificateVerification *cv,
 }
 
 #endif
+
+/* This plugin reads the certificate folders again before every verification
+ * and keeps no verification results. So there is nothing to flush. */
+UA_StatusCode
+UA_CertificateVerification_Reload(UA_CertificateVerification *cv) {
+    if(!cv || !cv->context ||
+       cv->verifyCertificate != certificateVerification_verify)
+        return UA_STATUSCODE_BADINTERNALERROR;
+    return UA_STATUSCODE_GOOD;
+}
+
 #endif
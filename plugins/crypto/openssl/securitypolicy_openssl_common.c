@@ -577,26 +577,14 @@ UA_OpenSSL_Decrypt (const UA_ByteString * iv,
                     const UA_ByteString * key,
                     const EVP_CIPHER *    cipherAlg,
                     UA_ByteString *       data  /* [in/out]*/) {
-    UA_ByteString    ivCopy    = {0, NULL};
-    UA_ByteString    cipherTxt = {0, NULL};
     EVP_CIPHER_CTX * ctx       = NULL;
     UA_StatusCode    ret;
     int              opensslRet;
     int              outLen;
     int              tmpLen;
 
-    /* copy the IV because the AES_cbc_encrypt function overwrites it. */
-
-    ret = UA_ByteString_copy (iv, &ivCopy);
-    if (ret != UA_STATUSCODE_GOOD) {
-        goto errout;
-    }
-
-    ret = UA_ByteString_copy (data, &cipherTxt);
-    if (ret != UA_STATUSCODE_GOOD) {
-        goto errout;
-    }
-
+    /* The EVP context keeps its own copy of the IV. The data is decrypted
+     * in-place. So neither needs to be copied. */
     ctx = EVP_CIPHER_CTX_new ();
     if (ctx == NULL) {
         ret = UA_STATUSCODE_BADOUTOFMEMORY;
@@ -605,7 +593,7 @@ UA_OpenSSL_Decrypt (const UA_ByteString * iv,
 
     /* call EVP_* to decrypt */
 
-    opensslRet = EVP_DecryptInit_ex (ctx, cipherAlg, NULL, key->data, ivCopy.data);
+    opensslRet = EVP_DecryptInit_ex (ctx, cipherAlg, NULL, key->data, iv->data);
     if (opensslRet != 1) {
         ret = UA_STATUSCODE_BADINTERNALERROR;
         goto errout;
@@ -615,7 +603,7 @@ UA_OpenSSL_Decrypt (const UA_ByteString * iv,
      */
     EVP_CIPHER_CTX_set_padding (ctx, 0);
     opensslRet = EVP_DecryptUpdate (ctx, data->data, &outLen,
-                                    cipherTxt.data, (int) cipherTxt.length);
+                                    data->data, (int) data->length);
     if (opensslRet != 1) {
         ret = UA_STATUSCODE_BADINTERNALERROR;
         goto errout;
@@ -630,8 +618,6 @@ UA_OpenSSL_Decrypt (const UA_ByteString * iv,
     ret = UA_STATUSCODE_GOOD;
 
 errout:
-    UA_ByteString_clear (&ivCopy);
-    UA_ByteString_clear (&cipherTxt);
     if (ctx != NULL) {
         EVP_CIPHER_CTX_free(ctx);
     }
@@ -645,26 +631,14 @@ UA_OpenSSL_Encrypt (const UA_ByteString * iv,
                     UA_ByteString *       data  /* [in/out]*/
                     ) {
 
-    UA_ByteString    ivCopy   = {0, NULL};
-    UA_ByteString    plainTxt = {0, NULL};
     EVP_CIPHER_CTX * ctx      = NULL;
     UA_StatusCode    ret;
     int              opensslRet;
     int              outLen;
     int              tmpLen;
 
-    /* copy the IV because the AES_cbc_encrypt function overwrites it. */
-
-    ret = UA_ByteString_copy (iv, &ivCopy);
-    if (ret != UA_STATUSCODE_GOOD) {
-        goto errout;
-    }
-
-    ret = UA_ByteString_copy (data, &plainTxt);
-    if (ret != UA_STATUSCODE_GOOD) {
-        goto errout;
-    }
-
+    /* The EVP context keeps its own copy of the IV. The data is encrypted
+     * in-place. So neither needs to be copied. */
     ctx = EVP_CIPHER_CTX_new ();
     if (ctx == NULL) {
         ret = UA_STATUSCODE_BADOUTOFMEMORY;
@@ -673,7 +647,7 @@ UA_OpenSSL_Encrypt (const UA_ByteString * iv,
 
     /* call EVP_* to encrypt */
 
-    opensslRet = EVP_EncryptInit_ex (ctx, cipherAlg, NULL, key->data, ivCopy.data);
+    opensslRet = EVP_EncryptInit_ex (ctx, cipherAlg, NULL, key->data, iv->data);
     if (opensslRet != 1) {
         ret = UA_STATUSCODE_BADINTERNALERROR;
         goto errout;
@@ -693,7 +667,7 @@ UA_OpenSSL_Encrypt (const UA_ByteString * iv,
 
     /* Encrypt the data */
     opensslRet = EVP_EncryptUpdate (ctx, data->data, &outLen,
-                                    plainTxt.data, (int) plainTxt.length);
+                                    data->data, (int) data->length);
     if (opensslRet != 1) {
         ret = UA_STATUSCODE_BADINTERNALERROR;
         goto errout;
@@ -710,8 +684,6 @@ UA_OpenSSL_Encrypt (const UA_ByteString * iv,
     ret = UA_STATUSCODE_GOOD;
 
 errout:
-    UA_ByteString_clear (&ivCopy);
-    UA_ByteString_clear (&plainTxt);
     if (ctx != NULL) {
         EVP_CIPHER_CTX_free(ctx);
     }
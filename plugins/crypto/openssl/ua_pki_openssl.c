@@ -11,6 +11,7 @@
 #include <open62541/plugin/log_stdout.h>
 
 #include "securitypolicy_openssl_common.h"
+#include "../ua_pki_cache.h"
 
 #if defined(UA_ENABLE_ENCRYPTION_OPENSSL) || defined(UA_ENABLE_ENCRYPTION_LIBRESSL)
 #include <openssl/x509.h>
@@ -75,6 +76,12 @@ typedef struct {
     STACK_OF(X509) *      skIssue;
     STACK_OF(X509) *      skTrusted;
     STACK_OF(X509_CRL) *  skCrls; /* Revocation list*/
+
+    /* Built once and reused for every verification */
+    X509_STORE *          store;
+
+    /* Recent verification results and change detection for the folders */
+    UA_PKICache           cache;
 } CertContext;
 
 static UA_StatusCode
@@ -103,6 +110,11 @@ UA_CertContext_Init (CertContext * context) {
     UA_ByteString_init (&context->issuerListFolder);
     UA_ByteString_init (&context->revocationListFolder);
     UA_ByteString_init (&context->rejectedListFolder);
+    UA_PKICache_init (&context->cache);
+    context->store = X509_STORE_new ();
+    if (context->store == NULL) {
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
     return UA_CertContext_sk_Init (context);
 }
 
@@ -121,6 +133,10 @@ UA_CertificateVerification_clear (UA_CertificateVerification * cv) {
     UA_ByteString_clear (&context->rejectedListFolder);
 
     UA_CertContext_sk_free (context);
+    if (context->store != NULL) {
+        X509_STORE_free (context->store);
+    }
+    UA_PKICache_clear (&context->cache);
     UA_free (context);
 
     cv->context = NULL;
@@ -434,34 +450,34 @@ UA_X509_Store_CTX_Error_To_UAError (int opensslErr) {
     return ret;
     }
 
+/* Time until the certificate expires. Zero if that cannot be determined. */
+static UA_DateTime
+UA_CertificateVerification_RemainingValidity (X509 * certificateX509) {
+    int days = 0;
+    int secs = 0;
+    if (ASN1_TIME_diff (&days, &secs, NULL, X509_get_notAfter (certificateX509)) != 1) {
+        return 0;
+    }
+    return ((UA_DateTime) days * 86400 + secs) * UA_DATETIME_SEC;
+}
+
+/* For a GOOD result, validFor is set to the time until the certificate
+ * expires */
 static UA_StatusCode
-UA_CertificateVerification_Verify (void *                verificationContext,
-                                   const UA_ByteString * certificate) {
+UA_CertificateVerification_VerifyChain (CertContext *         ctx,
+                                        const UA_ByteString * certificate,
+                                        UA_DateTime *         validFor) {
     X509_STORE_CTX*       storeCtx;
-    X509_STORE*           store;
-    CertContext *         ctx;
+    X509_STORE*           store = ctx->store;
     UA_StatusCode         ret;
     int                   opensslRet;
     X509 *                certificateX509 = NULL;
 
-    if (verificationContext == NULL) {
-        return UA_STATUSCODE_BADINTERNALERROR;
-    }
-    ctx = (CertContext *) verificationContext;
-
-    store = X509_STORE_new();
     storeCtx = X509_STORE_CTX_new();
-
-    if (store == NULL || storeCtx == NULL) {
+    if (storeCtx == NULL) {
         ret = UA_STATUSCODE_BADOUTOFMEMORY;
         goto cleanup;
     }
-#ifdef __linux__
-    ret = UA_ReloadCertFromFolder (ctx);
-    if (ret != UA_STATUSCODE_GOOD) {
-        goto cleanup;
-    }
-#endif
 
     certificateX509 = UA_OpenSSL_LoadCertificate(certificate);
     if (certificateX509 == NULL) {
@@ -500,7 +516,8 @@ UA_CertificateVerification_Verify (void *                verificationContext,
      * CTT/Security/Security Certificate Validation/029.js for more details */
      /** \todo Can the ca-parameter of X509_check_purpose can be used? */
     if(X509_check_purpose(certificateX509, X509_PURPOSE_CRL_SIGN, 0) && X509_check_ca(certificateX509)) {
-        return UA_STATUSCODE_BADCERTIFICATEUSENOTALLOWED;
+        ret = UA_STATUSCODE_BADCERTIFICATEUSENOTALLOWED;
+        goto cleanup;
     }
 
     opensslRet = X509_verify_cert (storeCtx);
@@ -574,8 +591,8 @@ UA_CertificateVerification_Verify (void *                verificationContext,
         ret = UA_X509_Store_CTX_Error_To_UAError (opensslRet);
     }
 cleanup:
-    if (store != NULL) {
-        X509_STORE_free (store);
+    if (ret == UA_STATUSCODE_GOOD) {
+        *validFor = UA_CertificateVerification_RemainingValidity (certificateX509);
     }
     if (storeCtx != NULL) {
         X509_STORE_CTX_free (storeCtx);
@@ -586,6 +603,37 @@ cleanup:
     return ret;
 }
 
+static UA_StatusCode
+UA_CertificateVerification_Verify (void *                verificationContext,
+                                   const UA_ByteString * certificate) {
+    CertContext * ctx;
+    UA_StatusCode ret;
+
+    if (verificationContext == NULL) {
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    ctx = (CertContext *) verificationContext;
+
+    /* Reload the trust store only if the folders have changed */
+    if (UA_PKICache_needsReload (&ctx->cache)) {
+#ifdef __linux__
+        ret = UA_ReloadCertFromFolder (ctx);
+        if (ret != UA_STATUSCODE_GOOD) {
+            ctx->cache.reload = true;
+            return ret;
+        }
+#endif
+    }
+
+    if (UA_PKICache_lookup (&ctx->cache, certificate, &ret)) {
+        return ret;
+    }
+    UA_DateTime validFor = UA_PKICACHE_LIFETIME;
+    ret = UA_CertificateVerification_VerifyChain (ctx, certificate, &validFor);
+    UA_PKICache_store (&ctx->cache, certificate, ret, validFor);
+    return ret;
+}
+
 static UA_StatusCode
 UA_CertificateVerification_VerifyApplicationURI (void *                verificationContext,
                                                  const UA_ByteString * certificate,
@@ -771,14 +819,31 @@ UA_CertificateVerification_CertFolders(UA_CertificateVerification * cv,
     cv->context = context;
     cv->verifyCertificate = UA_CertificateVerification_Verify;
 
-    /* Only set the folder paths. They will be reloaded during runtime. */
+    /* Only set the folder paths. They are loaded before the first
+     * verification and reloaded when they change. */
 
     context->trustListFolder = UA_STRING_ALLOC(trustListFolder);
     context->issuerListFolder = UA_STRING_ALLOC(issuerListFolder);
     context->revocationListFolder = UA_STRING_ALLOC(revocationListFolder);
 
+    UA_String folders[3] = {context->trustListFolder, context->issuerListFolder,
+                            context->revocationListFolder};
+    UA_PKICache_watchFolders (&context->cache, folders, 3);
+    context->cache.reload = true;
+
     return UA_STATUSCODE_GOOD;
 }
 #endif
 
+UA_StatusCode
+UA_CertificateVerification_Reload(UA_CertificateVerification * cv) {
+    if (cv == NULL || cv->context == NULL ||
+        cv->verifyCertificate != UA_CertificateVerification_Verify) {
+        return UA_STATUSCODE_BADINTERNALERROR;
+    }
+    CertContext * context = (CertContext *) cv->context;
+    UA_PKICache_flush (&context->cache);
+    return UA_STATUSCODE_GOOD;
+}
+
 #endif  /* end of defined(UA_ENABLE_ENCRYPTION_OPENSSL) || defined(UA_ENABLE_ENCRYPTION_LIBRESSL) */
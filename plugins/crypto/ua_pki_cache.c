@@ -0,0 +1,193 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#include "ua_pki_cache.h"
+
+#ifdef UA_ENABLE_ENCRYPTION
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+static void
+clearEntries(UA_PKICache *cache) {
+    for(size_t i = 0; i < UA_PKICACHE_SIZE; i++) {
+        UA_ByteString_clear(&cache->entries[i].certificate);
+        cache->entries[i].hash = 0;
+    }
+    cache->next = 0;
+}
+
+void
+UA_PKICache_init(UA_PKICache *cache) {
+    memset(cache, 0, sizeof(UA_PKICache));
+#ifdef __linux__
+    cache->inotifyFd = -1;
+    for(size_t i = 0; i < UA_PKICACHE_MAXFOLDERS; i++)
+        cache->watches[i] = -1;
+#endif
+}
+
+void
+UA_PKICache_clear(UA_PKICache *cache) {
+    clearEntries(cache);
+#ifdef __linux__
+    if(cache->inotifyFd >= 0)
+        close(cache->inotifyFd);
+    for(size_t i = 0; i < cache->foldersSize; i++)
+        UA_String_clear(&cache->folders[i]);
+#endif
+    UA_PKICache_init(cache);
+}
+
+void
+UA_PKICache_flush(UA_PKICache *cache) {
+    clearEntries(cache);
+    cache->reload = true;
+}
+
+#ifdef __linux__
+
+static int
+addWatch(UA_PKICache *cache, const UA_String *folder) {
+    char path[PATH_MAX];
+    if(folder->length >= PATH_MAX)
+        return -1;
+    memcpy(path, folder->data, folder->length);
+    path[folder->length] = 0;
+    return inotify_add_watch(cache->inotifyFd, path,
+                             IN_CREATE | IN_DELETE | IN_MODIFY |
+                             IN_CLOSE_WRITE | IN_ATTRIB |
+                             IN_MOVED_FROM | IN_MOVED_TO |
+                             IN_DELETE_SELF | IN_MOVE_SELF);
+}
+
+void
+UA_PKICache_watchFolders(UA_PKICache *cache, const UA_String *folders,
+                         size_t foldersSize) {
+    cache->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(cache->inotifyFd < 0) {
+        cache->alwaysReload = true;
+        return;
+    }
+
+    for(size_t i = 0; i < foldersSize; i++) {
+        if(folders[i].length == 0)
+            continue;
+        if(folders[i].length >= PATH_MAX ||
+           cache->foldersSize == UA_PKICACHE_MAXFOLDERS ||
+           UA_String_copy(&folders[i], &cache->folders[cache->foldersSize]) !=
+           UA_STATUSCODE_GOOD) {
+            cache->alwaysReload = true;
+            continue;
+        }
+        cache->watches[cache->foldersSize] =
+            addWatch(cache, &cache->folders[cache->foldersSize]);
+        cache->foldersSize++;
+    }
+}
+
+/* The watched folder was deleted or moved away. A moved folder is still
+ * watched under its new name. So the watch is removed explicitly. The
+ * IN_IGNORED event for a removed watch no longer matches a folder. */
+static void
+lostWatch(UA_PKICache *cache, int wd) {
+    for(size_t i = 0; i < cache->foldersSize; i++) {
+        if(cache->watches[i] != wd)
+            continue;
+        inotify_rm_watch(cache->inotifyFd, wd);
+        cache->watches[i] = -1;
+    }
+}
+
+static void
+processEvents(UA_PKICache *cache) {
+    char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    while((len = read(cache->inotifyFd, buf, sizeof(buf))) > 0) {
+        cache->reload = true;
+        size_t pos = 0;
+        while(pos + sizeof(struct inotify_event) <= (size_t)len) {
+            struct inotify_event ev;
+            memcpy(&ev, &buf[pos], sizeof(struct inotify_event));
+            if(ev.mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF))
+                lostWatch(cache, ev.wd);
+            pos += sizeof(struct inotify_event) + ev.len;
+        }
+    }
+
+    /* Watch the folders again that were (re-)created under the same path.
+     * Reload every time until that succeeds. Changes in the meantime would
+     * be missed otherwise. */
+    for(size_t i = 0; i < cache->foldersSize; i++) {
+        if(cache->watches[i] >= 0)
+            continue;
+        cache->watches[i] = addWatch(cache, &cache->folders[i]);
+        cache->reload = true;
+    }
+}
+
+#endif
+
+UA_Boolean
+UA_PKICache_needsReload(UA_PKICache *cache) {
+#ifdef __linux__
+    if(cache->inotifyFd >= 0)
+        processEvents(cache);
+#endif
+
+    if(!cache->reload && !cache->alwaysReload)
+        return false;
+    clearEntries(cache);
+    cache->reload = false;
+    return true;
+}
+
+UA_Boolean
+UA_PKICache_lookup(UA_PKICache *cache, const UA_ByteString *certificate,
+                   UA_StatusCode *result) {
+    if(certificate->length == 0)
+        return false;
+    UA_UInt32 hash = UA_ByteString_hash(0, certificate->data, certificate->length);
+    UA_DateTime now = UA_DateTime_nowMonotonic();
+    for(size_t i = 0; i < UA_PKICACHE_SIZE; i++) {
+        UA_PKICacheEntry *e = &cache->entries[i];
+        if(e->hash != hash || !UA_ByteString_equal(&e->certificate, certificate))
+            continue;
+        if(e->validUntil < now) {
+            UA_ByteString_clear(&e->certificate);
+            e->hash = 0;
+            return false;
+        }
+        *result = e->result;
+        return true;
+    }
+    return false;
+}
+
+void
+UA_PKICache_store(UA_PKICache *cache, const UA_ByteString *certificate,
+                  UA_StatusCode result, UA_DateTime maxAge) {
+    /* Don't remember transient errors */
+    if(result == UA_STATUSCODE_BADINTERNALERROR ||
+       result == UA_STATUSCODE_BADOUTOFMEMORY ||
+       certificate->length == 0 || maxAge <= 0)
+        return;
+    if(maxAge > UA_PKICACHE_LIFETIME)
+        maxAge = UA_PKICACHE_LIFETIME;
+
+    UA_PKICacheEntry *e = &cache->entries[cache->next];
+    UA_ByteString_clear(&e->certificate);
+    e->hash = 0;
+    if(UA_ByteString_copy(certificate, &e->certificate) != UA_STATUSCODE_GOOD)
+        return;
+    e->hash = UA_ByteString_hash(0, certificate->data, certificate->length);
+    e->result = result;
+    e->validUntil = UA_DateTime_nowMonotonic() + maxAge;
+    cache->next = (cache->next + 1) % UA_PKICACHE_SIZE;
+}
+
+#endif /* UA_ENABLE_ENCRYPTION */
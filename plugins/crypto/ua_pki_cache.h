@@ -0,0 +1,94 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information.
+ */
+
+#ifndef UA_PKI_CACHE_H_
+#define UA_PKI_CACHE_H_
+
+#include <open62541/types.h>
+
+_UA_BEGIN_DECLS
+
+#ifdef UA_ENABLE_ENCRYPTION
+
+/* The PKI plugins remember the outcome of recent certificate verifications.
+ * During a reconnect storm the same certificates are verified over and over.
+ * A cached result is used until it becomes too old or until the trust store
+ * changes. The oldest entry is replaced when the cache is full. */
+#define UA_PKICACHE_SIZE 32
+#define UA_PKICACHE_LIFETIME (60 * UA_DATETIME_SEC)
+#define UA_PKICACHE_MAXFOLDERS 4
+
+typedef struct {
+    UA_UInt32 hash;
+    UA_ByteString certificate;
+    UA_StatusCode result;
+    UA_DateTime validUntil; /* Monotonic clock */
+} UA_PKICacheEntry;
+
+typedef struct {
+    UA_PKICacheEntry entries[UA_PKICACHE_SIZE];
+    size_t next; /* The entry replaced next */
+
+    /* Reload the trust store before the next verification */
+    UA_Boolean reload;
+
+    /* The folders cannot be watched. Reload before every verification. */
+    UA_Boolean alwaysReload;
+
+#ifdef __linux__
+    int inotifyFd; /* -1 if no folders are watched */
+
+    /* A folder can be deleted or replaced by renaming another folder into its
+     * place. Then the watch is added again for the folder path. The watch
+     * descriptor is -1 while the folder cannot be watched. */
+    size_t foldersSize;
+    UA_String folders[UA_PKICACHE_MAXFOLDERS];
+    int watches[UA_PKICACHE_MAXFOLDERS];
+#endif
+} UA_PKICache;
+
+void
+UA_PKICache_init(UA_PKICache *cache);
+
+void
+UA_PKICache_clear(UA_PKICache *cache);
+
+/* Forget all results and reload the trust store before the next
+ * verification */
+void
+UA_PKICache_flush(UA_PKICache *cache);
+
+#ifdef __linux__
+/* Watch the trust store folders for changes with inotify. Empty folder names
+ * are skipped. If a watched folder is removed or moved away, the folder path is
+ * watched again as soon as it exists. Until then, the trust store is reloaded
+ * before every verification. */
+void
+UA_PKICache_watchFolders(UA_PKICache *cache, const UA_String *folders,
+                         size_t foldersSize);
+#endif
+
+/* Returns true if the trust store has to be reloaded before the verification.
+ * The cached results are forgotten in that case. */
+UA_Boolean
+UA_PKICache_needsReload(UA_PKICache *cache);
+
+/* Returns true and sets the result if the certificate is in the cache */
+UA_Boolean
+UA_PKICache_lookup(UA_PKICache *cache, const UA_ByteString *certificate,
+                   UA_StatusCode *result);
+
+/* Remember the verification result. It is kept for UA_PKICACHE_LIFETIME or
+ * for maxAge, whichever is shorter. A GOOD result must not outlive the
+ * validity of the certificate. So the PKI plugin passes the time until the
+ * certificate expires. Nothing is stored if maxAge is not positive. */
+void
+UA_PKICache_store(UA_PKICache *cache, const UA_ByteString *certificate,
+                  UA_StatusCode result, UA_DateTime maxAge);
+
+#endif /* UA_ENABLE_ENCRYPTION */
+
+_UA_END_DECLS
+
+#endif /* UA_PKI_CACHE_H_ */
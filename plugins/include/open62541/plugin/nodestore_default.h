@@ -27,6 +27,39 @@ UA_Nodestore_HashMap(UA_Nodestore *ns);
 UA_EXPORT UA_StatusCode
 UA_Nodestore_ZipTree(UA_Nodestore *ns);
 
+/* The Layered HashMap Nodestore allows several server instances to share the
+ * nodes that are identical between them. For example the nodes of namespace
+ * zero and of static companion specifications. The shared nodes reside in a
+ * frozen HashMap Nodestore that is never modified. Each server gets its own
+ * layered nodestore on top. Nodes from the frozen base layer are copied into
+ * the upper layer when they are edited (copy on write). Removing a node of the
+ * base layer hides it only for the layered nodestore.
+ *
+ * Usage: Initialize a "template" server with the static nodes. Create the
+ * frozen base from its nodestore. The template server can be deleted
+ * afterwards. For each server instance, replace the default nodestore in the
+ * config with a layered nodestore on the base. The information model is then
+ * already present and UA_Server_newWithConfig does not construct namespace zero
+ * again. The namespace array of the servers has to match that of the template
+ * server (for the namespaces used by the base nodes).
+ *
+ * The layered nodestore requires UA_ENABLE_IMMUTABLE_NODES. Otherwise the
+ * server edits the nodes in-situ and would modify the shared nodes.
+ *
+ * The frozen base can be shared across threads. It must outlive all nodestores
+ * layered on top of it. The nodes of the base are copies. So node contexts and
+ * callback pointers (DataSources, method callbacks, lifecycles) of the template
+ * server are shared as well. */
+
+/* Copy all nodes from the source nodestore into a new frozen HashMap
+ * Nodestore. Nodes cannot be added, replaced or removed from it. */
+UA_EXPORT UA_StatusCode
+UA_Nodestore_HashMapFrozen(UA_Nodestore *ns, const UA_Nodestore *source);
+
+/* Create a HashMap Nodestore on top of a frozen HashMap Nodestore */
+UA_EXPORT UA_StatusCode
+UA_Nodestore_HashMapLayered(UA_Nodestore *ns, const UA_Nodestore *base);
+
 _UA_END_DECLS
 
 #endif /* UA_NODESTORE_DEFAULT_H_ */
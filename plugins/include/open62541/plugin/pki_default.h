@@ -47,6 +47,12 @@ UA_CertificateVerification_CertFolders(UA_CertificateVerification *cv,
 #endif
 #endif
 
+/* Reload the trust store from the certificate folders before the next
+ * verification and forget the cached verification results. Changes in the
+ * folders are detected automatically where inotify is available. */
+UA_EXPORT UA_StatusCode
+UA_CertificateVerification_Reload(UA_CertificateVerification *cv);
+
 #endif
 
 _UA_END_DECLS
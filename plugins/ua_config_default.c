@@ -279,11 +279,19 @@ setDefaultConfig(UA_ServerConfig *conf, UA_UInt16 portNumber) {
     /* Limits for SecureChannels */
     conf->maxSecureChannels = 40;
     conf->maxSecurityTokenLifetime = 10 * 60 * 1000; /* 10 minutes */
+    conf->maxHandshakesPerIteration = 16;
 
     /* Limits for Sessions */
     conf->maxSessions = 100;
     conf->maxSessionTimeout = 60.0 * 60.0 * 1000.0; /* 1h */
 
+    /* Cache for DataSource values */
+    conf->maxValueCacheSize = 1 << 20; /* 1MB */
+
+    /* Cache for Browse results */
+    conf->maxBrowseCacheSize = 1 << 20; /* 1MB */
+    conf->maxBrowsePathCacheSize = 1 << 20; /* 1MB */
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     /* Limits for Subscriptions */
     conf->publishingIntervalLimits = UA_DURATIONRANGE(100.0, 3600.0 * 1000.0);
@@ -292,6 +300,7 @@ setDefaultConfig(UA_ServerConfig *conf, UA_UInt16 portNumber) {
     conf->maxNotificationsPerPublish = 1000;
     conf->enableRetransmissionQueue = true;
     conf->maxRetransmissionQueueSize = 0; /* unlimited */
+    conf->maxSessionMemoryUsage = 0; /* unlimited */
 # ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     conf->maxEventsPerNode = 0; /* unlimited */
 # endif
@@ -795,6 +804,7 @@ UA_ClientConfig_setDefault(UA_ClientConfig *config) {
      *  userTokenPolicy
      *  customDataTypes
      *  connectivityCheckInterval
+     *  maxRequestsInFlight
      *  stateCallback
      *  inactivityCallback
      *  outStandingPublishRequests
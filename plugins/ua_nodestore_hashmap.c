@@ -19,12 +19,20 @@
  *
  * - Tombstone or non-matching NodeId: continue searching
  * - Matching NodeId: Return the entry
- * - NULL: Abort the search */
+ * - NULL: Abort the search
+ *
+ * A nodemap can be layered on top of an immutable (frozen) base nodemap that is
+ * shared between several nodestores. Lookups that don't find the NodeId in the
+ * nodemap continue in the base layer. Nodes of the base layer are never
+ * modified. Instead, the edited copy is inserted into the upper layer (copy on
+ * write). Removed nodes of the base layer are hidden by a masking entry. */
 
 typedef struct UA_NodeMapEntry {
     struct UA_NodeMapEntry *orig; /* the version this is a copy from (or NULL) */
     UA_UInt16 refCount; /* How many consumers have a reference to the node? */
     UA_Boolean deleted; /* Node was marked as deleted and can be deleted when refCount == 0 */
+    UA_Boolean frozen; /* Entry of a frozen nodemap. Not refcounted. */
+    UA_Boolean masked; /* Hides the node with the same NodeId in the base layer */
     UA_Node node;
 } UA_NodeMapEntry;
 
@@ -36,7 +44,7 @@ typedef struct {
     UA_UInt32 nodeIdHash;
 } UA_NodeMapSlot;
 
-typedef struct {
+typedef struct UA_NodeMap {
     UA_NodeMapSlot *slots;
     UA_UInt32 size;
     UA_UInt32 count;
@@ -45,6 +53,12 @@ typedef struct {
     /* Maps ReferenceTypeIndex to the NodeId of the ReferenceType */
     UA_NodeId referenceTypeIds[UA_REFERENCETYPESET_MAX];
     UA_Byte referenceTypeCounter;
+
+    /* The frozen nodemap can no longer be modified */
+    UA_Boolean frozen;
+
+    /* Immutable lower layer (or NULL). Not owned by this nodemap. */
+    const struct UA_NodeMap *base;
 } UA_NodeMap;
 
 /*********************/
@@ -113,18 +127,12 @@ findFreeSlot(const UA_NodeMap *ns, const UA_NodeId *nodeid) {
     return candidate;
 }
 
-/* The occupancy of the table after the call will be about 50% */
+/* Move all entries to a new table with the size primes[nindex] */
 static UA_StatusCode
-expand(UA_NodeMap *ns) {
+resize(UA_NodeMap *ns, UA_UInt32 nindex) {
     UA_UInt32 osize = ns->size;
     UA_UInt32 count = ns->count;
-    /* Resize only when table after removal of unused elements is either too
-       full or too empty */
-    if(count * 2 < osize && (count * 8 > osize || osize <= UA_NODEMAP_MINSIZE))
-        return UA_STATUSCODE_GOOD;
-
     UA_NodeMapSlot *oslots = ns->slots;
-    UA_UInt32 nindex = higher_prime_index(count * 2);
     UA_UInt32 nsize = primes[nindex];
     UA_NodeMapSlot *nslots= (UA_NodeMapSlot*)UA_calloc(nsize, sizeof(UA_NodeMapSlot));
     if(!nslots)
@@ -148,6 +156,18 @@ expand(UA_NodeMap *ns) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* The occupancy of the table after the call will be about 50% */
+static UA_StatusCode
+expand(UA_NodeMap *ns) {
+    UA_UInt32 osize = ns->size;
+    UA_UInt32 count = ns->count;
+    /* Resize only when table after removal of unused elements is either too
+       full or too empty */
+    if(count * 2 < osize && (count * 8 > osize || osize <= UA_NODEMAP_MINSIZE))
+        return UA_STATUSCODE_GOOD;
+    return resize(ns, higher_prime_index(count * 2));
+}
+
 static UA_NodeMapEntry *
 createEntry(UA_NodeClass nodeClass) {
     size_t size = sizeof(UA_NodeMapEntry) - sizeof(UA_Node);
@@ -194,7 +214,7 @@ deleteNodeMapEntry(UA_NodeMapEntry *entry) {
 
 static void
 cleanupNodeMapEntry(UA_NodeMapEntry *entry) {
-    if(entry->refCount > 0)
+    if(entry->refCount > 0 || entry->frozen)
         return;
     if(entry->deleted) {
         deleteNodeMapEntry(entry);
@@ -234,6 +254,44 @@ findOccupiedSlot(const UA_NodeMap *ns, const UA_NodeId *nodeid) {
     return NULL;
 }
 
+/* Find the (visible) entry in the nodemap or in the base layer */
+static UA_NodeMapEntry *
+findEntry(const UA_NodeMap *ns, const UA_NodeId *nodeid) {
+    UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
+    if(slot)
+        return (slot->entry->masked) ? NULL : slot->entry;
+    if(!ns->base)
+        return NULL;
+    slot = findOccupiedSlot(ns->base, nodeid);
+    return (slot) ? slot->entry : NULL;
+}
+
+/* Returns the slot for a new entry or NULL if the NodeId is already taken (also
+ * in the base layer). The slot can contain a masking entry that has to be
+ * replaced. */
+static UA_NodeMapSlot *
+findInsertSlot(const UA_NodeMap *ns, const UA_NodeId *nodeid) {
+    if(!ns->base)
+        return findFreeSlot(ns, nodeid);
+    UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
+    if(slot)
+        return (slot->entry->masked) ? slot : NULL;
+    if(findOccupiedSlot(ns->base, nodeid))
+        return NULL;
+    return findFreeSlot(ns, nodeid);
+}
+
+/* Put the entry into the slot returned by findInsertSlot */
+static void
+setSlotEntry(UA_NodeMap *ns, UA_NodeMapSlot *slot, UA_NodeMapEntry *entry) {
+    if(slot->entry > UA_NODEMAP_TOMBSTONE)
+        deleteNodeMapEntry(slot->entry); /* Replace the masking entry */
+    else
+        ++ns->count;
+    slot->nodeIdHash = UA_NodeId_hash(&entry->node.head.nodeId);
+    slot->entry = entry;
+}
+
 /***********************/
 /* Interface functions */
 /***********************/
@@ -259,11 +317,12 @@ UA_NodeMap_getNode(void *context, const UA_NodeId *nodeid,
                    UA_ReferenceTypeSet references,
                    UA_BrowseDirection referenceDirections) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
-    if(!slot)
+    UA_NodeMapEntry *entry = findEntry(ns, nodeid);
+    if(!entry)
         return NULL;
-    ++slot->entry->refCount;
-    return &slot->entry->node;
+    if(!entry->frozen)
+        ++entry->refCount;
+    return &entry->node;
 }
 
 static const UA_Node *
@@ -283,6 +342,8 @@ UA_NodeMap_releaseNode(void *context, const UA_Node *node) {
         return;
     UA_NodeMapEntry *entry = container_of(node, UA_NodeMapEntry, node);
     UA_assert(&entry->node == node);
+    if(entry->frozen)
+        return;
     UA_assert(entry->refCount > 0);
     --entry->refCount;
     cleanupNodeMapEntry(entry);
@@ -292,10 +353,9 @@ static UA_StatusCode
 UA_NodeMap_getNodeCopy(void *context, const UA_NodeId *nodeid,
                        UA_Node **outNode) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
-    UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
-    if(!slot)
+    UA_NodeMapEntry *entry = findEntry(ns, nodeid);
+    if(!entry)
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
-    UA_NodeMapEntry *entry = slot->entry;
     UA_NodeMapEntry *newItem = createEntry(entry->node.head.nodeClass);
     if(!newItem)
         return UA_STATUSCODE_BADOUTOFMEMORY;
@@ -312,14 +372,49 @@ UA_NodeMap_getNodeCopy(void *context, const UA_NodeId *nodeid,
 static UA_StatusCode
 UA_NodeMap_removeNode(void *context, const UA_NodeId *nodeid) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
+    if(ns->frozen)
+        return UA_STATUSCODE_BADNOTWRITABLE;
     UA_NodeMapSlot *slot = findOccupiedSlot(ns, nodeid);
+    if(slot && slot->entry->masked)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+
+    /* Hide the node of the base layer behind a masking entry */
+    UA_NodeMapEntry *mask = NULL;
+    if(ns->base && findOccupiedSlot(ns->base, nodeid)) {
+        /* Allocate the full entry. The mask holds no attributes, but the
+         * compiler cannot see that a shortened allocation is never read
+         * beyond the ObjectNode. */
+        mask = (UA_NodeMapEntry*)UA_calloc(1, sizeof(UA_NodeMapEntry));
+        if(!mask)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        mask->node.head.nodeClass = UA_NODECLASS_OBJECT;
+        mask->masked = true;
+        UA_StatusCode res = UA_NodeId_copy(nodeid, &mask->node.head.nodeId);
+        if(res != UA_STATUSCODE_GOOD) {
+            deleteNodeMapEntry(mask);
+            return res;
+        }
+        if(!slot) {
+            if(ns->size * 3 <= ns->count * 4 && expand(ns) != UA_STATUSCODE_GOOD) {
+                deleteNodeMapEntry(mask);
+                return UA_STATUSCODE_BADOUTOFMEMORY;
+            }
+            setSlotEntry(ns, findFreeSlot(ns, nodeid), mask);
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+
     if(!slot)
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
 
     UA_NodeMapEntry *entry = slot->entry;
-    slot->entry = UA_NODEMAP_TOMBSTONE;
     entry->deleted = true;
     cleanupNodeMapEntry(entry);
+    if(mask) {
+        slot->entry = mask;
+        return UA_STATUSCODE_GOOD;
+    }
+    slot->entry = UA_NODEMAP_TOMBSTONE;
     --ns->count;
     /* Downsize the hashmap if it is very empty */
     if(ns->count * 8 < ns->size && ns->size > UA_NODEMAP_MINSIZE)
@@ -335,6 +430,10 @@ static UA_StatusCode
 UA_NodeMap_insertNode(void *context, UA_Node *node,
                       UA_NodeId *addedNodeId) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
+    if(ns->frozen) {
+        deleteNodeMapEntry(container_of(node, UA_NodeMapEntry, node));
+        return UA_STATUSCODE_BADNOTWRITABLE;
+    }
     if(ns->size * 3 <= ns->count * 4) {
         if(expand(ns) != UA_STATUSCODE_GOOD){
             deleteNodeMapEntry(container_of(node, UA_NodeMapEntry, node));
@@ -361,7 +460,7 @@ UA_NodeMap_insertNode(void *context, UA_Node *node,
 
         do {
             node->head.nodeId.identifier.numeric = (UA_UInt32)identifier;
-            slot = findFreeSlot(ns, &node->head.nodeId);
+            slot = findInsertSlot(ns, &node->head.nodeId);
             if(slot)
                 break;
             identifier += increase;
@@ -376,7 +475,7 @@ UA_NodeMap_insertNode(void *context, UA_Node *node,
 #endif
         } while((UA_UInt32)identifier != startId);
     } else {
-        slot = findFreeSlot(ns, &node->head.nodeId);
+        slot = findInsertSlot(ns, &node->head.nodeId);
     }
 
     if(!slot) {
@@ -416,10 +515,7 @@ UA_NodeMap_insertNode(void *context, UA_Node *node,
     }
 
     /* Insert the node */
-    UA_NodeMapEntry *newEntry = container_of(node, UA_NodeMapEntry, node);
-    slot->nodeIdHash = UA_NodeId_hash(&node->head.nodeId);
-    slot->entry = newEntry;
-    ++ns->count;
+    setSlotEntry(ns, slot, container_of(node, UA_NodeMapEntry, node));
     return retval;
 }
 
@@ -427,10 +523,27 @@ static UA_StatusCode
 UA_NodeMap_replaceNode(void *context, UA_Node *node) {
     UA_NodeMap *ns = (UA_NodeMap*)context;
     UA_NodeMapEntry *newEntry = container_of(node, UA_NodeMapEntry, node);
+    if(ns->frozen) {
+        deleteNodeMapEntry(newEntry);
+        return UA_STATUSCODE_BADNOTWRITABLE;
+    }
 
     /* Find the node */
     UA_NodeMapSlot *slot = findOccupiedSlot(ns, &node->head.nodeId);
-    if(!slot) {
+    if(!slot && ns->base) {
+        /* The edited copy of a base layer node is added to this layer */
+        UA_NodeMapSlot *baseSlot = findOccupiedSlot(ns->base, &node->head.nodeId);
+        if(baseSlot) {
+            if(baseSlot->entry != newEntry->orig ||
+               (ns->size * 3 <= ns->count * 4 && expand(ns) != UA_STATUSCODE_GOOD)) {
+                deleteNodeMapEntry(newEntry);
+                return UA_STATUSCODE_BADINTERNALERROR;
+            }
+            setSlotEntry(ns, findFreeSlot(ns, &node->head.nodeId), newEntry);
+            return UA_STATUSCODE_GOOD;
+        }
+    }
+    if(!slot || slot->entry->masked) {
         deleteNodeMapEntry(newEntry);
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
     }
@@ -463,14 +576,39 @@ UA_NodeMap_iterate(void *context, UA_NodestoreVisitor visitor,
     UA_NodeMap *ns = (UA_NodeMap*)context;
     for(UA_UInt32 i = 0; i < ns->size; ++i) {
         UA_NodeMapSlot *slot = &ns->slots[i];
-        if(slot->entry > UA_NODEMAP_TOMBSTONE) {
+        if(slot->entry > UA_NODEMAP_TOMBSTONE && !slot->entry->masked) {
             /* The visitor can delete the node. So refcount here. */
-            slot->entry->refCount++;
-            visitor(visitorContext, &slot->entry->node);
-            slot->entry->refCount--;
-            cleanupNodeMapEntry(slot->entry);
+            UA_NodeMapEntry *entry = slot->entry;
+            entry->refCount++;
+            visitor(visitorContext, &entry->node);
+            entry->refCount--;
+            cleanupNodeMapEntry(entry);
         }
     }
+
+    /* Visit the nodes of the base layer that are not hidden by this layer */
+    const UA_NodeMap *base = ns->base;
+    if(!base)
+        return;
+    for(UA_UInt32 i = 0; i < base->size; ++i) {
+        const UA_NodeMapSlot *slot = &base->slots[i];
+        if(slot->entry > UA_NODEMAP_TOMBSTONE &&
+           !findOccupiedSlot(ns, &slot->entry->node.head.nodeId))
+            visitor(visitorContext, &slot->entry->node);
+    }
+}
+
+/* Grow the table once so that the additional nodes can be inserted without
+ * intermediate rehashing */
+static UA_StatusCode
+UA_NodeMap_reserve(void *context, size_t additionalNodes) {
+    UA_NodeMap *ns = (UA_NodeMap*)context;
+    if(additionalNodes > (UA_UINT32_MAX / 4) - ns->count)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    UA_UInt32 count = ns->count + (UA_UInt32)additionalNodes;
+    if(ns->size * 3 > count * 4)
+        return UA_STATUSCODE_GOOD; /* No expansion required for the insertion */
+    return resize(ns, higher_prime_index(count * 2));
 }
 
 static void
@@ -516,6 +654,8 @@ UA_Nodestore_HashMap(UA_Nodestore *ns) {
     }
 
     nodemap->referenceTypeCounter = 0;
+    nodemap->frozen = false;
+    nodemap->base = NULL;
 
     /* Populate the nodestore */
     ns->context = nodemap;
@@ -531,5 +671,127 @@ UA_Nodestore_HashMap(UA_Nodestore *ns) {
     ns->removeNode = UA_NodeMap_removeNode;
     ns->getReferenceTypeId = UA_NodeMap_getReferenceTypeId;
     ns->iterate = UA_NodeMap_iterate;
+    ns->reserve = UA_NodeMap_reserve;
+    return UA_STATUSCODE_GOOD;
+}
+
+/*******************/
+/* Layered NodeMap */
+/*******************/
+
+typedef struct {
+    UA_NodeMap *ns;
+    UA_StatusCode res;
+} FreezeContext;
+
+static void
+freezeVisitor(void *visitorCtx, const UA_Node *node) {
+    FreezeContext *ctx = (FreezeContext*)visitorCtx;
+    if(ctx->res != UA_STATUSCODE_GOOD)
+        return;
+
+    UA_NodeMapEntry *entry = createEntry(node->head.nodeClass);
+    if(!entry) {
+        ctx->res = UA_STATUSCODE_BADOUTOFMEMORY;
+        return;
+    }
+    ctx->res = UA_Node_copy(node, &entry->node);
+    if(ctx->res != UA_STATUSCODE_GOOD) {
+        deleteNodeMapEntry(entry);
+        return;
+    }
+
+    /* The context and the MonitoredItems belong to the source server. They
+     * must not leak into the base that is shared by other servers. */
+    entry->node.head.context = NULL;
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    entry->node.head.monitoredItems = NULL;
+#endif
+
+    /* The references of frozen entries are never rearranged on release */
+    for(size_t i = 0; i < entry->node.head.referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &entry->node.head.references[i];
+        if(rk->targetsSize > 16 && !rk->hasRefTree)
+            UA_NodeReferenceKind_switch(rk);
+    }
+    entry->frozen = true;
+
+    UA_NodeMap *ns = ctx->ns;
+    if(ns->size * 3 <= ns->count * 4 && expand(ns) != UA_STATUSCODE_GOOD) {
+        ctx->res = UA_STATUSCODE_BADOUTOFMEMORY;
+        deleteNodeMapEntry(entry);
+        return;
+    }
+    UA_NodeMapSlot *slot = findFreeSlot(ns, &node->head.nodeId);
+    if(!slot) {
+        ctx->res = UA_STATUSCODE_BADNODEIDEXISTS;
+        deleteNodeMapEntry(entry);
+        return;
+    }
+    setSlotEntry(ns, slot, entry);
+}
+
+UA_StatusCode
+UA_Nodestore_HashMapFrozen(UA_Nodestore *ns, const UA_Nodestore *source) {
+    UA_StatusCode res = UA_Nodestore_HashMap(ns);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* Keep the ReferenceTypeIndex. The references of all nodes use it. */
+    FreezeContext ctx;
+    ctx.ns = (UA_NodeMap*)ns->context;
+    ctx.res = UA_STATUSCODE_GOOD;
+    for(size_t i = 0; i < UA_REFERENCETYPESET_MAX; i++) {
+        const UA_NodeId *refTypeId = source->getReferenceTypeId(source->context, (UA_Byte)i);
+        if(!refTypeId)
+            break;
+        ctx.res |= UA_NodeId_copy(refTypeId, &ctx.ns->referenceTypeIds[i]);
+        ctx.ns->referenceTypeCounter++;
+    }
+
+    /* Copy all nodes. The nodes of a layered source are flattened. */
+    if(ctx.res == UA_STATUSCODE_GOOD)
+        source->iterate(source->context, freezeVisitor, &ctx);
+
+    if(ctx.res != UA_STATUSCODE_GOOD) {
+        ns->clear(ns->context);
+        ns->context = NULL;
+        return ctx.res;
+    }
+
+    ctx.ns->frozen = true;
     return UA_STATUSCODE_GOOD;
 }
+
+UA_StatusCode
+UA_Nodestore_HashMapLayered(UA_Nodestore *ns, const UA_Nodestore *base) {
+#ifndef UA_ENABLE_IMMUTABLE_NODES
+    /* The server edits nodes in-situ. That would modify the shared nodes. */
+    return UA_STATUSCODE_BADNOTSUPPORTED;
+#else
+    if(base->getNode != UA_NodeMap_getNode || !base->context ||
+       !((UA_NodeMap*)base->context)->frozen)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+
+    UA_StatusCode res = UA_Nodestore_HashMap(ns);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+
+    /* New ReferenceTypes continue with the ReferenceTypeIndex after the base
+     * layer */
+    UA_NodeMap *nodemap = (UA_NodeMap*)ns->context;
+    const UA_NodeMap *baseMap = (const UA_NodeMap*)base->context;
+    for(size_t i = 0; i < baseMap->referenceTypeCounter; i++) {
+        res |= UA_NodeId_copy(&baseMap->referenceTypeIds[i],
+                              &nodemap->referenceTypeIds[i]);
+    }
+    nodemap->referenceTypeCounter = baseMap->referenceTypeCounter;
+    nodemap->base = baseMap;
+    if(res != UA_STATUSCODE_GOOD) {
+        ns->clear(ns->context);
+        ns->context = NULL;
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    return UA_STATUSCODE_GOOD;
+#endif
+}
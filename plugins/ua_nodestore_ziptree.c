@@ -400,6 +400,7 @@ UA_Nodestore_ZipTree(UA_Nodestore *ns) {
     ns->removeNode = zipNsRemoveNode;
     ns->getReferenceTypeId = zipNsGetReferenceTypeId;
     ns->iterate = zipNsIterate;
+    ns->reserve = NULL; /* The tree does not need to be resized */
 
     return UA_STATUSCODE_GOOD;
 }
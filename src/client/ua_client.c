@@ -27,6 +27,105 @@
 static void
 clientHouseKeeping(UA_Client *client, void *_);
 
+static void
+sendQueuedRequests(UA_Client *client);
+
+/*********************************/
+/* Lookup of Async Service Calls */
+/*********************************/
+
+#define UA_ASYNCSERVICECALLS_MINBUCKETS 16
+
+static enum aa_cmp
+cmpDeadline(const UA_DateTime *a, const UA_DateTime *b) {
+    if(*a < *b)
+        return AA_CMP_LESS;
+    if(*a > *b)
+        return AA_CMP_MORE;
+    return AA_CMP_EQ;
+}
+
+/* Grow the hash map when there are twice as many calls as buckets. The
+ * requestIds are consecutive and spread evenly over the buckets. Call this
+ * before sending the request, so that adding the call cannot fail. */
+static UA_StatusCode
+reserveAsyncServiceCall(UA_Client *client) {
+    if(client->asyncServiceCallsSize < client->asyncServiceCallsBuckets * 2)
+        return UA_STATUSCODE_GOOD;
+
+    size_t buckets = (client->asyncServiceCallsBuckets > 0) ?
+        client->asyncServiceCallsBuckets * 2 : UA_ASYNCSERVICECALLS_MINBUCKETS;
+    UA_AsyncServiceList *calls = (UA_AsyncServiceList*)
+        UA_malloc(sizeof(UA_AsyncServiceList) * buckets);
+    if(!calls) {
+        /* Continue with the longer buckets if the map cannot grow */
+        return (client->asyncServiceCallsBuckets > 0) ?
+            UA_STATUSCODE_GOOD : UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    for(size_t i = 0; i < buckets; i++)
+        LIST_INIT(&calls[i]);
+
+    /* Rehash */
+    AsyncServiceCall *ac, *ac_tmp;
+    for(size_t i = 0; i < client->asyncServiceCallsBuckets; i++) {
+        LIST_FOREACH_SAFE(ac, &client->asyncServiceCalls[i], pointers, ac_tmp) {
+            LIST_REMOVE(ac, pointers);
+            LIST_INSERT_HEAD(&calls[ac->requestId & (buckets - 1)], ac, pointers);
+        }
+    }
+
+    UA_free(client->asyncServiceCalls);
+    client->asyncServiceCalls = calls;
+    client->asyncServiceCallsBuckets = buckets;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* The call is queued if the request is set. Otherwise it was sent. */
+static void
+addAsyncServiceCall(UA_Client *client, AsyncServiceCall *ac) {
+    UA_assert(client->asyncServiceCallsBuckets > 0);
+    size_t bucket = ac->requestId & (client->asyncServiceCallsBuckets - 1);
+    LIST_INSERT_HEAD(&client->asyncServiceCalls[bucket], ac, pointers);
+    client->asyncServiceCallsSize++;
+
+    /* Begin counting for the timeout */
+    if(ac->timeout > 0) {
+        ac->deadline = UA_DateTime_nowMonotonic() +
+            ((UA_DateTime)ac->timeout * UA_DATETIME_MSEC);
+        aa_insert(&client->asyncServiceTimeouts, ac);
+    }
+
+    if(ac->request)
+        TAILQ_INSERT_TAIL(&client->asyncServiceQueue, ac, queueEntry);
+    else if(ac->windowed)
+        client->asyncServiceCallsInFlight++;
+}
+
+static void
+removeAsyncServiceCall(UA_Client *client, AsyncServiceCall *ac) {
+    LIST_REMOVE(ac, pointers);
+    client->asyncServiceCallsSize--;
+    if(ac->timeout > 0)
+        aa_remove(&client->asyncServiceTimeouts, ac);
+    if(ac->request)
+        TAILQ_REMOVE(&client->asyncServiceQueue, ac, queueEntry);
+    else if(ac->windowed)
+        client->asyncServiceCallsInFlight--;
+}
+
+static AsyncServiceCall *
+findAsyncServiceCall(UA_Client *client, UA_UInt32 requestId) {
+    if(client->asyncServiceCallsBuckets == 0)
+        return NULL;
+    size_t bucket = requestId & (client->asyncServiceCallsBuckets - 1);
+    AsyncServiceCall *ac;
+    LIST_FOREACH(ac, &client->asyncServiceCalls[bucket], pointers) {
+        if(ac->requestId == requestId)
+            return ac;
+    }
+    return NULL;
+}
+
 /********************/
 /* Client Lifecycle */
 /********************/
@@ -54,6 +153,12 @@ UA_Client_newWithConfig(const UA_ClientConfig *config) {
     client->channel.config = client->config.localConnectionConfig;
     client->connectStatus = UA_STATUSCODE_GOOD;
 
+    aa_init(&client->asyncServiceTimeouts,
+            (enum aa_cmp (*)(const void*, const void*))cmpDeadline,
+            offsetof(AsyncServiceCall, timeoutEntry),
+            offsetof(AsyncServiceCall, deadline));
+    TAILQ_INIT(&client->asyncServiceQueue);
+
 #if UA_MULTITHREADING >= 100
     UA_LOCK_INIT(&client->clientMutex);
 #endif
@@ -138,6 +243,11 @@ UA_Client_clear(UA_Client *client) {
     __Client_Subscriptions_clean(client);
 #endif
 
+    /* Delete the hash map of async service calls */
+    UA_free(client->asyncServiceCalls);
+    client->asyncServiceCalls = NULL;
+    client->asyncServiceCallsBuckets = 0;
+
     /* Remove the internal regular callback */
     UA_Client_removeCallback(client, client->houseKeepingCallbackId);
     client->houseKeepingCallbackId = 0;
@@ -235,7 +345,7 @@ notifyClientState(UA_Client *client) {
 /* For both synchronous and asynchronous service calls */
 static UA_StatusCode
 sendRequest(UA_Client *client, const void *request,
-            const UA_DataType *requestType, UA_UInt32 *requestId) {
+            const UA_DataType *requestType, UA_UInt32 rqId) {
     UA_LOCK_ASSERT(&client->clientMutex, 1);
 
     /* Renew SecureChannel if necessary */
@@ -250,7 +360,6 @@ sendRequest(UA_Client *client, const void *request,
     rr->authenticationToken = client->authenticationToken;
     rr->timestamp = UA_DateTime_now();
     rr->requestHandle = ++client->requestHandle;
-    UA_UInt32 rqId = ++client->requestId;
 
 #ifdef UA_ENABLE_TYPEDESCRIPTION
     UA_LOG_DEBUG_CHANNEL(&client->config.logger, &client->channel,
@@ -267,31 +376,25 @@ sendRequest(UA_Client *client, const void *request,
         UA_SecureChannel_sendSymmetricMessage(&client->channel, rqId,
                                               UA_MESSAGETYPE_MSG, rr, requestType);
     rr->authenticationToken = oldToken; /* Set the original token */
-
-    *requestId = rqId;
     return retval;
 }
 
 static const UA_NodeId
 serviceFaultId = {0, UA_NODEIDTYPE_NUMERIC, {UA_NS0ID_SERVICEFAULT_ENCODING_DEFAULTBINARY}};
 
-/* Look for the async callback in the linked list, execute and delete it */
+/* Look for the async callback in the hash map, execute and delete it */
 static UA_StatusCode
 processMSGResponse(UA_Client *client, UA_UInt32 requestId,
                    const UA_ByteString *msg) {
     /* Find the callback */
-    AsyncServiceCall *ac;
-    LIST_FOREACH(ac, &client->asyncServiceCalls, pointers) {
-        if(ac->requestId == requestId)
-            break;
-    }
+    AsyncServiceCall *ac = findAsyncServiceCall(client, requestId);
 
     /* Part 6, 6.7.6: After the security validation is complete the receiver
      * shall verify the RequestId and the SequenceNumber. If these checks fail a
      * Bad_SecurityChecksFailed error is reported. The RequestId only needs to
      * be verified by the Client since only the Client knows if it is valid or
-     * not.*/
-    if(!ac) {
+     * not. Queued requests have not been sent yet. */
+    if(!ac || ac->request) {
         UA_LOG_WARNING(&client->config.logger, UA_LOGCATEGORY_CLIENT,
                        "Request with unknown RequestId %u", requestId);
         return UA_STATUSCODE_BADSECURITYCHECKSFAILED;
@@ -302,7 +405,7 @@ processMSGResponse(UA_Client *client, UA_UInt32 requestId,
     const UA_DataType *responseType = ac->responseType;
 
     /* Dequeue ac. We might disconnect the client (remove all ac) in the callback. */
-    LIST_REMOVE(ac, pointers);
+    removeAsyncServiceCall(client, ac);
 
     /* Decode the response type */
     size_t offset = 0;
@@ -376,6 +479,9 @@ processMSGResponse(UA_Client *client, UA_UInt32 requestId,
     } else {
         ac->syncResponse = NULL; /* Indicate that response was received */
     }
+
+    /* A slot in the window of requests in flight might have become free */
+    sendQueuedRequests(client);
     return retval;
 }
 
@@ -466,9 +572,19 @@ __Client_Service(UA_Client *client, const void *request,
     ac.userdata = NULL;
     ac.responseType = responseType;
     ac.timeout = client->config.timeout;
+    ac.windowed = false;
     ac.syncResponse = (UA_Response*)response;
+    ac.request = NULL;
+    ac.requestType = requestType;
 
-    UA_StatusCode retval = sendRequest(client, request, requestType, &ac.requestId);
+    UA_StatusCode retval = reserveAsyncServiceCall(client);
+    if(retval != UA_STATUSCODE_GOOD) {
+        respHeader->serviceResult = retval;
+        return;
+    }
+
+    ac.requestId = ++client->requestId;
+    retval = sendRequest(client, request, requestType, ac.requestId);
     if(retval != UA_STATUSCODE_GOOD) {
         /* If sending failed, the status is set to closing. The SecureChannel is
          * the actually closed in the next iteration of the EventLoop. */
@@ -482,11 +598,9 @@ __Client_Service(UA_Client *client, const void *request,
         return;
     }
 
-    /* Begin counting for the timeout after sending */
-    ac.start = UA_DateTime_nowMonotonic();
-
-    /* Temporarily insert to the async service list */
-    LIST_INSERT_HEAD(&client->asyncServiceCalls, &ac, pointers);
+    /* Temporarily insert into the map of async service calls. This begins
+     * counting for the timeout after sending. */
+    addAsyncServiceCall(client, &ac);
 
     /* Update the first timeout. Call the event-loop at least once with a
      * timeout of zero. This is also important to have for debugging. */
@@ -537,8 +651,8 @@ __Client_Service(UA_Client *client, const void *request,
         timeout = (UA_UInt32)((maxDate - now) / UA_DATETIME_MSEC);
     }
 
-    /* Detach from the internal async service list */
-    LIST_REMOVE(&ac, pointers);
+    /* Detach from the internal map of async service calls */
+    removeAsyncServiceCall(client, &ac);
 
     /* Return the status code */
     respHeader->serviceResult = retval;
@@ -581,21 +695,32 @@ __Client_AsyncService_cancel(UA_Client *client, AsyncServiceCall *ac,
         UA_clear(&response, ac->responseType);
     }
 
+    /* The request was queued and not sent */
+    if(ac->request)
+        UA_delete(ac->request, ac->requestType);
     UA_free(ac);
 }
 
 void
 __Client_AsyncService_removeAll(UA_Client *client, UA_StatusCode statusCode) {
     /* Make this function reentrant. One of the async callbacks could indirectly
-     * operate on the list. Moving all elements to a local list before iterating
+     * operate on the map. Moving all elements to a local list before iterating
      * that. */
-    UA_AsyncServiceList asyncServiceCalls = client->asyncServiceCalls;
-    LIST_INIT(&client->asyncServiceCalls);
-    if(asyncServiceCalls.lh_first)
-        asyncServiceCalls.lh_first->pointers.le_prev = &asyncServiceCalls.lh_first;
+    UA_AsyncServiceList asyncServiceCalls;
+    LIST_INIT(&asyncServiceCalls);
+    AsyncServiceCall *ac, *ac_tmp;
+    for(size_t i = 0; i < client->asyncServiceCallsBuckets; i++) {
+        LIST_FOREACH_SAFE(ac, &client->asyncServiceCalls[i], pointers, ac_tmp) {
+            removeAsyncServiceCall(client, ac);
+            /* Keep the request to free it during the cancel */
+            LIST_INSERT_HEAD(&asyncServiceCalls, ac, pointers);
+        }
+    }
+    UA_assert(client->asyncServiceCallsSize == 0);
+    UA_assert(client->asyncServiceCallsInFlight == 0);
+    UA_assert(TAILQ_EMPTY(&client->asyncServiceQueue));
 
     /* Cancel and remove the elements from the local list */
-    AsyncServiceCall *ac, *ac_tmp;
     LIST_FOREACH_SAFE(ac, &asyncServiceCalls, pointers, ac_tmp) {
         LIST_REMOVE(ac, pointers);
         __Client_AsyncService_cancel(client, ac, statusCode);
@@ -606,27 +731,56 @@ UA_StatusCode
 UA_Client_modifyAsyncCallback(UA_Client *client, UA_UInt32 requestId,
                               void *userdata, UA_ClientAsyncServiceCallback callback) {
     UA_LOCK(&client->clientMutex);
-    AsyncServiceCall *ac;
     UA_StatusCode res = UA_STATUSCODE_BADNOTFOUND;
-    LIST_FOREACH(ac, &client->asyncServiceCalls, pointers) {
-        if(ac->requestId == requestId) {
-            ac->callback = callback;
-            ac->userdata = userdata;
-            res = UA_STATUSCODE_GOOD;
-            break;
-        }
+    AsyncServiceCall *ac = findAsyncServiceCall(client, requestId);
+    if(ac) {
+        ac->callback = callback;
+        ac->userdata = userdata;
+        res = UA_STATUSCODE_GOOD;
     }
     UA_UNLOCK(&client->clientMutex);
     return res;
 }
 
-UA_StatusCode
-__Client_AsyncServiceEx(UA_Client *client, const void *request,
-                        const UA_DataType *requestType,
-                        UA_ClientAsyncServiceCallback callback,
-                        const UA_DataType *responseType,
-                        void *userdata, UA_UInt32 *requestId,
-                        UA_UInt32 timeout) {
+/* Send queued requests in order while the window of requests in flight has
+ * room */
+static void
+sendQueuedRequests(UA_Client *client) {
+    UA_UInt32 window = client->config.maxRequestsInFlight;
+    AsyncServiceCall *ac;
+    while((ac = TAILQ_FIRST(&client->asyncServiceQueue))) {
+        if(window > 0 && client->asyncServiceCallsInFlight >= window)
+            return;
+        if(client->channel.state != UA_SECURECHANNELSTATE_OPEN)
+            return;
+
+        /* The call is now in flight */
+        TAILQ_REMOVE(&client->asyncServiceQueue, ac, queueEntry);
+        void *request = ac->request;
+        ac->request = NULL;
+        client->asyncServiceCallsInFlight++;
+
+        UA_StatusCode retval = sendRequest(client, request, ac->requestType,
+                                           ac->requestId);
+        UA_delete(request, ac->requestType);
+        if(retval != UA_STATUSCODE_GOOD) {
+            /* The SecureChannel is closed in the next iteration of the
+             * EventLoop. This cancels the remaining queued requests. */
+            removeAsyncServiceCall(client, ac);
+            __Client_AsyncService_cancel(client, ac, retval);
+            notifyClientState(client);
+            return;
+        }
+    }
+}
+
+static UA_StatusCode
+asyncService(UA_Client *client, const void *request,
+             const UA_DataType *requestType,
+             UA_ClientAsyncServiceCallback callback,
+             const UA_DataType *responseType,
+             void *userdata, UA_UInt32 *requestId,
+             UA_UInt32 timeout, UA_Boolean windowed) {
     UA_LOCK_ASSERT(&client->clientMutex, 1);
 
     if(client->channel.state != UA_SECURECHANNELSTATE_OPEN) {
@@ -635,7 +789,12 @@ __Client_AsyncServiceEx(UA_Client *client, const void *request,
         return UA_STATUSCODE_BADSERVERNOTCONNECTED;
     }
 
-    /* Prepare the entry for the linked list */
+    /* Make room in the hash map */
+    UA_StatusCode retval = reserveAsyncServiceCall(client);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+
+    /* Prepare the entry for the hash map */
     AsyncServiceCall *ac = (AsyncServiceCall*)UA_malloc(sizeof(AsyncServiceCall));
     if(!ac)
         return UA_STATUSCODE_BADOUTOFMEMORY;
@@ -643,24 +802,48 @@ __Client_AsyncServiceEx(UA_Client *client, const void *request,
     ac->responseType = responseType;
     ac->userdata = userdata;
     ac->timeout = timeout;
+    ac->windowed = windowed;
     ac->syncResponse = NULL;
-
-    /* Call the service and set the requestId */
-    UA_StatusCode retval = sendRequest(client, request, requestType, &ac->requestId);
-    if(retval != UA_STATUSCODE_GOOD) {
-        /* If sending failed, the status is set to closing. The SecureChannel is
-         * the actually closed in the next iteration of the EventLoop. */
-        UA_assert(client->channel.state == UA_SECURECHANNELSTATE_CLOSING ||
-                  client->channel.state == UA_SECURECHANNELSTATE_CLOSED);
-        UA_free(ac);
-        notifyClientState(client);
-        return retval;
+    ac->request = NULL;
+    ac->requestType = requestType;
+    ac->requestId = ++client->requestId;
+
+    /* Queue a copy of the request if the window of requests in flight is full.
+     * Also if earlier requests are still queued to keep the order. */
+    UA_UInt32 window = client->config.maxRequestsInFlight;
+    if(windowed && (!TAILQ_EMPTY(&client->asyncServiceQueue) ||
+                    (window > 0 && client->asyncServiceCallsInFlight >= window))) {
+        ac->request = UA_new(requestType);
+        if(!ac->request) {
+            UA_free(ac);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        retval = UA_copy(request, ac->request, requestType);
+        if(retval != UA_STATUSCODE_GOOD) {
+            UA_delete(ac->request, requestType);
+            UA_free(ac);
+            return retval;
+        }
+        UA_LOG_DEBUG_CHANNEL(&client->config.logger, &client->channel,
+                             "Queue the request with RequestId %u",
+                             (unsigned)ac->requestId);
+    } else {
+        /* Call the service */
+        retval = sendRequest(client, request, requestType, ac->requestId);
+        if(retval != UA_STATUSCODE_GOOD) {
+            /* If sending failed, the status is set to closing. The
+             * SecureChannel is the actually closed in the next iteration of
+             * the EventLoop. */
+            UA_assert(client->channel.state == UA_SECURECHANNELSTATE_CLOSING ||
+                      client->channel.state == UA_SECURECHANNELSTATE_CLOSED);
+            UA_free(ac);
+            notifyClientState(client);
+            return retval;
+        }
     }
 
-    ac->start = UA_DateTime_nowMonotonic();
-
     /* Store the entry for async processing */
-    LIST_INSERT_HEAD(&client->asyncServiceCalls, ac, pointers);
+    addAsyncServiceCall(client, ac);
     if(requestId)
         *requestId = ac->requestId;
 
@@ -669,6 +852,17 @@ __Client_AsyncServiceEx(UA_Client *client, const void *request,
     return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+__Client_AsyncServiceEx(UA_Client *client, const void *request,
+                        const UA_DataType *requestType,
+                        UA_ClientAsyncServiceCallback callback,
+                        const UA_DataType *responseType,
+                        void *userdata, UA_UInt32 *requestId,
+                        UA_UInt32 timeout) {
+    return asyncService(client, request, requestType, callback, responseType,
+                        userdata, requestId, timeout, false);
+}
+
 UA_StatusCode
 __UA_Client_AsyncServiceEx(UA_Client *client, const void *request,
                            const UA_DataType *requestType,
@@ -678,8 +872,8 @@ __UA_Client_AsyncServiceEx(UA_Client *client, const void *request,
                            UA_UInt32 timeout) {
     UA_LOCK(&client->clientMutex);
     UA_StatusCode res =
-        __Client_AsyncServiceEx(client, request, requestType, callback, responseType,
-                                userdata, requestId, timeout);
+        asyncService(client, request, requestType, callback, responseType,
+                     userdata, requestId, timeout, true);
     UA_UNLOCK(&client->clientMutex);
     return res;
 }
@@ -692,8 +886,8 @@ __UA_Client_AsyncService(UA_Client *client, const void *request,
                          void *userdata, UA_UInt32 *requestId) {
     UA_LOCK(&client->clientMutex);
     UA_StatusCode res =
-        __Client_AsyncServiceEx(client, request, requestType, callback, responseType,
-                                userdata, requestId, client->config.timeout);
+        asyncService(client, request, requestType, callback, responseType,
+                     userdata, requestId, client->config.timeout, true);
     UA_UNLOCK(&client->clientMutex);
     return res;
 }
@@ -769,19 +963,18 @@ UA_Client_removeCallback(UA_Client *client, UA_UInt64 callbackId) {
 static void
 asyncServiceTimeoutCheck(UA_Client *client) {
     /* Make this function reentrant. One of the async callbacks could indirectly
-     * operate on the list. Moving all elements to a local list before iterating
-     * that. */
+     * operate on the map. Moving all elements to a local list before iterating
+     * that. The calls are sorted by their deadline. Stop at the first call
+     * that has not timed out. */
     UA_AsyncServiceList asyncServiceCalls;
     AsyncServiceCall *ac, *ac_tmp;
     UA_DateTime now = UA_DateTime_nowMonotonic();
     LIST_INIT(&asyncServiceCalls);
-    LIST_FOREACH_SAFE(ac, &client->asyncServiceCalls, pointers, ac_tmp) {
-        if(!ac->timeout)
-           continue;
-        if(ac->start + (UA_DateTime)(ac->timeout * UA_DATETIME_MSEC) <= now) {
-            LIST_REMOVE(ac, pointers);
-            LIST_INSERT_HEAD(&asyncServiceCalls, ac, pointers);
-        }
+    while((ac = (AsyncServiceCall*)aa_min(&client->asyncServiceTimeouts))) {
+        if(ac->deadline > now)
+            break;
+        removeAsyncServiceCall(client, ac);
+        LIST_INSERT_HEAD(&asyncServiceCalls, ac, pointers);
     }
 
     /* Cancel and remove the elements from the local list */
@@ -789,6 +982,9 @@ asyncServiceTimeoutCheck(UA_Client *client) {
         LIST_REMOVE(ac, pointers);
         __Client_AsyncService_cancel(client, ac, UA_STATUSCODE_BADTIMEOUT);
     }
+
+    /* Timed out requests free their slot in the window */
+    sendQueuedRequests(client);
 }
 
 static void
@@ -95,16 +95,24 @@ __Client_Subscriptions_backgroundPublishInactivityCheck(UA_Client *client);
 /**********/
 
 typedef struct AsyncServiceCall {
-    LIST_ENTRY(AsyncServiceCall) pointers;
+    LIST_ENTRY(AsyncServiceCall) pointers; /* Hash bucket of the requestId */
+    struct aa_entry timeoutEntry;          /* Sorted by the deadline */
+    TAILQ_ENTRY(AsyncServiceCall) queueEntry; /* Waiting to be sent */
     UA_UInt32 requestId;
     UA_ClientAsyncServiceCallback callback;
     const UA_DataType *responseType;
     void *userdata;
-    UA_DateTime start;
+    UA_DateTime deadline; /* Monotonic clock */
     UA_UInt32 timeout;
+    UA_Boolean windowed; /* Counted in the window of requests in flight */
     UA_Response *syncResponse; /* If non-null, then this is the synchronous
                                 * response to be filled. Set back to null to
                                 * indicate that the response was filled. */
+
+    /* Copy of the request while it waits for a free slot in the window of
+     * requests in flight. NULL once the request was sent. */
+    void *request;
+    const UA_DataType *requestType;
 } AsyncServiceCall;
 
 typedef LIST_HEAD(UA_AsyncServiceList, AsyncServiceCall) UA_AsyncServiceList;
@@ -158,8 +166,16 @@ struct UA_Client {
     UA_DateTime lastConnectivityCheck;
     UA_Boolean pendingConnectivityCheck;
 
-    /* Async Service */
-    UA_AsyncServiceList asyncServiceCalls;
+    /* Async Service. The calls are found by their requestId in a hash map.
+     * Calls with a timeout are additionally sorted by their deadline. */
+    UA_AsyncServiceList *asyncServiceCalls;
+    size_t asyncServiceCallsBuckets; /* Power of two */
+    size_t asyncServiceCallsSize;
+    struct aa_head asyncServiceTimeouts;
+
+    /* Window of requests in flight (see config.maxRequestsInFlight) */
+    size_t asyncServiceCallsInFlight;
+    TAILQ_HEAD(, AsyncServiceCall) asyncServiceQueue;
 
     /* Subscriptions */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
@@ -59,10 +59,20 @@ const UA_ReferenceTypeSet UA_REFERENCETYPESET_ALL = {{UA_REFTYPES_ALL_ARRAY}};
 void
 UA_NodePointer_clear(UA_NodePointer *np) {
     switch(np->immediate & UA_NODEPOINTER_MASK) {
-    case UA_NODEPOINTER_TAG_NODEID:
+    case UA_NODEPOINTER_TAG_NODEID: {
+        /* Owned NodeIds are only created by UA_NodePointer_copy. The
+         * identifier is in the same allocation (see copyNodeIdCompact). */
         np->immediate &= ~(uintptr_t)UA_NODEPOINTER_MASK;
-        UA_NodeId_delete((UA_NodeId*)(uintptr_t)np->id);
+        const UA_NodeId *id = np->id;
+        UA_assert((id->identifierType != UA_NODEIDTYPE_STRING &&
+                   id->identifierType != UA_NODEIDTYPE_BYTESTRING) ||
+                  id->identifier.string.data == NULL ||
+                  id->identifier.string.data == UA_EMPTY_ARRAY_SENTINEL ||
+                  id->identifier.string.data == (const UA_Byte*)&id[1]);
+        (void)id;
+        UA_free((void*)(uintptr_t)np->id);
         break;
+    }
     case UA_NODEPOINTER_TAG_EXPANDEDNODEID:
         np->immediate &= ~(uintptr_t)UA_NODEPOINTER_MASK;
         UA_ExpandedNodeId_delete((UA_ExpandedNodeId*)(uintptr_t)
@@ -74,6 +84,27 @@ UA_NodePointer_clear(UA_NodePointer *np) {
     UA_NodePointer_init(np);
 }
 
+/* Copy the NodeId with the identifier of String and ByteString NodeIds in a
+ * single allocation. Many references point to the same non-numeric NodeIds.
+ * This halves the number of allocations for them. */
+static UA_NodeId *
+copyNodeIdCompact(const UA_NodeId *in) {
+    UA_Boolean isString = (in->identifierType == UA_NODEIDTYPE_STRING ||
+                           in->identifierType == UA_NODEIDTYPE_BYTESTRING);
+    size_t idLen = (isString) ? in->identifier.string.length : 0;
+    UA_NodeId *out = (UA_NodeId*)UA_malloc(sizeof(UA_NodeId) + idLen);
+    if(!out)
+        return NULL;
+    *out = *in;
+    if(idLen > 0) {
+        out->identifier.string.data = (UA_Byte*)&out[1];
+        memcpy(out->identifier.string.data, in->identifier.string.data, idLen);
+    } else if(isString && in->identifier.string.data != UA_EMPTY_ARRAY_SENTINEL) {
+        out->identifier.string.data = NULL;
+    }
+    return out;
+}
+
 UA_StatusCode
 UA_NodePointer_copy(UA_NodePointer in, UA_NodePointer *out) {
     UA_StatusCode res = UA_STATUSCODE_GOOD;
@@ -85,15 +116,9 @@ UA_NodePointer_copy(UA_NodePointer in, UA_NodePointer *out) {
         goto nodeid; /* fallthrough */
     case UA_NODEPOINTER_TAG_NODEID:
     nodeid:
-        out->id = UA_NodeId_new();
+        out->id = copyNodeIdCompact(in.id);
         if(!out->id)
             return UA_STATUSCODE_BADOUTOFMEMORY;
-        res = UA_NodeId_copy(in.id, (UA_NodeId*)(uintptr_t)out->id);
-        if(res != UA_STATUSCODE_GOOD) {
-            UA_free((void*)out->immediate);
-            out->immediate = 0;
-            break;
-        }
         out->immediate |= UA_NODEPOINTER_TAG_NODEID;
         break;
     case UA_NODEPOINTER_TAG_EXPANDEDNODEID:
@@ -256,6 +281,26 @@ static UA_StatusCode
 addReferenceTarget(UA_NodeReferenceKind *refs, UA_NodePointer target,
                    UA_UInt32 targetNameHash);
 
+/* The targets in the array representation. A single target is inline. */
+static UA_ReferenceTarget *
+getTargetArray(const UA_NodeReferenceKind *rk) {
+    UA_assert(!rk->hasRefTree);
+    if(rk->hasRefInline)
+        return (UA_ReferenceTarget*)(uintptr_t)&rk->targets.single;
+    return rk->targets.array;
+}
+
+/* Free the array representation. The NodePointers are cleared. */
+static void
+clearTargetArray(UA_NodeReferenceKind *rk) {
+    UA_ReferenceTarget *targets = getTargetArray(rk);
+    for(size_t i = 0; i < rk->targetsSize; i++)
+        UA_NodePointer_clear(&targets[i].targetId);
+    if(!rk->hasRefInline)
+        UA_free(rk->targets.array);
+    rk->hasRefInline = false;
+}
+
 static enum aa_cmp
 cmpRefTargetId(const void *a, const void *b) {
     const UA_ReferenceTargetTreeElem *aa = (const UA_ReferenceTargetTreeElem*)a;
@@ -298,9 +343,12 @@ UA_NodeReferenceKind_iterate(const UA_NodeReferenceKind *rk,
             return (const UA_ReferenceTarget*)aa_min(&_refIdTree);
         return (const UA_ReferenceTarget*)aa_next(&_refIdTree, prev);
     }
+    if(rk->targetsSize == 0)
+        return NULL;
+    const UA_ReferenceTarget *array = getTargetArray(rk);
     if(prev == NULL) /* Return start of the array */
-        return rk->targets.array;
-    if(prev + 1 >= &rk->targets.array[rk->targetsSize])
+        return array;
+    if(prev + 1 >= &array[rk->targetsSize])
         return NULL; /* End of the array */
     return prev + 1; /* Next element in the array */
 }
@@ -324,26 +372,37 @@ UA_StatusCode
 UA_NodeReferenceKind_switch(UA_NodeReferenceKind *rk) {
     if(rk->hasRefTree) {
         /* From tree to array */
-        UA_ReferenceTarget *array = (UA_ReferenceTarget*)
-            UA_malloc(sizeof(UA_ReferenceTarget) * rk->targetsSize);
-        if(!array)
-            return UA_STATUSCODE_BADOUTOFMEMORY;
+        UA_ReferenceTarget single;
+        UA_ReferenceTarget *array = &single;
+        if(rk->targetsSize > 1) {
+            array = (UA_ReferenceTarget*)
+                UA_malloc(sizeof(UA_ReferenceTarget) * rk->targetsSize);
+            if(!array)
+                return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
         size_t pos = 0;
         moveTreeToArray(array, &pos, rk->targets.tree.idTreeRoot);
-        rk->targets.array = array;
+        if(rk->targetsSize > 1)
+            rk->targets.array = array;
+        else
+            rk->targets.single = single;
         rk->hasRefTree = false;
+        rk->hasRefInline = (rk->targetsSize == 1);
         return UA_STATUSCODE_GOOD;
     }
 
     /* From array to tree */
     UA_NodeReferenceKind newRk = *rk;
     newRk.hasRefTree = true;
+    newRk.hasRefInline = false;
     newRk.targets.tree.idTreeRoot = NULL;
     newRk.targets.tree.nameTreeRoot = NULL;
+    newRk.targetsSize = 0; /* Counted up again during the insertion */
+    const UA_ReferenceTarget *array = getTargetArray(rk);
     for(size_t i = 0; i < rk->targetsSize; i++) {
         UA_StatusCode res =
-            addReferenceTarget(&newRk, rk->targets.array[i].targetId,
-                               rk->targets.array[i].targetNameHash);
+            addReferenceTarget(&newRk, array[i].targetId,
+                               array[i].targetNameHash);
         if(res != UA_STATUSCODE_GOOD) {
             struct aa_head _refIdTree = refIdTree;
             _refIdTree.root = newRk.targets.tree.idTreeRoot;
@@ -358,9 +417,7 @@ UA_NodeReferenceKind_switch(UA_NodeReferenceKind *rk) {
             return res;
         }
     }
-    for(size_t i = 0; i < rk->targetsSize; i++)
-        UA_NodePointer_clear(&rk->targets.array[i].targetId);
-    UA_free(rk->targets.array);
+    clearTargetArray(rk);
     *rk = newRk;
     return UA_STATUSCODE_GOOD;
 }
@@ -382,13 +439,235 @@ UA_NodeReferenceKind_findTarget(const UA_NodeReferenceKind *rk,
     }
 
     /* Return from the array */
+    const UA_ReferenceTarget *array = getTargetArray(rk);
     for(size_t i = 0; i < rk->targetsSize; i++) {
-        if(UA_NodePointer_equal(targetP, rk->targets.array[i].targetId))
-            return &rk->targets.array[i];
+        if(UA_NodePointer_equal(targetP, array[i].targetId))
+            return &array[i];
+    }
+    return NULL;
+}
+
+/********************/
+/* Interned Strings */
+/********************/
+
+/* The string content is allocated directly behind the entry header. The
+ * header is found from the data pointer of an interned string. The refCount
+ * of an entry in a pool is only changed with the pool lock held. Nodes are
+ * cleared from any thread (e.g. when a nodestore drops the last reference),
+ * not only with the service mutex of the server. */
+typedef struct UA_InternedString {
+    struct UA_InternedString *next;
+    UA_StringPool *pool; /* NULL after the pool was deleted */
+    size_t refCount;
+    UA_UInt32 hash;
+    size_t length;
+} UA_InternedString;
+
+#define UA_STRINGPOOL_MINSIZE 64
+
+struct UA_StringPool {
+#if UA_MULTITHREADING >= 100
+    UA_Lock lock;
+#endif
+    UA_InternedString **buckets;
+    size_t bucketsSize; /* Power of two */
+    size_t count;
+};
+
+static UA_Byte *
+internedData(UA_InternedString *is) {
+    return (UA_Byte*)is + sizeof(UA_InternedString);
+}
+
+static UA_InternedString *
+internedHeader(const UA_Byte *data) {
+    return (UA_InternedString*)(uintptr_t)(data - sizeof(UA_InternedString));
+}
+
+UA_StringPool *
+UA_StringPool_new(void) {
+    UA_StringPool *pool = (UA_StringPool*)UA_calloc(1, sizeof(UA_StringPool));
+    if(!pool)
+        return NULL;
+    pool->buckets = (UA_InternedString**)
+        UA_calloc(UA_STRINGPOOL_MINSIZE, sizeof(UA_InternedString*));
+    if(!pool->buckets) {
+        UA_free(pool);
+        return NULL;
+    }
+    pool->bucketsSize = UA_STRINGPOOL_MINSIZE;
+    UA_LOCK_INIT(&pool->lock);
+    return pool;
+}
+
+void
+UA_StringPool_delete(UA_StringPool *pool) {
+    if(!pool)
+        return;
+    /* Strings still in use (e.g. in nodes that outlive the server) are
+     * detached and freed with their last release */
+    UA_LOCK(&pool->lock);
+    for(size_t i = 0; i < pool->bucketsSize; i++) {
+        UA_InternedString *is = pool->buckets[i];
+        while(is) {
+            UA_InternedString *next = is->next;
+            is->next = NULL;
+            is->pool = NULL;
+            is = next;
+        }
+    }
+    UA_UNLOCK(&pool->lock);
+    UA_LOCK_DESTROY(&pool->lock);
+    UA_free(pool->buckets);
+    UA_free(pool);
+}
+
+static UA_InternedString *
+findInterned(const UA_StringPool *pool, UA_UInt32 hash, const UA_String *s) {
+    UA_InternedString *is = pool->buckets[hash & (pool->bucketsSize - 1)];
+    for(; is; is = is->next) {
+        if(is->hash == hash && is->length == s->length &&
+           memcmp(internedData(is), s->data, s->length) == 0)
+            return is;
     }
     return NULL;
 }
 
+/* Double the number of buckets. Does nothing if out-of-memory. */
+static void
+growStringPool(UA_StringPool *pool) {
+    size_t newSize = pool->bucketsSize * 2;
+    UA_InternedString **buckets = (UA_InternedString**)
+        UA_calloc(newSize, sizeof(UA_InternedString*));
+    if(!buckets)
+        return;
+    for(size_t i = 0; i < pool->bucketsSize; i++) {
+        UA_InternedString *is = pool->buckets[i];
+        while(is) {
+            UA_InternedString *next = is->next;
+            size_t b = is->hash & (newSize - 1);
+            is->next = buckets[b];
+            buckets[b] = is;
+            is = next;
+        }
+    }
+    UA_free(pool->buckets);
+    pool->buckets = buckets;
+    pool->bucketsSize = newSize;
+}
+
+const UA_Byte *
+UA_StringPool_find(UA_StringPool *pool, const UA_String *s) {
+    if(!pool || s->length == 0)
+        return NULL;
+    UA_UInt32 hash = UA_ByteString_hash(0, s->data, s->length);
+    UA_LOCK(&pool->lock);
+    UA_InternedString *is = findInterned(pool, hash, s);
+    UA_UNLOCK(&pool->lock);
+    return (is) ? internedData(is) : NULL;
+}
+
+UA_Boolean
+UA_StringPool_intern(UA_StringPool *pool, UA_String *s) {
+    if(!pool || s->length == 0)
+        return false;
+
+    /* Take a reference to an existing entry */
+    UA_UInt32 hash = UA_ByteString_hash(0, s->data, s->length);
+    UA_LOCK(&pool->lock);
+    UA_InternedString *is = findInterned(pool, hash, s);
+    if(is) {
+        is->refCount++;
+        UA_UNLOCK(&pool->lock);
+        UA_String_clear(s);
+        s->data = internedData(is);
+        s->length = is->length;
+        return true;
+    }
+
+    /* Add a new entry */
+    is = (UA_InternedString*)UA_malloc(sizeof(UA_InternedString) + s->length);
+    if(!is) {
+        UA_UNLOCK(&pool->lock);
+        return false;
+    }
+    is->pool = pool;
+    is->refCount = 1;
+    is->hash = hash;
+    is->length = s->length;
+    memcpy(internedData(is), s->data, s->length);
+    if(pool->count >= pool->bucketsSize)
+        growStringPool(pool);
+    size_t b = hash & (pool->bucketsSize - 1);
+    is->next = pool->buckets[b];
+    pool->buckets[b] = is;
+    pool->count++;
+    UA_UNLOCK(&pool->lock);
+
+    UA_String_clear(s);
+    s->data = internedData(is);
+    s->length = is->length;
+    return true;
+}
+
+void
+UA_StringPool_release(UA_String *s) {
+    UA_InternedString *is = internedHeader(s->data);
+    UA_String_init(s);
+
+    /* Detached entries are only referenced from nodes that outlived the
+     * server. They are released without a lock. */
+    UA_StringPool *pool = is->pool;
+    if(!pool) {
+        UA_assert(is->refCount > 0);
+        if(--is->refCount == 0)
+            UA_free(is);
+        return;
+    }
+
+    UA_LOCK(&pool->lock);
+    UA_assert(is->refCount > 0);
+    if(--is->refCount > 0) {
+        UA_UNLOCK(&pool->lock);
+        return;
+    }
+
+    /* Unlink from the pool */
+    UA_InternedString **prev = &pool->buckets[is->hash & (pool->bucketsSize - 1)];
+    while(*prev != is)
+        prev = &(*prev)->next;
+    *prev = is->next;
+    pool->count--;
+    UA_UNLOCK(&pool->lock);
+    UA_free(is);
+}
+
+static void
+internLocalizedTextList(UA_StringPool *pool, UA_LocalizedTextListEntry *lt) {
+    for(; lt; lt = lt->next) {
+        if(!lt->interned)
+            lt->interned = UA_StringPool_intern(pool, &lt->localizedText.text);
+    }
+}
+
+void
+UA_Node_internStrings(UA_StringPool *pool, UA_Node *node) {
+    UA_NodeHead *head = &node->head;
+    if(!head->internedBrowseName)
+        head->internedBrowseName = UA_StringPool_intern(pool, &head->browseName.name);
+    internLocalizedTextList(pool, head->displayName);
+    internLocalizedTextList(pool, head->description);
+}
+
+static void
+clearLocalizedTextListEntry(UA_LocalizedTextListEntry *lt) {
+    if(lt->interned)
+        UA_StringPool_release(&lt->localizedText.text);
+    UA_LocalizedText_clear(&lt->localizedText);
+    UA_free(lt);
+}
+
 /* General node handling methods. There is no UA_Node_new() method here.
  * Creating nodes is part of the Nodestore layer */
 
@@ -399,20 +678,22 @@ void UA_Node_clear(UA_Node *node) {
     /* Delete other head content */
     UA_NodeHead *head = &node->head;
     UA_NodeId_clear(&head->nodeId);
+    if(head->internedBrowseName) {
+        UA_StringPool_release(&head->browseName.name);
+        head->internedBrowseName = false;
+    }
     UA_QualifiedName_clear(&head->browseName);
 
     UA_LocalizedTextListEntry *lt;
 
     while((lt = head->displayName)) {
         head->displayName = lt->next;
-        UA_LocalizedText_clear(&lt->localizedText);
-        UA_free(lt);
+        clearLocalizedTextListEntry(lt);
     }
 
     while((lt = head->description)) {
         head->description = lt->next;
-        UA_LocalizedText_clear(&lt->localizedText);
-        UA_free(lt);
+        clearLocalizedTextListEntry(lt);
     }
 
     /* Delete unique content of the nodeclass */
@@ -483,6 +764,11 @@ UA_VariableNode_copy(const UA_VariableNode *src, UA_VariableNode *dst) {
     dst->minimumSamplingInterval = src->minimumSamplingInterval;
     dst->historizing = src->historizing;
     dst->isDynamic = src->isDynamic;
+#if UA_MULTITHREADING >= 100
+    dst->async = src->async;
+#endif
+    dst->readBatch = src->readBatch;
+    dst->sessionSpecificValue = src->sessionSpecificValue;
     return UA_CommonVariableNode_copy(src, dst);
 }
 
@@ -651,37 +937,36 @@ UA_Node_copy(const UA_Node *src, UA_Node *dst) {
     return retval;
 }
 
+/* Returns zero for an unknown NodeClass */
+static size_t
+getNodeSize(UA_NodeClass nodeClass) {
+    switch(nodeClass) {
+    case UA_NODECLASS_OBJECT:
+        return sizeof(UA_ObjectNode);
+    case UA_NODECLASS_VARIABLE:
+        return sizeof(UA_VariableNode);
+    case UA_NODECLASS_METHOD:
+        return sizeof(UA_MethodNode);
+    case UA_NODECLASS_OBJECTTYPE:
+        return sizeof(UA_ObjectTypeNode);
+    case UA_NODECLASS_VARIABLETYPE:
+        return sizeof(UA_VariableTypeNode);
+    case UA_NODECLASS_REFERENCETYPE:
+        return sizeof(UA_ReferenceTypeNode);
+    case UA_NODECLASS_DATATYPE:
+        return sizeof(UA_DataTypeNode);
+    case UA_NODECLASS_VIEW:
+        return sizeof(UA_ViewNode);
+    default:
+        return 0;
+    }
+}
+
 UA_Node *
 UA_Node_copy_alloc(const UA_Node *src) {
-    size_t nodesize = 0;
-    switch(src->head.nodeClass) {
-        case UA_NODECLASS_OBJECT:
-            nodesize = sizeof(UA_ObjectNode);
-            break;
-        case UA_NODECLASS_VARIABLE:
-            nodesize = sizeof(UA_VariableNode);
-            break;
-        case UA_NODECLASS_METHOD:
-            nodesize = sizeof(UA_MethodNode);
-            break;
-        case UA_NODECLASS_OBJECTTYPE:
-            nodesize = sizeof(UA_ObjectTypeNode);
-            break;
-        case UA_NODECLASS_VARIABLETYPE:
-            nodesize = sizeof(UA_VariableTypeNode);
-            break;
-        case UA_NODECLASS_REFERENCETYPE:
-            nodesize = sizeof(UA_ReferenceTypeNode);
-            break;
-        case UA_NODECLASS_DATATYPE:
-            nodesize = sizeof(UA_DataTypeNode);
-            break;
-        case UA_NODECLASS_VIEW:
-            nodesize = sizeof(UA_ViewNode);
-            break;
-        default:
-            return NULL;
-    }
+    size_t nodesize = getNodeSize(src->head.nodeClass);
+    if(nodesize == 0)
+        return NULL;
 
     UA_Node *dst = (UA_Node*)UA_calloc(1, nodesize);
     if(!dst)
@@ -696,6 +981,103 @@ UA_Node_copy_alloc(const UA_Node *src) {
     }
     return dst;
 }
+
+/****************/
+/* Memory Usage */
+/****************/
+
+static size_t
+nodeIdMemory(const UA_NodeId *id) {
+    if(id->identifierType == UA_NODEIDTYPE_STRING ||
+       id->identifierType == UA_NODEIDTYPE_BYTESTRING)
+        return id->identifier.string.length;
+    return 0;
+}
+
+static size_t
+nodePointerMemory(UA_NodePointer np) {
+    UA_Byte tag = np.immediate & UA_NODEPOINTER_MASK;
+    np.immediate &= ~(uintptr_t)UA_NODEPOINTER_MASK;
+    switch(tag) {
+    case UA_NODEPOINTER_TAG_NODEID:
+        return sizeof(UA_NodeId) + nodeIdMemory(np.id);
+    case UA_NODEPOINTER_TAG_EXPANDEDNODEID:
+        return sizeof(UA_ExpandedNodeId) + nodeIdMemory(&np.expandedId->nodeId) +
+            np.expandedId->namespaceUri.length;
+    default:
+        return 0;
+    }
+}
+
+static size_t
+localizedTextListMemory(const UA_LocalizedTextListEntry *lt) {
+    size_t mem = 0;
+    for(; lt; lt = lt->next)
+        mem += sizeof(UA_LocalizedTextListEntry) + lt->localizedText.locale.length +
+            ((lt->interned) ? 0 : lt->localizedText.text.length);
+    return mem;
+}
+
+/* Nested allocations inside the value are not considered */
+static size_t
+variantMemory(const UA_Variant *v) {
+    if(!v->type || v->storageType == UA_VARIANT_DATA_NODELETE ||
+       !v->data || v->data == UA_EMPTY_ARRAY_SENTINEL)
+        return 0;
+    size_t elements = (UA_Variant_isScalar(v)) ? 1 : v->arrayLength;
+    return elements * v->type->memSize +
+        v->arrayDimensionsSize * sizeof(UA_UInt32);
+}
+
+void
+UA_Node_getMemoryUsage(const UA_Node *node, size_t *nodeMemory,
+                       size_t *referenceMemory, size_t *references) {
+    /* Attributes */
+    const UA_NodeHead *head = &node->head;
+    size_t mem = getNodeSize(head->nodeClass);
+    mem += nodeIdMemory(&head->nodeId);
+    if(!head->internedBrowseName)
+        mem += head->browseName.name.length;
+    mem += localizedTextListMemory(head->displayName);
+    mem += localizedTextListMemory(head->description);
+    switch(head->nodeClass) {
+    case UA_NODECLASS_VARIABLE:
+    case UA_NODECLASS_VARIABLETYPE: {
+        /* The VariableNode and VariableTypeNode share the attribute layout */
+        const UA_VariableNode *vn = &node->variableNode;
+        mem += nodeIdMemory(&vn->dataType);
+        mem += vn->arrayDimensionsSize * sizeof(UA_UInt32);
+        if(vn->valueSource == UA_VALUESOURCE_DATA)
+            mem += variantMemory(&vn->value.data.value.value);
+        break;
+    }
+    case UA_NODECLASS_REFERENCETYPE:
+        mem += node->referenceTypeNode.inverseName.locale.length +
+            node->referenceTypeNode.inverseName.text.length;
+        break;
+    default:
+        break;
+    }
+    *nodeMemory = mem;
+
+    /* References */
+    size_t refMem = sizeof(UA_NodeReferenceKind) * head->referencesSize;
+    size_t refCount = 0;
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        const UA_NodeReferenceKind *rk = &head->references[i];
+        refCount += rk->targetsSize;
+        if(rk->hasRefTree)
+            refMem += rk->targetsSize * sizeof(UA_ReferenceTargetTreeElem);
+        else if(!rk->hasRefInline)
+            refMem += rk->targetsSize * sizeof(UA_ReferenceTarget);
+        const UA_ReferenceTarget *t = NULL;
+        while((t = UA_NodeReferenceKind_iterate(rk, t)))
+            refMem += nodePointerMemory(t->targetId);
+    }
+    *referenceMemory = refMem;
+    *references = refCount;
+}
+
 /******************************/
 /* Copy Attributes into Nodes */
 /******************************/
@@ -874,25 +1256,40 @@ addReferenceTarget(UA_NodeReferenceKind *rk, UA_NodePointer targetId,
                    UA_UInt32 targetNameHash) {
     /* Insert into array */
     if(!rk->hasRefTree) {
-        UA_ReferenceTarget *newRefs = (UA_ReferenceTarget*)
-            UA_realloc(rk->targets.array,
-                       sizeof(UA_ReferenceTarget) * (rk->targetsSize + 1));
-        if(!newRefs)
-            return UA_STATUSCODE_BADOUTOFMEMORY;
-        rk->targets.array = newRefs;
-
-        UA_StatusCode retval =
-            UA_NodePointer_copy(targetId,
-                                &rk->targets.array[rk->targetsSize].targetId);
-        rk->targets.array[rk->targetsSize].targetNameHash = targetNameHash;
-        if(retval != UA_STATUSCODE_GOOD) {
-            if(rk->targetsSize == 0) {
-                UA_free(rk->targets.array);
-                rk->targets.array = NULL;
-            }
+        UA_ReferenceTarget target;
+        UA_StatusCode retval = UA_NodePointer_copy(targetId, &target.targetId);
+        if(retval != UA_STATUSCODE_GOOD)
             return retval;
+        target.targetNameHash = targetNameHash;
+
+        /* The first target is stored inline */
+        if(rk->targetsSize == 0) {
+            rk->targets.single = target;
+            rk->targetsSize = 1;
+            rk->hasRefInline = true;
+            return UA_STATUSCODE_GOOD;
         }
+
+        /* Move the inline target into a new array */
+        UA_ReferenceTarget *newRefs;
+        if(rk->hasRefInline) {
+            newRefs = (UA_ReferenceTarget*)
+                UA_malloc(sizeof(UA_ReferenceTarget) * 2);
+            if(newRefs)
+                newRefs[0] = rk->targets.single;
+        } else {
+            newRefs = (UA_ReferenceTarget*)
+                UA_realloc(rk->targets.array,
+                           sizeof(UA_ReferenceTarget) * (rk->targetsSize + 1));
+        }
+        if(!newRefs) {
+            UA_NodePointer_clear(&target.targetId);
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        }
+        newRefs[rk->targetsSize] = target;
+        rk->targets.array = newRefs;
         rk->targetsSize++;
+        rk->hasRefInline = false;
         return UA_STATUSCODE_GOOD;
     }
 
@@ -1016,14 +1413,23 @@ UA_Node_deleteReference(UA_Node *node, UA_Byte refTypeIndex, UA_Boolean isForwar
             continue;
 
         /* Ok, delete the reference. Cannot fail */
-        refs->targetsSize--;
-
         if(!refs->hasRefTree) {
             /* Remove from array */
             UA_NodePointer_clear(&target->targetId);
-
-            /* Elements remaining. Realloc. */
-            if(refs->targetsSize > 0) {
+            refs->targetsSize--;
+
+            if(refs->hasRefInline) {
+                /* Removed the inline target */
+                refs->hasRefInline = false;
+            } else if(refs->targetsSize == 1) {
+                /* One element remaining. Move it inline. */
+                UA_ReferenceTarget *array = refs->targets.array;
+                refs->targets.single = (target == &array[0]) ? array[1] : array[0];
+                refs->hasRefInline = true;
+                UA_free(array);
+                return UA_STATUSCODE_GOOD;
+            } else if(refs->targetsSize > 0) {
+                /* Elements remaining. Realloc. */
                 if(target != &refs->targets.array[refs->targetsSize])
                     *target = refs->targets.array[refs->targetsSize];
                 UA_ReferenceTarget *newRefs = (UA_ReferenceTarget*)
@@ -1032,12 +1438,13 @@ UA_Node_deleteReference(UA_Node *node, UA_Byte refTypeIndex, UA_Boolean isForwar
                 if(newRefs)
                     refs->targets.array = newRefs;
                 return UA_STATUSCODE_GOOD; /* Realloc allowed to fail */
+            } else {
+                /* Removed the last target of an array */
+                UA_free(refs->targets.array);
             }
-
-            /* Remove the last target. Remove the ReferenceKind below */
-            UA_free(refs->targets.array);
         } else {
             /* Remove from the tree */
+            refs->targetsSize--;
             _refIdTree.root = refs->targets.tree.idTreeRoot;
             aa_remove(&_refIdTree, target);
             refs->targets.tree.idTreeRoot = _refIdTree.root;
@@ -1088,9 +1495,7 @@ UA_Node_deleteReferencesSubset(UA_Node *node, const UA_ReferenceTypeSet *keepSet
         /* Remove all target entries. Don't remove entries from browseName tree.
          * The entire ReferenceKind will be removed anyway. */
         if(!refs->hasRefTree) {
-            for(size_t j = 0; j < refs->targetsSize; j++)
-                UA_NodePointer_clear(&refs->targets.array[j].targetId);
-            UA_free(refs->targets.array);
+            clearTargetArray(refs);
         } else {
             _refIdTree.root = refs->targets.tree.idTreeRoot;
             while(_refIdTree.root) {
@@ -1147,8 +1552,7 @@ UA_Node_insertOrUpdateLocale(UA_LocalizedTextListEntry **root,
                 *root = lt->next;
             else
                 prev->next = lt->next;
-            UA_LocalizedText_clear(&lt->localizedText);
-            UA_free(lt);
+            clearLocalizedTextListEntry(lt);
             return UA_STATUSCODE_GOOD;
         }
 
@@ -1159,8 +1563,12 @@ UA_Node_insertOrUpdateLocale(UA_LocalizedTextListEntry **root,
         if(res != UA_STATUSCODE_GOOD)
             return res;
 
-        UA_String_clear(&lt->localizedText.text);
+        if(lt->interned)
+            UA_StringPool_release(&lt->localizedText.text);
+        else
+            UA_String_clear(&lt->localizedText.text);
         lt->localizedText.text = tmp;
+        lt->interned = false;
         return UA_STATUSCODE_GOOD;
     }
 
@@ -1180,6 +1588,7 @@ UA_Node_insertOrUpdateLocale(UA_LocalizedTextListEntry **root,
         UA_free(lt);
         return res;
     }
+    lt->interned = false;
 
     lt->next = *root;
     *root = lt;
@@ -183,14 +183,27 @@ cleanup:
 
 /* The server needs to be stopped before it can be deleted */
 void UA_Server_delete(UA_Server *server) {
+#if UA_MULTITHREADING >= 100
+    /* The workers may wait for the service mutex */
+    UA_AsyncManager_stopWorkers(&server->asyncManager);
+#endif
+
     UA_LOCK(&server->serviceMutex);
 
     UA_Server_deleteSecureChannels(server);
+    if(server->handshakeCallbackScheduled && server->config.eventLoop) {
+        UA_EventLoop *el = server->config.eventLoop;
+        el->removeDelayedCallback(el, &server->handshakeCallback);
+        server->handshakeCallbackScheduled = false;
+    }
     session_list_entry *current, *temp;
     LIST_FOREACH_SAFE(current, &server->sessions, pointers, temp) {
         UA_Server_removeSession(server, current, UA_DIAGNOSTICEVENT_CLOSE);
     }
     UA_Array_delete(server->namespaces, server->namespacesSize, &UA_TYPES[UA_TYPES_STRING]);
+    UA_ValueCache_clear(&server->valueCache);
+    UA_BrowseCache_clear(&server->browseCache);
+    UA_SubtypeCache_clear(&server->subtypeCache);
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     UA_MonitoredItem *mon, *mon_tmp;
@@ -206,6 +219,7 @@ void UA_Server_delete(UA_Server *server) {
     }
     UA_assert(server->monitoredItemsSize == 0);
     UA_assert(server->subscriptionsSize == 0);
+    UA_assert(LIST_EMPTY(&server->publishGroups));
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
     UA_ConditionList_delete(server);
@@ -246,6 +260,9 @@ void UA_Server_delete(UA_Server *server) {
     /* Clean up the config */
     UA_ServerConfig_clean(&server->config);
 
+    /* After the nodestore is cleaned up */
+    UA_StringPool_delete(server->stringPool);
+
 #if UA_MULTITHREADING >= 100
     UA_LOCK_DESTROY(&server->serviceMutex);
 #endif
@@ -314,8 +331,19 @@ UA_Server_init(UA_Server *server) {
     server->namespaces[1] = UA_STRING_NULL;
     server->namespacesSize = 2;
 
+    UA_ValueCache_init(&server->valueCache);
+    UA_BrowseCache_init(&server->browseCache);
+    UA_SubtypeCache_init(&server->subtypeCache);
+
+    /* Pool for the interned node strings */
+    server->stringPool = UA_StringPool_new();
+    UA_CHECK_MEM(server->stringPool, goto cleanup);
+
     /* Initialize SecureChannel */
     TAILQ_INIT(&server->channels);
+    TAILQ_INIT(&server->handshakeQueue);
+    server->handshakeCallback.callback = (UA_Callback)processQueuedHandshakes;
+    server->handshakeCallback.application = server;
     /* TODO: use an ID that is likely to be unique after a restart */
     server->lastChannelId = STARTCHANNELID;
     server->lastTokenId = STARTTOKENID;
@@ -558,9 +586,59 @@ UA_Server_getStatistics(UA_Server *server) {
     stat.ss.rejectedSessionCount = sds->rejectedSessionCount;
     stat.ss.sessionTimeoutCount = sds->sessionTimeoutCount;
     stat.ss.sessionAbortCount = sds->sessionAbortCount;
+    stat.bcs.hits = server->browseCache.hits;
+    stat.bcs.misses = server->browseCache.misses;
+    stat.bcs.entries = server->browseCache.count;
+    stat.bcs.memory = server->browseCache.memory;
+    stat.bcs.pathHits = server->browseCache.pathHits;
+    stat.bcs.pathMisses = server->browseCache.pathMisses;
+    stat.bcs.pathEntries = server->browseCache.pathCount;
+    stat.bcs.pathMemory = server->browseCache.pathMemory;
     return stat;
 }
 
+static void
+addMemoryUsage(UA_NodeClassMemoryUsage *usage, size_t nodeMemory,
+               size_t referenceMemory, size_t references) {
+    usage->nodes++;
+    usage->references += references;
+    usage->nodeMemory += nodeMemory;
+    usage->referenceMemory += referenceMemory;
+}
+
+static void
+memoryUsageVisitor(void *visitorCtx, const UA_Node *node) {
+    UA_NodestoreMemoryUsage *usage = (UA_NodestoreMemoryUsage*)visitorCtx;
+    UA_NodeClassMemoryUsage *ncUsage;
+    switch(node->head.nodeClass) {
+    case UA_NODECLASS_OBJECT: ncUsage = &usage->objects; break;
+    case UA_NODECLASS_VARIABLE: ncUsage = &usage->variables; break;
+    case UA_NODECLASS_METHOD: ncUsage = &usage->methods; break;
+    case UA_NODECLASS_OBJECTTYPE: ncUsage = &usage->objectTypes; break;
+    case UA_NODECLASS_VARIABLETYPE: ncUsage = &usage->variableTypes; break;
+    case UA_NODECLASS_REFERENCETYPE: ncUsage = &usage->referenceTypes; break;
+    case UA_NODECLASS_DATATYPE: ncUsage = &usage->dataTypes; break;
+    case UA_NODECLASS_VIEW: ncUsage = &usage->views; break;
+    default: return;
+    }
+
+    size_t nodeMemory, referenceMemory, references;
+    UA_Node_getMemoryUsage(node, &nodeMemory, &referenceMemory, &references);
+    addMemoryUsage(ncUsage, nodeMemory, referenceMemory, references);
+    addMemoryUsage(&usage->total, nodeMemory, referenceMemory, references);
+}
+
+UA_NodestoreMemoryUsage
+UA_Server_getNodestoreMemoryUsage(UA_Server *server) {
+    UA_NodestoreMemoryUsage usage;
+    memset(&usage, 0, sizeof(UA_NodestoreMemoryUsage));
+    UA_LOCK(&server->serviceMutex);
+    server->config.nodestore.iterate(server->config.nodestore.context,
+                                     memoryUsageVisitor, &usage);
+    UA_UNLOCK(&server->serviceMutex);
+    return usage;
+}
+
 static UA_StatusCode
 UA_Server_createServerConnection(UA_Server *server, const UA_String *serverUrl) {
     UA_ServerConfig *config = &server->config;
@@ -795,6 +873,12 @@ UA_Server_run_startup(UA_Server *server) {
         UA_CHECK_STATUS(retVal, return retVal);
     }
 
+#if UA_MULTITHREADING >= 100
+    /* Start the worker threads for async operations */
+    retVal = UA_AsyncManager_startWorkers(&server->asyncManager, server);
+    UA_CHECK_STATUS(retVal, return retVal);
+#endif
+
     /* Open server sockets */
     UA_Boolean haveServerSocket = false;
     if(config->serverUrlsSize == 0) {
@@ -940,6 +1024,12 @@ UA_Server_run_shutdown(UA_Server *server) {
     UA_Server_removeCallback(server, server->houseKeepingCallbackId);
     server->houseKeepingCallbackId = 0;
 
+#if UA_MULTITHREADING >= 100
+    /* Stop the worker threads for async operations. Their results are
+     * integrated while the EventLoop is stopped. */
+    UA_AsyncManager_stopWorkers(&server->asyncManager);
+#endif
+
     /* Mark all reverse connects as destroying */
     reverse_connect_context *rev = NULL;
     SLIST_FOREACH(rev, &server->reverseConnects, next) {
@@ -10,10 +10,67 @@
 
 #if UA_MULTITHREADING >= 100
 
+/* Types of the operation request and result */
+static const UA_DataType *
+operationRequestType(UA_AsyncOperationType type) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_READ: return &UA_TYPES[UA_TYPES_READVALUEID];
+    case UA_ASYNCOPERATIONTYPE_WRITE: return &UA_TYPES[UA_TYPES_WRITEVALUE];
+    default: return &UA_TYPES[UA_TYPES_CALLMETHODREQUEST];
+    }
+}
+
+static const UA_DataType *
+operationResultType(UA_AsyncOperationType type) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_READ: return &UA_TYPES[UA_TYPES_DATAVALUE];
+    case UA_ASYNCOPERATIONTYPE_WRITE: return &UA_TYPES[UA_TYPES_STATUSCODE];
+    default: return &UA_TYPES[UA_TYPES_CALLMETHODRESULT];
+    }
+}
+
+/* Type of the service response */
+static const char *
+operationTypeName(UA_AsyncOperationType type) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_READ: return "Read";
+    case UA_ASYNCOPERATIONTYPE_WRITE: return "Write";
+    default: return "Call";
+    }
+}
+
+static const UA_DataType *
+serviceResponseType(UA_AsyncOperationType type) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_READ: return &UA_TYPES[UA_TYPES_READRESPONSE];
+    case UA_ASYNCOPERATIONTYPE_WRITE: return &UA_TYPES[UA_TYPES_WRITERESPONSE];
+    default: return &UA_TYPES[UA_TYPES_CALLRESPONSE];
+    }
+}
+
+/* Set the status of a result that was not returned by the worker */
+static void
+setResultStatus(UA_AsyncOperationType type, UA_AsyncOperationResponse *result,
+                UA_StatusCode res) {
+    switch(type) {
+    case UA_ASYNCOPERATIONTYPE_READ:
+        result->readResult.hasStatus = true;
+        result->readResult.status = res;
+        break;
+    case UA_ASYNCOPERATIONTYPE_WRITE:
+        result->writeResult = res;
+        break;
+    default:
+        result->callMethodResult.statusCode = res;
+        break;
+    }
+}
+
 static void
 UA_AsyncOperation_delete(UA_AsyncOperation *ar) {
-    UA_CallMethodRequest_clear(&ar->request);
-    UA_CallMethodResult_clear(&ar->response);
+    UA_clear(&ar->request, operationRequestType(ar->type));
+    UA_clear(&ar->response, operationResultType(ar->type));
+    UA_NodeId_clear(&ar->sessionId);
     UA_free(ar);
 }
 
@@ -43,12 +100,14 @@ UA_AsyncManager_sendAsyncResponse(UA_AsyncManager *am, UA_Server *server,
         goto clean_up;
     }
 
-    /* Okay, here we go, send the UA_CallResponse */
+    /* Okay, here we go, send the response. The ResponseHeader is the first
+     * member of all response types. */
     responseHeader = (UA_ResponseHeader*)
         &ar->response.callResponse.responseHeader;
     responseHeader->requestHandle = ar->requestHandle;
     res = sendResponse(server, session, channel, ar->requestId,
-                       (UA_Response*)&ar->response, &UA_TYPES[UA_TYPES_CALLRESPONSE]);
+                       (UA_Response*)&ar->response,
+                       serviceResponseType(ar->operationType));
     UA_LOG_DEBUG(&server->config.logger, UA_LOGCATEGORY_SERVER,
                  "UA_Server_SendResponse: Response for Req# %" PRIu32 " sent", ar->requestId);
 
@@ -59,12 +118,12 @@ UA_AsyncManager_sendAsyncResponse(UA_AsyncManager *am, UA_Server *server,
 }
 
 /* Integrate operation result in the AsyncResponse and send out the response if
- * it is ready. */
+ * it is ready. The result is moved. */
 static void
 integrateOperationResult(UA_AsyncManager *am, UA_Server *server,
-                         UA_AsyncOperation *ao) {
-    /* Grab the open request, so we can continue to construct the response */
-    UA_AsyncResponse *ar = ao->parent;
+                         UA_AsyncResponse *ar, const UA_AsyncOperation *ao,
+                         UA_AsyncOperationResponse *result) {
+    size_t index = ao->index;
 
     /* Reduce the number of open results */
     ar->opCountdown -= 1;
@@ -73,31 +132,97 @@ integrateOperationResult(UA_AsyncManager *am, UA_Server *server,
                  "Return result in the server thread with %" PRIu32 " remaining",
                  ar->opCountdown);
 
-    /* Move the UA_CallMethodResult to UA_CallResponse */
-    ar->response.callResponse.results[ao->index] = ao->response;
-    UA_CallMethodResult_init(&ao->response);
+    /* Move the operation result into the response */
+    switch(ao->type) {
+    case UA_ASYNCOPERATIONTYPE_READ: {
+        UA_DataValue *v = &ar->response.readResponse.results[index];
+        *v = result->readResult;
+        /* Static variables have timestamps of "now" (as for synchronous
+         * reads). Use the flag captured when the operation was created. The
+         * serviceMutex is not held here for a nodestore lookup. */
+        if(ao->staticValue) {
+            v->hasServerTimestamp = false;
+            v->hasSourceTimestamp = false;
+        }
+        UA_StatusCode res = (v->hasStatus) ? v->status : UA_STATUSCODE_GOOD;
+        finishRead(ar->timestampsToReturn, UA_ATTRIBUTEID_VALUE, res, v);
+        break;
+    }
+    case UA_ASYNCOPERATIONTYPE_WRITE:
+        ar->response.writeResponse.results[index] = result->writeResult;
+        break;
+    default:
+        ar->response.callResponse.results[index] = result->callMethodResult;
+        break;
+    }
+    memset(result, 0, sizeof(UA_AsyncOperationResponse));
 
     /* Are we done with all operations? */
     if(ar->opCountdown == 0)
         UA_AsyncManager_sendAsyncResponse(am, server, ar);
 }
 
-/* Process all operations in the result queue -> move content over to the
+/* Integrate a timeout result. The operation is detached from the
+ * AsyncResponse. */
+static void
+integrateTimeout(UA_AsyncManager *am, UA_Server *server, UA_AsyncOperation *ao) {
+    UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                   "Operation was removed due to a timeout");
+    UA_AsyncOperationResponse result;
+    memset(&result, 0, sizeof(UA_AsyncOperationResponse));
+    setResultStatus(ao->type, &result, UA_STATUSCODE_BADTIMEOUT);
+    UA_AsyncResponse *ar = ao->parent;
+    ao->parent = NULL;
+    integrateOperationResult(am, server, ar, ao, &result);
+}
+
+/* Take all results returned by the workers and move them over to the
  * AsyncResponse. This is only done by the server thread. */
 static void
 processAsyncResults(UA_Server *server, void *data) {
     UA_AsyncManager *am = &server->asyncManager;
-    while(true) {
-        UA_LOCK(&am->queueLock);
-        UA_AsyncOperation *ao = TAILQ_FIRST(&am->resultQueue);
-        if(ao)
-            TAILQ_REMOVE(&am->resultQueue, ao, pointers);
-        UA_UNLOCK(&am->queueLock);
-        if(!ao)
-            break;
-        UA_LOG_DEBUG(&server->config.logger, UA_LOGCATEGORY_SERVER,
-                     "UA_Server_CallMethodResponse: Got Response: OKAY");
-        integrateOperationResult(am, server, ao);
+
+    /* Take the entire stack. Workers pushing from now on add the delayed
+     * callback again. */
+    UA_AsyncOperation *ao = (UA_AsyncOperation*)
+        UA_atomic_xchg((void * volatile *)&am->resultStack, NULL);
+    if(!ao)
+        return;
+
+    /* Reverse to integrate in the order the results were returned */
+    UA_AsyncOperation *results = NULL, *next;
+    for(; ao; ao = next) {
+        next = ao->nextResult;
+        ao->nextResult = results;
+        results = ao;
+    }
+
+    /* Remove from the dispatched queue. Take the lock only once. Wake up the
+     * workers if operations are no longer blocked by the concurrency limit of
+     * their method. */
+    UA_Boolean released = false;
+    UA_LOCK(&am->queueLock);
+    for(ao = results; ao; ao = ao->nextResult) {
+        TAILQ_REMOVE(&am->dispatchedQueue, ao, pointers);
+        if(ao->limit) {
+            ao->limit->running--;
+            released = true;
+        }
+    }
+    if(released && am->workersSize > 0)
+        UA_COND_BROADCAST(&am->workerCondition);
+    UA_UNLOCK(&am->queueLock);
+
+    /* Integrate the results */
+    for(ao = results; ao; ao = next) {
+        next = ao->nextResult;
+        if(ao->parent) {
+            integrateOperationResult(am, server, ao->parent, ao, &ao->response);
+        } else {
+            UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                           "Async %s operation: The result is discarded as the "
+                           "operation has timed out", operationTypeName(ao->type));
+        }
         UA_AsyncOperation_delete(ao);
         am->opsCount--;
     }
@@ -113,21 +238,23 @@ checkTimeouts(UA_Server *server, void *_) {
     UA_AsyncManager *am = &server->asyncManager;
     const UA_DateTime tNow = UA_DateTime_now();
 
+    /* Collect the timed out operations. Integrate them only after the lock is
+     * released, as sending the response takes the service mutex. */
+    UA_AsyncOperation *timedOutNew = NULL, *timedOutDispatched = NULL;
     UA_LOCK(&am->queueLock);
 
-    /* Loop over the queue of dispatched ops */
+    /* Loop over the queue of dispatched ops. They remain in the queue until
+     * the worker returns them. */
     UA_AsyncOperation *op = NULL, *op_tmp = NULL;
-    TAILQ_FOREACH_SAFE(op, &am->dispatchedQueue, pointers, op_tmp) {
+    TAILQ_FOREACH(op, &am->dispatchedQueue, pointers) {
+        /* Has already timed out */
+        if(!op->parent)
+            continue;
         /* The timeout has not passed. Also for all elements following in the queue. */
         if(tNow <= op->parent->timeout)
             break;
-
-        /* Mark as timed out and put it into the result queue */
-        op->response.statusCode = UA_STATUSCODE_BADTIMEOUT;
-        TAILQ_REMOVE(&am->dispatchedQueue, op, pointers);
-        TAILQ_INSERT_TAIL(&am->resultQueue, op, pointers);
-        UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
-                       "Operation was removed due to a timeout");
+        op->nextTimedOut = timedOutDispatched;
+        timedOutDispatched = op;
     }
 
     /* Loop over the queue of new ops */
@@ -135,19 +262,22 @@ checkTimeouts(UA_Server *server, void *_) {
         /* The timeout has not passed. Also for all elements following in the queue. */
         if(tNow <= op->parent->timeout)
             break;
-
-        /* Mark as timed out and put it into the result queue */
-        op->response.statusCode = UA_STATUSCODE_BADTIMEOUT;
         TAILQ_REMOVE(&am->newQueue, op, pointers);
-        TAILQ_INSERT_TAIL(&am->resultQueue, op, pointers);
-        UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
-                       "Operation was removed due to a timeout");
+        op->nextTimedOut = timedOutNew;
+        timedOutNew = op;
     }
 
     UA_UNLOCK(&am->queueLock);
 
-    /* Integrate async results and send out complete responses */
-    processAsyncResults(server, NULL);
+    /* Integrate the timeouts and send out complete responses */
+    for(op = timedOutDispatched; op; op = op->nextTimedOut)
+        integrateTimeout(am, server, op);
+    for(op = timedOutNew; op; op = op_tmp) {
+        op_tmp = op->nextTimedOut;
+        integrateTimeout(am, server, op);
+        UA_AsyncOperation_delete(op);
+        am->opsCount--;
+    }
 }
 
 void
@@ -156,11 +286,12 @@ UA_AsyncManager_init(UA_AsyncManager *am, UA_Server *server) {
     TAILQ_INIT(&am->asyncResponses);
     TAILQ_INIT(&am->newQueue);
     TAILQ_INIT(&am->dispatchedQueue);
-    TAILQ_INIT(&am->resultQueue);
     UA_LOCK_INIT(&am->queueLock);
+    UA_COND_INIT(&am->workerCondition);
+    am->processResultsCallback.callback = (UA_Callback)processAsyncResults;
+    am->processResultsCallback.application = server;
 
-    /* Add a regular callback for cleanup and sending finished responses at a
-     * 100s interval. */
+    /* Add a regular callback for checking timeouts at a 100ms interval */
     UA_Server_addRepeatedCallback(server, (UA_ServerCallback)checkTimeouts,
                                   NULL, 100.0, &am->checkTimeoutCallbackId);
 }
@@ -168,10 +299,12 @@ UA_AsyncManager_init(UA_AsyncManager *am, UA_Server *server) {
 void
 UA_AsyncManager_clear(UA_AsyncManager *am, UA_Server *server) {
     removeCallback(server, am->checkTimeoutCallbackId);
+    UA_assert(am->workersSize == 0);
 
     UA_AsyncOperation *ar, *ar_tmp;
 
-    /* Clean up queues */
+    /* Clean up queues. The results on the stack are also still in the
+     * dispatched queue. A pending delayed callback finds the stack empty. */
     UA_LOCK(&am->queueLock);
     TAILQ_FOREACH_SAFE(ar, &am->newQueue, pointers, ar_tmp) {
         TAILQ_REMOVE(&am->newQueue, ar, pointers);
@@ -181,10 +314,16 @@ UA_AsyncManager_clear(UA_AsyncManager *am, UA_Server *server) {
         TAILQ_REMOVE(&am->dispatchedQueue, ar, pointers);
         UA_AsyncOperation_delete(ar);
     }
-    TAILQ_FOREACH_SAFE(ar, &am->resultQueue, pointers, ar_tmp) {
-        TAILQ_REMOVE(&am->resultQueue, ar, pointers);
-        UA_AsyncOperation_delete(ar);
+    am->resultStack = NULL;
+
+    /* Remove the method limits */
+    UA_AsyncMethodLimit *limit, *limit_tmp;
+    for(limit = am->methodLimits; limit; limit = limit_tmp) {
+        limit_tmp = limit->next;
+        UA_NodeId_clear(&limit->methodId);
+        UA_free(limit);
     }
+    am->methodLimits = NULL;
     UA_UNLOCK(&am->queueLock);
 
     /* Remove responses */
@@ -194,6 +333,7 @@ UA_AsyncManager_clear(UA_AsyncManager *am, UA_Server *server) {
     }
 
     /* Delete all locks */
+    UA_COND_DESTROY(&am->workerCondition);
     UA_LOCK_DESTROY(&am->queueLock);
 }
 
@@ -214,6 +354,7 @@ UA_AsyncManager_createAsyncResponse(UA_AsyncManager *am, UA_Server *server,
     }
 
     am->asyncResponsesCount += 1;
+    newentry->operationType = operationType;
     newentry->requestId = requestId;
     newentry->requestHandle = requestHandle;
     newentry->timeout = UA_DateTime_now();
@@ -231,16 +372,34 @@ void
 UA_AsyncManager_removeAsyncResponse(UA_AsyncManager *am, UA_AsyncResponse *ar) {
     TAILQ_REMOVE(&am->asyncResponses, ar, pointers);
     am->asyncResponsesCount -= 1;
-    UA_CallResponse_clear(&ar->response.callResponse);
+    UA_clear(&ar->response, serviceResponseType(ar->operationType));
     UA_NodeId_clear(&ar->sessionId);
     UA_free(ar);
 }
 
-/* Enqueue next MethodRequest */
+void
+UA_AsyncManager_takeResponse(UA_AsyncManager *am, UA_AsyncResponse *ar,
+                             void *response, UA_Boolean *finished) {
+    /* If there is a new AsyncResponse, ensure it has at least one pending
+     * operation */
+    if(ar->opCountdown == 0) {
+        UA_AsyncManager_removeAsyncResponse(am, ar);
+        return;
+    }
+
+    /* Move all results to the AsyncResponse. The async operation results will
+     * be overwritten when the workers return results. */
+    const UA_DataType *responseType = serviceResponseType(ar->operationType);
+    memcpy(&ar->response, response, responseType->memSize);
+    UA_init(response, responseType);
+    *finished = false;
+}
+
+/* Enqueue the next operation */
 UA_StatusCode
 UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
                               UA_AsyncResponse *ar, size_t opIndex,
-                              const UA_CallMethodRequest *opRequest) {
+                              const void *opRequest, UA_Boolean staticValue) {
     if(server->config.maxAsyncOperationQueueSize != 0 &&
        am->opsCount >= server->config.maxAsyncOperationQueueSize) {
         UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
@@ -256,22 +415,33 @@ UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
         return UA_STATUSCODE_BADOUTOFMEMORY;
     }
 
-    UA_StatusCode result = UA_CallMethodRequest_copy(opRequest, &ao->request);
+    ao->type = ar->operationType;
+    UA_StatusCode result =
+        UA_copy(opRequest, &ao->request, operationRequestType(ao->type));
     if(result != UA_STATUSCODE_GOOD) {
         UA_LOG_ERROR(&server->config.logger, UA_LOGCATEGORY_SERVER,
-                     "UA_Server_SetAsyncMethodResult: UA_CallMethodRequest_copy failed.");
+                     "UA_Server_SetAsyncMethodResult: Copying the request failed.");
+        UA_free(ao);
+        return result;
+    }
+
+    result = UA_NodeId_copy(&ar->sessionId, &ao->sessionId);
+    if(result != UA_STATUSCODE_GOOD) {
+        UA_clear(&ao->request, operationRequestType(ao->type));
         UA_free(ao);
         return result;
     }
 
-    UA_CallMethodResult_init(&ao->response);
     ao->index = opIndex;
     ao->parent = ar;
+    ao->staticValue = staticValue;
 
     UA_LOCK(&am->queueLock);
     TAILQ_INSERT_TAIL(&am->newQueue, ao, pointers);
     am->opsCount++;
     ar->opCountdown++;
+    if(am->workersSize > 0)
+        UA_COND_SIGNAL(&am->workerCondition);
     UA_UNLOCK(&am->queueLock);
 
     if(server->config.asyncOperationNotifyCallback)
@@ -280,6 +450,39 @@ UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
     return UA_STATUSCODE_GOOD;
 }
 
+static UA_AsyncMethodLimit *
+findMethodLimit(UA_AsyncManager *am, const UA_NodeId *methodId) {
+    UA_AsyncMethodLimit *limit = am->methodLimits;
+    for(; limit; limit = limit->next) {
+        if(UA_NodeId_equal(&limit->methodId, methodId))
+            return limit;
+    }
+    return NULL;
+}
+
+/* Move the next operation to the dispatched queue. Skip operations whose method
+ * has reached its concurrency limit. Call with the queueLock held. */
+static UA_AsyncOperation *
+takeAsyncOperation(UA_AsyncManager *am) {
+    UA_AsyncOperation *ao;
+    TAILQ_FOREACH(ao, &am->newQueue, pointers) {
+        UA_AsyncMethodLimit *limit = NULL;
+        if(am->methodLimits && ao->type == UA_ASYNCOPERATIONTYPE_CALL)
+            limit = findMethodLimit(am, &ao->request.callMethodRequest.methodId);
+        if(limit && limit->maxConcurrency > 0 &&
+           limit->running >= limit->maxConcurrency)
+            continue;
+        if(limit) {
+            limit->running++;
+            ao->limit = limit;
+        }
+        TAILQ_REMOVE(&am->newQueue, ao, pointers);
+        TAILQ_INSERT_TAIL(&am->dispatchedQueue, ao, pointers);
+        return ao;
+    }
+    return NULL;
+}
+
 /* Get and remove next Method Call Request */
 UA_Boolean
 UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType *type,
@@ -290,12 +493,10 @@ UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType
     UA_Boolean bRV = false;
     *type = UA_ASYNCOPERATIONTYPE_INVALID;
     UA_LOCK(&am->queueLock);
-    UA_AsyncOperation *ao = TAILQ_FIRST(&am->newQueue);
+    UA_AsyncOperation *ao = takeAsyncOperation(am);
     if(ao) {
-        TAILQ_REMOVE(&am->newQueue, ao, pointers);
-        TAILQ_INSERT_TAIL(&am->dispatchedQueue, ao, pointers);
-        *type = UA_ASYNCOPERATIONTYPE_CALL;
-        *request = (UA_AsyncOperationRequest*)&ao->request;
+        *type = ao->type;
+        *request = &ao->request;
         *context = (void*)ao;
         if(timeout)
             *timeout = ao->parent->timeout;
@@ -306,13 +507,31 @@ UA_Server_getAsyncOperationNonBlocking(UA_Server *server, UA_AsyncOperationType
     return bRV;
 }
 
+/* Push the operation with the result onto the lock-free result stack. There is
+ * no ABA problem, as the server thread always takes the entire stack. */
+static void
+returnAsyncOperation(UA_Server *server, UA_AsyncOperation *ao) {
+    UA_AsyncManager *am = &server->asyncManager;
+    UA_AsyncOperation *head;
+    do {
+        head = am->resultStack;
+        ao->nextResult = head;
+    } while(UA_atomic_cmpxchg((void * volatile *)&am->resultStack,
+                              head, ao) != head);
+
+    /* The stack was empty. Process the results in the next EventLoop
+     * iteration. */
+    if(!head) {
+        UA_EventLoop *el = server->config.eventLoop;
+        el->addDelayedCallback(el, &am->processResultsCallback);
+    }
+}
+
 /* Worker submits Method Call Response */
 void
 UA_Server_setAsyncOperationResult(UA_Server *server,
                                   const UA_AsyncOperationResponse *response,
                                   void *context) {
-    UA_AsyncManager *am = &server->asyncManager;
-
     UA_AsyncOperation *ao = (UA_AsyncOperation*)context;
     if(!ao) {
         /* Something went wrong. Not a good AsyncOp. */
@@ -321,46 +540,136 @@ UA_Server_setAsyncOperationResult(UA_Server *server,
         return;
     }
 
-    UA_LOCK(&am->queueLock);
+    /* Copy the result into the internal AsyncOperation. The operation remains
+     * valid until the result is returned, also if it has timed out. Then the
+     * result is discarded in the server thread. */
+    UA_StatusCode result =
+        UA_copy(response, &ao->response, operationResultType(ao->type));
+    if(result != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                       "UA_Server_SetAsyncMethodResult: Copying the result failed.");
+        setResultStatus(ao->type, &ao->response, UA_STATUSCODE_BADOUTOFMEMORY);
+    }
 
-    /* See if the operation is still in the dispatched queue. Otherwise it has
-     * been removed due to a timeout.
-     *
-     * TODO: Add a tree-structure for the dispatch queue. The linear lookup does
-     * not scale. */
-    UA_Boolean found = false;
-    UA_AsyncOperation *op = NULL;
-    TAILQ_FOREACH(op, &am->dispatchedQueue, pointers) {
-        if(op == ao) {
-            found = true;
-            break;
-        }
+    returnAsyncOperation(server, ao);
+
+    UA_LOG_DEBUG(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                 "Set the result from the worker thread");
+}
+
+/******************/
+/* Worker Threads */
+/******************/
+
+/* Execute the operation in the worker thread with the access rights of the
+ * originating session. The result is moved into the operation.
+ *
+ * The serviceMutex is released during the user callbacks. The session can be
+ * removed in the meantime. So the operation is executed with a local session
+ * that only carries the identity (SessionId and the handle from the access
+ * control plugin). */
+static void
+executeAsyncOperation(UA_Server *server, UA_AsyncOperation *ao) {
+    UA_LOCK(&server->serviceMutex);
+    UA_Session *origin = getSessionById(server, &ao->sessionId);
+    if(!origin) {
+        UA_UNLOCK(&server->serviceMutex);
+        setResultStatus(ao->type, &ao->response, UA_STATUSCODE_BADSESSIONIDINVALID);
+        return;
     }
 
-    if(!found) {
-        UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
-                       "UA_Server_SetAsyncMethodResult: The operation has timed out");
+    UA_Session session;
+    UA_Session_init(&session);
+    session.sessionId = ao->sessionId;
+    session.sessionHandle = origin->sessionHandle;
+
+    switch(ao->type) {
+    case UA_ASYNCOPERATIONTYPE_READ:
+        /* The TimestampsToReturn of the request are applied when the result is
+         * integrated */
+        ao->response.readResult =
+            UA_Server_readWithSession(server, &session, &ao->request.readValueId,
+                                      UA_TIMESTAMPSTORETURN_BOTH, 0.0);
+        break;
+    case UA_ASYNCOPERATIONTYPE_WRITE:
+        ao->response.writeResult =
+            UA_Server_writeWithSession(server, &session, &ao->request.writeValue);
+        break;
+    default:
+#ifdef UA_ENABLE_METHODCALLS
+        ao->response.callMethodResult =
+            UA_Server_callWithSession(server, &session,
+                                      &ao->request.callMethodRequest);
+#else
+        ao->response.callMethodResult.statusCode = UA_STATUSCODE_BADNOTIMPLEMENTED;
+#endif
+        break;
+    }
+    UA_UNLOCK(&server->serviceMutex);
+}
+
+UA_THREAD_CALLBACK(asyncWorkerLoop) {
+    UA_Server *server = (UA_Server*)context;
+    UA_AsyncManager *am = &server->asyncManager;
+    UA_LOCK(&am->queueLock);
+    while(am->workersRunning) {
+        UA_AsyncOperation *ao = takeAsyncOperation(am);
+        if(!ao) {
+            UA_COND_WAIT(&am->workerCondition, &am->queueLock);
+            continue;
+        }
         UA_UNLOCK(&am->queueLock);
-        return;
+        executeAsyncOperation(server, ao);
+        returnAsyncOperation(server, ao);
+        UA_LOCK(&am->queueLock);
     }
+    UA_UNLOCK(&am->queueLock);
+    return 0;
+}
 
-    /* Copy the result into the internal AsyncOperation */
-    UA_StatusCode result =
-        UA_CallMethodResult_copy(&response->callMethodResult, &ao->response);
-    if(result != UA_STATUSCODE_GOOD) {
-        UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
-                       "UA_Server_SetAsyncMethodResult: UA_CallMethodResult_copy failed.");
-        ao->response.statusCode = UA_STATUSCODE_BADOUTOFMEMORY;
+UA_StatusCode
+UA_AsyncManager_startWorkers(UA_AsyncManager *am, UA_Server *server) {
+    UA_UInt16 workers = server->config.asyncOperationWorkers;
+    if(workers == 0 || am->workersSize > 0)
+        return UA_STATUSCODE_GOOD;
+
+    am->workers = (UA_Thread*)UA_malloc(sizeof(UA_Thread) * workers);
+    if(!am->workers)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    am->workersRunning = true;
+    for(; am->workersSize < workers; am->workersSize++) {
+        if(UA_THREAD_CREATE(&am->workers[am->workersSize],
+                            asyncWorkerLoop, server) != 0) {
+            UA_LOG_ERROR(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                         "Could not start the async operation workers");
+            UA_AsyncManager_stopWorkers(am);
+            return UA_STATUSCODE_BADINTERNALERROR;
+        }
     }
 
-    /* Move to the result queue */
-    TAILQ_REMOVE(&am->dispatchedQueue, ao, pointers);
-    TAILQ_INSERT_TAIL(&am->resultQueue, ao, pointers);
+    UA_LOG_INFO(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                "Started %u workers for async operations", (unsigned)workers);
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+UA_AsyncManager_stopWorkers(UA_AsyncManager *am) {
+    if(!am->workers)
+        return;
 
+    /* Wake up all workers. They finish the current operation before they
+     * stop. */
+    UA_LOCK(&am->queueLock);
+    am->workersRunning = false;
+    UA_COND_BROADCAST(&am->workerCondition);
     UA_UNLOCK(&am->queueLock);
 
-    UA_LOG_DEBUG(&server->config.logger, UA_LOGCATEGORY_SERVER,
-                 "Set the result from the worker thread");
+    for(size_t i = 0; i < am->workersSize; i++)
+        UA_THREAD_JOIN(&am->workers[i]);
+    UA_free(am->workers);
+    am->workers = NULL;
+    am->workersSize = 0;
 }
 
 /******************/
@@ -383,6 +692,66 @@ UA_Server_setMethodNodeAsync(UA_Server *server, const UA_NodeId id,
                               (UA_EditNodeCallback)setMethodNodeAsync, &isAsync);
 }
 
+UA_StatusCode
+UA_Server_setMethodNodeAsyncConcurrency(UA_Server *server, const UA_NodeId id,
+                                        UA_UInt32 maxConcurrency) {
+    UA_NodeClass nodeClass = UA_NODECLASS_UNSPECIFIED;
+    UA_StatusCode res = UA_Server_readNodeClass(server, id, &nodeClass);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    if(nodeClass != UA_NODECLASS_METHOD)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+
+    /* Update an existing limit. The entry is kept also when the limit is
+     * removed, as operations in the dispatched queue point to it. */
+    UA_AsyncManager *am = &server->asyncManager;
+    UA_LOCK(&am->queueLock);
+    UA_AsyncMethodLimit *limit = findMethodLimit(am, &id);
+    if(limit) {
+        limit->maxConcurrency = maxConcurrency;
+        if(am->workersSize > 0)
+            UA_COND_BROADCAST(&am->workerCondition);
+        goto done;
+    }
+
+    /* Add a new limit */
+    if(maxConcurrency == 0)
+        goto done;
+    limit = (UA_AsyncMethodLimit*)UA_calloc(1, sizeof(UA_AsyncMethodLimit));
+    if(!limit) {
+        res = UA_STATUSCODE_BADOUTOFMEMORY;
+        goto done;
+    }
+    res = UA_NodeId_copy(&id, &limit->methodId);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_free(limit);
+        goto done;
+    }
+    limit->maxConcurrency = maxConcurrency;
+    limit->next = am->methodLimits;
+    am->methodLimits = limit;
+
+ done:
+    UA_UNLOCK(&am->queueLock);
+    return res;
+}
+
+static UA_StatusCode
+setVariableNodeAsync(UA_Server *server, UA_Session *session,
+                     UA_Node *node, UA_Boolean *isAsync) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+    node->variableNode.async = *isAsync;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Server_setVariableNodeAsync(UA_Server *server, const UA_NodeId id,
+                               UA_Boolean isAsync) {
+    return UA_Server_editNode(server, &server->adminSession, &id,
+                              (UA_EditNodeCallback)setVariableNodeAsync, &isAsync);
+}
+
 UA_StatusCode
 UA_Server_processServiceOperationsAsync(UA_Server *server, UA_Session *session,
                                         UA_UInt32 requestId, UA_UInt32 requestHandle,
@@ -21,20 +21,39 @@
 
 _UA_BEGIN_DECLS
 
-#if UA_MULTITHREADING >= 100
-
 struct UA_AsyncResponse;
 typedef struct UA_AsyncResponse UA_AsyncResponse;
 
+#if UA_MULTITHREADING >= 100
+
+/* Limit for the number of operations of an async method that are executed at
+ * the same time */
+typedef struct UA_AsyncMethodLimit {
+    struct UA_AsyncMethodLimit *next;
+    UA_NodeId methodId;
+    UA_UInt32 maxConcurrency; /* 0 => unlimited */
+    UA_UInt32 running;        /* Operations taken by a worker */
+} UA_AsyncMethodLimit;
+
 /* A single operation (of a larger request) */
 typedef struct UA_AsyncOperation {
     TAILQ_ENTRY(UA_AsyncOperation) pointers;
-    UA_CallMethodRequest request;
-    UA_CallMethodResult	response;
+    UA_AsyncOperationType type;
+    UA_AsyncOperationRequest request;
+    UA_AsyncOperationResponse response;
     size_t index;             /* Index of the operation in the array of ops in
                                * request/response */
-    UA_AsyncResponse *parent; /* Always non-NULL. The parent is only removed
-                               * when its operations are removed */
+    UA_AsyncResponse *parent; /* The parent is only removed when its operations
+                               * are removed. Set to NULL when the operation
+                               * has timed out while taken by a worker. */
+    struct UA_AsyncOperation *nextResult;   /* In the lock-free result stack */
+    struct UA_AsyncOperation *nextTimedOut; /* Only used in checkTimeouts */
+    UA_AsyncMethodLimit *limit; /* Counts the operation while it is taken by a
+                                 * worker */
+    UA_NodeId sessionId;      /* The operation is executed with the access
+                               * rights of the originating session */
+    UA_Boolean staticValue;   /* Read of a static variable. The timestamps are
+                               * set when the result is integrated. */
 } UA_AsyncOperation;
 
 struct UA_AsyncResponse {
@@ -44,6 +63,7 @@ struct UA_AsyncResponse {
     UA_UInt32 requestHandle;
     UA_DateTime	timeout;
     UA_AsyncOperationType operationType;
+    UA_TimestampsToReturn timestampsToReturn; /* Applied to async read results */
     union {
         UA_CallResponse callResponse;
         UA_ReadResponse readResponse;
@@ -64,11 +84,28 @@ typedef struct {
      * take out at the head.*/
     UA_Lock queueLock;
     UA_AsyncOperationQueue newQueue;        /* New operations for the workers */
-    UA_AsyncOperationQueue dispatchedQueue; /* Operations taken by a worker. When a result is
-                                             * returned, we search for the op here to see if it
-                                             * is still "alive" (not timed out). */
-    UA_AsyncOperationQueue resultQueue;     /* Results to be integrated */
-    size_t opsCount; /* How many operations are transient (in one of the three queues)? */
+    UA_AsyncOperationQueue dispatchedQueue; /* Operations taken by a worker. They
+                                             * remain until the result has been
+                                             * integrated. Also after a timeout,
+                                             * as the worker still has the
+                                             * pointer. */
+    size_t opsCount; /* How many operations are transient (in one of the queues)? */
+
+    /* Results returned by the workers. The workers push without taking a lock.
+     * The server thread takes all results at once in a delayed callback. The
+     * worker that pushes to the empty stack adds the delayed callback. */
+    UA_AsyncOperation * volatile resultStack;
+    UA_DelayedCallback processResultsCallback;
+
+    /* Concurrency limits of async methods. Protected by the queueLock. */
+    UA_AsyncMethodLimit *methodLimits;
+
+    /* Worker threads started by the server. They wait on the condition
+     * (with the queueLock) for new operations. */
+    UA_Thread *workers;
+    size_t workersSize;
+    UA_Boolean workersRunning;
+    UA_Cond workerCondition;
 
     UA_UInt64 checkTimeoutCallbackId; /* Registered repeated callbacks */
 } UA_AsyncManager;
@@ -76,6 +113,14 @@ typedef struct {
 void UA_AsyncManager_init(UA_AsyncManager *am, UA_Server *server);
 void UA_AsyncManager_clear(UA_AsyncManager *am, UA_Server *server);
 
+/* Start the number of worker threads configured in the server config. The
+ * worker threads are stopped and joined in _stopWorkers. This must be called
+ * without holding the serviceMutex, as the workers may wait for it. */
+UA_StatusCode
+UA_AsyncManager_startWorkers(UA_AsyncManager *am, UA_Server *server);
+void
+UA_AsyncManager_stopWorkers(UA_AsyncManager *am);
+
 UA_StatusCode
 UA_AsyncManager_createAsyncResponse(UA_AsyncManager *am, UA_Server *server,
                                     const UA_NodeId *sessionId,
@@ -88,10 +133,20 @@ UA_AsyncManager_createAsyncResponse(UA_AsyncManager *am, UA_Server *server,
 void
 UA_AsyncManager_removeAsyncResponse(UA_AsyncManager *am, UA_AsyncResponse *ar);
 
+/* Called at the end of the service with the (sync) response. If async
+ * operations are pending, the response is moved into the AsyncResponse and
+ * finished is set to false. Otherwise the AsyncResponse is removed. */
+void
+UA_AsyncManager_takeResponse(UA_AsyncManager *am, UA_AsyncResponse *ar,
+                             void *response, UA_Boolean *finished);
+
+/* The opRequest has the type matching the operationType of the AsyncResponse.
+ * That is UA_CallMethodRequest, UA_ReadValueId or UA_WriteValue. Set
+ * staticValue for reads of non-dynamic variables. */
 UA_StatusCode
 UA_AsyncManager_createAsyncOp(UA_AsyncManager *am, UA_Server *server,
                               UA_AsyncResponse *ar, size_t opIndex,
-                              const UA_CallMethodRequest *opRequest);
+                              const void *opRequest, UA_Boolean staticValue);
 
 typedef void (*UA_AsyncServiceOperation)(UA_Server *server, UA_Session *session,
                                          UA_UInt32 requestId, UA_UInt32 requestHandle,
@@ -680,16 +680,27 @@ processMSGDecoded(UA_Server *server, UA_SecureChannel *channel, UA_UInt32 reques
 #endif
 
 #if UA_MULTITHREADING >= 100
-    /* The call request might not be answered immediately */
-    if(requestType == &UA_TYPES[UA_TYPES_CALLREQUEST]) {
+    /* The call, read and write requests might not be answered immediately */
+    if(requestType == &UA_TYPES[UA_TYPES_CALLREQUEST] ||
+       requestType == &UA_TYPES[UA_TYPES_READREQUEST] ||
+       requestType == &UA_TYPES[UA_TYPES_WRITEREQUEST]) {
         UA_Boolean finished = true;
         UA_LOCK(&server->serviceMutex);
-        Service_CallAsync(server, session, requestId, &request->callRequest,
-                          &response->callResponse, &finished);
+        if(requestType == &UA_TYPES[UA_TYPES_READREQUEST])
+            Service_ReadAsync(server, session, requestId, &request->readRequest,
+                              &response->readResponse, &finished);
+        else if(requestType == &UA_TYPES[UA_TYPES_WRITEREQUEST])
+            Service_WriteAsync(server, session, requestId, &request->writeRequest,
+                               &response->writeResponse, &finished);
+#ifdef UA_ENABLE_METHODCALLS
+        else
+            Service_CallAsync(server, session, requestId, &request->callRequest,
+                              &response->callResponse, &finished);
+#endif
         UA_UNLOCK(&server->serviceMutex);
 
-        /* Async method calls remain. Don't send a response now. In case we have
-         * an async call, count as a "good" request for the diagnostics
+        /* Async operations remain. Don't send a response now. In case we have
+         * an async operation, count as a "good" request for the diagnostics
          * statistic. */
         if(UA_LIKELY(finished)) {
             serviceRes = response->responseHeader.serviceResult;
@@ -889,6 +900,99 @@ processSecureChannelMessage(void *application, UA_SecureChannel *channel,
     return retval;
 }
 
+/* Without a message, only the chunks already queued in the channel are
+ * processed. A buffered half-received chunk does not block them. */
+static void
+processChannelBuffer(UA_Server *server, UA_SecureChannel *channel,
+                     const UA_ByteString *msg) {
+    UA_StatusCode retval = (msg) ?
+        UA_SecureChannel_processBuffer(channel, server,
+                                       processSecureChannelMessage, msg) :
+        UA_SecureChannel_processCompleteChunks(channel, server,
+                                               processSecureChannelMessage);
+    if(retval != UA_STATUSCODE_GOOD) {
+        UA_LOG_WARNING_CHANNEL(&server->config.logger, channel,
+                               "Processing the message failed with error %s",
+                               UA_StatusCode_name(retval));
+
+        /* Send an ERR message and close the connection */
+        UA_TcpErrorMessage error;
+        error.error = retval;
+        error.reason = UA_STRING_NULL;
+        UA_SecureChannel_sendError(channel, &error);
+        UA_SecureChannel_shutdown(channel);
+    }
+}
+
+static void
+scheduleHandshakeCallback(UA_Server *server) {
+    if(server->handshakeCallbackScheduled)
+        return;
+    UA_EventLoop *el = server->config.eventLoop;
+    el->addDelayedCallback(el, &server->handshakeCallback);
+    server->handshakeCallbackScheduled = true;
+}
+
+UA_StatusCode
+admitServerOPN(void *application, UA_SecureChannel *channel) {
+    UA_Server *server = (UA_Server*)application;
+    UA_UInt16 max = server->config.maxHandshakesPerIteration;
+    if(max == 0)
+        return UA_STATUSCODE_GOOD;
+
+    /* Only the initial handshake is throttled. Renewing the token of an open
+     * channel is never postponed (the old token could expire meanwhile). */
+    if(channel->state == UA_SECURECHANNELSTATE_OPEN)
+        return UA_STATUSCODE_GOOD;
+
+    /* Already waiting in the queue. Keep the order. */
+    channel_entry *entry = container_of(channel, channel_entry, channel);
+    if(entry->handshakeQueued)
+        return UA_STATUSCODE_GOODCALLAGAIN;
+
+    /* The limit for this iteration is reached. Queue the channel. */
+    UA_SecureChannelStatistics *scs = &server->secureChannelStatistics;
+    if(server->handshakesThisIteration >= max) {
+        TAILQ_INSERT_TAIL(&server->handshakeQueue, entry, handshakePointers);
+        entry->handshakeQueued = true;
+        scs->queuedHandshakeCount++;
+        scs->deferredHandshakeCount++;
+        scheduleHandshakeCallback(server);
+        return UA_STATUSCODE_GOODCALLAGAIN;
+    }
+
+    /* Admit the handshake. The delayed callback resets the counter in the
+     * next iteration. */
+    server->handshakesThisIteration++;
+    scheduleHandshakeCallback(server);
+    return UA_STATUSCODE_GOOD;
+}
+
+void
+processQueuedHandshakes(UA_Server *server, void *_) {
+    server->handshakeCallbackScheduled = false;
+    server->handshakesThisIteration = 0;
+
+    /* Process the queued handshakes up to the limit. Channels that are
+     * admitted again are re-queued at the tail. */
+    UA_SecureChannelStatistics *scs = &server->secureChannelStatistics;
+    channel_entry *entry;
+    UA_UInt16 max = server->config.maxHandshakesPerIteration;
+    while((entry = TAILQ_FIRST(&server->handshakeQueue)) &&
+          (max == 0 || server->handshakesThisIteration < max)) {
+        TAILQ_REMOVE(&server->handshakeQueue, entry, handshakePointers);
+        entry->handshakeQueued = false;
+        scs->queuedHandshakeCount--;
+        if(!UA_SecureChannel_isConnected(&entry->channel))
+            continue;
+        processChannelBuffer(server, &entry->channel, NULL);
+    }
+
+    /* Continue in the next iteration */
+    if(!TAILQ_EMPTY(&server->handshakeQueue))
+        scheduleHandshakeCallback(server);
+}
+
 /* Callback of a TCP socket (server socket or an active connection) */
 void
 UA_Server_networkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
@@ -982,20 +1086,7 @@ UA_Server_networkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
     UA_debug_dumpCompleteChunk(server, channel->connection, message);
 #endif
 
-    retval = UA_SecureChannel_processBuffer(channel, server,
-                                            processSecureChannelMessage, &msg);
-    if(retval != UA_STATUSCODE_GOOD) {
-        UA_LOG_WARNING_CHANNEL(&server->config.logger, channel,
-                               "Processing the message failed with error %s",
-                               UA_StatusCode_name(retval));
-
-        /* Send an ERR message and close the connection */
-        UA_TcpErrorMessage error;
-        error.error = retval;
-        error.reason = UA_STRING_NULL;
-        UA_SecureChannel_sendError(channel, &error);
-        UA_SecureChannel_shutdown(channel);
-    }
+    processChannelBuffer(server, channel, &msg);
 }
 
 #define UA_MINMESSAGESIZE 8192
@@ -0,0 +1,519 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ua_server_internal.h"
+
+/* Cache of Browse results. The entries are found by the hash of the browsed
+ * NodeId and the parameters of the BrowseDescription. Every entry remembers the
+ * version of the information model it was created with. Changing references or
+ * attributes that are part of a ReferenceDescription increases the version.
+ *
+ * The version of the last change is also stored for the changed node. A Browse
+ * result depends on the references of the browsed node and on the targets
+ * (their attributes, TypeDefinition and existence). The entry is outdated if
+ * one of these nodes has changed after the entry was created. The versions are
+ * not stored per NodeId but in a fixed number of slots selected by the hash of
+ * the NodeId. A collision only leads to an unnecessary cache miss.
+ *
+ * Outdated entries are removed when they are found. When the memory limit is
+ * reached, the least recently used entries are evicted. All accesses happen
+ * with the service mutex taken. */
+
+#define UA_BROWSECACHE_MINSIZE 64
+#define UA_BROWSECACHE_NODESLOTS 4096 /* Power of two, fits into a UA_UInt16 */
+
+static void clearCachedBrowsePaths(UA_BrowseCache *bc);
+
+/* Parameters of the BrowseDescription that are part of the key */
+typedef struct {
+    UA_ReferenceTypeSet relevantReferences;
+    UA_UInt32 browseDirection;
+    UA_UInt32 nodeClassMask;
+    UA_UInt32 resultMask;
+} BrowseKeyParameters;
+
+/* The locales are only relevant if the DisplayName is returned */
+static size_t
+keyLocaleIdsSize(const UA_Session *session, const UA_BrowseDescription *bd) {
+    if(!(bd->resultMask & UA_BROWSERESULTMASK_DISPLAYNAME))
+        return 0;
+    return session->localeIdsSize;
+}
+
+static UA_UInt32
+browseKeyHash(const UA_Session *session, const UA_BrowseDescription *bd,
+              const UA_ReferenceTypeSet *relevantReferences) {
+    BrowseKeyParameters p;
+    memset(&p, 0, sizeof(BrowseKeyParameters));
+    p.relevantReferences = *relevantReferences;
+    p.browseDirection = (UA_UInt32)bd->browseDirection;
+    p.nodeClassMask = bd->nodeClassMask;
+    p.resultMask = bd->resultMask;
+    UA_UInt32 hash = UA_ByteString_hash(UA_NodeId_hash(&bd->nodeId),
+                                        (const UA_Byte*)&p, sizeof(BrowseKeyParameters));
+    size_t locales = keyLocaleIdsSize(session, bd);
+    for(size_t i = 0; i < locales; i++)
+        hash = UA_ByteString_hash(hash, session->localeIds[i].data,
+                                  session->localeIds[i].length);
+    return hash;
+}
+
+static UA_Boolean
+matchBrowseKey(const UA_CachedBrowseResult *cr, const UA_Session *session,
+               const UA_BrowseDescription *bd,
+               const UA_ReferenceTypeSet *relevantReferences) {
+    if(cr->browseDirection != bd->browseDirection ||
+       cr->nodeClassMask != bd->nodeClassMask ||
+       cr->resultMask != bd->resultMask ||
+       memcmp(&cr->relevantReferences, relevantReferences,
+              sizeof(UA_ReferenceTypeSet)) != 0 ||
+       !UA_NodeId_equal(&cr->nodeId, &bd->nodeId))
+        return false;
+    size_t locales = keyLocaleIdsSize(session, bd);
+    if(cr->localeIdsSize != locales)
+        return false;
+    for(size_t i = 0; i < locales; i++) {
+        if(!UA_String_equal(&cr->localeIds[i], &session->localeIds[i]))
+            return false;
+    }
+    return true;
+}
+
+/* Approximate heap memory of the entry. The encoded size of the
+ * ReferenceDescriptions is used as an estimate for their nested allocations. */
+static size_t
+cachedBrowseResultMemory(const UA_CachedBrowseResult *cr) {
+    size_t mem = sizeof(UA_CachedBrowseResult);
+    mem += cr->dependenciesSize * sizeof(UA_UInt16);
+    mem += UA_calcSizeBinary(&cr->nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    for(size_t i = 0; i < cr->localeIdsSize; i++)
+        mem += sizeof(UA_String) + cr->localeIds[i].length;
+    for(size_t i = 0; i < cr->referencesSize; i++)
+        mem += sizeof(UA_ReferenceDescription) +
+            UA_calcSizeBinary(&cr->references[i],
+                              &UA_TYPES[UA_TYPES_REFERENCEDESCRIPTION]);
+    return mem;
+}
+
+void
+UA_BrowseCache_init(UA_BrowseCache *bc) {
+    memset(bc, 0, sizeof(UA_BrowseCache));
+    TAILQ_INIT(&bc->lru);
+    TAILQ_INIT(&bc->pathLru);
+}
+
+static UA_UInt16
+nodeSlot(const UA_NodeId *nodeId) {
+    return (UA_UInt16)(UA_NodeId_hash(nodeId) & (UA_BROWSECACHE_NODESLOTS - 1));
+}
+
+static int
+cmpSlot(const void *a, const void *b) {
+    return (int)*(const UA_UInt16*)a - (int)*(const UA_UInt16*)b;
+}
+
+/* Collect the (unique) slots of the browsed node and the local targets of the
+ * references that are browsed */
+static UA_StatusCode
+collectDependencies(UA_CachedBrowseResult *cr, const UA_BrowseDescription *bd,
+                    const UA_ReferenceTypeSet *relevantReferences,
+                    const UA_NodeHead *head) {
+    size_t count = 1;
+    for(size_t i = 0; i < head->referencesSize; i++)
+        count += head->references[i].targetsSize;
+    cr->dependencies = (UA_UInt16*)UA_malloc(count * sizeof(UA_UInt16));
+    if(!cr->dependencies)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    size_t size = 0;
+    cr->dependencies[size++] = nodeSlot(&head->nodeId);
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        const UA_NodeReferenceKind *rk = &head->references[i];
+        if(rk->isInverse && bd->browseDirection == UA_BROWSEDIRECTION_FORWARD)
+            continue;
+        if(!rk->isInverse && bd->browseDirection == UA_BROWSEDIRECTION_INVERSE)
+            continue;
+        if(!UA_ReferenceTypeSet_contains(relevantReferences, rk->referenceTypeIndex))
+            continue;
+        const UA_ReferenceTarget *t = NULL;
+        while((t = UA_NodeReferenceKind_iterate(rk, t))) {
+            if(!UA_NodePointer_isLocal(t->targetId))
+                continue;
+            UA_NodeId id = UA_NodePointer_toNodeId(t->targetId);
+            cr->dependencies[size++] = nodeSlot(&id);
+        }
+    }
+
+    /* Remove duplicates */
+    qsort(cr->dependencies, size, sizeof(UA_UInt16), cmpSlot);
+    size_t unique = 1;
+    for(size_t i = 1; i < size; i++) {
+        if(cr->dependencies[i] != cr->dependencies[unique-1])
+            cr->dependencies[unique++] = cr->dependencies[i];
+    }
+    cr->dependenciesSize = unique;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* None of the nodes the result depends on has changed since it was cached */
+static UA_Boolean
+isCurrent(const UA_BrowseCache *bc, const UA_CachedBrowseResult *cr) {
+    for(size_t i = 0; i < cr->dependenciesSize; i++) {
+        if(bc->nodeVersions[cr->dependencies[i]] > cr->version)
+            return false;
+    }
+    return true;
+}
+
+void
+UA_BrowseCache_invalidate(UA_BrowseCache *bc, const UA_NodeId *nodeId) {
+    bc->version++;
+    if(bc->nodeVersions)
+        bc->nodeVersions[nodeSlot(nodeId)] = bc->version;
+}
+
+static void
+deleteCachedBrowseResult(UA_CachedBrowseResult *cr) {
+    UA_free(cr->dependencies);
+    UA_NodeId_clear(&cr->nodeId);
+    UA_Array_delete(cr->localeIds, cr->localeIdsSize, &UA_TYPES[UA_TYPES_STRING]);
+    UA_Array_delete(cr->references, cr->referencesSize,
+                    &UA_TYPES[UA_TYPES_REFERENCEDESCRIPTION]);
+    UA_free(cr);
+}
+
+static void
+removeCachedBrowseResult(UA_BrowseCache *bc, UA_CachedBrowseResult *cr) {
+    UA_CachedBrowseResult **prev = &bc->buckets[cr->hash & (bc->bucketsSize - 1)];
+    while(*prev != cr)
+        prev = &(*prev)->next;
+    *prev = cr->next;
+    TAILQ_REMOVE(&bc->lru, cr, lruEntry);
+    bc->count--;
+    bc->memory -= cr->memory;
+    deleteCachedBrowseResult(cr);
+}
+
+void
+UA_BrowseCache_clear(UA_BrowseCache *bc) {
+    UA_CachedBrowseResult *cr, *cr_tmp;
+    TAILQ_FOREACH_SAFE(cr, &bc->lru, lruEntry, cr_tmp) {
+        removeCachedBrowseResult(bc, cr);
+    }
+    UA_free(bc->buckets);
+    UA_free(bc->nodeVersions);
+    clearCachedBrowsePaths(bc);
+    UA_BrowseCache_init(bc);
+}
+
+static UA_CachedBrowseResult *
+findCachedBrowseResult(const UA_BrowseCache *bc, const UA_Session *session,
+                       const UA_BrowseDescription *bd,
+                       const UA_ReferenceTypeSet *relevantReferences,
+                       UA_UInt32 hash) {
+    if(bc->bucketsSize == 0)
+        return NULL;
+    UA_CachedBrowseResult *cr = bc->buckets[hash & (bc->bucketsSize - 1)];
+    for(; cr; cr = cr->next) {
+        if(cr->hash == hash && matchBrowseKey(cr, session, bd, relevantReferences))
+            return cr;
+    }
+    return NULL;
+}
+
+/* Double the number of buckets (or allocate the initial buckets) */
+static UA_StatusCode
+growBrowseCache(UA_BrowseCache *bc) {
+    size_t newSize = (bc->bucketsSize == 0) ?
+        UA_BROWSECACHE_MINSIZE : bc->bucketsSize * 2;
+    UA_CachedBrowseResult **buckets = (UA_CachedBrowseResult**)
+        UA_calloc(newSize, sizeof(UA_CachedBrowseResult*));
+    if(!buckets)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    for(size_t i = 0; i < bc->bucketsSize; i++) {
+        UA_CachedBrowseResult *cr = bc->buckets[i];
+        while(cr) {
+            UA_CachedBrowseResult *next = cr->next;
+            size_t b = cr->hash & (newSize - 1);
+            cr->next = buckets[b];
+            buckets[b] = cr;
+            cr = next;
+        }
+    }
+    UA_free(bc->buckets);
+    bc->buckets = buckets;
+    bc->bucketsSize = newSize;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_Boolean
+UA_BrowseCache_get(UA_BrowseCache *bc, const UA_Session *session,
+                   const UA_BrowseDescription *bd,
+                   const UA_ReferenceTypeSet *relevantReferences,
+                   UA_UInt32 maxReferences, UA_BrowseResult *result) {
+    UA_CachedBrowseResult *cr = NULL;
+    if(bc->count > 0) {
+        UA_UInt32 hash = browseKeyHash(session, bd, relevantReferences);
+        cr = findCachedBrowseResult(bc, session, bd, relevantReferences, hash);
+    }
+    if(!cr)
+        goto miss;
+
+    /* Outdated. Remove right away. */
+    if(!isCurrent(bc, cr)) {
+        removeCachedBrowseResult(bc, cr);
+        goto miss;
+    }
+
+    /* A ContinuationPoint is required */
+    if(cr->referencesSize > maxReferences)
+        goto miss;
+
+    if(UA_Array_copy(cr->references, cr->referencesSize, (void**)&result->references,
+                     &UA_TYPES[UA_TYPES_REFERENCEDESCRIPTION]) != UA_STATUSCODE_GOOD)
+        goto miss;
+    result->referencesSize = cr->referencesSize;
+
+    /* Move to the end of the LRU list */
+    TAILQ_REMOVE(&bc->lru, cr, lruEntry);
+    TAILQ_INSERT_TAIL(&bc->lru, cr, lruEntry);
+    bc->hits++;
+    return true;
+
+ miss:
+    bc->misses++;
+    return false;
+}
+
+void
+UA_BrowseCache_put(UA_BrowseCache *bc, size_t maxMemory, const UA_Session *session,
+                   const UA_BrowseDescription *bd,
+                   const UA_ReferenceTypeSet *relevantReferences,
+                   const UA_NodeHead *head,
+                   const UA_ReferenceDescription *references, size_t referencesSize) {
+    /* Allocate the versions of the nodes */
+    if(!bc->nodeVersions) {
+        bc->nodeVersions = (UA_UInt64*)
+            UA_calloc(UA_BROWSECACHE_NODESLOTS, sizeof(UA_UInt64));
+        if(!bc->nodeVersions)
+            return;
+    }
+
+    /* Remove the previous entry */
+    UA_UInt32 hash = browseKeyHash(session, bd, relevantReferences);
+    UA_CachedBrowseResult *cr =
+        findCachedBrowseResult(bc, session, bd, relevantReferences, hash);
+    if(cr)
+        removeCachedBrowseResult(bc, cr);
+
+    /* Make a copy */
+    cr = (UA_CachedBrowseResult*)UA_calloc(1, sizeof(UA_CachedBrowseResult));
+    if(!cr)
+        return;
+    UA_StatusCode res = UA_NodeId_copy(&bd->nodeId, &cr->nodeId);
+    size_t locales = keyLocaleIdsSize(session, bd);
+    if(locales > 0) {
+        res |= UA_Array_copy(session->localeIds, locales, (void**)&cr->localeIds,
+                             &UA_TYPES[UA_TYPES_STRING]);
+        if(res == UA_STATUSCODE_GOOD)
+            cr->localeIdsSize = locales;
+    }
+    res |= UA_Array_copy(references, referencesSize, (void**)&cr->references,
+                         &UA_TYPES[UA_TYPES_REFERENCEDESCRIPTION]);
+    if(res == UA_STATUSCODE_GOOD)
+        cr->referencesSize = referencesSize;
+    res |= collectDependencies(cr, bd, relevantReferences, head);
+    cr->memory = cachedBrowseResultMemory(cr);
+    if(res != UA_STATUSCODE_GOOD || cr->memory > maxMemory ||
+       (bc->count >= bc->bucketsSize && growBrowseCache(bc) != UA_STATUSCODE_GOOD)) {
+        deleteCachedBrowseResult(cr);
+        return;
+    }
+    cr->hash = hash;
+    cr->version = bc->version;
+    cr->relevantReferences = *relevantReferences;
+    cr->browseDirection = bd->browseDirection;
+    cr->nodeClassMask = bd->nodeClassMask;
+    cr->resultMask = bd->resultMask;
+
+    /* Evict the least recently used entries */
+    while(bc->memory + cr->memory > maxMemory)
+        removeCachedBrowseResult(bc, TAILQ_FIRST(&bc->lru));
+
+    /* Insert */
+    size_t b = hash & (bc->bucketsSize - 1);
+    cr->next = bc->buckets[b];
+    bc->buckets[b] = cr;
+    TAILQ_INSERT_TAIL(&bc->lru, cr, lruEntry);
+    bc->count++;
+    bc->memory += cr->memory;
+}
+
+/* Resolved BrowsePaths of TranslateBrowsePathsToNodeIds. The key is the binary
+ * encoding of the BrowsePath together with the NodeClass mask. BrowsePaths with
+ * a longer encoding are not cached. The result depends on all nodes along the
+ * path and the nodes that were tried on the way. So the entries are outdated
+ * after any change of the information model (the global version counter). */
+
+#define UA_BROWSEPATHCACHE_MAXKEY 256
+
+static UA_Boolean
+encodeBrowsePathKey(const UA_BrowsePath *path, UA_ByteString *key) {
+    return (UA_encodeBinary(path, &UA_TYPES[UA_TYPES_BROWSEPATH], key) ==
+            UA_STATUSCODE_GOOD);
+}
+
+static size_t
+cachedBrowsePathMemory(const UA_CachedBrowsePath *cp) {
+    return sizeof(UA_CachedBrowsePath) + cp->key.length +
+        UA_calcSizeBinary(&cp->result, &UA_TYPES[UA_TYPES_BROWSEPATHRESULT]);
+}
+
+static void
+deleteCachedBrowsePath(UA_CachedBrowsePath *cp) {
+    UA_ByteString_clear(&cp->key);
+    UA_BrowsePathResult_clear(&cp->result);
+    UA_free(cp);
+}
+
+static void
+removeCachedBrowsePath(UA_BrowseCache *bc, UA_CachedBrowsePath *cp) {
+    UA_CachedBrowsePath **prev =
+        &bc->pathBuckets[cp->hash & (bc->pathBucketsSize - 1)];
+    while(*prev != cp)
+        prev = &(*prev)->next;
+    *prev = cp->next;
+    TAILQ_REMOVE(&bc->pathLru, cp, lruEntry);
+    bc->pathCount--;
+    bc->pathMemory -= cp->memory;
+    deleteCachedBrowsePath(cp);
+}
+
+static void
+clearCachedBrowsePaths(UA_BrowseCache *bc) {
+    UA_CachedBrowsePath *cp, *cp_tmp;
+    TAILQ_FOREACH_SAFE(cp, &bc->pathLru, lruEntry, cp_tmp) {
+        removeCachedBrowsePath(bc, cp);
+    }
+    UA_free(bc->pathBuckets);
+}
+
+static UA_CachedBrowsePath *
+findCachedBrowsePath(const UA_BrowseCache *bc, const UA_ByteString *key,
+                     UA_UInt32 nodeClassMask, UA_UInt32 hash) {
+    if(bc->pathBucketsSize == 0)
+        return NULL;
+    UA_CachedBrowsePath *cp = bc->pathBuckets[hash & (bc->pathBucketsSize - 1)];
+    for(; cp; cp = cp->next) {
+        if(cp->hash == hash && cp->nodeClassMask == nodeClassMask &&
+           UA_ByteString_equal(&cp->key, key))
+            return cp;
+    }
+    return NULL;
+}
+
+static UA_StatusCode
+growBrowsePathCache(UA_BrowseCache *bc) {
+    size_t newSize = (bc->pathBucketsSize == 0) ?
+        UA_BROWSECACHE_MINSIZE : bc->pathBucketsSize * 2;
+    UA_CachedBrowsePath **buckets = (UA_CachedBrowsePath**)
+        UA_calloc(newSize, sizeof(UA_CachedBrowsePath*));
+    if(!buckets)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    for(size_t i = 0; i < bc->pathBucketsSize; i++) {
+        UA_CachedBrowsePath *cp = bc->pathBuckets[i];
+        while(cp) {
+            UA_CachedBrowsePath *next = cp->next;
+            size_t b = cp->hash & (newSize - 1);
+            cp->next = buckets[b];
+            buckets[b] = cp;
+            cp = next;
+        }
+    }
+    UA_free(bc->pathBuckets);
+    bc->pathBuckets = buckets;
+    bc->pathBucketsSize = newSize;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_Boolean
+UA_BrowseCache_getPath(UA_BrowseCache *bc, const UA_BrowsePath *path,
+                       UA_UInt32 nodeClassMask, UA_BrowsePathResult *result) {
+    UA_CachedBrowsePath *cp = NULL;
+    if(bc->pathCount > 0) {
+        UA_Byte keyBuf[UA_BROWSEPATHCACHE_MAXKEY];
+        UA_ByteString key = {UA_BROWSEPATHCACHE_MAXKEY, keyBuf};
+        if(encodeBrowsePathKey(path, &key)) {
+            UA_UInt32 hash = UA_ByteString_hash(nodeClassMask, key.data, key.length);
+            cp = findCachedBrowsePath(bc, &key, nodeClassMask, hash);
+        }
+    }
+    if(!cp)
+        goto miss;
+
+    /* Outdated. Remove right away. */
+    if(cp->version != bc->version) {
+        removeCachedBrowsePath(bc, cp);
+        goto miss;
+    }
+
+    if(UA_BrowsePathResult_copy(&cp->result, result) != UA_STATUSCODE_GOOD)
+        goto miss;
+
+    /* Move to the end of the LRU list */
+    TAILQ_REMOVE(&bc->pathLru, cp, lruEntry);
+    TAILQ_INSERT_TAIL(&bc->pathLru, cp, lruEntry);
+    bc->pathHits++;
+    return true;
+
+ miss:
+    bc->pathMisses++;
+    return false;
+}
+
+void
+UA_BrowseCache_putPath(UA_BrowseCache *bc, size_t maxMemory,
+                       const UA_BrowsePath *path, UA_UInt32 nodeClassMask,
+                       const UA_BrowsePathResult *result) {
+    UA_Byte keyBuf[UA_BROWSEPATHCACHE_MAXKEY];
+    UA_ByteString key = {UA_BROWSEPATHCACHE_MAXKEY, keyBuf};
+    if(!encodeBrowsePathKey(path, &key))
+        return;
+
+    /* Remove the previous entry */
+    UA_UInt32 hash = UA_ByteString_hash(nodeClassMask, key.data, key.length);
+    UA_CachedBrowsePath *cp = findCachedBrowsePath(bc, &key, nodeClassMask, hash);
+    if(cp)
+        removeCachedBrowsePath(bc, cp);
+
+    /* Make a copy */
+    cp = (UA_CachedBrowsePath*)UA_calloc(1, sizeof(UA_CachedBrowsePath));
+    if(!cp)
+        return;
+    UA_StatusCode res = UA_ByteString_copy(&key, &cp->key);
+    res |= UA_BrowsePathResult_copy(result, &cp->result);
+    cp->memory = cachedBrowsePathMemory(cp);
+    if(res != UA_STATUSCODE_GOOD || cp->memory > maxMemory ||
+       (bc->pathCount >= bc->pathBucketsSize &&
+        growBrowsePathCache(bc) != UA_STATUSCODE_GOOD)) {
+        deleteCachedBrowsePath(cp);
+        return;
+    }
+    cp->hash = hash;
+    cp->version = bc->version;
+    cp->nodeClassMask = nodeClassMask;
+
+    /* Evict the least recently used entries */
+    while(bc->pathMemory + cp->memory > maxMemory)
+        removeCachedBrowsePath(bc, TAILQ_FIRST(&bc->pathLru));
+
+    /* Insert */
+    size_t b = hash & (bc->pathBucketsSize - 1);
+    cp->next = bc->pathBuckets[b];
+    bc->pathBuckets[b] = cp;
+    TAILQ_INSERT_TAIL(&bc->pathLru, cp, lruEntry);
+    bc->pathCount++;
+    bc->pathMemory += cp->memory;
+}
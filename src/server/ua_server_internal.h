@@ -61,8 +61,15 @@ typedef enum {
     UA_DIAGNOSTICEVENT_PURGE
 } UA_DiagnosticEvent;
 
+#ifndef container_of
+#define container_of(ptr, type, member) \
+    (type *)((uintptr_t)ptr - offsetof(type,member))
+#endif
+
 typedef struct channel_entry {
     TAILQ_ENTRY(channel_entry) pointers;
+    TAILQ_ENTRY(channel_entry) handshakePointers; /* In the handshake queue */
+    UA_Boolean handshakeQueued;
     UA_SecureChannel channel;
     UA_DiagnosticEvent closeEvent;
 } channel_entry;
@@ -106,6 +113,130 @@ typedef struct reverse_connect_context {
     SLIST_ENTRY(reverse_connect_context) next;
 } reverse_connect_context;
 
+/* The reverse direction of a reference that is inserted at the end of
+ * UA_Server_addNodes_bulk */
+typedef struct {
+    UA_NodeId targetId;    /* The node where the reference is inserted */
+    UA_NodeId sourceId;    /* The node pointed to by the reference */
+    UA_UInt32 sourceNameHash;
+    UA_Byte refTypeIndex;
+    UA_Boolean isForward;
+} UA_DeferredReference;
+
+/* Value read from a DataSource that is reused for reads with a maxAge */
+typedef struct UA_CachedValue {
+    struct UA_CachedValue *next; /* In the hash bucket */
+    TAILQ_ENTRY(UA_CachedValue) lruEntry;
+    UA_UInt32 nodeIdHash;
+    UA_NodeId nodeId;
+    UA_NodeId sessionId; /* The session that read the value */
+    UA_DateTime readTime; /* Monotonic */
+    size_t memory;
+    UA_DataValue value;
+} UA_CachedValue;
+
+typedef struct {
+    UA_CachedValue **buckets;
+    size_t bucketsSize; /* Power of two */
+    size_t count;
+    size_t memory;
+    TAILQ_HEAD(, UA_CachedValue) lru; /* Least recently used first */
+} UA_ValueCache;
+
+/* Result of a Browse operation that is reused for identical Browse operations
+ * as long as the information model is unchanged */
+typedef struct UA_CachedBrowseResult {
+    struct UA_CachedBrowseResult *next; /* In the hash bucket */
+    TAILQ_ENTRY(UA_CachedBrowseResult) lruEntry;
+    UA_UInt32 hash;
+    UA_UInt64 version; /* Version of the information model at creation */
+    size_t memory;
+
+    /* Slots of the browsed node and of the local targets of the relevant
+     * references. The entry is outdated if one of them has changed. */
+    size_t dependenciesSize;
+    UA_UInt16 *dependencies;
+
+    /* Key */
+    UA_NodeId nodeId;
+    UA_ReferenceTypeSet relevantReferences;
+    UA_BrowseDirection browseDirection;
+    UA_UInt32 nodeClassMask;
+    UA_UInt32 resultMask;
+    size_t localeIdsSize; /* The DisplayName depends on the session locales */
+    UA_String *localeIds;
+
+    /* Result */
+    size_t referencesSize;
+    UA_ReferenceDescription *references;
+} UA_CachedBrowseResult;
+
+/* Result of a TranslateBrowsePathsToNodeIds operation */
+typedef struct UA_CachedBrowsePath {
+    struct UA_CachedBrowsePath *next; /* In the hash bucket */
+    TAILQ_ENTRY(UA_CachedBrowsePath) lruEntry;
+    UA_UInt32 hash;
+    UA_UInt64 version; /* Version of the information model */
+    size_t memory;
+
+    /* Key */
+    UA_ByteString key; /* Binary encoding of the BrowsePath */
+    UA_UInt32 nodeClassMask;
+
+    /* Result */
+    UA_BrowsePathResult result;
+} UA_CachedBrowsePath;
+
+typedef struct {
+    UA_CachedBrowseResult **buckets;
+    size_t bucketsSize; /* Power of two */
+    size_t count;
+    size_t memory;
+    UA_UInt64 version; /* Incremented when references or attributes change */
+    UA_UInt64 *nodeVersions; /* Version of the last change for every slot of
+                              * NodeIds (by hash). Allocated with the first
+                              * cached Browse result. */
+    size_t hits;
+    size_t misses;
+    TAILQ_HEAD(, UA_CachedBrowseResult) lru; /* Least recently used first */
+
+    /* Resolved BrowsePaths */
+    UA_CachedBrowsePath **pathBuckets;
+    size_t pathBucketsSize; /* Power of two */
+    size_t pathCount;
+    size_t pathMemory;
+    size_t pathHits;
+    size_t pathMisses;
+    TAILQ_HEAD(, UA_CachedBrowsePath) pathLru;
+} UA_BrowseCache;
+
+/* Transitive supertypes of a type node */
+typedef struct UA_SubtypeEntry {
+    struct UA_SubtypeEntry *next; /* In the hash bucket */
+    UA_NodeId nodeId;
+    UA_UInt32 hash;
+    size_t supertypesSize;
+    UA_NodeId *supertypes;
+    UA_UInt32 *supertypeHashes;
+} UA_SubtypeEntry;
+
+typedef struct {
+    UA_SubtypeEntry **buckets;
+    size_t bucketsSize; /* Power of two */
+    size_t count;
+} UA_SubtypeCache;
+
+/* State while a batch of nodes is added with UA_Server_addNodes_bulk. Only
+ * used with the service mutex taken. */
+typedef struct {
+    UA_DeferredReference *refs;
+    size_t refsSize;
+    size_t refsCapacity;
+
+    /* ReferenceTypes that were already verified to be hierarchical */
+    UA_ReferenceTypeSet hierarchicalRefs;
+} UA_BulkAddNodes;
+
 struct UA_Server {
     /* Config */
     UA_ServerConfig config;
@@ -129,6 +260,14 @@ struct UA_Server {
     UA_UInt32 lastChannelId;
     UA_UInt32 lastTokenId;
 
+    /* OPN handshakes beyond config.maxHandshakesPerIteration wait in the queue.
+     * The delayed callback processes them in the next EventLoop iteration and
+     * resets the counter. */
+    TAILQ_HEAD(, channel_entry) handshakeQueue;
+    UA_UInt16 handshakesThisIteration;
+    UA_DelayedCallback handshakeCallback;
+    UA_Boolean handshakeCallbackScheduled;
+
 #if UA_MULTITHREADING >= 100
     UA_AsyncManager asyncManager;
 #endif
@@ -145,10 +284,24 @@ struct UA_Server {
     size_t namespacesSize;
     UA_String *namespaces;
 
+    /* Interned node strings */
+    struct UA_StringPool *stringPool;
+
+    /* Cached DataSource values */
+    UA_ValueCache valueCache;
+
+    /* Cached Browse results */
+    UA_BrowseCache browseCache;
+    UA_SubtypeCache subtypeCache;
+
     /* For bootstrapping, omit some consistency checks, creating a reference to
      * the parent and member instantiation */
     UA_Boolean bootstrapNS0;
 
+    /* Set while UA_Server_addNodes_bulk is processed. The reverse direction of
+     * new references is deferred to the end of the batch. */
+    UA_BulkAddNodes *bulkAddNodes;
+
     /* Discovery */
 #ifdef UA_ENABLE_DISCOVERY
     UA_DiscoveryManager discoveryManager;
@@ -162,6 +315,7 @@ struct UA_Server {
                                                  * server. They may be detached
                                                  * from a session. */
     UA_UInt32 lastSubscriptionId; /* To generate unique SubscriptionIds */
+    LIST_HEAD(, UA_PublishGroup) publishGroups; /* Shared publish callbacks */
 
     /* To be cast to UA_LocalMonitoredItem to get the callback and context */
     LIST_HEAD(, UA_MonitoredItem) localMonitoredItems;
@@ -291,6 +445,136 @@ UA_StatusCode UA_Server_editNode(UA_Server *server, UA_Session *session,
                                  UA_EditNodeCallback callback,
                                  void *data);
 
+/* Approximate heap memory of the node attributes and of the references (without
+ * allocator overhead). Also returns the number of reference targets. Interned
+ * strings are shared between nodes and not counted. */
+void
+UA_Node_getMemoryUsage(const UA_Node *node, size_t *nodeMemory,
+                       size_t *referenceMemory, size_t *references);
+
+/********************/
+/* Interned Strings */
+/********************/
+
+/* Pool of reference-counted immutable strings. Nodes with the same BrowseName
+ * or DisplayName share a single allocation. Interned strings can be compared
+ * by their data pointer. The pool has its own lock, as nodes (and their
+ * interned strings) can be cleared without holding the service mutex. */
+typedef struct UA_StringPool UA_StringPool;
+
+UA_StringPool * UA_StringPool_new(void);
+
+/* Remaining interned strings are detached and freed with their last release */
+void UA_StringPool_delete(UA_StringPool *pool);
+
+/* Replaces the heap-allocated string with a reference to the pooled version.
+ * Returns false (the string is unchanged) for empty strings and if out of
+ * memory. */
+UA_Boolean UA_StringPool_intern(UA_StringPool *pool, UA_String *s);
+
+/* Returns the data pointer of the pooled string or NULL */
+const UA_Byte * UA_StringPool_find(UA_StringPool *pool, const UA_String *s);
+
+/* Release the reference of an interned string and reset it */
+void UA_StringPool_release(UA_String *s);
+
+/* Intern the BrowseName, DisplayName and Description of the node */
+void UA_Node_internStrings(UA_StringPool *pool, UA_Node *node);
+
+/***************/
+/* Value Cache */
+/***************/
+
+void UA_ValueCache_init(UA_ValueCache *vc);
+void UA_ValueCache_clear(UA_ValueCache *vc);
+
+/* Copies the value cached for the session if it was read not longer than
+ * maxAge (in ms) ago. If v is NULL, only test whether such a value exists. */
+UA_Boolean
+UA_ValueCache_get(UA_ValueCache *vc, const UA_NodeId *nodeId,
+                  const UA_NodeId *sessionId, UA_Double maxAge, UA_DataValue *v);
+
+/* Stores a copy of the value read by the session. Older entries are evicted to
+ * stay within the memory limit. Does nothing upon an error. */
+void
+UA_ValueCache_put(UA_ValueCache *vc, size_t maxMemory,
+                  const UA_NodeId *nodeId, const UA_NodeId *sessionId,
+                  const UA_DataValue *v);
+
+/* Invalidate the cached values of all sessions (e.g. after a write) */
+void
+UA_ValueCache_remove(UA_ValueCache *vc, const UA_NodeId *nodeId);
+
+/* Remove the cached values of a closed session */
+void
+UA_ValueCache_removeSession(UA_ValueCache *vc, const UA_NodeId *sessionId);
+
+/****************/
+/* Browse Cache */
+/****************/
+
+void UA_BrowseCache_init(UA_BrowseCache *bc);
+void UA_BrowseCache_clear(UA_BrowseCache *bc);
+
+/* Copies the cached references into the result. Fails if the cached result is
+ * outdated or has more than maxReferences entries. */
+UA_Boolean
+UA_BrowseCache_get(UA_BrowseCache *bc, const UA_Session *session,
+                   const UA_BrowseDescription *bd,
+                   const UA_ReferenceTypeSet *relevantReferences,
+                   UA_UInt32 maxReferences, UA_BrowseResult *result);
+
+/* Stores a copy of the complete result of a Browse operation. The browsed node
+ * is used to find the targets the result depends on. Older entries are evicted
+ * to stay within the memory limit. Does nothing upon an error. */
+void
+UA_BrowseCache_put(UA_BrowseCache *bc, size_t maxMemory, const UA_Session *session,
+                   const UA_BrowseDescription *bd,
+                   const UA_ReferenceTypeSet *relevantReferences,
+                   const UA_NodeHead *head,
+                   const UA_ReferenceDescription *references, size_t referencesSize);
+
+/* Copies the cached result of a TranslateBrowsePathsToNodeIds operation. Fails
+ * if the cached result is outdated. */
+UA_Boolean
+UA_BrowseCache_getPath(UA_BrowseCache *bc, const UA_BrowsePath *path,
+                       UA_UInt32 nodeClassMask, UA_BrowsePathResult *result);
+
+/* Stores a copy of the result of a TranslateBrowsePathsToNodeIds operation.
+ * Older entries are evicted to stay within the memory limit. Does nothing upon
+ * an error. */
+void
+UA_BrowseCache_putPath(UA_BrowseCache *bc, size_t maxMemory,
+                       const UA_BrowsePath *path, UA_UInt32 nodeClassMask,
+                       const UA_BrowsePathResult *result);
+
+/* Invalidate the cached results that depend on the node after a change of its
+ * references or of attributes that are part of a ReferenceDescription. That
+ * are the results for browsing the node itself and for browsing nodes that
+ * reference it. All resolved BrowsePaths are invalidated. The outdated entries
+ * are removed lazily. */
+void
+UA_BrowseCache_invalidate(UA_BrowseCache *bc, const UA_NodeId *nodeId);
+
+/*****************/
+/* Subtype Cache */
+/*****************/
+
+void UA_SubtypeCache_init(UA_SubtypeCache *sc);
+void UA_SubtypeCache_clear(UA_SubtypeCache *sc);
+
+/* Tests whether type is equal to or a (transitive) subtype of supertype.
+ * Returns false if the result cannot be cached because the type is unknown or
+ * is no type node. Then the caller has to follow the references itself. */
+UA_Boolean
+UA_SubtypeCache_isSubtype(UA_Server *server, const UA_NodeId *type,
+                          const UA_NodeId *supertype, UA_Boolean *result);
+
+/* Remove the entries of the node and of all its subtypes after a HasSubtype
+ * reference of the node was added or deleted */
+void
+UA_SubtypeCache_invalidate(UA_SubtypeCache *sc, const UA_NodeId *nodeId);
+
 /*********************/
 /* Utility Functions */
 /*********************/
@@ -387,6 +671,14 @@ UA_Server_networkCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
                           const UA_KeyValueMap *params,
                           UA_ByteString msg);
 
+/* Limit the number of OPN handshakes per EventLoop iteration. Channels beyond
+ * the limit are queued. The queue is processed in a delayed callback. */
+UA_StatusCode
+admitServerOPN(void *application, UA_SecureChannel *channel);
+
+void
+processQueuedHandshakes(UA_Server *server, void *_);
+
 /* Processing for reverse connect */
 void
 UA_Server_reverseConnectCallback(UA_ConnectionManager *cm, uintptr_t connectionId,
@@ -584,13 +876,18 @@ RefTree_containsNodeId(RefTree *rt, const UA_NodeId *target);
  * node and has UA_VARIANT_DATA_NODELETE set. */
 void
 ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
-             UA_TimestampsToReturn timestampsToReturn,
+             UA_TimestampsToReturn timestampsToReturn, UA_Double maxAge,
              const UA_ReadValueId *id, UA_DataValue *v);
 
 UA_StatusCode
 readValueAttribute(UA_Server *server, UA_Session *session,
                    const UA_VariableNode *vn, UA_DataValue *v);
 
+/* Set the status and the timestamps of a read result */
+void
+finishRead(UA_TimestampsToReturn timestampsToReturn, UA_UInt32 attributeId,
+           UA_StatusCode retval, UA_DataValue *v);
+
 /* Test whether the value matches a variable definition given by
  * - datatype
  * - valuerank
@@ -649,10 +946,25 @@ void
 Operation_Browse(UA_Server *server, UA_Session *session, const UA_UInt32 *maxrefs,
                  const UA_BrowseDescription *descr, UA_BrowseResult *result);
 
+/* Values from DataSources can be served from the cache if they are not older
+ * than maxAge (in ms) */
 UA_DataValue
 UA_Server_readWithSession(UA_Server *server, UA_Session *session,
                           const UA_ReadValueId *item,
-                          UA_TimestampsToReturn timestampsToReturn);
+                          UA_TimestampsToReturn timestampsToReturn,
+                          UA_Double maxAge);
+
+/* Write and Call with the access rights of the session (used for async
+ * operations that are executed by a worker thread) */
+UA_StatusCode
+UA_Server_writeWithSession(UA_Server *server, UA_Session *session,
+                           const UA_WriteValue *value);
+
+#ifdef UA_ENABLE_METHODCALLS
+UA_CallMethodResult
+UA_Server_callWithSession(UA_Server *server, UA_Session *session,
+                          const UA_CallMethodRequest *request);
+#endif
 
 /*****************************/
 /* AddNodes Begin and Finish */
@@ -679,6 +991,11 @@ AddNode_finish(UA_Server *server, UA_Session *session, const UA_NodeId *nodeId);
 
 UA_StatusCode UA_Server_initNS0(UA_Server *server);
 
+/* Insert the nodes from a snapshot into the (empty) nodestore and restore the
+ * namespace array. See UA_Server_saveNodestoreSnapshot. */
+UA_StatusCode
+loadNodestoreSnapshot(UA_Server *server, const UA_ByteString *snapshot);
+
 UA_StatusCode writeNs0VariableArray(UA_Server *server, UA_UInt32 id, void *v,
                       size_t length, const UA_DataType *type);
 
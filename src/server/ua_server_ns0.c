@@ -638,13 +638,68 @@ readMonitoredItems(UA_Server *server, const UA_NodeId *sessionId, void *sessionC
 }
 #endif /* defined(UA_ENABLE_METHODCALLS) && defined(UA_ENABLE_SUBSCRIPTIONS) */
 
+/* The ns0 nodes can be shared with other servers (layered nodestore). Writing
+ * copies a shared node into the layer of the server. So attributes and
+ * callbacks are only written if they differ from the current node. */
+
+static UA_StatusCode
+writeNs0Value(UA_Server *server, UA_UInt32 id, const UA_Variant *var) {
+    UA_NodeId nodeId = UA_NODEID_NUMERIC(0, id);
+    UA_Variant old;
+    if(UA_Server_readValue(server, nodeId, &old) == UA_STATUSCODE_GOOD) {
+        UA_Boolean equal =
+            (UA_order(&old, var, &UA_TYPES[UA_TYPES_VARIANT]) == UA_ORDER_EQ);
+        UA_Variant_clear(&old);
+        if(equal)
+            return UA_STATUSCODE_GOOD;
+    }
+    return UA_Server_writeValue(server, nodeId, *var);
+}
+
+static UA_StatusCode
+writeNs0Attribute(UA_Server *server, UA_UInt32 id, UA_AttributeId attributeId,
+                  const void *v, const UA_DataType *type) {
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = UA_NODEID_NUMERIC(0, id);
+    rvi.attributeId = attributeId;
+    UA_DataValue dv = UA_Server_read(server, &rvi, UA_TIMESTAMPSTORETURN_NEITHER);
+    UA_Boolean equal = (dv.hasValue && UA_Variant_hasScalarType(&dv.value, type) &&
+                        UA_order(dv.value.data, v, type) == UA_ORDER_EQ);
+    UA_DataValue_clear(&dv);
+    if(equal)
+        return UA_STATUSCODE_GOOD;
+    return __UA_Server_write(server, &rvi.nodeId, attributeId, type, v);
+}
+
+static UA_StatusCode
+setNs0DataSource(UA_Server *server, UA_UInt32 id, UA_DataSource dataSource) {
+    UA_NodeId nodeId = UA_NODEID_NUMERIC(0, id);
+    UA_LOCK(&server->serviceMutex);
+    const UA_Node *node = UA_NODESTORE_GET(server, &nodeId);
+    UA_Boolean isSet = false;
+    if(node) {
+        const UA_VariableNode *vn = &node->variableNode;
+        isSet = (vn->head.nodeClass == UA_NODECLASS_VARIABLE &&
+                 vn->valueBackend.backendType == UA_VALUEBACKENDTYPE_NONE &&
+                 vn->valueSource == UA_VALUESOURCE_DATASOURCE &&
+                 vn->value.dataSource.read == dataSource.read &&
+                 vn->value.dataSource.write == dataSource.write);
+        UA_NODESTORE_RELEASE(server, node);
+    }
+    UA_UNLOCK(&server->serviceMutex);
+    if(isSet)
+        return UA_STATUSCODE_GOOD;
+    return UA_Server_setVariableNode_dataSource(server, nodeId, dataSource);
+}
+
 UA_StatusCode
 writeNs0VariableArray(UA_Server *server, UA_UInt32 id, void *v,
                       size_t length, const UA_DataType *type) {
     UA_Variant var;
     UA_Variant_init(&var);
     UA_Variant_setArray(&var, v, length, type);
-    return UA_Server_writeValue(server, UA_NODEID_NUMERIC(0, id), var);
+    return writeNs0Value(server, id, &var);
 }
 
 #ifndef UA_GENERATED_NAMESPACE_ZERO
@@ -736,7 +791,7 @@ writeNs0Variable(UA_Server *server, UA_UInt32 id, void *v, const UA_DataType *ty
     UA_Variant var;
     UA_Variant_init(&var);
     UA_Variant_setScalar(&var, v, type);
-    return UA_Server_writeValue(server, UA_NODEID_NUMERIC(0, id), var);
+    return writeNs0Value(server, id, &var);
 }
 
 static void
@@ -796,15 +851,28 @@ UA_Server_initNS0(UA_Server *server) {
     /* Initialize base nodes which are always required an cannot be created
      * through the NS compiler */
     server->bootstrapNS0 = true;
-    UA_StatusCode retVal = UA_Server_createNS0_base(server);
-
+    UA_StatusCode retVal = UA_STATUSCODE_GOOD;
+    UA_NodeId serverId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+    const UA_Node *serverNode = UA_NODESTORE_GET(server, &serverId);
+    if(serverNode) {
+        /* The nodestore is already populated. For example when it is layered
+         * on top of shared nodes. The callbacks are set below. */
+        UA_NODESTORE_RELEASE(server, serverNode);
+    } else if(server->config.nodestoreSnapshot.length > 0) {
+        /* Restore the nodes from a snapshot. The callbacks are set below. */
+        UA_LOCK(&server->serviceMutex);
+        retVal = loadNodestoreSnapshot(server, &server->config.nodestoreSnapshot);
+        UA_UNLOCK(&server->serviceMutex);
+    } else {
+        retVal = UA_Server_createNS0_base(server);
 #ifdef UA_GENERATED_NAMESPACE_ZERO
-    /* Load nodes and references generated from the XML ns0 definition */
-    retVal |= namespace0_generated(server);
+        /* Load nodes and references generated from the XML ns0 definition */
+        retVal |= namespace0_generated(server);
 #else
-    /* Create a minimal server object */
-    retVal |= UA_Server_minimalServerObject(server);
+        /* Create a minimal server object */
+        retVal |= UA_Server_minimalServerObject(server);
 #endif
+    }
 
     server->bootstrapNS0 = false;
 
@@ -818,75 +886,63 @@ UA_Server_initNS0(UA_Server *server) {
 
     /* NamespaceArray */
     UA_DataSource namespaceDataSource = {readNamespaces, writeNamespaces};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                                                   UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY),
-                                                   namespaceDataSource);
-    retVal |= UA_Server_writeValueRank(server, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY), 1);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_NAMESPACEARRAY, namespaceDataSource);
+    UA_Int32 arrayValueRank = UA_VALUERANK_ONE_DIMENSION;
+    retVal |= writeNs0Attribute(server, UA_NS0ID_SERVER_NAMESPACEARRAY,
+                                UA_ATTRIBUTEID_VALUERANK, &arrayValueRank,
+                                &UA_TYPES[UA_TYPES_INT32]);
 
     /* ServerArray */
     retVal |= writeNs0VariableArray(server, UA_NS0ID_SERVER_SERVERARRAY,
                                     &server->config.applicationDescription.applicationUri,
                                     1, &UA_TYPES[UA_TYPES_STRING]);
-    retVal |= UA_Server_writeValueRank(server, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERARRAY), 1);
+    retVal |= writeNs0Attribute(server, UA_NS0ID_SERVER_SERVERARRAY,
+                                UA_ATTRIBUTEID_VALUERANK, &arrayValueRank,
+                                &UA_TYPES[UA_TYPES_INT32]);
 
     /* ServerStatus */
     UA_DataSource serverStatus = {readStatus, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS), serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS, serverStatus);
 
     /* StartTime will be sampled in UA_Server_run_startup()*/
 
     /* CurrentTime */
     UA_DataSource currentTime = {readCurrentTime, NULL};
-    UA_NodeId currTime = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME);
-    retVal |= UA_Server_setVariableNode_dataSource(server, currTime, currentTime);
-    retVal |= UA_Server_writeMinimumSamplingInterval(server, currTime, 100.0);
+    UA_Double currTimeInterval = 100.0;
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME,
+                               currentTime);
+    retVal |= writeNs0Attribute(server, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME,
+                                UA_ATTRIBUTEID_MINIMUMSAMPLINGINTERVAL,
+                                &currTimeInterval, &UA_TYPES[UA_TYPES_DOUBLE]);
 
     /* State */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_STATE, serverStatus);
 
     /* BuildInfo */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO), serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO, serverStatus);
 
     /* BuildInfo - ProductUri */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_PRODUCTURI),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_PRODUCTURI, serverStatus);
 
     /* BuildInfo - ManufacturerName */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_MANUFACTURERNAME),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_MANUFACTURERNAME, serverStatus);
 
     /* BuildInfo - ProductName */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_PRODUCTNAME),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_PRODUCTNAME, serverStatus);
 
     /* BuildInfo - SoftwareVersion */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_SOFTWAREVERSION),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_SOFTWAREVERSION, serverStatus);
 
     /* BuildInfo - BuildNumber */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_BUILDNUMBER),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_BUILDNUMBER, serverStatus);
 
     /* BuildInfo - BuildDate */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_BUILDDATE),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_BUILDDATE, serverStatus);
 
 #ifdef UA_GENERATED_NAMESPACE_ZERO
 
     /* SecondsTillShutdown */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_SECONDSTILLSHUTDOWN),
-                                                   serverStatus);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERSTATUS_SECONDSTILLSHUTDOWN, serverStatus);
 
     /* ShutDownReason */
     UA_LocalizedText shutdownReason;
@@ -896,8 +952,7 @@ UA_Server_initNS0(UA_Server *server) {
 
     /* ServiceLevel */
     UA_DataSource serviceLevel = {readServiceLevel, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVICELEVEL), serviceLevel);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVICELEVEL, serviceLevel);
 
     /* ServerDiagnostics - EnabledFlag */
 #ifdef UA_ENABLE_DIAGNOSTICS
@@ -913,13 +968,14 @@ UA_Server_initNS0(UA_Server *server) {
      * In CTT, Subscription_Minimum_1/002.js test will modify the above flag. This will not be a problem when build
      * configuration is set at UA_NAMESPACE_ZERO="REDUCED" as NodeIds will not be present. When UA_NAMESPACE_ZERO="FULL",
      * the test will fail. Hence made the NodeId as read only */
-    retVal |= UA_Server_writeAccessLevel(server, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_ENABLEDFLAG),
-                                         UA_ACCESSLEVELMASK_READ);
+    UA_Byte enabledFlagAccessLevel = UA_ACCESSLEVELMASK_READ;
+    retVal |= writeNs0Attribute(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_ENABLEDFLAG,
+                                UA_ATTRIBUTEID_ACCESSLEVEL, &enabledFlagAccessLevel,
+                                &UA_TYPES[UA_TYPES_BYTE]);
 
     /* Auditing */
     UA_DataSource auditing = {readAuditing, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_AUDITING), auditing);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_AUDITING, auditing);
 
     /* Redundancy Support */
     UA_RedundancySupport redundancySupport = UA_REDUNDANCYSUPPORT_NONE;
@@ -968,9 +1024,7 @@ UA_Server_initNS0(UA_Server *server) {
 
     /* ServerCapabilities - MinSupportedSampleRate */
     UA_DataSource samplingInterval = {readMinSamplingInterval, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                 UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERCAPABILITIES_MINSUPPORTEDSAMPLERATE),
-                                                   samplingInterval);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERCAPABILITIES_MINSUPPORTEDSAMPLERATE, samplingInterval);
 
     /* ServerCapabilities - OperationLimits - MaxNodesPerRead */
     retVal |= writeNs0Variable(server, UA_NS0ID_SERVER_SERVERCAPABILITIES_OPERATIONLIMITS_MAXNODESPERREAD,
@@ -1025,73 +1079,57 @@ UA_Server_initNS0(UA_Server *server) {
 #ifdef UA_ENABLE_DIAGNOSTICS
     /* ServerDiagnostics - ServerDiagnosticsSummary */
     UA_DataSource serverDiagSummary = {readDiagnostics, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - ServerViewCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SERVERVIEWCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SERVERVIEWCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - CurrentSessionCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CURRENTSESSIONCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CURRENTSESSIONCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - CumulatedSessionCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CUMULATEDSESSIONCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CUMULATEDSESSIONCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - SecurityRejectedSessionCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SECURITYREJECTEDSESSIONCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SECURITYREJECTEDSESSIONCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - RejectedSessionCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_REJECTEDSESSIONCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_REJECTEDSESSIONCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - SessionTimeoutCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SESSIONTIMEOUTCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SESSIONTIMEOUTCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - SessionAbortCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SESSIONABORTCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SESSIONABORTCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - CurrentSubscriptionCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CURRENTSUBSCRIPTIONCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CURRENTSUBSCRIPTIONCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - CumulatedSubscriptionCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CUMULATEDSUBSCRIPTIONCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_CUMULATEDSUBSCRIPTIONCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - PublishingIntervalCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_PUBLISHINGINTERVALCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_PUBLISHINGINTERVALCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - SecurityRejectedRequestsCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SECURITYREJECTEDREQUESTSCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_SECURITYREJECTEDREQUESTSCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - ServerDiagnosticsSummary - RejectedRequestsCount */
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_REJECTEDREQUESTSCOUNT), serverDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SERVERDIAGNOSTICSSUMMARY_REJECTEDREQUESTSCOUNT, serverDiagSummary);
 
     /* ServerDiagnostics - SubscriptionDiagnosticsArray */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     UA_DataSource serverSubDiagSummary = {readSubscriptionDiagnosticsArray, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SUBSCRIPTIONDIAGNOSTICSARRAY), serverSubDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SUBSCRIPTIONDIAGNOSTICSARRAY, serverSubDiagSummary);
 #endif
 
     /* ServerDiagnostics - SessionDiagnosticsSummary - SessionDiagnosticsArray */
     UA_DataSource sessionDiagSummary = {readSessionDiagnosticsArray, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SESSIONSDIAGNOSTICSSUMMARY_SESSIONDIAGNOSTICSARRAY), sessionDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SESSIONSDIAGNOSTICSSUMMARY_SESSIONDIAGNOSTICSARRAY, sessionDiagSummary);
 
     /* ServerDiagnostics - SessionDiagnosticsSummary - SessionSecurityDiagnosticsArray */
     UA_DataSource sessionSecDiagSummary = {readSessionSecurityDiagnostics, NULL};
-    retVal |= UA_Server_setVariableNode_dataSource(server,
-                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SESSIONSDIAGNOSTICSSUMMARY_SESSIONSECURITYDIAGNOSTICSARRAY), sessionSecDiagSummary);
+    retVal |= setNs0DataSource(server, UA_NS0ID_SERVER_SERVERDIAGNOSTICS_SESSIONSDIAGNOSTICSSUMMARY_SESSIONSECURITYDIAGNOSTICSARRAY, sessionSecDiagSummary);
 
 #else
     /* Removing these NodeIds make Server Object to be non-complaint with UA
@@ -1169,7 +1207,12 @@ UA_Server_initNS0(UA_Server *server) {
 #endif
 
 #if defined(UA_ENABLE_METHODCALLS) && defined(UA_ENABLE_SUBSCRIPTIONS)
-    retVal |= UA_Server_setMethodNodeCallback(server,
+    UA_MethodCallback getMonitoredItems = NULL;
+    UA_Server_getMethodNodeCallback(server,
+                        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_GETMONITOREDITEMS),
+                        &getMonitoredItems);
+    if(getMonitoredItems != readMonitoredItems)
+        retVal |= UA_Server_setMethodNodeCallback(server,
                         UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_GETMONITOREDITEMS), readMonitoredItems);
 #endif
 
@@ -371,6 +371,15 @@ readSessionDiagnostics(UA_Server *server,
         content = &data.ssddt;
         type = &UA_TYPES[UA_TYPES_SESSIONSECURITYDIAGNOSTICSDATATYPE];
         goto set_value;
+    } else if(equalBrowseName(&bn.name, "MemoryUsage")) {
+        /* Vendor-specific property with the bytes used for the queued
+         * notifications and retransmission messages */
+        UA_UInt64 memoryUsage = (UA_UInt64)session->totalMemoryUsage;
+        res = UA_Variant_setScalarCopy(&value->value, &memoryUsage,
+                                       &UA_TYPES[UA_TYPES_UINT64]);
+        if(res == UA_STATUSCODE_GOOD)
+            value->hasValue = true;
+        goto cleanup;
     }
 
     /* Try to find the member in SessionDiagnosticsDataType and
@@ -481,6 +490,23 @@ createSessionObject(UA_Server *server, UA_Session *session) {
         setVariableNode_dataSource(server, children[i].nodeId, sessionDiagSource);
     }
 
+    /* Add a vendor-specific property for the memory usage of the session */
+    UA_VariableAttributes memAttr = UA_VariableAttributes_default;
+    memAttr.displayName = UA_LOCALIZEDTEXT("", "MemoryUsage");
+    memAttr.dataType = UA_TYPES[UA_TYPES_UINT64].typeId;
+    memAttr.valueRank = UA_VALUERANK_SCALAR;
+    UA_NodeId memId = UA_NODEID_NUMERIC(1, 0); /* Assign a random id */
+    UA_NodeId hasProperty = UA_NODEID_NUMERIC(0, UA_NS0ID_HASPROPERTY);
+    UA_NodeId propertyType = UA_NODEID_NUMERIC(0, UA_NS0ID_PROPERTYTYPE);
+    res = addNode(server, UA_NODECLASS_VARIABLE, &memId, &session->sessionId,
+                  &hasProperty, UA_QUALIFIEDNAME(1, "MemoryUsage"), &propertyType,
+                  (UA_NodeAttributes*)&memAttr, &UA_TYPES[UA_TYPES_VARIABLEATTRIBUTES],
+                  NULL, &memId);
+    if(res != UA_STATUSCODE_GOOD)
+        goto cleanup;
+    res = setVariableNode_dataSource(server, memId, sessionDiagSource);
+    UA_NodeId_clear(&memId);
+
  cleanup:
     if(res != UA_STATUSCODE_GOOD) {
         UA_LOG_WARNING_SESSION(&server->config.logger, session,
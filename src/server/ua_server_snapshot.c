@@ -0,0 +1,691 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ua_server_internal.h"
+#include "../ua_types_encoding_binary.h"
+
+/* Binary snapshot of the nodestore. The snapshot uses the OPC UA binary
+ * encoding for the individual fields:
+ *
+ * - Magic number and format version
+ * - NamespaceArray
+ * - NodeIds of the ReferenceTypes in the order of their ReferenceTypeIndex
+ * - Number of nodes, followed by the nodes. The ReferenceTypes come first
+ *   (ordered by their index) so that the same indices are assigned when the
+ *   snapshot is loaded into an empty nodestore. The other nodes follow in
+ *   the order of their NodeId.
+ *
+ * Pointers (node contexts, DataSources, callbacks, method implementations,
+ * type lifecycles) are not part of the snapshot. They need to be set again
+ * after the snapshot was loaded. */
+
+#define UA_SNAPSHOT_MAGIC 0x534E5541 /* "AUNS" */
+#define UA_SNAPSHOT_VERSION 1
+
+/************/
+/* Encoding */
+/************/
+
+typedef struct {
+    UA_ByteString buf;
+    UA_Byte *pos;
+    const UA_Byte *end;
+    UA_StatusCode res;
+} SnapshotEncoder;
+
+/* Called from the binary encoding when the end of the buffer is reached. Grow
+ * the buffer and continue at the same position. */
+static UA_StatusCode
+growSnapshotBuffer(void *handle, UA_Byte **bufPos, const UA_Byte **bufEnd) {
+    UA_ByteString *buf = (UA_ByteString*)handle;
+    size_t offset = (uintptr_t)*bufPos - (uintptr_t)buf->data;
+    size_t newLength = buf->length * 2;
+    UA_Byte *data = (UA_Byte*)UA_realloc(buf->data, newLength);
+    if(!data)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    buf->data = data;
+    buf->length = newLength;
+    *bufPos = &data[offset];
+    *bufEnd = &data[newLength];
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+encodeField(SnapshotEncoder *e, const void *p, const UA_DataType *type) {
+    if(e->res != UA_STATUSCODE_GOOD)
+        return;
+    e->res = UA_encodeBinaryInternal(p, type, &e->pos, &e->end,
+                                     growSnapshotBuffer, &e->buf);
+}
+
+static void
+encodeUInt32(SnapshotEncoder *e, UA_UInt32 v) {
+    encodeField(e, &v, &UA_TYPES[UA_TYPES_UINT32]);
+}
+
+static void
+encodeLocalizedTextList(SnapshotEncoder *e, const UA_LocalizedTextListEntry *lt) {
+    UA_UInt32 count = 0;
+    for(const UA_LocalizedTextListEntry *it = lt; it; it = it->next)
+        count++;
+    encodeUInt32(e, count);
+    for(; lt; lt = lt->next)
+        encodeField(e, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+}
+
+static void
+encodeReferences(SnapshotEncoder *e, const UA_NodeHead *head) {
+    encodeUInt32(e, (UA_UInt32)head->referencesSize);
+    for(size_t i = 0; i < head->referencesSize; i++) {
+        const UA_NodeReferenceKind *rk = &head->references[i];
+        encodeField(e, &rk->referenceTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        encodeField(e, &rk->isInverse, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        encodeUInt32(e, (UA_UInt32)rk->targetsSize);
+        const UA_ReferenceTarget *t = NULL;
+        while((t = UA_NodeReferenceKind_iterate(rk, t))) {
+            UA_ExpandedNodeId en = UA_NodePointer_toExpandedNodeId(t->targetId);
+            encodeField(e, &en, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+            encodeUInt32(e, t->targetNameHash);
+        }
+    }
+}
+
+/* Values from a DataSource or an external value backend are not persisted */
+static void
+encodeVariableAttributes(SnapshotEncoder *e, const UA_VariableNode *vn) {
+    encodeField(e, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    encodeField(e, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    encodeUInt32(e, (UA_UInt32)vn->arrayDimensionsSize);
+    for(size_t i = 0; i < vn->arrayDimensionsSize; i++)
+        encodeUInt32(e, vn->arrayDimensions[i]);
+    UA_DataValue empty;
+    UA_DataValue_init(&empty);
+    const UA_DataValue *value = &empty;
+    if(vn->valueSource == UA_VALUESOURCE_DATA)
+        value = &vn->value.data.value;
+    encodeField(e, value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+}
+
+static void
+encodeNode(SnapshotEncoder *e, const UA_Node *node) {
+    const UA_NodeHead *head = &node->head;
+    encodeField(e, &head->nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    encodeField(e, &head->nodeClass, &UA_TYPES[UA_TYPES_NODECLASS]);
+    encodeField(e, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    encodeLocalizedTextList(e, head->displayName);
+    encodeLocalizedTextList(e, head->description);
+    encodeUInt32(e, head->writeMask);
+    encodeField(e, &head->constructed, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    encodeReferences(e, head);
+
+    switch(head->nodeClass) {
+    case UA_NODECLASS_OBJECT:
+        encodeField(e, &node->objectNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        break;
+    case UA_NODECLASS_VARIABLE: {
+        const UA_VariableNode *vn = &node->variableNode;
+        encodeVariableAttributes(e, vn);
+        encodeField(e, &vn->accessLevel, &UA_TYPES[UA_TYPES_BYTE]);
+        encodeField(e, &vn->minimumSamplingInterval, &UA_TYPES[UA_TYPES_DOUBLE]);
+        encodeField(e, &vn->historizing, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        encodeField(e, &vn->isDynamic, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    }
+    case UA_NODECLASS_VARIABLETYPE:
+        encodeVariableAttributes(e, (const UA_VariableNode*)&node->variableTypeNode);
+        encodeField(e, &node->variableTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_METHOD:
+        encodeField(e, &node->methodNode.executable, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        encodeField(e, &node->objectTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_REFERENCETYPE: {
+        const UA_ReferenceTypeNode *rn = &node->referenceTypeNode;
+        encodeField(e, &rn->isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        encodeField(e, &rn->symmetric, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        encodeField(e, &rn->inverseName, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        encodeField(e, &rn->referenceTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        for(size_t i = 0; i < UA_REFERENCETYPESET_MAX / 32; i++)
+            encodeUInt32(e, rn->subTypes.bits[i]);
+        break;
+    }
+    case UA_NODECLASS_DATATYPE:
+        encodeField(e, &node->dataTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_VIEW:
+        encodeField(e, &node->viewNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        encodeField(e, &node->viewNode.containsNoLoops, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    default:
+        e->res = UA_STATUSCODE_BADINTERNALERROR;
+        break;
+    }
+}
+
+/* Collect the NodeIds of all nodes except the ReferenceTypes. The nodes are
+ * encoded sorted by their NodeId. So the snapshot does not depend on the
+ * internal layout of the nodestore and a server restored from a snapshot
+ * produces the identical snapshot again. */
+typedef struct {
+    UA_NodeId *ids;
+    size_t idsSize;
+    size_t idsCapacity;
+    UA_StatusCode res;
+} SnapshotVisitorContext;
+
+static void
+collectNodeIdVisitor(void *visitorCtx, const UA_Node *node) {
+    SnapshotVisitorContext *vc = (SnapshotVisitorContext*)visitorCtx;
+    if(vc->res != UA_STATUSCODE_GOOD)
+        return;
+    if(node->head.nodeClass == UA_NODECLASS_REFERENCETYPE)
+        return; /* Already encoded */
+    if(vc->idsSize == vc->idsCapacity) {
+        size_t newCapacity = (vc->idsCapacity > 0) ? vc->idsCapacity * 2 : 1024;
+        UA_NodeId *ids = (UA_NodeId*)
+            UA_realloc(vc->ids, newCapacity * sizeof(UA_NodeId));
+        if(!ids) {
+            vc->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        vc->ids = ids;
+        vc->idsCapacity = newCapacity;
+    }
+    vc->res = UA_NodeId_copy(&node->head.nodeId, &vc->ids[vc->idsSize]);
+    if(vc->res == UA_STATUSCODE_GOOD)
+        vc->idsSize++;
+}
+
+static int
+cmpNodeId(const void *a, const void *b) {
+    return (int)UA_NodeId_order((const UA_NodeId*)a, (const UA_NodeId*)b);
+}
+
+static UA_StatusCode
+saveNodestoreSnapshot(UA_Server *server, UA_ByteString *snapshot) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+    setupNs1Uri(server);
+
+    SnapshotEncoder e;
+    e.res = UA_ByteString_allocBuffer(&e.buf, 1 << 16);
+    if(e.res != UA_STATUSCODE_GOOD)
+        return e.res;
+    e.pos = e.buf.data;
+    e.end = &e.buf.data[e.buf.length];
+
+    /* Header and namespaces */
+    encodeUInt32(&e, UA_SNAPSHOT_MAGIC);
+    encodeUInt32(&e, UA_SNAPSHOT_VERSION);
+    encodeUInt32(&e, (UA_UInt32)server->namespacesSize);
+    for(size_t i = 0; i < server->namespacesSize; i++)
+        encodeField(&e, &server->namespaces[i], &UA_TYPES[UA_TYPES_STRING]);
+
+    /* ReferenceTypes in the order of their index */
+    UA_UInt32 refTypesSize = 0;
+    while(refTypesSize < UA_REFERENCETYPESET_MAX &&
+          UA_NODESTORE_GETREFERENCETYPEID(server, (UA_Byte)refTypesSize))
+        refTypesSize++;
+    encodeUInt32(&e, refTypesSize);
+    for(UA_UInt32 i = 0; i < refTypesSize; i++)
+        encodeField(&e, UA_NODESTORE_GETREFERENCETYPEID(server, (UA_Byte)i),
+                    &UA_TYPES[UA_TYPES_NODEID]);
+
+    /* Placeholder for the number of nodes */
+    size_t countOffset = (uintptr_t)e.pos - (uintptr_t)e.buf.data;
+    encodeUInt32(&e, 0);
+
+    /* Encode the ReferenceTypes first. Then all other nodes. */
+    UA_UInt32 count = 0;
+    for(UA_UInt32 i = 0; i < refTypesSize; i++) {
+        const UA_Node *node =
+            UA_NODESTORE_GET(server, UA_NODESTORE_GETREFERENCETYPEID(server, (UA_Byte)i));
+        if(!node) {
+            e.res = UA_STATUSCODE_BADINTERNALERROR;
+            break;
+        }
+        encodeNode(&e, node);
+        count++;
+        UA_NODESTORE_RELEASE(server, node);
+    }
+
+    SnapshotVisitorContext vc;
+    memset(&vc, 0, sizeof(SnapshotVisitorContext));
+    if(e.res == UA_STATUSCODE_GOOD) {
+        server->config.nodestore.iterate(server->config.nodestore.context,
+                                         collectNodeIdVisitor, &vc);
+        e.res = vc.res;
+    }
+    if(e.res == UA_STATUSCODE_GOOD && vc.idsSize > 0)
+        qsort(vc.ids, vc.idsSize, sizeof(UA_NodeId), cmpNodeId);
+    for(size_t i = 0; i < vc.idsSize && e.res == UA_STATUSCODE_GOOD; i++) {
+        const UA_Node *node = UA_NODESTORE_GET(server, &vc.ids[i]);
+        if(!node) {
+            e.res = UA_STATUSCODE_BADINTERNALERROR;
+            break;
+        }
+        encodeNode(&e, node);
+        count++;
+        UA_NODESTORE_RELEASE(server, node);
+    }
+    for(size_t i = 0; i < vc.idsSize; i++)
+        UA_NodeId_clear(&vc.ids[i]);
+    UA_free(vc.ids);
+    if(e.res != UA_STATUSCODE_GOOD) {
+        UA_ByteString_clear(&e.buf);
+        return e.res;
+    }
+
+    /* Write the number of nodes into the placeholder */
+    size_t length = (uintptr_t)e.pos - (uintptr_t)e.buf.data;
+    UA_Byte *countPos = &e.buf.data[countOffset];
+    const UA_Byte *countEnd = &e.buf.data[countOffset + 4];
+    e.res = UA_encodeBinaryInternal(&count, &UA_TYPES[UA_TYPES_UINT32],
+                                    &countPos, &countEnd, NULL, NULL);
+    if(e.res != UA_STATUSCODE_GOOD) {
+        UA_ByteString_clear(&e.buf);
+        return e.res;
+    }
+
+    /* Return the used part of the buffer */
+    e.buf.length = length;
+    *snapshot = e.buf;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Server_saveNodestoreSnapshot(UA_Server *server, UA_ByteString *snapshot) {
+    UA_LOCK(&server->serviceMutex);
+    UA_StatusCode res = saveNodestoreSnapshot(server, snapshot);
+    UA_UNLOCK(&server->serviceMutex);
+    return res;
+}
+
+/************/
+/* Decoding */
+/************/
+
+typedef struct {
+    const UA_ByteString *src;
+    size_t offset;
+    UA_StatusCode res;
+} SnapshotDecoder;
+
+static void
+decodeField(SnapshotDecoder *d, void *p, const UA_DataType *type) {
+    if(d->res != UA_STATUSCODE_GOOD) {
+        memset(p, 0, type->memSize);
+        return;
+    }
+    d->res = UA_decodeBinaryInternal(d->src, &d->offset, p, type, NULL);
+}
+
+static UA_UInt32
+decodeUInt32(SnapshotDecoder *d) {
+    UA_UInt32 v = 0;
+    decodeField(d, &v, &UA_TYPES[UA_TYPES_UINT32]);
+    return v;
+}
+
+/* Decoded counts are checked against the remaining length. Every element takes
+ * at least one byte. So that corrupted snapshots do not cause huge
+ * allocations. */
+static UA_Boolean
+checkCount(SnapshotDecoder *d, UA_UInt32 count) {
+    if(d->res != UA_STATUSCODE_GOOD)
+        return false;
+    if(count > d->src->length - d->offset) {
+        d->res = UA_STATUSCODE_BADDECODINGERROR;
+        return false;
+    }
+    return true;
+}
+
+/* Keep the order of the list entries */
+static void
+decodeLocalizedTextList(SnapshotDecoder *d, UA_LocalizedTextListEntry **list) {
+    UA_UInt32 count = decodeUInt32(d);
+    if(!checkCount(d, count))
+        return;
+    for(UA_UInt32 i = 0; i < count; i++) {
+        UA_LocalizedTextListEntry *lt = (UA_LocalizedTextListEntry*)
+            UA_malloc(sizeof(UA_LocalizedTextListEntry));
+        if(!lt) {
+            d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        decodeField(d, &lt->localizedText, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        if(d->res != UA_STATUSCODE_GOOD) {
+            UA_free(lt);
+            return;
+        }
+        lt->next = NULL;
+        lt->interned = false;
+        *list = lt;
+        list = &lt->next;
+    }
+}
+
+static void
+decodeReferences(SnapshotDecoder *d, UA_NodeHead *head) {
+    UA_UInt32 kinds = decodeUInt32(d);
+    if(!checkCount(d, kinds) || kinds == 0)
+        return;
+    head->references = (UA_NodeReferenceKind*)
+        UA_calloc(kinds, sizeof(UA_NodeReferenceKind));
+    if(!head->references) {
+        d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+        return;
+    }
+
+    for(UA_UInt32 i = 0; i < kinds; i++) {
+        UA_NodeReferenceKind *rk = &head->references[i];
+        head->referencesSize++;
+        decodeField(d, &rk->referenceTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        decodeField(d, &rk->isInverse, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        UA_UInt32 targetsSize = decodeUInt32(d);
+        if(!checkCount(d, targetsSize))
+            return;
+        if(targetsSize == 0)
+            continue;
+
+        /* A single target is stored inline. The zeroed targets can be cleaned
+         * up if the decoding fails midway. */
+        UA_ReferenceTarget *targets = &rk->targets.single;
+        rk->hasRefInline = (targetsSize == 1);
+        if(targetsSize > 1) {
+            targets = (UA_ReferenceTarget*)
+                UA_calloc(targetsSize, sizeof(UA_ReferenceTarget));
+            if(!targets) {
+                d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+                return;
+            }
+            rk->targets.array = targets;
+        }
+        rk->targetsSize = targetsSize;
+        for(UA_UInt32 j = 0; j < targetsSize; j++) {
+            UA_ReferenceTarget *t = &targets[j];
+            UA_ExpandedNodeId en;
+            decodeField(d, &en, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+            if(d->res != UA_STATUSCODE_GOOD)
+                return;
+            d->res = UA_NodePointer_copy(UA_NodePointer_fromExpandedNodeId(&en),
+                                         &t->targetId);
+            UA_ExpandedNodeId_clear(&en);
+            if(d->res != UA_STATUSCODE_GOOD)
+                return;
+            t->targetNameHash = decodeUInt32(d);
+        }
+
+        /* Use the tree representation for nodes with many references */
+        if(rk->targetsSize > 16)
+            UA_NodeReferenceKind_switch(rk);
+    }
+}
+
+/* The binary encoding of a Variant only carries the builtin type. Enums are
+ * decoded as Int32 and aliases such as LocaleId as their builtin type.
+ * Restore the DataType of the node for them, so that the value is the same as
+ * before the snapshot was taken. Only the type pointer is changed. The memory
+ * layout is identical. */
+static void
+restoreValueType(UA_Server *server, UA_VariableNode *vn) {
+    UA_Variant *value = &vn->value.data.value.value;
+    if(!value->type)
+        return;
+    const UA_DataType *type = UA_Server_findDataType(server, &vn->dataType);
+    if(!type || type == value->type || type->memSize != value->type->memSize)
+        return;
+    UA_DataTypeKind k1 = (UA_DataTypeKind)type->typeKind;
+    UA_DataTypeKind k2 = (UA_DataTypeKind)value->type->typeKind;
+    if(k1 == UA_DATATYPEKIND_ENUM)
+        k1 = UA_DATATYPEKIND_INT32;
+    if(k1 == k2 && k1 < UA_DATATYPEKIND_ENUM)
+        value->type = type;
+}
+
+static void
+decodeVariableAttributes(SnapshotDecoder *d, UA_VariableNode *vn) {
+    decodeField(d, &vn->dataType, &UA_TYPES[UA_TYPES_NODEID]);
+    decodeField(d, &vn->valueRank, &UA_TYPES[UA_TYPES_INT32]);
+    UA_UInt32 dims = decodeUInt32(d);
+    if(!checkCount(d, dims))
+        return;
+    if(dims > 0) {
+        vn->arrayDimensions = (UA_UInt32*)
+            UA_Array_new(dims, &UA_TYPES[UA_TYPES_UINT32]);
+        if(!vn->arrayDimensions) {
+            d->res = UA_STATUSCODE_BADOUTOFMEMORY;
+            return;
+        }
+        vn->arrayDimensionsSize = dims;
+        for(UA_UInt32 i = 0; i < dims; i++)
+            vn->arrayDimensions[i] = decodeUInt32(d);
+    }
+    vn->valueSource = UA_VALUESOURCE_DATA;
+    decodeField(d, &vn->value.data.value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+}
+
+static UA_Node *
+decodeNode(UA_Server *server, SnapshotDecoder *d) {
+    UA_NodeId nodeId;
+    UA_NodeClass nodeClass;
+    decodeField(d, &nodeId, &UA_TYPES[UA_TYPES_NODEID]);
+    decodeField(d, &nodeClass, &UA_TYPES[UA_TYPES_NODECLASS]);
+    if(d->res != UA_STATUSCODE_GOOD) {
+        UA_NodeId_clear(&nodeId);
+        return NULL;
+    }
+
+    UA_Node *node = UA_NODESTORE_NEW(server, nodeClass);
+    if(!node) {
+        UA_NodeId_clear(&nodeId);
+        d->res = UA_STATUSCODE_BADDECODINGERROR;
+        return NULL;
+    }
+
+    UA_NodeHead *head = &node->head;
+    head->nodeId = nodeId;
+    decodeField(d, &head->browseName, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]);
+    decodeLocalizedTextList(d, &head->displayName);
+    decodeLocalizedTextList(d, &head->description);
+    head->writeMask = decodeUInt32(d);
+    decodeField(d, &head->constructed, &UA_TYPES[UA_TYPES_BOOLEAN]);
+    decodeReferences(d, head);
+
+    switch(nodeClass) {
+    case UA_NODECLASS_OBJECT:
+        decodeField(d, &node->objectNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        break;
+    case UA_NODECLASS_VARIABLE: {
+        UA_VariableNode *vn = &node->variableNode;
+        decodeVariableAttributes(d, vn);
+        restoreValueType(server, vn);
+        decodeField(d, &vn->accessLevel, &UA_TYPES[UA_TYPES_BYTE]);
+        decodeField(d, &vn->minimumSamplingInterval, &UA_TYPES[UA_TYPES_DOUBLE]);
+        decodeField(d, &vn->historizing, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        decodeField(d, &vn->isDynamic, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    }
+    case UA_NODECLASS_VARIABLETYPE:
+        decodeVariableAttributes(d, (UA_VariableNode*)&node->variableTypeNode);
+        restoreValueType(server, (UA_VariableNode*)&node->variableTypeNode);
+        decodeField(d, &node->variableTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_METHOD:
+        decodeField(d, &node->methodNode.executable, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_OBJECTTYPE:
+        decodeField(d, &node->objectTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_REFERENCETYPE: {
+        UA_ReferenceTypeNode *rn = &node->referenceTypeNode;
+        decodeField(d, &rn->isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        decodeField(d, &rn->symmetric, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        decodeField(d, &rn->inverseName, &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]);
+        decodeField(d, &rn->referenceTypeIndex, &UA_TYPES[UA_TYPES_BYTE]);
+        for(size_t i = 0; i < UA_REFERENCETYPESET_MAX / 32; i++)
+            rn->subTypes.bits[i] = decodeUInt32(d);
+        break;
+    }
+    case UA_NODECLASS_DATATYPE:
+        decodeField(d, &node->dataTypeNode.isAbstract, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    case UA_NODECLASS_VIEW:
+        decodeField(d, &node->viewNode.eventNotifier, &UA_TYPES[UA_TYPES_BYTE]);
+        decodeField(d, &node->viewNode.containsNoLoops, &UA_TYPES[UA_TYPES_BOOLEAN]);
+        break;
+    default:
+        d->res = UA_STATUSCODE_BADDECODINGERROR;
+        break;
+    }
+
+    if(d->res != UA_STATUSCODE_GOOD) {
+        UA_NODESTORE_DELETE(server, node);
+        return NULL;
+    }
+    return node;
+}
+
+static UA_StatusCode
+setReferenceTypeSubtypes(UA_Server *server, UA_Session *session,
+                         UA_Node *node, const UA_ReferenceTypeSet *subTypes) {
+    node->referenceTypeNode.subTypes = *subTypes;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+loadNodestoreSnapshot(UA_Server *server, const UA_ByteString *snapshot) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    SnapshotDecoder d;
+    d.src = snapshot;
+    d.offset = 0;
+    d.res = UA_STATUSCODE_GOOD;
+
+    /* Header */
+    UA_UInt32 magic = decodeUInt32(&d);
+    UA_UInt32 version = decodeUInt32(&d);
+    if(d.res != UA_STATUSCODE_GOOD || magic != UA_SNAPSHOT_MAGIC ||
+       version != UA_SNAPSHOT_VERSION) {
+        UA_LOG_ERROR(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                     "Nodestore snapshot: Unknown format");
+        return UA_STATUSCODE_BADDECODINGERROR;
+    }
+
+    /* Namespaces */
+    UA_UInt32 namespacesSize = decodeUInt32(&d);
+    if(!checkCount(&d, namespacesSize) || namespacesSize < 2)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    UA_String *namespaces = (UA_String*)
+        UA_Array_new(namespacesSize, &UA_TYPES[UA_TYPES_STRING]);
+    if(!namespaces)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    for(UA_UInt32 i = 0; i < namespacesSize; i++)
+        decodeField(&d, &namespaces[i], &UA_TYPES[UA_TYPES_STRING]);
+    if(d.res != UA_STATUSCODE_GOOD) {
+        UA_Array_delete(namespaces, namespacesSize, &UA_TYPES[UA_TYPES_STRING]);
+        return d.res;
+    }
+
+    /* Namespace 1 is the ApplicationUri of the running server. Keep it, also
+     * if the snapshot was taken with a different ApplicationUri. */
+    setupNs1Uri(server);
+    if(server->namespacesSize > 1 &&
+       !UA_String_equal(&namespaces[1], &server->namespaces[1])) {
+        UA_LOG_INFO(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                    "Nodestore snapshot: Keep the ApplicationUri of the "
+                    "server for namespace 1");
+        UA_String_clear(&namespaces[1]);
+        d.res = UA_String_copy(&server->namespaces[1], &namespaces[1]);
+        if(d.res != UA_STATUSCODE_GOOD) {
+            UA_Array_delete(namespaces, namespacesSize, &UA_TYPES[UA_TYPES_STRING]);
+            return d.res;
+        }
+    }
+
+    UA_Array_delete(server->namespaces, server->namespacesSize,
+                    &UA_TYPES[UA_TYPES_STRING]);
+    server->namespaces = namespaces;
+    server->namespacesSize = namespacesSize;
+
+    /* The ReferenceTypes must be inserted with the same index */
+    UA_UInt32 refTypesSize = decodeUInt32(&d);
+    if(d.res != UA_STATUSCODE_GOOD || refTypesSize > UA_REFERENCETYPESET_MAX)
+        return UA_STATUSCODE_BADDECODINGERROR;
+    UA_ReferenceTypeSet subTypes[UA_REFERENCETYPESET_MAX];
+    UA_NodeId refTypeIds[UA_REFERENCETYPESET_MAX];
+    UA_Boolean refTypeInserted[UA_REFERENCETYPESET_MAX];
+    memset(subTypes, 0, sizeof(subTypes));
+    memset(refTypeIds, 0, sizeof(refTypeIds));
+    memset(refTypeInserted, 0, sizeof(refTypeInserted));
+    for(UA_UInt32 i = 0; i < refTypesSize; i++)
+        decodeField(&d, &refTypeIds[i], &UA_TYPES[UA_TYPES_NODEID]);
+
+    /* Insert the nodes */
+    UA_UInt32 nodesSize = decodeUInt32(&d);
+    if(checkCount(&d, nodesSize) && server->config.nodestore.reserve)
+        d.res = server->config.nodestore.reserve(server->config.nodestore.context,
+                                                 nodesSize);
+    for(UA_UInt32 i = 0; i < nodesSize && d.res == UA_STATUSCODE_GOOD; i++) {
+        UA_Node *node = decodeNode(server, &d);
+        if(!node)
+            break;
+        UA_Boolean isRefType = (node->head.nodeClass == UA_NODECLASS_REFERENCETYPE);
+        UA_Byte refTypeIndex = 0;
+        if(isRefType) {
+            refTypeIndex = node->referenceTypeNode.referenceTypeIndex;
+            if(refTypeIndex >= refTypesSize) {
+                UA_NODESTORE_DELETE(server, node);
+                d.res = UA_STATUSCODE_BADDECODINGERROR;
+                break;
+            }
+            subTypes[refTypeIndex] = node->referenceTypeNode.subTypes;
+        }
+        UA_Node_internStrings(server->stringPool, node);
+        d.res = UA_NODESTORE_INSERT(server, node, NULL);
+        if(d.res != UA_STATUSCODE_GOOD)
+            break;
+
+        /* The nodestore has assigned the same ReferenceTypeIndex? */
+        if(isRefType) {
+            const UA_NodeId *refTypeId =
+                UA_NODESTORE_GETREFERENCETYPEID(server, refTypeIndex);
+            if(!refTypeId || !UA_NodeId_equal(refTypeId, &refTypeIds[refTypeIndex])) {
+                UA_LOG_ERROR(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                             "Nodestore snapshot: The ReferenceTypes could not "
+                             "be restored. The nodestore needs to be empty.");
+                d.res = UA_STATUSCODE_BADINTERNALERROR;
+            }
+            refTypeInserted[refTypeIndex] = true;
+        }
+    }
+
+    /* Every listed ReferenceType must be contained in the snapshot */
+    for(UA_UInt32 i = 0; i < refTypesSize && d.res == UA_STATUSCODE_GOOD; i++) {
+        if(!refTypeInserted[i]) {
+            UA_LOG_ERROR(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                         "Nodestore snapshot: ReferenceType node missing");
+            d.res = UA_STATUSCODE_BADDECODINGERROR;
+        }
+    }
+
+    /* Restore the ReferenceTypeSets of the subtypes */
+    for(UA_UInt32 i = 0; i < refTypesSize && d.res == UA_STATUSCODE_GOOD; i++) {
+        d.res = UA_Server_editNode(server, &server->adminSession, &refTypeIds[i],
+                                   (UA_EditNodeCallback)setReferenceTypeSubtypes,
+                                   &subTypes[i]);
+    }
+
+    for(UA_UInt32 i = 0; i < refTypesSize; i++)
+        UA_NodeId_clear(&refTypeIds[i]);
+
+    if(d.res != UA_STATUSCODE_GOOD)
+        UA_LOG_ERROR(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                     "Nodestore snapshot: Loading failed with %s",
+                     UA_StatusCode_name(d.res));
+    return d.res;
+}
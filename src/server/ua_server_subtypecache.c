@@ -0,0 +1,232 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ua_server_internal.h"
+
+/* Cache of the transitive supertypes of type nodes. "Is A a subtype of B"
+ * becomes a lookup of A followed by a scan of its (short) list of supertypes.
+ * The list is computed when A is looked up for the first time. Adding or
+ * deleting a HasSubtype reference removes the entries of the affected nodes
+ * and of all their subtypes. All accesses happen with the service mutex
+ * taken. */
+
+#define UA_SUBTYPECACHE_MINSIZE 64
+
+void
+UA_SubtypeCache_init(UA_SubtypeCache *sc) {
+    memset(sc, 0, sizeof(UA_SubtypeCache));
+}
+
+static void
+deleteSubtypeEntry(UA_SubtypeEntry *e) {
+    UA_NodeId_clear(&e->nodeId);
+    UA_Array_delete(e->supertypes, e->supertypesSize, &UA_TYPES[UA_TYPES_NODEID]);
+    UA_free(e->supertypeHashes);
+    UA_free(e);
+}
+
+void
+UA_SubtypeCache_clear(UA_SubtypeCache *sc) {
+    for(size_t i = 0; i < sc->bucketsSize; i++) {
+        UA_SubtypeEntry *e = sc->buckets[i];
+        while(e) {
+            UA_SubtypeEntry *next = e->next;
+            deleteSubtypeEntry(e);
+            e = next;
+        }
+    }
+    UA_free(sc->buckets);
+    UA_SubtypeCache_init(sc);
+}
+
+static UA_Boolean
+hasSupertype(const UA_SubtypeEntry *e, const UA_NodeId *supertype, UA_UInt32 hash) {
+    for(size_t i = 0; i < e->supertypesSize; i++) {
+        if(e->supertypeHashes[i] == hash &&
+           UA_NodeId_equal(&e->supertypes[i], supertype))
+            return true;
+    }
+    return false;
+}
+
+static UA_StatusCode
+growSubtypeCache(UA_SubtypeCache *sc) {
+    size_t newSize = (sc->bucketsSize == 0) ?
+        UA_SUBTYPECACHE_MINSIZE : sc->bucketsSize * 2;
+    UA_SubtypeEntry **buckets = (UA_SubtypeEntry**)
+        UA_calloc(newSize, sizeof(UA_SubtypeEntry*));
+    if(!buckets)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    for(size_t i = 0; i < sc->bucketsSize; i++) {
+        UA_SubtypeEntry *e = sc->buckets[i];
+        while(e) {
+            UA_SubtypeEntry *next = e->next;
+            size_t b = e->hash & (newSize - 1);
+            e->next = buckets[b];
+            buckets[b] = e;
+            e = next;
+        }
+    }
+    UA_free(sc->buckets);
+    sc->buckets = buckets;
+    sc->bucketsSize = newSize;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Append the supertype if it is not yet in the list */
+static UA_StatusCode
+addSupertype(UA_SubtypeEntry *e, size_t *capacity, const UA_NodeId *supertype) {
+    UA_UInt32 hash = UA_NodeId_hash(supertype);
+    if(hasSupertype(e, supertype, hash) || UA_NodeId_equal(&e->nodeId, supertype))
+        return UA_STATUSCODE_GOOD;
+    if(e->supertypesSize >= *capacity) {
+        size_t newCapacity = (*capacity == 0) ? 8 : *capacity * 2;
+        UA_NodeId *st = (UA_NodeId*)
+            UA_realloc(e->supertypes, newCapacity * sizeof(UA_NodeId));
+        if(!st)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        e->supertypes = st;
+        UA_UInt32 *sh = (UA_UInt32*)
+            UA_realloc(e->supertypeHashes, newCapacity * sizeof(UA_UInt32));
+        if(!sh)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        e->supertypeHashes = sh;
+        *capacity = newCapacity;
+    }
+    UA_StatusCode res = UA_NodeId_copy(supertype, &e->supertypes[e->supertypesSize]);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    e->supertypeHashes[e->supertypesSize] = hash;
+    e->supertypesSize++;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Collect the direct supertypes of the node. Fails if the node does not exist
+ * or (with checkNodeClass) is not a type node. */
+static UA_StatusCode
+addDirectSupertypes(UA_Server *server, UA_SubtypeEntry *e, size_t *capacity,
+                    const UA_NodeId *nodeId, UA_Boolean checkNodeClass) {
+    const UA_Node *node =
+        UA_NODESTORE_GET_SELECTIVE(server, nodeId, UA_NODEATTRIBUTESMASK_NODECLASS,
+                                   UA_REFTYPESET(UA_REFERENCETYPEINDEX_HASSUBTYPE),
+                                   UA_BROWSEDIRECTION_INVERSE);
+    if(!node)
+        return UA_STATUSCODE_BADNODEIDUNKNOWN;
+
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(checkNodeClass &&
+       node->head.nodeClass != UA_NODECLASS_OBJECTTYPE &&
+       node->head.nodeClass != UA_NODECLASS_VARIABLETYPE &&
+       node->head.nodeClass != UA_NODECLASS_DATATYPE &&
+       node->head.nodeClass != UA_NODECLASS_REFERENCETYPE) {
+        res = UA_STATUSCODE_BADNODECLASSINVALID;
+        goto cleanup;
+    }
+
+    for(size_t i = 0; i < node->head.referencesSize; i++) {
+        UA_NodeReferenceKind *rk = &node->head.references[i];
+        if(!rk->isInverse ||
+           rk->referenceTypeIndex != UA_REFERENCETYPEINDEX_HASSUBTYPE)
+            continue;
+        const UA_ReferenceTarget *t = NULL;
+        while((t = UA_NodeReferenceKind_iterate(rk, t))) {
+            if(!UA_NodePointer_isLocal(t->targetId))
+                continue;
+            UA_NodeId id = UA_NodePointer_toNodeId(t->targetId);
+            res = addSupertype(e, capacity, &id);
+            if(res != UA_STATUSCODE_GOOD)
+                goto cleanup;
+        }
+    }
+
+ cleanup:
+    UA_NODESTORE_RELEASE(server, node);
+    return res;
+}
+
+/* Compute the transitive supertypes in breadth-first order. The list itself
+ * is the queue. Supertypes that no longer exist are skipped. */
+static UA_SubtypeEntry *
+createSubtypeEntry(UA_Server *server, const UA_NodeId *nodeId, UA_UInt32 hash) {
+    UA_SubtypeEntry *e = (UA_SubtypeEntry*)UA_calloc(1, sizeof(UA_SubtypeEntry));
+    if(!e)
+        return NULL;
+    size_t capacity = 0;
+    UA_StatusCode res = UA_NodeId_copy(nodeId, &e->nodeId);
+    if(res == UA_STATUSCODE_GOOD)
+        res = addDirectSupertypes(server, e, &capacity, nodeId, true);
+    for(size_t i = 0; i < e->supertypesSize && res == UA_STATUSCODE_GOOD; i++) {
+        res = addDirectSupertypes(server, e, &capacity, &e->supertypes[i], false);
+        if(res == UA_STATUSCODE_BADNODEIDUNKNOWN)
+            res = UA_STATUSCODE_GOOD;
+    }
+    if(res != UA_STATUSCODE_GOOD) {
+        deleteSubtypeEntry(e);
+        return NULL;
+    }
+    e->hash = hash;
+    return e;
+}
+
+UA_Boolean
+UA_SubtypeCache_isSubtype(UA_Server *server, const UA_NodeId *type,
+                          const UA_NodeId *supertype, UA_Boolean *result) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+    UA_SubtypeCache *sc = &server->subtypeCache;
+
+    if(UA_NodeId_equal(type, supertype)) {
+        *result = true;
+        return true;
+    }
+
+    /* Lookup */
+    UA_UInt32 hash = UA_NodeId_hash(type);
+    UA_SubtypeEntry *e = NULL;
+    if(sc->bucketsSize > 0) {
+        e = sc->buckets[hash & (sc->bucketsSize - 1)];
+        for(; e; e = e->next) {
+            if(e->hash == hash && UA_NodeId_equal(&e->nodeId, type))
+                break;
+        }
+    }
+
+    /* Compute and insert */
+    if(!e) {
+        if(sc->count >= sc->bucketsSize &&
+           growSubtypeCache(sc) != UA_STATUSCODE_GOOD)
+            return false;
+        e = createSubtypeEntry(server, type, hash);
+        if(!e)
+            return false;
+        size_t b = hash & (sc->bucketsSize - 1);
+        e->next = sc->buckets[b];
+        sc->buckets[b] = e;
+        sc->count++;
+    }
+
+    *result = hasSupertype(e, supertype, UA_NodeId_hash(supertype));
+    return true;
+}
+
+void
+UA_SubtypeCache_invalidate(UA_SubtypeCache *sc, const UA_NodeId *nodeId) {
+    if(sc->count == 0)
+        return;
+    UA_UInt32 hash = UA_NodeId_hash(nodeId);
+    for(size_t i = 0; i < sc->bucketsSize; i++) {
+        UA_SubtypeEntry **prev = &sc->buckets[i];
+        while(*prev) {
+            UA_SubtypeEntry *e = *prev;
+            if((e->hash == hash && UA_NodeId_equal(&e->nodeId, nodeId)) ||
+               hasSupertype(e, nodeId, hash)) {
+                *prev = e->next;
+                sc->count--;
+                deleteSubtypeEntry(e);
+                continue;
+            }
+            prev = &e->next;
+        }
+    }
+}
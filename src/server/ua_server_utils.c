@@ -280,6 +280,7 @@ UA_Server_editNode(UA_Server *server, UA_Session *session,
     if(!node)
         return UA_STATUSCODE_BADNODEIDUNKNOWN;
     UA_StatusCode retval = callback(server, session, (UA_Node*)(uintptr_t)node, data);
+    UA_Node_internStrings(server->stringPool, (UA_Node*)(uintptr_t)node);
     UA_NODESTORE_RELEASE(server, node);
     return retval;
 #else
@@ -299,6 +300,7 @@ UA_Server_editNode(UA_Server *server, UA_Session *session,
         }
 
         /* Replace the node */
+        UA_Node_internStrings(server->stringPool, node);
         retval = UA_NODESTORE_REPLACE(server, node);
     } while(retval != UA_STATUSCODE_GOOD);
     return retval;
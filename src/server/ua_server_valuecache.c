@@ -0,0 +1,188 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ua_server_internal.h"
+
+/* Cache of values read from DataSources. The entries are keyed by the NodeId
+ * and the SessionId. The SessionId is null for values shared between all
+ * sessions. Only DataSources with session-specific values have entries per
+ * session. The entries are found by the hash of their NodeId. The entries for
+ * the same node (from different sessions) end up in the same bucket. When the
+ * memory limit is reached, the least recently used entries are evicted. All
+ * accesses happen with the service mutex taken. */
+
+#define UA_VALUECACHE_MINSIZE 64
+
+/* Approximate memory of the entry. The binary encoding size of the value
+ * accounts for the nested content (strings, arrays, structures). */
+static size_t
+cachedValueMemory(const UA_CachedValue *cv) {
+    return sizeof(UA_CachedValue) +
+        UA_calcSizeBinary(&cv->nodeId, &UA_TYPES[UA_TYPES_NODEID]) +
+        UA_calcSizeBinary(&cv->sessionId, &UA_TYPES[UA_TYPES_NODEID]) +
+        UA_calcSizeBinary(&cv->value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+}
+
+void
+UA_ValueCache_init(UA_ValueCache *vc) {
+    memset(vc, 0, sizeof(UA_ValueCache));
+    TAILQ_INIT(&vc->lru);
+}
+
+static void
+removeCachedValue(UA_ValueCache *vc, UA_CachedValue *cv) {
+    UA_CachedValue **prev = &vc->buckets[cv->nodeIdHash & (vc->bucketsSize - 1)];
+    while(*prev != cv)
+        prev = &(*prev)->next;
+    *prev = cv->next;
+    TAILQ_REMOVE(&vc->lru, cv, lruEntry);
+    vc->count--;
+    vc->memory -= cv->memory;
+    UA_NodeId_clear(&cv->nodeId);
+    UA_NodeId_clear(&cv->sessionId);
+    UA_DataValue_clear(&cv->value);
+    UA_free(cv);
+}
+
+void
+UA_ValueCache_clear(UA_ValueCache *vc) {
+    UA_CachedValue *cv, *cv_tmp;
+    TAILQ_FOREACH_SAFE(cv, &vc->lru, lruEntry, cv_tmp) {
+        removeCachedValue(vc, cv);
+    }
+    UA_free(vc->buckets);
+    UA_ValueCache_init(vc);
+}
+
+static UA_CachedValue *
+findCachedValue(const UA_ValueCache *vc, const UA_NodeId *nodeId,
+                const UA_NodeId *sessionId, UA_UInt32 hash) {
+    if(vc->bucketsSize == 0)
+        return NULL;
+    UA_CachedValue *cv = vc->buckets[hash & (vc->bucketsSize - 1)];
+    for(; cv; cv = cv->next) {
+        if(cv->nodeIdHash == hash && UA_NodeId_equal(&cv->nodeId, nodeId) &&
+           UA_NodeId_equal(&cv->sessionId, sessionId))
+            return cv;
+    }
+    return NULL;
+}
+
+/* Double the number of buckets (or allocate the initial buckets) */
+static UA_StatusCode
+growValueCache(UA_ValueCache *vc) {
+    size_t newSize = (vc->bucketsSize == 0) ?
+        UA_VALUECACHE_MINSIZE : vc->bucketsSize * 2;
+    UA_CachedValue **buckets = (UA_CachedValue**)
+        UA_calloc(newSize, sizeof(UA_CachedValue*));
+    if(!buckets)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    for(size_t i = 0; i < vc->bucketsSize; i++) {
+        UA_CachedValue *cv = vc->buckets[i];
+        while(cv) {
+            UA_CachedValue *next = cv->next;
+            size_t b = cv->nodeIdHash & (newSize - 1);
+            cv->next = buckets[b];
+            buckets[b] = cv;
+            cv = next;
+        }
+    }
+    UA_free(vc->buckets);
+    vc->buckets = buckets;
+    vc->bucketsSize = newSize;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_Boolean
+UA_ValueCache_get(UA_ValueCache *vc, const UA_NodeId *nodeId,
+                  const UA_NodeId *sessionId, UA_Double maxAge, UA_DataValue *v) {
+    UA_CachedValue *cv =
+        findCachedValue(vc, nodeId, sessionId, UA_NodeId_hash(nodeId));
+    if(!cv)
+        return false;
+
+    /* Too old. Remove right away. */
+    UA_DateTime age = UA_DateTime_nowMonotonic() - cv->readTime;
+    if(age > (UA_DateTime)(maxAge * UA_DATETIME_MSEC)) {
+        removeCachedValue(vc, cv);
+        return false;
+    }
+
+    if(!v)
+        return true;
+    if(UA_DataValue_copy(&cv->value, v) != UA_STATUSCODE_GOOD)
+        return false;
+
+    /* Move to the end of the LRU list */
+    TAILQ_REMOVE(&vc->lru, cv, lruEntry);
+    TAILQ_INSERT_TAIL(&vc->lru, cv, lruEntry);
+    return true;
+}
+
+void
+UA_ValueCache_put(UA_ValueCache *vc, size_t maxMemory,
+                  const UA_NodeId *nodeId, const UA_NodeId *sessionId,
+                  const UA_DataValue *v) {
+    /* Remove the previous entry */
+    UA_UInt32 hash = UA_NodeId_hash(nodeId);
+    UA_CachedValue *cv = findCachedValue(vc, nodeId, sessionId, hash);
+    if(cv)
+        removeCachedValue(vc, cv);
+
+    /* Make a copy */
+    cv = (UA_CachedValue*)UA_calloc(1, sizeof(UA_CachedValue));
+    if(!cv)
+        return;
+    UA_StatusCode res = UA_NodeId_copy(nodeId, &cv->nodeId);
+    res |= UA_NodeId_copy(sessionId, &cv->sessionId);
+    res |= UA_DataValue_copy(v, &cv->value);
+    cv->memory = cachedValueMemory(cv);
+    if(res != UA_STATUSCODE_GOOD || cv->memory > maxMemory ||
+       (vc->count >= vc->bucketsSize && growValueCache(vc) != UA_STATUSCODE_GOOD)) {
+        UA_NodeId_clear(&cv->nodeId);
+        UA_NodeId_clear(&cv->sessionId);
+        UA_DataValue_clear(&cv->value);
+        UA_free(cv);
+        return;
+    }
+    cv->nodeIdHash = hash;
+    cv->readTime = UA_DateTime_nowMonotonic();
+
+    /* Evict the least recently used entries */
+    while(vc->memory + cv->memory > maxMemory)
+        removeCachedValue(vc, TAILQ_FIRST(&vc->lru));
+
+    /* Insert */
+    size_t b = hash & (vc->bucketsSize - 1);
+    cv->next = vc->buckets[b];
+    vc->buckets[b] = cv;
+    TAILQ_INSERT_TAIL(&vc->lru, cv, lruEntry);
+    vc->count++;
+    vc->memory += cv->memory;
+}
+
+void
+UA_ValueCache_remove(UA_ValueCache *vc, const UA_NodeId *nodeId) {
+    if(vc->count == 0)
+        return;
+    /* Remove the entries of all sessions. They are in the same bucket. */
+    UA_UInt32 hash = UA_NodeId_hash(nodeId);
+    UA_CachedValue *cv = vc->buckets[hash & (vc->bucketsSize - 1)];
+    while(cv) {
+        UA_CachedValue *next = cv->next;
+        if(cv->nodeIdHash == hash && UA_NodeId_equal(&cv->nodeId, nodeId))
+            removeCachedValue(vc, cv);
+        cv = next;
+    }
+}
+
+void
+UA_ValueCache_removeSession(UA_ValueCache *vc, const UA_NodeId *sessionId) {
+    UA_CachedValue *cv, *cv_tmp;
+    TAILQ_FOREACH_SAFE(cv, &vc->lru, lruEntry, cv_tmp) {
+        if(UA_NodeId_equal(&cv->sessionId, sessionId))
+            removeCachedValue(vc, cv);
+    }
+}
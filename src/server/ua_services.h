@@ -312,6 +312,12 @@ void Service_Read(UA_Server *server, UA_Session *session,
                   const UA_ReadRequest *request,
                   UA_ReadResponse *response);
 
+#if UA_MULTITHREADING >= 100
+void Service_ReadAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                       const UA_ReadRequest *request, UA_ReadResponse *response,
+                       UA_Boolean *finished);
+#endif
+
 /**
  * Write Service
  * ^^^^^^^^^^^^^
@@ -323,6 +329,12 @@ void Service_Write(UA_Server *server, UA_Session *session,
                    const UA_WriteRequest *request,
                    UA_WriteResponse *response);
 
+#if UA_MULTITHREADING >= 100
+void Service_WriteAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                        const UA_WriteRequest *request, UA_WriteResponse *response,
+                        UA_Boolean *finished);
+#endif
+
 /**
  * HistoryRead Service
  * ^^^^^^^^^^^^^^^^^^^
@@ -186,38 +186,112 @@ readValueAttributeFromNode(UA_Server *server, UA_Session *session,
     return retval;
 }
 
+/* Take over the value returned from a DataSource. Zero-copy values are
+ * copied. */
+static UA_StatusCode
+moveDataSourceValue(UA_DataValue *src, UA_DataValue *dst) {
+    if(src->hasValue && src->value.storageType == UA_VARIANT_DATA_NODELETE) {
+        UA_StatusCode retval = UA_DataValue_copy(src, dst);
+        UA_DataValue_clear(src);
+        return retval;
+    }
+    *dst = *src;
+    UA_DataValue_init(src);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* The value cache is used for reads of the full value with a maxAge */
+static UA_Boolean
+useValueCache(UA_Server *server, UA_Double maxAge, const UA_NumericRange *range) {
+    return (maxAge > 0.0 && !range && server->config.maxValueCacheSize > 0);
+}
+
+/* Cached values are shared between sessions. Unless the DataSource returns
+ * session-specific values. Then they are only reused within the same
+ * session. */
+static const UA_NodeId *
+cacheSessionId(const UA_VariableNode *vn, const UA_Session *session) {
+    if(!session || vn->head.nodeClass != UA_NODECLASS_VARIABLE ||
+       !vn->sessionSpecificValue)
+        return &UA_NODEID_NULL;
+    return &session->sessionId;
+}
+
+static void
+cacheDataSourceValue(UA_Server *server, UA_Session *session,
+                     const UA_VariableNode *vn, UA_DataValue *v) {
+    if(v->hasStatus && UA_StatusCode_isBad(v->status))
+        return;
+    if(!v->hasSourceTimestamp) {
+        v->sourceTimestamp = UA_DateTime_now();
+        v->hasSourceTimestamp = true;
+    }
+    UA_ValueCache_put(&server->valueCache, server->config.maxValueCacheSize,
+                      &vn->head.nodeId, cacheSessionId(vn, session), v);
+}
+
 static UA_StatusCode
 readValueAttributeFromDataSource(UA_Server *server, UA_Session *session,
                                  const UA_VariableNode *vn, UA_DataValue *v,
                                  UA_TimestampsToReturn timestamps,
-                                 UA_NumericRange *rangeptr) {
-    if(!vn->value.dataSource.read)
+                                 UA_NumericRange *rangeptr, UA_Double maxAge) {
+    const UA_DataSource *ds = &vn->value.dataSource;
+    UA_DataSourceReadBatch readBatch =
+        (vn->head.nodeClass == UA_NODECLASS_VARIABLE) ? vn->readBatch : NULL;
+    if(!ds->read && !readBatch)
         return UA_STATUSCODE_BADINTERNALERROR;
-    UA_Boolean sourceTimeStamp = (timestamps == UA_TIMESTAMPSTORETURN_SOURCE ||
+
+    /* Serve from the cache. Cached values always have the source timestamp. */
+    UA_Boolean cache = useValueCache(server, maxAge, rangeptr);
+    if(cache && UA_ValueCache_get(&server->valueCache, &vn->head.nodeId,
+                                  cacheSessionId(vn, session), maxAge, v))
+        return UA_STATUSCODE_GOOD;
+
+    UA_Boolean sourceTimeStamp = (cache ||
+                                  timestamps == UA_TIMESTAMPSTORETURN_SOURCE ||
                                   timestamps == UA_TIMESTAMPSTORETURN_BOTH);
     UA_DataValue v2;
     UA_DataValue_init(&v2);
+    UA_StatusCode retval;
     UA_UNLOCK(&server->serviceMutex);
-    UA_StatusCode retval = vn->value.dataSource.
-        read(server,
-             session ? &session->sessionId : NULL,
-             session ? session->sessionHandle : NULL,
-             &vn->head.nodeId, vn->head.context,
-             sourceTimeStamp, rangeptr, &v2);
-    UA_LOCK(&server->serviceMutex);
-    if(v2.hasValue && v2.value.storageType == UA_VARIANT_DATA_NODELETE) {
-        retval = UA_DataValue_copy(&v2, v);
-        UA_DataValue_clear(&v2);
+    if(ds->read) {
+        retval = ds->read(server,
+                          session ? &session->sessionId : NULL,
+                          session ? session->sessionHandle : NULL,
+                          &vn->head.nodeId, vn->head.context,
+                          sourceTimeStamp, rangeptr, &v2);
     } else {
-        *v = v2;
+        /* Batch of a single value */
+        UA_DataSourceReadItem item = {&vn->head.nodeId, vn->head.context, rangeptr};
+        retval = readBatch(server,
+                           session ? &session->sessionId : NULL,
+                           session ? session->sessionHandle : NULL,
+                           1, &item, sourceTimeStamp, &v2);
     }
-    return retval;
+    UA_LOCK(&server->serviceMutex);
+    UA_StatusCode res = moveDataSourceValue(&v2, v);
+    if(retval != UA_STATUSCODE_GOOD)
+        return retval;
+    if(cache && res == UA_STATUSCODE_GOOD)
+        cacheDataSourceValue(server, session, vn, v);
+    return res;
+}
+
+/* Static Variables and VariableTypes have timestamps of "now". Will be set
+ * in ReadWithNode in the absence of predefined timestamps. */
+static void
+clearStaticTimestamps(const UA_VariableNode *vn, UA_DataValue *v) {
+    if(vn->head.nodeClass == UA_NODECLASS_VARIABLE && vn->isDynamic)
+        return;
+    v->hasServerTimestamp = false;
+    v->hasSourceTimestamp = false;
 }
 
 static UA_StatusCode
 readValueAttributeComplete(UA_Server *server, UA_Session *session,
                            const UA_VariableNode *vn, UA_TimestampsToReturn timestamps,
-                           const UA_String *indexRange, UA_DataValue *v) {
+                           UA_Double maxAge, const UA_String *indexRange,
+                           UA_DataValue *v) {
     /* Compute the index range */
     UA_NumericRange range;
     UA_NumericRange *rangeptr = NULL;
@@ -236,7 +310,7 @@ readValueAttributeComplete(UA_Server *server, UA_Session *session,
             break;
         case UA_VALUEBACKENDTYPE_DATA_SOURCE_CALLBACK:
             retval = readValueAttributeFromDataSource(server, session, vn, v,
-                                                      timestamps, rangeptr);
+                                                      timestamps, rangeptr, maxAge);
             //TODO change old structure to value backend
             break;
         case UA_VALUEBACKENDTYPE_EXTERNAL:
@@ -265,22 +339,12 @@ readValueAttributeComplete(UA_Server *server, UA_Session *session,
                 retval = readValueAttributeFromNode(server, session, vn, v, rangeptr);
             else
                 retval = readValueAttributeFromDataSource(server, session, vn, v,
-                                                          timestamps, rangeptr);
+                                                          timestamps, rangeptr, maxAge);
             /* end lagacy */
             break;
     }
 
-    /* Static Variables and VariableTypes have timestamps of "now". Will be set
-     * below in the absence of predefined timestamps. */
-    if(vn->head.nodeClass == UA_NODECLASS_VARIABLE) {
-        if(!vn->isDynamic) {
-            v->hasServerTimestamp = false;
-            v->hasSourceTimestamp = false;
-        }
-    } else {
-        v->hasServerTimestamp = false;
-        v->hasSourceTimestamp = false;
-    }
+    clearStaticTimestamps(vn, v);
 
     /* Clean up */
     if(rangeptr)
@@ -292,7 +356,7 @@ UA_StatusCode
 readValueAttribute(UA_Server *server, UA_Session *session,
                    const UA_VariableNode *vn, UA_DataValue *v) {
     return readValueAttributeComplete(server, session, vn,
-                                      UA_TIMESTAMPSTORETURN_NEITHER, NULL, v);
+                                      UA_TIMESTAMPSTORETURN_NEITHER, 0.0, NULL, v);
 }
 
 static const UA_String binEncoding = {sizeof("Default Binary")-1, (UA_Byte*)"Default Binary"};
@@ -371,12 +435,48 @@ getStructureDefinition(const UA_DataType *type, UA_StructureDefinition *def) {
 }
 #endif
 
+void
+finishRead(UA_TimestampsToReturn timestampsToReturn, UA_UInt32 attributeId,
+           UA_StatusCode retval, UA_DataValue *v) {
+    if(retval != UA_STATUSCODE_GOOD) {
+        /* Reading has failed but can not return because we may need to add timestamp */
+        v->hasStatus = true;
+        v->status = retval;
+    } else {
+        v->hasValue = true;
+    }
+
+    /* Create server timestamp */
+    if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
+       timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH) {
+        if(!v->hasServerTimestamp) {
+            v->serverTimestamp = UA_DateTime_now();
+            v->hasServerTimestamp = true;
+        }
+    } else {
+        /* In case the ServerTimestamp has been set manually */
+        v->hasServerTimestamp = false;
+    }
+
+    /* Handle source time stamp */
+    if(attributeId == UA_ATTRIBUTEID_VALUE) {
+        if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
+           timestampsToReturn == UA_TIMESTAMPSTORETURN_NEITHER) {
+            v->hasSourceTimestamp = false;
+            v->hasSourcePicoseconds = false;
+        } else if(!v->hasSourceTimestamp) {
+            v->sourceTimestamp = UA_DateTime_now();
+            v->hasSourceTimestamp = true;
+        }
+    }
+}
+
 /* Returns a datavalue that may point into the node via the
  * UA_VARIANT_DATA_NODELETE tag. Don't access the returned DataValue once the
  * node has been released! */
 void
 ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
-             UA_TimestampsToReturn timestampsToReturn,
+             UA_TimestampsToReturn timestampsToReturn, UA_Double maxAge,
              const UA_ReadValueId *id, UA_DataValue *v) {
     UA_LOG_NODEID_DEBUG(&node->head.nodeId,
                         UA_LOG_DEBUG_SESSION(&server->config.logger, session,
@@ -486,7 +586,8 @@ ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
             }
         }
         retval = readValueAttributeComplete(server, session, &node->variableNode,
-                                            timestampsToReturn, &id->indexRange, v);
+                                            timestampsToReturn, maxAge,
+                                            &id->indexRange, v);
         break;
     }
     case UA_ATTRIBUTEID_DATATYPE:
@@ -569,62 +670,200 @@ ReadWithNode(const UA_Node *node, UA_Server *server, UA_Session *session,
         retval = UA_STATUSCODE_BADATTRIBUTEIDINVALID;
     }
 
-    if(retval != UA_STATUSCODE_GOOD) {
-        /* Reading has failed but can not return because we may need to add timestamp */
-        v->hasStatus = true;
-        v->status = retval;
-    } else {
-        v->hasValue = true;
-    }
+    finishRead(timestampsToReturn, id->attributeId, retval, v);
+}
 
-    /* Create server timestamp */
-    if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
-       timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH) {
-        if(!v->hasServerTimestamp) {
-            v->serverTimestamp = UA_DateTime_now();
-            v->hasServerTimestamp = true;
+/* Value read that is deferred to a batched DataSource read */
+typedef struct {
+    const UA_Node *node; /* Released after the batch was read */
+    UA_DataValue *result;
+    UA_NumericRange range;
+    UA_Boolean hasRange;
+    UA_Boolean cache; /* Add the result to the value cache */
+} DeferredRead;
+
+/* Prepare the deferred read if the value comes from a DataSource with a batch
+ * read method. Otherwise (also for all error cases) the value is read
+ * individually. */
+static UA_Boolean
+deferValueRead(UA_Server *server, UA_Session *session, const UA_Node *node,
+               const UA_ReadValueId *rvi, UA_Double maxAge, DeferredRead *dr) {
+    if(rvi->attributeId != UA_ATTRIBUTEID_VALUE ||
+       node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return false;
+    if(rvi->dataEncoding.name.length > 0 &&
+       !UA_String_equal(&binEncoding, &rvi->dataEncoding.name))
+        return false;
+
+    /* Batching is supported for the DataSource? */
+    const UA_VariableNode *vn = &node->variableNode;
+    UA_ValueBackendType backend = vn->valueBackend.backendType;
+    if(backend != UA_VALUEBACKENDTYPE_DATA_SOURCE_CALLBACK &&
+       (backend != UA_VALUEBACKENDTYPE_NONE ||
+        vn->valueSource != UA_VALUESOURCE_DATASOURCE))
+        return false;
+    if(!vn->readBatch)
+        return false;
+
+    /* Check the access rights */
+    if(!(getAccessLevel(server, session, vn) & UA_ACCESSLEVELMASK_READ) ||
+       !(getUserAccessLevel(server, session, vn) & UA_ACCESSLEVELMASK_READ))
+        return false;
+
+    /* Recent cached values are read individually */
+    dr->hasRange = (rvi->indexRange.length > 0);
+    dr->cache = (!dr->hasRange && useValueCache(server, maxAge, NULL));
+    if(dr->cache && UA_ValueCache_get(&server->valueCache, &node->head.nodeId,
+                                      cacheSessionId(vn, session), maxAge, NULL))
+        return false;
+
+    /* Parse the index range */
+    if(dr->hasRange &&
+       UA_NumericRange_parse(&dr->range, rvi->indexRange) != UA_STATUSCODE_GOOD)
+        return false;
+
+    dr->node = node;
+    return true;
+}
+
+/* Call the batch read method once for all deferred reads from DataSources that
+ * share the method. The service mutex is released during the call. */
+static void
+readDeferredValues(UA_Server *server, UA_Session *session,
+                   UA_TimestampsToReturn timestampsToReturn, UA_Double maxAge,
+                   DeferredRead *deferred, size_t deferredSize) {
+    if(deferredSize == 0)
+        return;
+    UA_Boolean sourceTimeStamp =
+        (useValueCache(server, maxAge, NULL) ||
+         timestampsToReturn == UA_TIMESTAMPSTORETURN_SOURCE ||
+         timestampsToReturn == UA_TIMESTAMPSTORETURN_BOTH);
+    UA_DataSourceReadItem *items = (UA_DataSourceReadItem*)
+        UA_malloc(deferredSize * sizeof(UA_DataSourceReadItem));
+    UA_DataValue *values = (UA_DataValue*)
+        UA_malloc(deferredSize * sizeof(UA_DataValue));
+    size_t *batch = (size_t*)UA_malloc(deferredSize * sizeof(size_t));
+
+    for(size_t i = 0; i < deferredSize; i++) {
+        if(!deferred[i].node)
+            continue; /* Already read in a previous batch */
+
+        /* Collect all reads with the same batch read method */
+        size_t batchSize = 0;
+        UA_StatusCode retval = UA_STATUSCODE_BADOUTOFMEMORY;
+        UA_DataSourceReadBatch readBatch = deferred[i].node->variableNode.readBatch;
+        for(size_t j = i; j < deferredSize; j++) {
+            DeferredRead *dr = &deferred[j];
+            if(!dr->node || dr->node->variableNode.readBatch != readBatch)
+                continue;
+            if(items && values && batch) {
+                items[batchSize].nodeId = &dr->node->head.nodeId;
+                items[batchSize].nodeContext = dr->node->head.context;
+                items[batchSize].range = (dr->hasRange) ? &dr->range : NULL;
+                UA_DataValue_init(&values[batchSize]);
+                batch[batchSize] = j;
+                batchSize++;
+                continue;
+            }
+            /* Out of memory. Finish every read on its own. */
+            finishRead(timestampsToReturn, UA_ATTRIBUTEID_VALUE, retval, dr->result);
+            if(dr->hasRange)
+                UA_free(dr->range.dimensions);
+            UA_NODESTORE_RELEASE(server, dr->node);
+            dr->node = NULL;
         }
-    } else {
-        /* In case the ServerTimestamp has been set manually */
-        v->hasServerTimestamp = false;
-    }
+        if(batchSize == 0)
+            continue;
 
-    /* Handle source time stamp */
-    if(id->attributeId == UA_ATTRIBUTEID_VALUE) {
-        if(timestampsToReturn == UA_TIMESTAMPSTORETURN_SERVER ||
-           timestampsToReturn == UA_TIMESTAMPSTORETURN_NEITHER) {
-            v->hasSourceTimestamp = false;
-            v->hasSourcePicoseconds = false;
-        } else if(!v->hasSourceTimestamp) {
-            v->sourceTimestamp = UA_DateTime_now();
-            v->hasSourceTimestamp = true;
+        /* Read the batch */
+        UA_UNLOCK(&server->serviceMutex);
+        retval = readBatch(server,
+                           session ? &session->sessionId : NULL,
+                           session ? session->sessionHandle : NULL,
+                           batchSize, items, sourceTimeStamp, values);
+        UA_LOCK(&server->serviceMutex);
+
+        /* Set the results */
+        for(size_t k = 0; k < batchSize; k++) {
+            DeferredRead *dr = &deferred[batch[k]];
+            UA_StatusCode res = retval;
+            if(retval == UA_STATUSCODE_GOOD)
+                res = moveDataSourceValue(&values[k], dr->result);
+            else
+                UA_DataValue_clear(&values[k]);
+            if(dr->cache && res == UA_STATUSCODE_GOOD)
+                cacheDataSourceValue(server, session, &dr->node->variableNode,
+                                     dr->result);
+            clearStaticTimestamps(&dr->node->variableNode, dr->result);
+            finishRead(timestampsToReturn, UA_ATTRIBUTEID_VALUE, res, dr->result);
+            if(dr->hasRange)
+                UA_free(dr->range.dimensions);
+            UA_NODESTORE_RELEASE(server, dr->node);
+            dr->node = NULL;
         }
     }
+
+    UA_free(items);
+    UA_free(values);
+    UA_free(batch);
 }
 
-static void
-Operation_Read(UA_Server *server, UA_Session *session, UA_ReadRequest *request,
-               UA_ReadValueId *rvi, UA_DataValue *result) {
-    /* Get the node (with only the selected attribute if the NodeStore supports that) */
-    const UA_Node *node =
-        UA_NODESTORE_GET_SELECTIVE(server, &rvi->nodeId,
-                                   attributeId2AttributeMask((UA_AttributeId)rvi->attributeId),
-                                   UA_REFERENCETYPESET_NONE,
-                                   UA_BROWSEDIRECTION_INVALID);
+#if UA_MULTITHREADING >= 100
 
-    /* Perform the read operation */
-    if(node) {
-        ReadWithNode(node, server, session, request->timestampsToReturn, rvi, result);
-        UA_NODESTORE_RELEASE(server, node);
-    } else {
+/* Dispatch reading the value of an async variable to the workers. Returns
+ * false if the value is read right away. Access errors and recent cached
+ * values are also handled right away. */
+static UA_Boolean
+readValueAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+               const UA_ReadRequest *request, size_t opIndex,
+               const UA_Node *node, UA_DataValue *result, UA_AsyncResponse **ar) {
+    const UA_ReadValueId *rvi = &request->nodesToRead[opIndex];
+    if(rvi->attributeId != UA_ATTRIBUTEID_VALUE ||
+       node->head.nodeClass != UA_NODECLASS_VARIABLE ||
+       !node->variableNode.async)
+        return false;
+
+    const UA_VariableNode *vn = &node->variableNode;
+    if(!(getAccessLevel(server, session, vn) & UA_ACCESSLEVELMASK_READ) ||
+       !(getUserAccessLevel(server, session, vn) & UA_ACCESSLEVELMASK_READ))
+        return false;
+    if(rvi->indexRange.length == 0 &&
+       useValueCache(server, request->maxAge, NULL) &&
+       UA_ValueCache_get(&server->valueCache, &node->head.nodeId,
+                         cacheSessionId(vn, session), request->maxAge, NULL))
+        return false;
+
+    /* No AsyncResponse allocated so far */
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(!*ar) {
+        res = UA_AsyncManager_createAsyncResponse(&server->asyncManager, server,
+                                                  &session->sessionId, requestId,
+                                                  request->requestHeader.requestHandle,
+                                                  UA_ASYNCOPERATIONTYPE_READ, ar);
+        if(res != UA_STATUSCODE_GOOD)
+            goto out;
+        (*ar)->timestampsToReturn = request->timestampsToReturn;
+    }
+
+    /* Create the async operation to be taken by the workers */
+    res = UA_AsyncManager_createAsyncOp(&server->asyncManager, server, *ar,
+                                        opIndex, rvi, !vn->isDynamic);
+
+ out:
+    if(res != UA_STATUSCODE_GOOD) {
         result->hasStatus = true;
-        result->status = UA_STATUSCODE_BADNODEIDUNKNOWN;
+        result->status = res;
     }
+    return true;
 }
 
-void
-Service_Read(UA_Server *server, UA_Session *session,
-             const UA_ReadRequest *request, UA_ReadResponse *response) {
+#endif
+
+/* Values of async variables are read by the workers if ar is non-NULL */
+static void
+readService(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+            const UA_ReadRequest *request, UA_ReadResponse *response,
+            UA_AsyncResponse **ar) {
     UA_LOG_DEBUG_SESSION(&server->config.logger, session, "Processing ReadRequest");
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
@@ -649,19 +888,91 @@ Service_Read(UA_Server *server, UA_Session *session,
 
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
-    response->responseHeader.serviceResult =
-        UA_Server_processServiceOperations(server, session,
-                                           (UA_ServiceOperation)Operation_Read,
-                                           request, &request->nodesToReadSize,
-                                           &UA_TYPES[UA_TYPES_READVALUEID],
-                                           &response->resultsSize,
-                                           &UA_TYPES[UA_TYPES_DATAVALUE]);
+    size_t ops = request->nodesToReadSize;
+    if(ops == 0) {
+        response->responseHeader.serviceResult = UA_STATUSCODE_BADNOTHINGTODO;
+        return;
+    }
+    response->results = (UA_DataValue*)UA_Array_new(ops, &UA_TYPES[UA_TYPES_DATAVALUE]);
+    if(!response->results) {
+        response->responseHeader.serviceResult = UA_STATUSCODE_BADOUTOFMEMORY;
+        return;
+    }
+    response->resultsSize = ops;
+
+    /* Values from DataSources with a batch read method are read after all
+     * other operations. Without memory for the deferred reads, every value is
+     * read on its own. */
+    DeferredRead *deferred = NULL;
+    size_t deferredSize = 0;
+    if(ops > 1)
+        deferred = (DeferredRead*)UA_malloc(ops * sizeof(DeferredRead));
+
+    for(size_t i = 0; i < ops; i++) {
+        UA_ReadValueId *rvi = &request->nodesToRead[i];
+        UA_DataValue *result = &response->results[i];
+
+        /* Get the node (with only the selected attribute if the NodeStore
+         * supports that) */
+        const UA_Node *node =
+            UA_NODESTORE_GET_SELECTIVE(server, &rvi->nodeId,
+                                       attributeId2AttributeMask((UA_AttributeId)rvi->attributeId),
+                                       UA_REFERENCETYPESET_NONE,
+                                       UA_BROWSEDIRECTION_INVALID);
+        if(!node) {
+            result->hasStatus = true;
+            result->status = UA_STATUSCODE_BADNODEIDUNKNOWN;
+            continue;
+        }
+
+#if UA_MULTITHREADING >= 100
+        if(ar && readValueAsync(server, session, requestId, request,
+                                i, node, result, ar)) {
+            UA_NODESTORE_RELEASE(server, node);
+            continue;
+        }
+#endif
+
+        if(deferred && deferValueRead(server, session, node, rvi, request->maxAge,
+                                      &deferred[deferredSize])) {
+            deferred[deferredSize].result = result;
+            deferredSize++;
+            continue;
+        }
+
+        ReadWithNode(node, server, session, request->timestampsToReturn,
+                     request->maxAge, rvi, result);
+        UA_NODESTORE_RELEASE(server, node);
+    }
+
+    readDeferredValues(server, session, request->timestampsToReturn,
+                       request->maxAge, deferred, deferredSize);
+    UA_free(deferred);
+}
+
+void
+Service_Read(UA_Server *server, UA_Session *session,
+             const UA_ReadRequest *request, UA_ReadResponse *response) {
+    readService(server, session, 0, request, response, NULL);
+}
+
+#if UA_MULTITHREADING >= 100
+void
+Service_ReadAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                  const UA_ReadRequest *request, UA_ReadResponse *response,
+                  UA_Boolean *finished) {
+    UA_AsyncResponse *ar = NULL;
+    readService(server, session, requestId, request, response, &ar);
+    if(ar)
+        UA_AsyncManager_takeResponse(&server->asyncManager, ar, response, finished);
 }
+#endif
 
 UA_DataValue
 UA_Server_readWithSession(UA_Server *server, UA_Session *session,
                           const UA_ReadValueId *item,
-                          UA_TimestampsToReturn timestampsToReturn) {
+                          UA_TimestampsToReturn timestampsToReturn,
+                          UA_Double maxAge) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
     UA_DataValue dv;
@@ -680,7 +991,7 @@ UA_Server_readWithSession(UA_Server *server, UA_Session *session,
     }
 
     /* Perform the read operation */
-    ReadWithNode(node, server, session, timestampsToReturn, item, &dv);
+    ReadWithNode(node, server, session, timestampsToReturn, maxAge, item, &dv);
 
     /* Release the node and return */
     UA_NODESTORE_RELEASE(server, node);
@@ -691,7 +1002,7 @@ UA_DataValue
 readAttribute(UA_Server *server, const UA_ReadValueId *item,
                UA_TimestampsToReturn timestamps) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
-    return UA_Server_readWithSession(server, &server->adminSession, item, timestamps);
+    return UA_Server_readWithSession(server, &server->adminSession, item, timestamps, 0.0);
 }
 
 UA_StatusCode
@@ -1618,15 +1929,53 @@ updateLocalizedText(const UA_LocalizedText *source, UA_LocalizedText *target) {
 /* Trigger sampling if a MonitoredItem surveils the attribute with no sampling
  * interval */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
+
+/* Test whether a MonitoredItem with an IndexRange can see the elements written
+ * with an IndexRange. Only the dimensions that are part of both ranges are
+ * compared. If a range cannot be parsed, assume an overlap. */
+static UA_Boolean
+writeRangeOverlaps(const UA_NumericRange *written, const UA_String *monRange) {
+    if(!written || monRange->length == 0)
+        return true;
+    UA_NumericRange range;
+    if(UA_NumericRange_parse(&range, *monRange) != UA_STATUSCODE_GOOD)
+        return true;
+    size_t dims = (written->dimensionsSize < range.dimensionsSize) ?
+        written->dimensionsSize : range.dimensionsSize;
+    UA_Boolean overlap = true;
+    for(size_t i = 0; i < dims; i++) {
+        if(written->dimensions[i].max < range.dimensions[i].min ||
+           range.dimensions[i].max < written->dimensions[i].min) {
+            overlap = false;
+            break;
+        }
+    }
+    UA_free(range.dimensions);
+    return overlap;
+}
+
 static void
 triggerImmediateDataChange(UA_Server *server, UA_Session *session,
                            UA_Node *node, const UA_WriteValue *wvalue) {
+    /* A write with an IndexRange changes only part of the value. Skip the
+     * MonitoredItems that surveil a different part of the array. */
+    UA_NumericRange written;
+    UA_NumericRange *writtenptr = NULL;
+    if(wvalue->attributeId == UA_ATTRIBUTEID_VALUE && wvalue->indexRange.length > 0 &&
+       UA_NumericRange_parse(&written, wvalue->indexRange) == UA_STATUSCODE_GOOD)
+        writtenptr = &written;
+
     for(UA_MonitoredItem *mon = node->head.monitoredItems; mon != NULL; mon = mon->next) {
         if(mon->itemToMonitor.attributeId != wvalue->attributeId)
             continue;
+        if(!writeRangeOverlaps(writtenptr, &mon->itemToMonitor.indexRange))
+            continue;
+        /* The sampling interval limits the rate of the samples */
+        if(!UA_MonitoredItem_rateLimit(server, mon))
+            continue;
         UA_DataValue value;
         UA_DataValue_init(&value);
-        ReadWithNode(node, server, session, mon->timestampsToReturn,
+        ReadWithNode(node, server, session, mon->timestampsToReturn, 0.0,
                      &mon->itemToMonitor, &value);
         UA_Subscription *sub = mon->subscription;
         UA_StatusCode res = sampleCallbackWithValue(server, sub, mon, &value);
@@ -1639,6 +1988,9 @@ triggerImmediateDataChange(UA_Server *server, UA_Session *session,
                                         UA_StatusCode_name(res));
         }
     }
+
+    if(writtenptr)
+        UA_free(written.dimensions);
 }
 #endif
 
@@ -1807,7 +2159,7 @@ copyAttributeIntoNode(UA_Server *server, UA_Session *session,
         return retval;
     }
 
-    /* Trigger MonitoredItems with no SamplingInterval */
+    /* Trigger the MonitoredItems attached to the node */
 #ifdef UA_ENABLE_SUBSCRIPTIONS
     triggerImmediateDataChange(server, session, node, wvalue);
 #endif
@@ -1822,8 +2174,95 @@ Operation_Write(UA_Server *server, UA_Session *session, void *context,
     *result = UA_Server_editNode(server, session, &wv->nodeId,
                                  (UA_EditNodeCallback)copyAttributeIntoNode,
                                  (void*)(uintptr_t)wv);
+
+    /* Invalidate the cached value. Also if the write has failed, as the
+     * DataSource might have been changed partially. Other attributes (e.g. the
+     * BrowseName) can be part of cached Browse results. */
+    if(wv->attributeId == UA_ATTRIBUTEID_VALUE)
+        UA_ValueCache_remove(&server->valueCache, &wv->nodeId);
+    else if(*result == UA_STATUSCODE_GOOD)
+        UA_BrowseCache_invalidate(&server->browseCache, &wv->nodeId);
+}
+
+#if UA_MULTITHREADING >= 100
+
+/* Dispatch writing the value of an async variable to the workers. Returns
+ * false if the value is written right away. */
+static UA_Boolean
+writeValueAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                UA_UInt32 requestHandle, size_t opIndex,
+                const UA_WriteValue *wv, UA_StatusCode *result,
+                UA_AsyncResponse **ar) {
+    if(wv->attributeId != UA_ATTRIBUTEID_VALUE)
+        return false;
+    const UA_Node *node = UA_NODESTORE_GET(server, &wv->nodeId);
+    if(!node)
+        return false;
+    UA_Boolean async = (node->head.nodeClass == UA_NODECLASS_VARIABLE &&
+                        node->variableNode.async &&
+                        (getAccessLevel(server, session, &node->variableNode) &
+                         UA_ACCESSLEVELMASK_WRITE) &&
+                        (getUserAccessLevel(server, session, &node->variableNode) &
+                         UA_ACCESSLEVELMASK_WRITE));
+    UA_NODESTORE_RELEASE(server, node);
+    if(!async)
+        return false;
+
+    UA_ValueCache_remove(&server->valueCache, &wv->nodeId);
+
+    /* No AsyncResponse allocated so far */
+    if(!*ar) {
+        *result = UA_AsyncManager_createAsyncResponse(&server->asyncManager, server,
+                                                      &session->sessionId, requestId,
+                                                      requestHandle,
+                                                      UA_ASYNCOPERATIONTYPE_WRITE, ar);
+        if(*result != UA_STATUSCODE_GOOD)
+            return true;
+    }
+
+    /* Create the async operation to be taken by the workers */
+    *result = UA_AsyncManager_createAsyncOp(&server->asyncManager, server,
+                                            *ar, opIndex, wv, false);
+    return true;
+}
+
+static void
+Operation_WriteAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                     UA_UInt32 requestHandle, size_t opIndex,
+                     const UA_WriteValue *wv, UA_StatusCode *result,
+                     UA_AsyncResponse **ar) {
+    if(!writeValueAsync(server, session, requestId, requestHandle,
+                        opIndex, wv, result, ar))
+        Operation_Write(server, session, NULL, wv, result);
 }
 
+void
+Service_WriteAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
+                   const UA_WriteRequest *request, UA_WriteResponse *response,
+                   UA_Boolean *finished) {
+    UA_LOG_DEBUG_SESSION(&server->config.logger, session,
+                         "Processing WriteRequestAsync");
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    if(server->config.maxNodesPerWrite != 0 &&
+       request->nodesToWriteSize > server->config.maxNodesPerWrite) {
+        response->responseHeader.serviceResult = UA_STATUSCODE_BADTOOMANYOPERATIONS;
+        return;
+    }
+
+    UA_AsyncResponse *ar = NULL;
+    response->responseHeader.serviceResult =
+        UA_Server_processServiceOperationsAsync(server, session, requestId,
+                  request->requestHeader.requestHandle,
+                  (UA_AsyncServiceOperation)Operation_WriteAsync,
+                  &request->nodesToWriteSize, &UA_TYPES[UA_TYPES_WRITEVALUE],
+                  &response->resultsSize, &UA_TYPES[UA_TYPES_STATUSCODE], &ar);
+    if(ar)
+        UA_AsyncManager_takeResponse(&server->asyncManager, ar, response, finished);
+}
+
+#endif
+
 void
 Service_Write(UA_Server *server, UA_Session *session,
               const UA_WriteRequest *request,
@@ -1851,10 +2290,19 @@ Service_Write(UA_Server *server, UA_Session *session,
 }
 
 UA_StatusCode
-UA_Server_write(UA_Server *server, const UA_WriteValue *value) {
+UA_Server_writeWithSession(UA_Server *server, UA_Session *session,
+                           const UA_WriteValue *value) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
     UA_StatusCode res = UA_STATUSCODE_GOOD;
+    Operation_Write(server, session, NULL, value, &res);
+    return res;
+}
+
+UA_StatusCode
+UA_Server_write(UA_Server *server, const UA_WriteValue *value) {
     UA_LOCK(&server->serviceMutex);
-    Operation_Write(server, &server->adminSession, NULL, value, &res);
+    UA_StatusCode res =
+        UA_Server_writeWithSession(server, &server->adminSession, value);
     UA_UNLOCK(&server->serviceMutex);
     return res;
 }
@@ -402,7 +402,7 @@ Operation_CallMethodAsync(UA_Server *server, UA_Session *session, UA_UInt32 requ
     /* Create the Async Request to be taken by workers */
     opResult->statusCode =
         UA_AsyncManager_createAsyncOp(&server->asyncManager,
-                                      server, *ar, opIndex, opRequest);
+                                      server, *ar, opIndex, opRequest, false);
 
  cleanup:
     /* Release the method and object node */
@@ -429,19 +429,8 @@ Service_CallAsync(UA_Server *server, UA_Session *session, UA_UInt32 requestId,
                   &request->methodsToCallSize, &UA_TYPES[UA_TYPES_CALLMETHODREQUEST],
                   &response->resultsSize, &UA_TYPES[UA_TYPES_CALLMETHODRESULT], &ar);
 
-    if(ar) {
-        if(ar->opCountdown > 0) {
-            /* Move all results to the AsyncResponse. The async operation
-             * results will be overwritten when the workers return results. */
-            ar->response.callResponse = *response;
-            UA_CallResponse_init(response);
-            *finished = false;
-        } else {
-            /* If there is a new AsyncResponse, ensure it has at least one
-             * pending operation */
-            UA_AsyncManager_removeAsyncResponse(&server->asyncManager, ar);
-        }
-    }
+    if(ar)
+        UA_AsyncManager_takeResponse(&server->asyncManager, ar, response, finished);
 }
 #endif
 
@@ -505,11 +494,20 @@ void Service_Call(UA_Server *server, UA_Session *session,
 }
 
 UA_CallMethodResult
-UA_Server_call(UA_Server *server, const UA_CallMethodRequest *request) {
+UA_Server_callWithSession(UA_Server *server, UA_Session *session,
+                          const UA_CallMethodRequest *request) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
     UA_CallMethodResult result;
     UA_CallMethodResult_init(&result);
+    Operation_CallMethod(server, session, NULL, request, &result);
+    return result;
+}
+
+UA_CallMethodResult
+UA_Server_call(UA_Server *server, const UA_CallMethodRequest *request) {
     UA_LOCK(&server->serviceMutex);
-    Operation_CallMethod(server, &server->adminSession, NULL, request, &result);
+    UA_CallMethodResult result =
+        UA_Server_callWithSession(server, &server->adminSession, request);
     UA_UNLOCK(&server->serviceMutex);
     return result;
 }
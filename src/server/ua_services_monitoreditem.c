@@ -51,7 +51,7 @@ setAbsoluteFromPercentageDeadband(UA_Server *server, UA_Session *session,
     rvi.nodeId = bpr.targets->targetId.nodeId;
     rvi.attributeId = UA_ATTRIBUTEID_VALUE;
     UA_DataValue rangeVal = UA_Server_readWithSession(server, session, &rvi,
-                                                      UA_TIMESTAMPSTORETURN_NEITHER);
+                                                      UA_TIMESTAMPSTORETURN_NEITHER, 0.0);
     UA_BrowsePathResult_clear(&bpr);
     if(!UA_Variant_isScalar(&rangeVal.value) ||
        rangeVal.value.type != &UA_TYPES[UA_TYPES_RANGE]) {
@@ -357,7 +357,7 @@ Operation_CreateMonitoredItem(UA_Server *server, UA_Session *session,
      * - The Session does not have sufficient access rights
      * - The indicated encoding is not supported or not valid */
     UA_DataValue v = UA_Server_readWithSession(server, session, &request->itemToMonitor,
-                                               cmc->timestampsToReturn);
+                                               cmc->timestampsToReturn, 0.0);
     if(v.hasStatus &&
        (v.status == UA_STATUSCODE_BADNODEIDUNKNOWN ||
         v.status == UA_STATUSCODE_BADATTRIBUTEIDINVALID ||
@@ -568,7 +568,7 @@ Operation_ModifyMonitoredItem(UA_Server *server, UA_Session *session, UA_Subscri
      * Can return an empty value (v.value.type == NULL). */
     UA_DataValue v =
         UA_Server_readWithSession(server, session, &mon->itemToMonitor,
-                                  mon->timestampsToReturn);
+                                  mon->timestampsToReturn, 0.0);
 
     /* Verify and adjust the new parameters. This still leaves the original
      * MonitoredItem untouched. */
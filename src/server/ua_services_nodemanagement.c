@@ -149,6 +149,7 @@ checkParentReference(UA_Server *server, UA_Session *session, const UA_NodeHead *
 
     /* Check that the reference type is not abstract */
     UA_Boolean referenceTypeIsAbstract = referenceType->referenceTypeNode.isAbstract;
+    UA_Byte refTypeIndex = referenceType->referenceTypeNode.referenceTypeIndex;
     UA_NODESTORE_RELEASE(server, referenceType);
     if(referenceTypeIsAbstract == true) {
         logAddNode(&server->config.logger, session, &head->nodeId,
@@ -162,8 +163,7 @@ checkParentReference(UA_Server *server, UA_Session *session, const UA_NodeHead *
        head->nodeClass == UA_NODECLASS_OBJECTTYPE ||
        head->nodeClass == UA_NODECLASS_REFERENCETYPE) {
         /* Type needs hassubtype reference to the supertype */
-        if(referenceType->referenceTypeNode.referenceTypeIndex !=
-           UA_REFERENCETYPEINDEX_HASSUBTYPE) {
+        if(refTypeIndex != UA_REFERENCETYPEINDEX_HASSUBTYPE) {
             logAddNode(&server->config.logger, session, &head->nodeId,
                        "Type nodes need to have a HasSubType reference to the parent");
             return UA_STATUSCODE_BADREFERENCENOTALLOWED;
@@ -178,6 +178,11 @@ checkParentReference(UA_Server *server, UA_Session *session, const UA_NodeHead *
         return UA_STATUSCODE_GOOD;
     }
 
+    /* The ReferenceType was already checked during the current bulk insert */
+    UA_BulkAddNodes *bulk = server->bulkAddNodes;
+    if(bulk && UA_ReferenceTypeSet_contains(&bulk->hierarchicalRefs, refTypeIndex))
+        return UA_STATUSCODE_GOOD;
+
     /* Test if the referencetype is hierarchical */
     const UA_NodeId hierarchRefs = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
     if(!isNodeInTree_singleRef(server, referenceTypeId, &hierarchRefs,
@@ -187,6 +192,9 @@ checkParentReference(UA_Server *server, UA_Session *session, const UA_NodeHead *
         return UA_STATUSCODE_BADREFERENCETYPEIDINVALID;
     }
 
+    if(bulk)
+        bulk->hierarchicalRefs =
+            UA_ReferenceTypeSet_union(bulk->hierarchicalRefs, UA_REFTYPESET(refTypeIndex));
     return UA_STATUSCODE_GOOD;
 }
 
@@ -1059,6 +1067,10 @@ AddNode_raw(UA_Server *server, UA_Session *session, void *nodeContext,
     if(retval != UA_STATUSCODE_GOOD)
         goto create_error;
 
+    /* Share the strings with nodes of the same name (e.g. the instances of an
+     * ObjectType) */
+    UA_Node_internStrings(server->stringPool, node);
+
     /* Add the node to the nodestore */
     if(!outNewNodeId)
         outNewNodeId = &tmpOutId;
@@ -1670,6 +1682,305 @@ UA_Server_addNode_finish(UA_Server *server, const UA_NodeId nodeId) {
     return retval;
 }
 
+/******************/
+/* Bulk Add Nodes */
+/******************/
+
+static UA_StatusCode
+deferReference(UA_BulkAddNodes *bulk, const UA_NodeId *targetId,
+               const UA_NodeId *sourceId, UA_Byte refTypeIndex,
+               UA_Boolean isForward, UA_UInt32 sourceNameHash) {
+    /* Grow the list */
+    if(bulk->refsSize == bulk->refsCapacity) {
+        size_t newCapacity = (bulk->refsCapacity == 0) ? 64 : bulk->refsCapacity * 2;
+        UA_DeferredReference *refs = (UA_DeferredReference*)
+            UA_realloc(bulk->refs, newCapacity * sizeof(UA_DeferredReference));
+        if(!refs)
+            return UA_STATUSCODE_BADOUTOFMEMORY;
+        bulk->refs = refs;
+        bulk->refsCapacity = newCapacity;
+    }
+
+    UA_DeferredReference *ref = &bulk->refs[bulk->refsSize];
+    UA_StatusCode res = UA_NodeId_copy(targetId, &ref->targetId);
+    res |= UA_NodeId_copy(sourceId, &ref->sourceId);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_NodeId_clear(&ref->targetId);
+        UA_NodeId_clear(&ref->sourceId);
+        return res;
+    }
+    ref->sourceNameHash = sourceNameHash;
+    ref->refTypeIndex = refTypeIndex;
+    ref->isForward = isForward;
+    bulk->refsSize++;
+    return UA_STATUSCODE_GOOD;
+}
+
+static int
+cmpDeferredReference(const void *a, const void *b) {
+    const UA_DeferredReference *ra = (const UA_DeferredReference*)a;
+    const UA_DeferredReference *rb = (const UA_DeferredReference*)b;
+    return (int)UA_NodeId_order(&ra->targetId, &rb->targetId);
+}
+
+/* Context for the edit of one target node */
+typedef struct {
+    const UA_DeferredReference *refs;
+    size_t refsSize;
+} DeferredRefGroup;
+
+static UA_StatusCode
+addDeferredReferences(UA_Server *server, UA_Session *session, UA_Node *node,
+                      const DeferredRefGroup *group) {
+    UA_BrowseCache_invalidate(&server->browseCache, &node->head.nodeId);
+    UA_ExpandedNodeId target;
+    UA_ExpandedNodeId_init(&target);
+    for(size_t i = 0; i < group->refsSize; i++) {
+        const UA_DeferredReference *ref = &group->refs[i];
+        target.nodeId = ref->sourceId;
+        if(ref->refTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE) {
+            UA_SubtypeCache_invalidate(&server->subtypeCache, &node->head.nodeId);
+            UA_SubtypeCache_invalidate(&server->subtypeCache, &ref->sourceId);
+        }
+        UA_StatusCode res =
+            UA_Node_addReference(node, ref->refTypeIndex, ref->isForward,
+                                 &target, ref->sourceNameHash);
+        if(res != UA_STATUSCODE_GOOD &&
+           res != UA_STATUSCODE_BADDUPLICATEREFERENCENOTALLOWED)
+            return res;
+
+        /* Many references are added to the same node. Switch to the tree
+         * representation early. The duplicate check in the array is linear. */
+        for(size_t j = 0; j < node->head.referencesSize; j++) {
+            UA_NodeReferenceKind *rk = &node->head.references[j];
+            if(rk->targetsSize > 16 && !rk->hasRefTree)
+                UA_NodeReferenceKind_switch(rk);
+        }
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Insert the deferred references with one edit per target node */
+static void
+flushDeferredReferences(UA_Server *server, UA_BulkAddNodes *bulk) {
+    qsort(bulk->refs, bulk->refsSize, sizeof(UA_DeferredReference),
+          cmpDeferredReference);
+
+    size_t begin = 0;
+    while(begin < bulk->refsSize) {
+        size_t end = begin + 1;
+        while(end < bulk->refsSize &&
+              UA_NodeId_equal(&bulk->refs[begin].targetId, &bulk->refs[end].targetId))
+            end++;
+
+        DeferredRefGroup group = {&bulk->refs[begin], end - begin};
+        UA_StatusCode res =
+            UA_Server_editNode(server, &server->adminSession, &bulk->refs[begin].targetId,
+                               (UA_EditNodeCallback)addDeferredReferences, &group);
+        if(res != UA_STATUSCODE_GOOD)
+            UA_LOG_WARNING(&server->config.logger, UA_LOGCATEGORY_SERVER,
+                           "Bulk AddNodes: Could not add the deferred references "
+                           "with StatusCode %s", UA_StatusCode_name(res));
+        begin = end;
+    }
+
+    for(size_t i = 0; i < bulk->refsSize; i++) {
+        UA_NodeId_clear(&bulk->refs[i].targetId);
+        UA_NodeId_clear(&bulk->refs[i].sourceId);
+    }
+    UA_free(bulk->refs);
+    bulk->refs = NULL;
+    bulk->refsSize = 0;
+    bulk->refsCapacity = 0;
+}
+
+/* Remove the deferred references from or to the node */
+static void
+dropDeferredReferences(UA_BulkAddNodes *bulk, const UA_NodeId *nodeId) {
+    size_t i = 0;
+    while(i < bulk->refsSize) {
+        UA_DeferredReference *ref = &bulk->refs[i];
+        if(!UA_NodeId_equal(&ref->targetId, nodeId) &&
+           !UA_NodeId_equal(&ref->sourceId, nodeId)) {
+            i++;
+            continue;
+        }
+        UA_NodeId_clear(&ref->targetId);
+        UA_NodeId_clear(&ref->sourceId);
+        bulk->refsSize--;
+        bulk->refs[i] = bulk->refs[bulk->refsSize]; /* Sorted later */
+    }
+}
+
+static UA_StatusCode
+removeAllReferences(UA_Server *server, UA_Session *session,
+                    UA_Node *node, void *context) {
+    UA_BrowseCache_invalidate(&server->browseCache, &node->head.nodeId);
+    UA_SubtypeCache_invalidate(&server->subtypeCache, &node->head.nodeId);
+    UA_Node_deleteReferences(node);
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Undo the references added by AddNode_addRefs for a node of the bulk insert.
+ * The other direction of the references is still deferred. */
+static void
+rollbackBulkReferences(UA_Server *server, UA_BulkAddNodes *bulk,
+                       const UA_NodeId *nodeId) {
+    UA_Server_editNode(server, &server->adminSession, nodeId,
+                       removeAllReferences, NULL);
+    dropDeferredReferences(bulk, nodeId);
+}
+
+/* Does the item point to a node that could not be added as its parent or type
+ * definition? Returns the StatusCode for the item. */
+static UA_StatusCode
+checkFailedDependency(const UA_AddNodesItem *item, const UA_AddNodesResult *results,
+                      const size_t *failed, size_t failedSize) {
+    for(size_t i = 0; i < failedSize; i++) {
+        const UA_NodeId *failedId = &results[failed[i]].addedNodeId;
+        if(UA_NodeId_equal(&item->parentNodeId.nodeId, failedId))
+            return UA_STATUSCODE_BADPARENTNODEIDINVALID;
+        if(UA_NodeId_equal(&item->typeDefinition.nodeId, failedId))
+            return UA_STATUSCODE_BADTYPEDEFINITIONINVALID;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+addNodes_bulk(UA_Server *server, size_t itemsSize, const UA_AddNodesItem *items,
+              void **nodeContexts, UA_AddNodesResult *results) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+    UA_Session *session = &server->adminSession;
+
+    /* Bulk inserts cannot be nested (e.g. from a constructor) */
+    if(server->bulkAddNodes)
+        return UA_STATUSCODE_BADINVALIDSTATE;
+
+    /* Prepare the nodestore for the new nodes */
+    if(server->config.nodestore.reserve) {
+        UA_StatusCode res =
+            server->config.nodestore.reserve(server->config.nodestore.context, itemsSize);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
+
+    /* Create the nodes and add them to the nodestore */
+    for(size_t i = 0; i < itemsSize; i++) {
+        UA_AddNodesResult_init(&results[i]);
+        UA_AddNodesItem item = items[i]; /* Shallow copy to set the BrowseName */
+        results[i].statusCode = checkSetBrowseName(server, session, &item);
+        if(results[i].statusCode != UA_STATUSCODE_GOOD)
+            continue;
+        void *nodeContext = (nodeContexts) ? nodeContexts[i] : NULL;
+        results[i].statusCode =
+            AddNode_raw(server, session, nodeContext, &item, &results[i].addedNodeId);
+        if(UA_QualifiedName_isNull(&items[i].browseName))
+            UA_QualifiedName_clear(&item.browseName);
+    }
+
+    /* Typecheck and add the references. The reverse direction of the
+     * references is deferred. Retry the nodes that fail (e.g. the parent
+     * is added later in the batch) as long as progress is made. */
+    UA_BulkAddNodes bulk;
+    memset(&bulk, 0, sizeof(UA_BulkAddNodes));
+    server->bulkAddNodes = &bulk;
+    /* Indices of the items that still fail. The list is compacted after
+     * every round. */
+    size_t *pending = (size_t*)UA_malloc(itemsSize * sizeof(size_t));
+    if(!pending && itemsSize > 0) {
+        server->bulkAddNodes = NULL;
+        for(size_t i = 0; i < itemsSize; i++) {
+            if(results[i].statusCode == UA_STATUSCODE_GOOD)
+                UA_NODESTORE_REMOVE(server, &results[i].addedNodeId);
+            UA_AddNodesResult_clear(&results[i]);
+        }
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    }
+    size_t pendingSize = 0;
+    for(size_t i = 0; i < itemsSize; i++) {
+        if(results[i].statusCode == UA_STATUSCODE_GOOD)
+            pending[pendingSize++] = i;
+    }
+
+    UA_Boolean progress = true;
+    while(progress) {
+        progress = false;
+        size_t remaining = 0;
+        for(size_t j = 0; j < pendingSize; j++) {
+            size_t i = pending[j];
+            results[i].statusCode =
+                AddNode_addRefs(server, session, &results[i].addedNodeId,
+                                &items[i].parentNodeId.nodeId, &items[i].referenceTypeId,
+                                &items[i].typeDefinition.nodeId);
+            if(results[i].statusCode == UA_STATUSCODE_GOOD) {
+                progress = true;
+                continue;
+            }
+            /* The parent reference might have been added before the type
+             * definition failed. Start over in the next round. */
+            rollbackBulkReferences(server, &bulk, &results[i].addedNodeId);
+            pending[remaining++] = i;
+        }
+        pendingSize = remaining;
+    }
+
+    /* The nodes that point to a failed node as their parent or type definition
+     * fail as well. Repeat for the newly failed nodes. The failed nodes are
+     * appended to the pending list. Every node is added at most once. */
+    size_t checked = 0;
+    while(checked < pendingSize) {
+        size_t from = checked;
+        checked = pendingSize;
+        for(size_t i = 0; i < itemsSize; i++) {
+            if(results[i].statusCode != UA_STATUSCODE_GOOD)
+                continue;
+            UA_StatusCode res = checkFailedDependency(&items[i], results, &pending[from],
+                                                      checked - from);
+            if(res == UA_STATUSCODE_GOOD)
+                continue;
+            results[i].statusCode = res;
+            rollbackBulkReferences(server, &bulk, &results[i].addedNodeId);
+            pending[pendingSize++] = i;
+        }
+    }
+
+    /* Remove the failed nodes. They have no references left. Don't use
+     * deleteNode, which would also remove the children. */
+    for(size_t j = 0; j < pendingSize; j++) {
+        UA_AddNodesResult *result = &results[pending[j]];
+        dropDeferredReferences(&bulk, &result->addedNodeId);
+        UA_NODESTORE_REMOVE(server, &result->addedNodeId);
+        UA_NodeId_clear(&result->addedNodeId);
+    }
+    UA_free(pending);
+
+    /* Insert the reverse references */
+    flushDeferredReferences(server, &bulk);
+    server->bulkAddNodes = NULL;
+
+    /* Finish the nodes in reverse order. Same as for the generated nodeset
+     * code, the children are constructed before their parents. */
+    for(size_t i = itemsSize; i > 0; i--) {
+        UA_AddNodesResult *result = &results[i-1];
+        if(result->statusCode != UA_STATUSCODE_GOOD)
+            continue;
+        result->statusCode = AddNode_finish(server, session, &result->addedNodeId);
+        if(result->statusCode != UA_STATUSCODE_GOOD)
+            UA_NodeId_clear(&result->addedNodeId);
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Server_addNodes_bulk(UA_Server *server, size_t itemsSize,
+                        const UA_AddNodesItem *items, void **nodeContexts,
+                        UA_AddNodesResult *results) {
+    UA_LOCK(&server->serviceMutex);
+    UA_StatusCode res = addNodes_bulk(server, itemsSize, items, nodeContexts, results);
+    UA_UNLOCK(&server->serviceMutex);
+    return res;
+}
+
 /****************/
 /* Delete Nodes */
 /****************/
@@ -1854,6 +2165,9 @@ deleteNodeSet(UA_Server *server, UA_Session *session,
         UA_NODESTORE_RELEASE(server, member);
         if(removeTargetRefs)
             removeIncomingReferences(server, session, &member->head);
+        UA_ValueCache_remove(&server->valueCache, &member->head.nodeId);
+        UA_BrowseCache_invalidate(&server->browseCache, &member->head.nodeId);
+        UA_SubtypeCache_invalidate(&server->subtypeCache, &member->head.nodeId);
         UA_NODESTORE_REMOVE(server, &member->head.nodeId);
     }
 }
@@ -1989,6 +2303,11 @@ struct AddNodeInfo {
 static UA_StatusCode
 addOneWayReference(UA_Server *server, UA_Session *session, UA_Node *node,
                    const struct AddNodeInfo *info) {
+    UA_BrowseCache_invalidate(&server->browseCache, &node->head.nodeId);
+    if(info->refTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE) {
+        UA_SubtypeCache_invalidate(&server->subtypeCache, &node->head.nodeId);
+        UA_SubtypeCache_invalidate(&server->subtypeCache, &info->targetNodeId->nodeId);
+    }
     return UA_Node_addReference(node, info->refTypeIndex, info->isForward,
                                 info->targetNodeId, info->targetBrowseNameHash);
 }
@@ -2005,6 +2324,11 @@ deleteOneWayReference(UA_Server *server, UA_Session *session, UA_Node *node,
     }
     UA_Byte refTypeIndex = refType->referenceTypeNode.referenceTypeIndex;
     UA_NODESTORE_RELEASE(server, refType);
+    UA_BrowseCache_invalidate(&server->browseCache, &node->head.nodeId);
+    if(refTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE) {
+        UA_SubtypeCache_invalidate(&server->subtypeCache, &node->head.nodeId);
+        UA_SubtypeCache_invalidate(&server->subtypeCache, &item->targetNodeId.nodeId);
+    }
     return UA_Node_deleteReference(node, refTypeIndex, item->isForward, &item->targetNodeId);
 }
 
@@ -2082,6 +2406,14 @@ Operation_addReference(UA_Server *server, UA_Session *session, void *context,
     if(*retval != UA_STATUSCODE_GOOD)
         return;
 
+    /* Defer the second direction to the end of the bulk insert. Add it right
+     * away if that fails. */
+    if(server->bulkAddNodes &&
+       deferReference(server->bulkAddNodes, &item->targetNodeId.nodeId,
+                      &item->sourceNodeId, refTypeIndex, !item->isForward,
+                      sourceNameHash) == UA_STATUSCODE_GOOD)
+        return;
+
     /* Add the second direction */
     UA_ExpandedNodeId target2;
     UA_ExpandedNodeId_init(&target2);
@@ -2266,11 +2598,17 @@ setValueCallback(UA_Server *server, UA_Session *session,
 UA_StatusCode
 setVariableNode_valueCallback(UA_Server *server, const UA_NodeId nodeId,
                               const UA_ValueCallback callback) {
-    return UA_Server_editNode(server, &server->adminSession, &nodeId,
-                              (UA_EditNodeCallback)setValueCallback,
-                              /* cast away const because
-                               * callback uses const anyway */
-                              (UA_ValueCallback *)(uintptr_t) &callback);
+    UA_StatusCode retval =
+        UA_Server_editNode(server, &server->adminSession, &nodeId,
+                           (UA_EditNodeCallback)setValueCallback,
+                           /* cast away const because
+                            * callback uses const anyway */
+                           (UA_ValueCallback *)(uintptr_t) &callback);
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    if(retval == UA_STATUSCODE_GOOD)
+        UA_MonitoredItem_resetNodeSampling(server, &nodeId);
+#endif
+    return retval;
 }
 
 UA_StatusCode
@@ -2278,11 +2616,7 @@ UA_Server_setVariableNode_valueCallback(UA_Server *server,
                                         const UA_NodeId nodeId,
                                         const UA_ValueCallback callback) {
     UA_LOCK(&server->serviceMutex);
-    UA_StatusCode retval = UA_Server_editNode(server, &server->adminSession, &nodeId,
-                                              (UA_EditNodeCallback)setValueCallback,
-                                              /* cast away const because
-                                               * callback uses const anyway */
-                                              (UA_ValueCallback *)(uintptr_t) &callback);
+    UA_StatusCode retval = setVariableNode_valueCallback(server, nodeId, callback);
     UA_UNLOCK(&server->serviceMutex);
     return retval;
 }
@@ -2355,6 +2689,7 @@ setDataSource(UA_Server *server, UA_Session *session,
         UA_DataValue_clear(&node->value.data.value);
     node->value.dataSource = *dataSource;
     node->valueSource = UA_VALUESOURCE_DATASOURCE;
+    UA_ValueCache_remove(&server->valueCache, &node->head.nodeId);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -2362,10 +2697,16 @@ UA_StatusCode
 setVariableNode_dataSource(UA_Server *server, const UA_NodeId nodeId,
                                      const UA_DataSource dataSource) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
-    return UA_Server_editNode(server, &server->adminSession, &nodeId,
-                              (UA_EditNodeCallback)setDataSource,
-                              /* casting away const because callback casts it back anyway */
-                              (UA_DataSource *) (uintptr_t)&dataSource);
+    UA_StatusCode retval =
+        UA_Server_editNode(server, &server->adminSession, &nodeId,
+                           (UA_EditNodeCallback)setDataSource,
+                           /* casting away const because callback casts it back anyway */
+                           (UA_DataSource *) (uintptr_t)&dataSource);
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    if(retval == UA_STATUSCODE_GOOD)
+        UA_MonitoredItem_resetNodeSampling(server, &nodeId);
+#endif
+    return retval;
 }
 
 UA_StatusCode
@@ -2377,6 +2718,51 @@ UA_Server_setVariableNode_dataSource(UA_Server *server, const UA_NodeId nodeId,
     return retval;
 }
 
+static UA_StatusCode
+setDataSourceBatch(UA_Server *server, UA_Session *session,
+                   UA_VariableNode *node, UA_DataSourceReadBatch *readBatch) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+    node->readBatch = *readBatch;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Server_setVariableNode_dataSourceBatch(UA_Server *server, const UA_NodeId nodeId,
+                                          UA_DataSourceReadBatch readBatch) {
+    UA_LOCK(&server->serviceMutex);
+    UA_StatusCode retval =
+        UA_Server_editNode(server, &server->adminSession, &nodeId,
+                           (UA_EditNodeCallback)setDataSourceBatch, &readBatch);
+    UA_UNLOCK(&server->serviceMutex);
+    return retval;
+}
+
+static UA_StatusCode
+setSessionSpecificValue(UA_Server *server, UA_Session *session,
+                        UA_VariableNode *node, UA_Boolean *sessionSpecific) {
+    if(node->head.nodeClass != UA_NODECLASS_VARIABLE)
+        return UA_STATUSCODE_BADNODECLASSINVALID;
+    node->sessionSpecificValue = *sessionSpecific;
+    return UA_STATUSCODE_GOOD;
+}
+
+UA_StatusCode
+UA_Server_setVariableNode_sessionSpecificValue(UA_Server *server,
+                                               const UA_NodeId nodeId,
+                                               UA_Boolean sessionSpecific) {
+    UA_LOCK(&server->serviceMutex);
+    UA_StatusCode retval =
+        UA_Server_editNode(server, &server->adminSession, &nodeId,
+                           (UA_EditNodeCallback)setSessionSpecificValue,
+                           &sessionSpecific);
+    /* Drop the values cached with the previous setting */
+    if(retval == UA_STATUSCODE_GOOD)
+        UA_ValueCache_remove(&server->valueCache, &nodeId);
+    UA_UNLOCK(&server->serviceMutex);
+    return retval;
+}
+
 /******************************/
 /* Set External Value Source  */
 /******************************/
@@ -2443,6 +2829,10 @@ UA_Server_setVariableNode_valueBackend(UA_Server *server, const UA_NodeId nodeId
     /* cast away const because callback uses const anyway */
     // (UA_ValueCallback *)(uintptr_t) &callback);
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+    if(retval == UA_STATUSCODE_GOOD)
+        UA_MonitoredItem_resetNodeSampling(server, &nodeId);
+#endif
 
     UA_UNLOCK(&server->serviceMutex);
     return retval;
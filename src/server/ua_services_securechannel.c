@@ -12,11 +12,6 @@
 #include "ua_server_internal.h"
 #include "ua_services.h"
 
-#ifndef container_of
-#define container_of(ptr, type, member) \
-    (type *)((uintptr_t)ptr - offsetof(type,member))
-#endif
-
 void
 deleteServerSecureChannel(UA_Server *server, UA_SecureChannel *channel) {
     UA_LOG_INFO_CHANNEL(&server->config.logger, channel, "SecureChannel closed");
@@ -25,12 +20,16 @@ deleteServerSecureChannel(UA_Server *server, UA_SecureChannel *channel) {
      * UA_SecureChannel_clear must be called within the server code-base. */
     UA_SecureChannel_clear(channel);
 
-    /* Detach the channel from the server list */
+    /* Detach the channel from the server list and the handshake queue */
     struct channel_entry *entry = container_of(channel, channel_entry, channel);
     TAILQ_REMOVE(&server->channels, entry, pointers);
+    UA_SecureChannelStatistics *scs = &server->secureChannelStatistics;
+    if(entry->handshakeQueued) {
+        TAILQ_REMOVE(&server->handshakeQueue, entry, handshakePointers);
+        scs->queuedHandshakeCount--;
+    }
 
     /* Update the statistics */
-    UA_SecureChannelStatistics *scs = &server->secureChannelStatistics;
     scs->currentChannelCount--;
     switch(entry->closeEvent) {
     case UA_DIAGNOSTICEVENT_CLOSE:
@@ -178,6 +177,8 @@ createServerSecureChannel(UA_Server *server, UA_ConnectionManager *cm,
     entry->channel.config = connConfig;
     entry->channel.certificateVerification = &config->certificateVerification;
     entry->channel.processOPNHeader = configServerSecureChannel;
+    entry->channel.admitOPN = admitServerOPN;
+    entry->handshakeQueued = false;
     entry->channel.connectionManager = cm;
     entry->channel.connectionId = connectionId;
     entry->closeEvent = UA_DIAGNOSTICEVENT_CLOSE; /* Used if the eventloop closes */
@@ -46,6 +46,9 @@ UA_Server_removeSession(UA_Server *server, session_list_entry *sentry,
     }
 #endif
 
+    /* Remove the values cached for the session */
+    UA_ValueCache_removeSession(&server->valueCache, &session->sessionId);
+
     /* Callback into userland access control */
     if(server->config.accessControl.closeSession) {
         UA_UNLOCK(&server->serviceMutex);
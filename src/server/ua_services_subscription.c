@@ -167,12 +167,18 @@ Service_ModifySubscription(UA_Server *server, UA_Session *session,
     /* Reset the subscription lifetime */
     sub->currentLifetimeCount = 0;
 
-    /* Change the repeated callback to the new interval. This cannot fail as the
-     * CallbackId must exist. */
-    if(sub->publishCallbackId > 0 &&
-       sub->publishingInterval != oldPublishingInterval)
-        changeRepeatedCallbackInterval(server, sub->publishCallbackId,
-                                       sub->publishingInterval);
+    /* Move to the PublishGroup for the new interval. Keep the old interval if
+     * that fails. */
+    if(sub->publishGroup &&
+       sub->publishingInterval != oldPublishingInterval) {
+        UA_StatusCode res = Subscription_registerPublishCallback(server, sub);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_LOG_WARNING_SUBSCRIPTION(&server->config.logger, sub,
+                                        "Could not change the publishing interval "
+                                        "with error code %s", UA_StatusCode_name(res));
+            sub->publishingInterval = oldPublishingInterval;
+        }
+    }
 
     /* If the priority has changed, re-enter the subscription to the
      * priority-ordered queue in the session. */
@@ -514,6 +520,7 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
     memcpy(newSub, sub, sizeof(UA_Subscription));
 
     /* Register cyclic publish callback */
+    newSub->publishGroup = NULL;
     result->statusCode = Subscription_registerPublishCallback(server, newSub);
     if(result->statusCode != UA_STATUSCODE_GOOD) {
         UA_Array_delete(result->availableSequenceNumbers,
@@ -559,6 +566,12 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
     UA_assert(sub->retransmissionQueueSize == 0);
     sub->retransmissionQueueSize = 0;
 
+    /* The memory usage moves over with the queues. It is accounted in the new
+     * Session once the Subscription is attached. */
+    if(oldSession)
+        oldSession->totalMemoryUsage -= sub->memoryUsage;
+    sub->memoryUsage = 0;
+
     /* Add to the server */
     UA_assert(newSub->subscriptionId == sub->subscriptionId);
     LIST_INSERT_HEAD(&server->subscriptions, newSub, serverListEntry);
@@ -574,7 +587,7 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
      * queued to send a StatusChangeNotification. */
     sub->statusChange = UA_STATUSCODE_GOODSUBSCRIPTIONTRANSFERRED;
     UA_Subscription_publish(server, sub);
-    UA_assert(sub->publishCallbackId == 0);
+    UA_assert(sub->publishGroup == NULL);
 
     /* Create notifications with the current values */
     if(*sendInitialValues) {
@@ -595,7 +608,7 @@ Operation_TransferSubscription(UA_Server *server, UA_Session *session,
 
             /* Create a notification with the last sampled value */
             UA_MonitoredItem_createDataChangeNotification(server, newSub, mon,
-                                                          &mon->lastValue);
+                                                          &mon->lastValue, 0);
         }
     }
 
@@ -181,6 +181,12 @@ isNodeInTree(UA_Server *server, const UA_NodeId *leafNode,
 UA_Boolean
 isNodeInTree_singleRef(UA_Server *server, const UA_NodeId *leafNode,
                        const UA_NodeId *nodeToFind, const UA_Byte relevantRefTypeIndex) {
+    /* Subtype checks are answered from the cached supertypes */
+    UA_Boolean isSubtype = false;
+    if(relevantRefTypeIndex == UA_REFERENCETYPEINDEX_HASSUBTYPE &&
+       UA_SubtypeCache_isSubtype(server, leafNode, nodeToFind, &isSubtype))
+        return isSubtype;
+
     UA_ReferenceTypeSet reftypes = UA_REFTYPESET(relevantRefTypeIndex);
     return isNodeInTree(server, leafNode, nodeToFind, &reftypes);
 }
@@ -441,6 +447,139 @@ UA_Server_browseRecursive(UA_Server *server, const UA_BrowseDescription *bd,
     return retval;
 }
 
+/* Process the starting node (if startId is set) or the entry at the index of
+ * the queue. The targets are appended to the queue, which serves both as the
+ * set of nodes visited in the current direction and as the FIFO queue of the
+ * breadth-first search. As in browseRecursive, the starting node is not part of
+ * the visited nodes. So it is reported if it is reached again. Nodes that do
+ * not match the NodeClassMask are also expanded. But as every node has the same
+ * targets regardless of the path to it, each node is expanded only once per
+ * direction. Matching nodes are reported once, also if they are reached in
+ * both directions. */
+static UA_StatusCode
+browseRecursiveStep(UA_Server *server, RefTree *queue, RefTree *reported,
+                    const UA_ExpandedNodeId *startId, size_t index,
+                    UA_BrowseDirection browseDirection,
+                    const UA_ReferenceTypeSet *refTypes, UA_UInt32 nodeClassMask,
+                    UA_BrowseRecursiveCallback callback, void *context) {
+    UA_Boolean match = !startId;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+
+    /* Remote targets are reported but not followed */
+    const UA_ExpandedNodeId *id = (startId) ? startId : &queue->targets[index];
+    if(UA_ExpandedNodeId_isLocal(id)) {
+        const UA_Node *node =
+            UA_NODESTORE_GET_SELECTIVE(server, &id->nodeId,
+                                       UA_NODEATTRIBUTESMASK_NODECLASS,
+                                       *refTypes, browseDirection);
+        if(!node)
+            return (startId) ? UA_STATUSCODE_BADNODEIDUNKNOWN : UA_STATUSCODE_GOOD;
+        match = match && matchClassMask(node, nodeClassMask);
+
+        const UA_NodeHead *head = &node->head;
+        for(size_t i = 0; i < head->referencesSize && res == UA_STATUSCODE_GOOD; i++) {
+            UA_NodeReferenceKind *rk = &head->references[i];
+            if(rk->isInverse != (browseDirection == UA_BROWSEDIRECTION_INVERSE))
+                continue;
+            if(!UA_ReferenceTypeSet_contains(refTypes, rk->referenceTypeIndex))
+                continue;
+            const UA_ReferenceTarget *target = NULL;
+            while((target = UA_NodeReferenceKind_iterate(rk, target))) {
+                res = RefTree_add(queue, target->targetId, NULL);
+                if(res != UA_STATUSCODE_GOOD)
+                    break;
+            }
+        }
+        UA_NODESTORE_RELEASE(server, node);
+        if(res != UA_STATUSCODE_GOOD)
+            return res;
+    }
+    if(!match)
+        return UA_STATUSCODE_GOOD;
+
+    /* Already reported in the other direction? The queue may have been
+     * reallocated when the targets were added. */
+    id = &queue->targets[index];
+    UA_Boolean duplicate = false;
+    res = RefTree_add(reported, UA_NodePointer_fromExpandedNodeId(id), &duplicate);
+    if(res != UA_STATUSCODE_GOOD || duplicate)
+        return res;
+
+    /* The queue is not modified while the server is unlocked */
+    UA_UNLOCK(&server->serviceMutex);
+    res = callback(server, id, context);
+    UA_LOCK(&server->serviceMutex);
+    return res;
+}
+
+/* Browse separately for each direction, see browseRecursive */
+static UA_StatusCode
+browseRecursivePass(UA_Server *server, const UA_NodeId *startNode,
+                    RefTree *reported, UA_BrowseDirection browseDirection,
+                    const UA_ReferenceTypeSet *refTypes, UA_UInt32 nodeClassMask,
+                    UA_BrowseRecursiveCallback callback, void *context) {
+    RefTree queue;
+    UA_StatusCode res = RefTree_init(&queue);
+    if(res != UA_STATUSCODE_GOOD)
+        return res;
+    UA_ExpandedNodeId startId;
+    UA_ExpandedNodeId_init(&startId);
+    startId.nodeId = *startNode;
+    res = browseRecursiveStep(server, &queue, reported, &startId, 0,
+                              browseDirection, refTypes, nodeClassMask,
+                              callback, context);
+    for(size_t i = 0; i < queue.size && res == UA_STATUSCODE_GOOD; i++)
+        res = browseRecursiveStep(server, &queue, reported, NULL, i,
+                                  browseDirection, refTypes, nodeClassMask,
+                                  callback, context);
+    RefTree_clear(&queue);
+    return res;
+}
+
+UA_StatusCode
+UA_Server_browseRecursiveCallback(UA_Server *server, const UA_BrowseDescription *bd,
+                                  UA_BrowseRecursiveCallback callback,
+                                  void *context) {
+    if(!callback)
+        return UA_STATUSCODE_BADINVALIDARGUMENT;
+
+    UA_LOCK(&server->serviceMutex);
+
+    /* Set the list of relevant reference types */
+    UA_ReferenceTypeSet refTypes;
+    UA_StatusCode res = referenceTypeIndices(server, &bd->referenceTypeId,
+                                             &refTypes, bd->includeSubtypes);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_UNLOCK(&server->serviceMutex);
+        return res;
+    }
+
+    /* The nodes reported to the callback */
+    RefTree reported;
+    res = RefTree_init(&reported);
+    if(res != UA_STATUSCODE_GOOD) {
+        UA_UNLOCK(&server->serviceMutex);
+        return res;
+    }
+
+    /* Browse */
+    if(bd->browseDirection == UA_BROWSEDIRECTION_FORWARD ||
+       bd->browseDirection == UA_BROWSEDIRECTION_BOTH)
+        res = browseRecursivePass(server, &bd->nodeId, &reported,
+                                  UA_BROWSEDIRECTION_FORWARD, &refTypes,
+                                  bd->nodeClassMask, callback, context);
+    if(res == UA_STATUSCODE_GOOD &&
+       (bd->browseDirection == UA_BROWSEDIRECTION_INVERSE ||
+        bd->browseDirection == UA_BROWSEDIRECTION_BOTH))
+        res = browseRecursivePass(server, &bd->nodeId, &reported,
+                                  UA_BROWSEDIRECTION_INVERSE, &refTypes,
+                                  bd->nodeClassMask, callback, context);
+
+    RefTree_clear(&reported);
+    UA_UNLOCK(&server->serviceMutex);
+    return res;
+}
+
 /**********/
 /* Browse */
 /**********/
@@ -742,6 +881,17 @@ browseWithContinuation(UA_Server *server, UA_Session *session,
         return true;
     }
 
+    /* Reuse a cached result when browsing starts (no ContinuationPoint). The
+     * access rights for the node are checked in any case. */
+    UA_Boolean useCache =
+        (cp->identifier.length == 0 && server->config.maxBrowseCacheSize > 0);
+    if(useCache &&
+       UA_BrowseCache_get(&server->browseCache, session, descr,
+                          &cp->relevantReferences, cp->maxReferences, result)) {
+        UA_NODESTORE_RELEASE(server, node);
+        return true;
+    }
+
     RefResult rr;
     result->statusCode = RefResult_init(&rr);
     if(result->statusCode != UA_STATUSCODE_GOOD) {
@@ -752,12 +902,19 @@ browseWithContinuation(UA_Server *server, UA_Session *session,
     /* Browse the references */
     UA_Boolean done = false;
     result->statusCode = browseReferences(server, session, &node->head, cp, &rr, &done);
-    UA_NODESTORE_RELEASE(server, node);
     if(result->statusCode != UA_STATUSCODE_GOOD) {
+        UA_NODESTORE_RELEASE(server, node);
         RefResult_clear(&rr);
         return true;
     }
 
+    /* Cache the complete result */
+    if(useCache && done)
+        UA_BrowseCache_put(&server->browseCache, server->config.maxBrowseCacheSize,
+                           session, descr, &cp->relevantReferences, &node->head,
+                           rr.descr, rr.size);
+    UA_NODESTORE_RELEASE(server, node);
+
     /* Move results */
     if(rr.size > 0) {
         result->references = rr.descr;
@@ -1006,10 +1163,33 @@ recursiveAddBrowseHashTarget(RefTree *results, struct aa_head *head,
     return res;
 }
 
+/* BrowseName together with its string from the server's pool (or NULL if not
+ * interned). The interned BrowseNames of nodes are compared by pointer. */
+typedef struct {
+    const UA_QualifiedName *name;
+    const UA_Byte *interned;
+} BrowseNameFilter;
+
+static void
+BrowseNameFilter_init(UA_Server *server, BrowseNameFilter *filter,
+                      const UA_QualifiedName *name) {
+    filter->name = name;
+    filter->interned = UA_StringPool_find(server->stringPool, &name->name);
+}
+
+static UA_Boolean
+matchBrowseName(const BrowseNameFilter *filter, const UA_NodeHead *head) {
+    if(!head->internedBrowseName)
+        return UA_QualifiedName_equal(filter->name, &head->browseName);
+    /* Interned names are not empty. A name not in the pool cannot match. */
+    return (head->browseName.name.data == filter->interned &&
+            head->browseName.namespaceIndex == filter->name->namespaceIndex);
+}
+
 static UA_StatusCode
 walkBrowsePathElement(UA_Server *server, UA_Session *session,
                       const UA_RelativePath *path, const size_t pathIndex,
-                      UA_UInt32 nodeClassMask, const UA_QualifiedName *lastBrowseName,
+                      UA_UInt32 nodeClassMask, const BrowseNameFilter *lastBrowseName,
                       UA_BrowsePathResult *result, RefTree *current, RefTree *next) {
     /* For the next level. Note the difference from lastBrowseName */
     const UA_RelativePathElement *elem = &path->elements[pathIndex];
@@ -1066,8 +1246,7 @@ walkBrowsePathElement(UA_Server *server, UA_Session *session,
 
         /* Does the BrowseName match for the current node (not the references
          * going out here) */
-        skip |= (lastBrowseName &&
-                 !UA_QualifiedName_equal(lastBrowseName, &node->head.browseName));
+        skip |= (lastBrowseName && !matchBrowseName(lastBrowseName, &node->head));
 
         if(skip) {
             UA_NODESTORE_RELEASE(server, node);
@@ -1104,10 +1283,11 @@ walkBrowsePathElement(UA_Server *server, UA_Session *session,
                 /* The array entries don't have a BrowseName hash. Add all of
                  * them at this level to be checked with a full string
                  * comparison. */
-                for(size_t k = 0; k < rk->targetsSize; k++) {
-                    if(rk->targets.array[k].targetNameHash != browseNameHash)
+                const UA_ReferenceTarget *t = NULL;
+                while((t = UA_NodeReferenceKind_iterate(rk, t))) {
+                    if(t->targetNameHash != browseNameHash)
                         continue;
-                    res = RefTree_add(next, rk->targets.array[k].targetId, NULL);
+                    res = RefTree_add(next, t->targetId, NULL);
                     if(res != UA_STATUSCODE_GOOD)
                         break;
                 }
@@ -1122,10 +1302,9 @@ walkBrowsePathElement(UA_Server *server, UA_Session *session,
 }
 
 static void
-Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
-                                       const UA_UInt32 *nodeClassMask,
-                                       const UA_BrowsePath *path,
-                                       UA_BrowsePathResult *result) {
+resolveBrowsePath(UA_Server *server, UA_Session *session,
+                  const UA_UInt32 *nodeClassMask, const UA_BrowsePath *path,
+                  UA_BrowsePathResult *result) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
     if(path->relativePath.elementsSize == 0) {
@@ -1162,7 +1341,8 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
     result->statusCode |= RefTree_init(&rt1);
     result->statusCode |= RefTree_init(&rt2);
     UA_BrowsePathTarget *tmpResults = NULL;
-    UA_QualifiedName *browseNameFilter = NULL;
+    BrowseNameFilter filter;
+    BrowseNameFilter *browseNameFilter = NULL;
     if(result->statusCode != UA_STATUSCODE_GOOD)
         goto cleanup;
 
@@ -1197,7 +1377,9 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
         if(result->statusCode != UA_STATUSCODE_GOOD)
             goto cleanup;
 
-        browseNameFilter = &path->relativePath.elements[i].targetName;
+        BrowseNameFilter_init(server, &filter,
+                              &path->relativePath.elements[i].targetName);
+        browseNameFilter = &filter;
     }
 
     /* Allocate space for the results array */
@@ -1220,7 +1402,7 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
                                        UA_BROWSEDIRECTION_INVALID);
         if(!node)
             continue;
-        UA_Boolean match = UA_QualifiedName_equal(browseNameFilter, &node->head.browseName);
+        UA_Boolean match = matchBrowseName(browseNameFilter, &node->head);
         UA_NODESTORE_RELEASE(server, node);
         if(!match)
             continue;
@@ -1250,6 +1432,32 @@ Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
     }
 }
 
+/* Clients resolve the same BrowsePaths over and over again (e.g. after every
+ * reconnect). Their results are cached until the information model changes.
+ * Internal lookups are not cached, as they happen mostly while nodes are added
+ * and the cache is invalidated all the time. */
+static void
+Operation_TranslateBrowsePathToNodeIds(UA_Server *server, UA_Session *session,
+                                       const UA_UInt32 *nodeClassMask,
+                                       const UA_BrowsePath *path,
+                                       UA_BrowsePathResult *result) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+    UA_Boolean useCache = (server->config.maxBrowsePathCacheSize > 0 &&
+                           session != &server->adminSession);
+    if(useCache && UA_BrowseCache_getPath(&server->browseCache, path,
+                                          *nodeClassMask, result))
+        return;
+
+    resolveBrowsePath(server, session, nodeClassMask, path, result);
+
+    /* Cache the result if the BrowsePath was valid */
+    if(useCache && (result->statusCode == UA_STATUSCODE_GOOD ||
+                    result->statusCode == UA_STATUSCODE_BADNOMATCH))
+        UA_BrowseCache_putPath(&server->browseCache,
+                               server->config.maxBrowsePathCacheSize,
+                               path, *nodeClassMask, result);
+}
+
 UA_BrowsePathResult
 translateBrowsePathToNodeIds(UA_Server *server,
                                        const UA_BrowsePath *browsePath) {
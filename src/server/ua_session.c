@@ -142,6 +142,9 @@ UA_Session_attachSubscription(UA_Session *session, UA_Subscription *sub) {
     /* Increase the number of outstanding retransmissions */
     session->totalRetransmissionQueueSize += sub->retransmissionQueueSize;
 
+    /* Account the queued notifications and retransmissions */
+    session->totalMemoryUsage += sub->memoryUsage;
+
     /* Insert at the end of the subscriptions of the same priority / just before
      * the subscriptions with the next lower priority. */
     UA_Subscription *after = NULL;
@@ -168,6 +171,10 @@ UA_Session_detachSubscription(UA_Server *server, UA_Session *session,
     /* Reduce the number of outstanding retransmissions */
     session->totalRetransmissionQueueSize -= sub->retransmissionQueueSize;
 
+    /* Release the memory budget */
+    UA_assert(session->totalMemoryUsage >= sub->memoryUsage);
+    session->totalMemoryUsage -= sub->memoryUsage;
+
     /* Send remaining publish responses if the last subscription was removed */
     if(!releasePublishResponses || !TAILQ_EMPTY(&session->subscriptions))
         return;
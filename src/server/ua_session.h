@@ -69,6 +69,7 @@ typedef struct {
     SIMPLEQ_HEAD(, UA_PublishResponseEntry) responseQueue;
 
     size_t totalRetransmissionQueueSize; /* Retransmissions of all subscriptions */
+    size_t totalMemoryUsage; /* Bytes in the queues of all subscriptions */
 #endif
 
 #ifdef UA_ENABLE_DIAGNOSTICS
@@ -114,6 +114,7 @@ UA_Subscription_delete(UA_Server *server, UA_Subscription *sub) {
     UA_NotificationMessageEntry *nme, *nme_tmp;
     TAILQ_FOREACH_SAFE(nme, &sub->retransmissionQueue, listEntry, nme_tmp) {
         TAILQ_REMOVE(&sub->retransmissionQueue, nme, listEntry);
+        UA_Subscription_removeMemoryUsage(sub, nme->memSize);
         UA_NotificationMessage_clear(&nme->message);
         UA_free(nme);
         if(sub->session)
@@ -121,6 +122,7 @@ UA_Subscription_delete(UA_Server *server, UA_Subscription *sub) {
         --sub->retransmissionQueueSize;
     }
     UA_assert(sub->retransmissionQueueSize == 0);
+    UA_assert(sub->memoryUsage == 0);
 
     /* Pointers to the subscription may still exist upwards in the call stack.
      * Add a delayed callback to remove the Subscription when the current jobs
@@ -141,11 +143,29 @@ UA_Subscription_getMonitoredItem(UA_Subscription *sub, UA_UInt32 monitoredItemId
     return mon;
 }
 
+void
+UA_Subscription_addMemoryUsage(UA_Subscription *sub, size_t size) {
+    sub->memoryUsage += size;
+    if(sub->session)
+        sub->session->totalMemoryUsage += size;
+}
+
+void
+UA_Subscription_removeMemoryUsage(UA_Subscription *sub, size_t size) {
+    UA_assert(sub->memoryUsage >= size);
+    sub->memoryUsage -= size;
+    if(sub->session) {
+        UA_assert(sub->session->totalMemoryUsage >= size);
+        sub->session->totalMemoryUsage -= size;
+    }
+}
+
 static void
 removeOldestRetransmissionMessageFromSub(UA_Subscription *sub) {
     UA_NotificationMessageEntry *oldestEntry =
         TAILQ_LAST(&sub->retransmissionQueue, NotificationMessageQueue);
     TAILQ_REMOVE(&sub->retransmissionQueue, oldestEntry, listEntry);
+    UA_Subscription_removeMemoryUsage(sub, oldestEntry->memSize);
     UA_NotificationMessage_clear(&oldestEntry->message);
     UA_free(oldestEntry);
     --sub->retransmissionQueueSize;
@@ -178,9 +198,34 @@ removeOldestRetransmissionMessageFromSession(UA_Session *session) {
     removeOldestRetransmissionMessageFromSub(oldestSub);
 }
 
+UA_Boolean
+UA_Subscription_reserveMemory(UA_Server *server, UA_Subscription *sub,
+                              size_t size) {
+    UA_Session *session = sub->session;
+    size_t budget = server->config.maxSessionMemoryUsage;
+    if(!session || budget == 0)
+        return true;
+
+    /* The retransmission messages are only kept for an optional Republish */
+    while(session->totalMemoryUsage + size > budget &&
+          session->totalRetransmissionQueueSize > 0) {
+        UA_LOG_DEBUG_SUBSCRIPTION(&server->config.logger, sub,
+                                  "Session memory budget exhausted. "
+                                  "Release a retransmission message.");
+        removeOldestRetransmissionMessageFromSession(session);
+    }
+    return (session->totalMemoryUsage + size <= budget);
+}
+
 static void
 UA_Subscription_addRetransmissionMessage(UA_Server *server, UA_Subscription *sub,
                                          UA_NotificationMessageEntry *entry) {
+    /* Make room in the memory budget of the Session. The new message is
+     * always added. */
+    entry->memSize = sizeof(UA_NotificationMessageEntry) +
+        UA_calcSizeBinary(&entry->message, &UA_TYPES[UA_TYPES_NOTIFICATIONMESSAGE]);
+    UA_Subscription_reserveMemory(server, sub, entry->memSize);
+
     /* Release the oldest entry if there is not enough space */
     UA_Session *session = sub->session;
     if(sub->retransmissionQueueSize >= UA_MAX_RETRANSMISSIONQUEUESIZE) {
@@ -197,6 +242,7 @@ UA_Subscription_addRetransmissionMessage(UA_Server *server, UA_Subscription *sub
 
     /* Add entry */
     TAILQ_INSERT_TAIL(&sub->retransmissionQueue, entry, listEntry);
+    UA_Subscription_addMemoryUsage(sub, entry->memSize);
     ++sub->retransmissionQueueSize;
     if(session)
         ++session->totalRetransmissionQueueSize;
@@ -215,6 +261,7 @@ UA_Subscription_removeRetransmissionMessage(UA_Subscription *sub, UA_UInt32 sequ
 
     /* Remove the retransmission message */
     TAILQ_REMOVE(&sub->retransmissionQueue, entry, listEntry);
+    UA_Subscription_removeMemoryUsage(sub, entry->memSize);
     --sub->retransmissionQueueSize;
     UA_NotificationMessage_clear(&entry->message);
     UA_free(entry);
@@ -362,6 +409,28 @@ prepareNotificationMessage(UA_Server *server, UA_Subscription *sub,
     return UA_STATUSCODE_GOOD;
 }
 
+/* Encode the notifications of the message in place. The encoded message is
+ * sent out and then kept in the retransmission queue. So every notification is
+ * encoded only once and a Republish only copies the encoded bytes. If the
+ * encoding fails, the notification is kept in decoded form. */
+static void
+encodeNotificationData(UA_NotificationMessage *message) {
+    for(size_t i = 0; i < message->notificationDataSize; i++) {
+        UA_ExtensionObject *eo = &message->notificationData[i];
+        if(eo->encoding < UA_EXTENSIONOBJECT_DECODED)
+            continue;
+        const UA_DataType *type = eo->content.decoded.type;
+        UA_ByteString body = UA_BYTESTRING_NULL;
+        UA_StatusCode res = UA_encodeBinary(eo->content.decoded.data, type, &body);
+        if(res != UA_STATUSCODE_GOOD)
+            continue;
+        UA_ExtensionObject_clear(eo);
+        eo->encoding = UA_EXTENSIONOBJECT_ENCODED_BYTESTRING;
+        eo->content.encoded.typeId = type->binaryEncodingId;
+        eo->content.encoded.body = body;
+    }
+}
+
 /* According to OPC Unified Architecture, Part 4 5.13.1.1 i) The value 0 is
  * never used for the sequence number */
 static UA_UInt32
@@ -372,10 +441,26 @@ UA_Subscription_nextSequenceNumber(UA_UInt32 sequenceNumber) {
     return nextSequenceNumber;
 }
 
+/* Publish all Subscriptions of the group with a single lock. A Subscription
+ * might be deleted during its publish. The group is removed together with the
+ * last Subscription. So it must not be accessed after that. */
 static void
-repeatedPublishCallback(UA_Server *server, UA_Subscription *sub) {
+repeatedPublishCallback(UA_Server *server, UA_PublishGroup *pg) {
     UA_LOCK(&server->serviceMutex);
-    UA_Subscription_publish(server, sub);
+    UA_DateTime latestJoin = UA_DateTime_nowMonotonic() -
+        (UA_DateTime)(pg->publishingInterval * UA_DATETIME_MSEC);
+    UA_Subscription *sub, *sub_tmp;
+    TAILQ_FOREACH_SAFE(sub, &pg->subscriptions, publishGroupEntry, sub_tmp) {
+        /* The first tick after joining the group comes at the phase of the
+         * group. Skip it if it is earlier than a full interval. */
+        if(sub->publishGroupJoined != 0) {
+            UA_Boolean early = (sub->publishGroupJoined > latestJoin);
+            sub->publishGroupJoined = 0;
+            if(early)
+                continue;
+        }
+        UA_Subscription_publish(server, sub);
+    }
     UA_UNLOCK(&server->serviceMutex);
 }
 
@@ -551,6 +636,10 @@ UA_Subscription_publish(UA_Server *server, UA_Subscription *sub) {
             UA_Session_queuePublishReq(sub->session, pre, true); /* Re-enqueue */
             return;
         }
+
+        /* Encode once for the response and the retransmission queue */
+        if(retransmission)
+            encodeNotificationData(message);
     }
 
     /* <-- The point of no return --> */
@@ -685,22 +774,66 @@ UA_Session_reachedPublishReqLimit(UA_Server *server, UA_Session *session) {
     return true;
 }
 
+static UA_PublishGroup *
+getPublishGroup(UA_Server *server, UA_Double publishingInterval) {
+    UA_PublishGroup *pg;
+    LIST_FOREACH(pg, &server->publishGroups, listEntry) {
+        if(pg->publishingInterval == publishingInterval)
+            return pg;
+    }
+
+    pg = (UA_PublishGroup*)UA_calloc(1, sizeof(UA_PublishGroup));
+    if(!pg)
+        return NULL;
+    pg->publishingInterval = publishingInterval;
+    TAILQ_INIT(&pg->subscriptions);
+    UA_StatusCode retval =
+        addRepeatedCallback(server, (UA_ServerCallback)repeatedPublishCallback,
+                            pg, publishingInterval, &pg->callbackId);
+    if(retval != UA_STATUSCODE_GOOD) {
+        UA_free(pg);
+        return NULL;
+    }
+    LIST_INSERT_HEAD(&server->publishGroups, pg, listEntry);
+    return pg;
+}
+
+static void
+removeFromPublishGroup(UA_Server *server, UA_Subscription *sub) {
+    UA_PublishGroup *pg = sub->publishGroup;
+    TAILQ_REMOVE(&pg->subscriptions, sub, publishGroupEntry);
+    pg->subscriptionsSize--;
+    sub->publishGroup = NULL;
+    if(pg->subscriptionsSize > 0)
+        return;
+    removeCallback(server, pg->callbackId);
+    LIST_REMOVE(pg, listEntry);
+    UA_free(pg);
+}
+
 UA_StatusCode
 Subscription_registerPublishCallback(UA_Server *server, UA_Subscription *sub) {
     UA_LOG_DEBUG_SUBSCRIPTION(&server->config.logger, sub,
                               "Register subscription publishing callback");
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
 
-    if(sub->publishCallbackId > 0)
+    if(sub->publishGroup &&
+       sub->publishGroup->publishingInterval == sub->publishingInterval)
         return UA_STATUSCODE_GOOD;
 
-    UA_StatusCode retval =
-        addRepeatedCallback(server, (UA_ServerCallback)repeatedPublishCallback,
-                            sub, sub->publishingInterval, &sub->publishCallbackId);
-    if(retval != UA_STATUSCODE_GOOD)
-        return retval;
+    /* Get the group before leaving the old one. So the Subscription remains
+     * registered if no group can be created. */
+    UA_PublishGroup *pg = getPublishGroup(server, sub->publishingInterval);
+    if(!pg)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+
+    if(sub->publishGroup)
+        removeFromPublishGroup(server, sub);
 
-    UA_assert(sub->publishCallbackId > 0);
+    sub->publishGroupJoined = UA_DateTime_nowMonotonic();
+    TAILQ_INSERT_TAIL(&pg->subscriptions, sub, publishGroupEntry);
+    pg->subscriptionsSize++;
+    sub->publishGroup = pg;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -709,11 +842,10 @@ Subscription_unregisterPublishCallback(UA_Server *server, UA_Subscription *sub)
     UA_LOG_DEBUG_SUBSCRIPTION(&server->config.logger, sub,
                               "Unregister subscription publishing callback");
 
-    if(sub->publishCallbackId == 0)
+    if(!sub->publishGroup)
         return;
 
-    removeCallback(server, sub->publishCallbackId);
-    sub->publishCallbackId = 0;
+    removeFromPublishGroup(server, sub);
 }
 
 #endif /* UA_ENABLE_SUBSCRIPTIONS */
@@ -65,6 +65,9 @@ typedef struct UA_Notification {
     UA_Boolean isOverflowEvent; /* Counted manually */
     UA_EventFilterResult result;
 #endif
+
+    size_t memSize; /* Accounted in the Subscription while in the queue of the
+                     * MonitoredItem. Computed on enqueue if not set. */
 } UA_Notification;
 
 /* Initializes and sets the sentinel pointers */
@@ -85,11 +88,15 @@ void UA_Notification_enqueueAndTrigger(UA_Server *server,
 /* Dequeue and delete the notification */
 void UA_Notification_delete(UA_Notification *n);
 
+/* Estimated memory held by the notification */
+size_t UA_Notification_memSize(const UA_Notification *n);
+
 /* A NotificationMessage contains an array of notifications.
  * Sent NotificationMessages are stored for the republish service. */
 typedef struct UA_NotificationMessageEntry {
     TAILQ_ENTRY(UA_NotificationMessageEntry) listEntry;
     UA_NotificationMessage message;
+    size_t memSize;
 } UA_NotificationMessageEntry;
 
 /* Queue Definitions */
@@ -140,6 +147,9 @@ struct UA_MonitoredItem {
 
     /* Sampling Callback */
     UA_UInt64 sampleCallbackId;
+    UA_UInt64 rateLimitCallbackId; /* Pending sample after a write. Only for
+                                    * MonitoredItems attached to the node. */
+    UA_DateTime lastSampled; /* Monotonic time of the last sample */
     UA_DataValue lastValue;
 
     /* Triggering Links */
@@ -166,7 +176,8 @@ void
 UA_Server_registerMonitoredItem(UA_Server *server, UA_MonitoredItem *mon);
 
 /* Register sampling. Either by adding a repeated callback or by adding the
- * MonitoredItem to a linked list in the node. */
+ * MonitoredItem to a linked list in the node. The latter are sampled when the
+ * node is written. */
 UA_StatusCode
 UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon);
 
@@ -174,6 +185,22 @@ void
 UA_MonitoredItem_unregisterSampling(UA_Server *server,
                                     UA_MonitoredItem *mon);
 
+/* Called for MonitoredItems attached to the node when the node is written.
+ * Returns true if the sample can be taken right away. Otherwise a sample is
+ * scheduled for the end of the sampling interval. */
+UA_Boolean
+UA_MonitoredItem_rateLimit(UA_Server *server, UA_MonitoredItem *mon);
+
+/* A sample of a MonitoredItem attached to the node was dropped. Schedule
+ * another sample, as there might be no further write to the node. */
+void
+UA_MonitoredItem_retrySample(UA_Server *server, UA_MonitoredItem *mon);
+
+/* The value source of the node has changed. MonitoredItems that were triggered
+ * by writes to the node get a repeated sampling callback if required. */
+void
+UA_MonitoredItem_resetNodeSampling(UA_Server *server, const UA_NodeId *nodeId);
+
 UA_StatusCode
 UA_MonitoredItem_setMonitoringMode(UA_Server *server, UA_MonitoredItem *mon,
                                    UA_MonitoringMode monitoringMode);
@@ -194,11 +221,15 @@ UA_StatusCode
 UA_MonitoredItem_addLink(UA_Subscription *sub, UA_MonitoredItem *mon,
                          UA_UInt32 linkId);
 
+/* The memSize of the notification is computed when it is enqueued if zero is
+ * passed. Callers that already know the size can pass it to avoid a second
+ * calcSizeBinary of the value. */
 UA_StatusCode
 UA_MonitoredItem_createDataChangeNotification(UA_Server *server,
                                               UA_Subscription *sub,
                                               UA_MonitoredItem *mon,
-                                              const UA_DataValue *value);
+                                              const UA_DataValue *value,
+                                              size_t memSize);
 
 /* Remove entries until mon->maxQueueSize is reached. Sets infobits for lost
  * data if required. */
@@ -218,6 +249,19 @@ typedef enum {
     UA_SUBSCRIPTIONSTATE_KEEPALIVE
 } UA_SubscriptionState;
 
+/* Subscriptions with the same publishing interval share a PublishGroup with a
+ * single repeated callback. So the timer fires once per publishing interval and
+ * not once per Subscription. A Subscription that joins a running group skips
+ * the first tick if it comes before a full interval. The group is removed
+ * together with its last Subscription. */
+typedef struct UA_PublishGroup {
+    LIST_ENTRY(UA_PublishGroup) listEntry;
+    UA_Double publishingInterval; /* in ms */
+    UA_UInt64 callbackId;
+    TAILQ_HEAD(, UA_Subscription) subscriptions;
+    size_t subscriptionsSize;
+} UA_PublishGroup;
+
 /* Subscriptions are managed in a server-wide linked list. If they are attached
  * to a Session, then they are additionaly in the per-Session linked-list. A
  * subscription is always generated for a Session. But the CloseSession Service
@@ -249,8 +293,11 @@ struct UA_Subscription {
     UA_UInt32 currentKeepAliveCount;
     UA_UInt32 currentLifetimeCount;
 
-    /* Publish Callback. Registered if id > 0. */
-    UA_UInt64 publishCallbackId;
+    /* Publish Callback. Registered if the PublishGroup is set. */
+    UA_PublishGroup *publishGroup;
+    TAILQ_ENTRY(UA_Subscription) publishGroupEntry;
+    UA_DateTime publishGroupJoined; /* Monotonic time of joining the group.
+                                     * Reset after the first tick. */
 
     /* Delayed callback to schedule publication of more notifications */
     UA_Boolean delayedCallbackRegistered;
@@ -271,6 +318,10 @@ struct UA_Subscription {
     NotificationMessageQueue retransmissionQueue;
     size_t retransmissionQueueSize;
 
+    /* Bytes held by the notification and retransmission queues. Also counted
+     * in the Session the Subscription is attached to. */
+    size_t memoryUsage;
+
     /* Statistics for the server diagnostics. The fields are defined according
      * to the SubscriptionDiagnosticsDataType (Part 5, §12.15). */
 #ifdef UA_ENABLE_DIAGNOSTICS
@@ -298,6 +349,9 @@ UA_Subscription * UA_Subscription_new(void);
 void
 UA_Subscription_delete(UA_Server *server, UA_Subscription *sub);
 
+/* Adds the Subscription to the PublishGroup for its publishing interval. If
+ * the Subscription is already registered with a different interval, it is
+ * moved to the matching group. The old registration remains if that fails. */
 UA_StatusCode
 Subscription_registerPublishCallback(UA_Server *server,
                                      UA_Subscription *sub);
@@ -310,6 +364,18 @@ UA_MonitoredItem *
 UA_Subscription_getMonitoredItem(UA_Subscription *sub,
                                  UA_UInt32 monitoredItemId);
 
+void
+UA_Subscription_addMemoryUsage(UA_Subscription *sub, size_t size);
+
+void
+UA_Subscription_removeMemoryUsage(UA_Subscription *sub, size_t size);
+
+/* Returns false if the additional memory exceeds the budget of the Session.
+ * Retransmission messages of the Session are released first to make room. */
+UA_Boolean
+UA_Subscription_reserveMemory(UA_Server *server, UA_Subscription *sub,
+                              size_t size);
+
 void
 UA_Subscription_publish(UA_Server *server, UA_Subscription *sub);
 
@@ -15,42 +15,42 @@
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS /* conditional compilation */
 
-/* Detect value changes outside the deadband */
-#define UA_DETECT_DEADBAND(TYPE) do {                           \
-    TYPE v1 = *(const TYPE*)data1;                              \
-    TYPE v2 = *(const TYPE*)data2;                              \
-    TYPE diff = (v1 > v2) ? (TYPE)(v1 - v2) : (TYPE)(v2 - v1);  \
-    return ((UA_Double)diff > deadband);                        \
-} while(false);
-
-static UA_Boolean
-detectScalarDeadBand(const void *data1, const void *data2,
-                     const UA_DataType *type, const UA_Double deadband) {
-    if(type->typeKind == UA_DATATYPEKIND_SBYTE) {
-        UA_DETECT_DEADBAND(UA_SByte);
-    } else if(type->typeKind == UA_DATATYPEKIND_BYTE) {
-        UA_DETECT_DEADBAND(UA_Byte);
-    } else if(type->typeKind == UA_DATATYPEKIND_INT16) {
-        UA_DETECT_DEADBAND(UA_Int16);
-    } else if(type->typeKind == UA_DATATYPEKIND_UINT16) {
-        UA_DETECT_DEADBAND(UA_UInt16);
-    } else if(type->typeKind == UA_DATATYPEKIND_INT32) {
-        UA_DETECT_DEADBAND(UA_Int32);
-    } else if(type->typeKind == UA_DATATYPEKIND_UINT32) {
-        UA_DETECT_DEADBAND(UA_UInt32);
-    } else if(type->typeKind == UA_DATATYPEKIND_INT64) {
-        UA_DETECT_DEADBAND(UA_Int64);
-    } else if(type->typeKind == UA_DATATYPEKIND_UINT64) {
-        UA_DETECT_DEADBAND(UA_UInt64);
-    } else if(type->typeKind == UA_DATATYPEKIND_FLOAT) {
-        UA_DETECT_DEADBAND(UA_Float);
-    } else if(type->typeKind == UA_DATATYPEKIND_DOUBLE) {
-        UA_DETECT_DEADBAND(UA_Double);
-    } else {
-        return false; /* Not a known numerical type */
-    }
+/* Detect value changes outside the deadband. The elements are compared in
+ * blocks without an early exit inside the block. That lets the compiler
+ * vectorize the inner loop for large arrays. */
+#define UA_DEADBAND_BLOCKSIZE 64
+
+#define UA_DETECT_DEADBAND(NAME, TYPE)                                  \
+static UA_Boolean                                                       \
+NAME(const TYPE *v1, const TYPE *v2, size_t length,                     \
+     const UA_Double deadband) {                                        \
+    for(size_t i = 0; i < length; i += UA_DEADBAND_BLOCKSIZE) {         \
+        size_t end = i + UA_DEADBAND_BLOCKSIZE;                         \
+        if(end > length)                                                \
+            end = length;                                               \
+        UA_Boolean changed = false;                                     \
+        for(size_t j = i; j < end; j++) {                               \
+            TYPE diff = (v1[j] > v2[j]) ?                               \
+                (TYPE)(v1[j] - v2[j]) : (TYPE)(v2[j] - v1[j]);          \
+            changed |= ((UA_Double)diff > deadband);                    \
+        }                                                               \
+        if(changed)                                                     \
+            return true;                                                \
+    }                                                                   \
+    return false;                                                       \
 }
 
+UA_DETECT_DEADBAND(detectDeadbandSByte, UA_SByte)
+UA_DETECT_DEADBAND(detectDeadbandByte, UA_Byte)
+UA_DETECT_DEADBAND(detectDeadbandInt16, UA_Int16)
+UA_DETECT_DEADBAND(detectDeadbandUInt16, UA_UInt16)
+UA_DETECT_DEADBAND(detectDeadbandInt32, UA_Int32)
+UA_DETECT_DEADBAND(detectDeadbandUInt32, UA_UInt32)
+UA_DETECT_DEADBAND(detectDeadbandInt64, UA_Int64)
+UA_DETECT_DEADBAND(detectDeadbandUInt64, UA_UInt64)
+UA_DETECT_DEADBAND(detectDeadbandFloat, UA_Float)
+UA_DETECT_DEADBAND(detectDeadbandDouble, UA_Double)
+
 static UA_Boolean
 detectVariantDeadband(const UA_Variant *value, const UA_Variant *oldValue,
                       const UA_Double deadbandValue) {
@@ -61,17 +61,65 @@ detectVariantDeadband(const UA_Variant *value, const UA_Variant *oldValue,
     size_t length = 1;
     if(!UA_Variant_isScalar(value))
         length = value->arrayLength;
-    uintptr_t data = (uintptr_t)value->data;
-    uintptr_t oldData = (uintptr_t)oldValue->data;
-    UA_UInt32 memSize = value->type->memSize;
-    for(size_t i = 0; i < length; ++i) {
-        if(detectScalarDeadBand((const void*)data, (const void*)oldData,
-                                value->type, deadbandValue))
-            return true;
-        data += memSize;
-        oldData += memSize;
+    const void *data = value->data;
+    const void *oldData = oldValue->data;
+    switch(value->type->typeKind) {
+    case UA_DATATYPEKIND_SBYTE:
+        return detectDeadbandSByte((const UA_SByte*)data, (const UA_SByte*)oldData,
+                                   length, deadbandValue);
+    case UA_DATATYPEKIND_BYTE:
+        return detectDeadbandByte((const UA_Byte*)data, (const UA_Byte*)oldData,
+                                  length, deadbandValue);
+    case UA_DATATYPEKIND_INT16:
+        return detectDeadbandInt16((const UA_Int16*)data, (const UA_Int16*)oldData,
+                                   length, deadbandValue);
+    case UA_DATATYPEKIND_UINT16:
+        return detectDeadbandUInt16((const UA_UInt16*)data, (const UA_UInt16*)oldData,
+                                    length, deadbandValue);
+    case UA_DATATYPEKIND_INT32:
+        return detectDeadbandInt32((const UA_Int32*)data, (const UA_Int32*)oldData,
+                                   length, deadbandValue);
+    case UA_DATATYPEKIND_UINT32:
+        return detectDeadbandUInt32((const UA_UInt32*)data, (const UA_UInt32*)oldData,
+                                    length, deadbandValue);
+    case UA_DATATYPEKIND_INT64:
+        return detectDeadbandInt64((const UA_Int64*)data, (const UA_Int64*)oldData,
+                                   length, deadbandValue);
+    case UA_DATATYPEKIND_UINT64:
+        return detectDeadbandUInt64((const UA_UInt64*)data, (const UA_UInt64*)oldData,
+                                    length, deadbandValue);
+    case UA_DATATYPEKIND_FLOAT:
+        return detectDeadbandFloat((const UA_Float*)data, (const UA_Float*)oldData,
+                                   length, deadbandValue);
+    case UA_DATATYPEKIND_DOUBLE:
+        return detectDeadbandDouble((const UA_Double*)data, (const UA_Double*)oldData,
+                                    length, deadbandValue);
+    default:
+        return false; /* Not a known numerical type */
     }
-    return false;
+}
+
+/* Bitwise identical values are also equal for UA_order. The memcmp is much
+ * faster than the element-wise comparison for large arrays. If the bits differ,
+ * the caller falls back to UA_order (e.g. for NaN or -0.0). */
+static UA_Boolean
+variantBitwiseEqual(const UA_Variant *v1, const UA_Variant *v2) {
+    if(v1->type != v2->type || !v1->type || !v1->type->pointerFree)
+        return false;
+    if(v1->arrayLength != v2->arrayLength ||
+       v1->arrayDimensionsSize != v2->arrayDimensionsSize)
+        return false;
+    size_t length = v1->arrayLength;
+    if(UA_Variant_isScalar(v1) && UA_Variant_isScalar(v2))
+        length = 1;
+    if(length == 0 || v1->data <= UA_EMPTY_ARRAY_SENTINEL ||
+       v2->data <= UA_EMPTY_ARRAY_SENTINEL)
+        return false;
+    if(v1->arrayDimensionsSize > 0 &&
+       memcmp(v1->arrayDimensions, v2->arrayDimensions,
+              sizeof(UA_UInt32) * v1->arrayDimensionsSize) != 0)
+        return false;
+    return (memcmp(v1->data, v2->data, v1->type->memSize * length) == 0);
 }
 
 static UA_Boolean
@@ -121,6 +169,8 @@ detectValueChange(UA_Server *server, UA_MonitoredItem *mon,
     /* Has the value changed? */
     if(value->hasValue != mon->lastValue.hasValue)
         return true;
+    if(variantBitwiseEqual(&value->value, &mon->lastValue.value))
+        return false;
     return (UA_order(&value->value, &mon->lastValue.value,
                      &UA_TYPES[UA_TYPES_VARIANT]) != UA_ORDER_EQ);
 }
@@ -128,7 +178,8 @@ detectValueChange(UA_Server *server, UA_MonitoredItem *mon,
 UA_StatusCode
 UA_MonitoredItem_createDataChangeNotification(UA_Server *server, UA_Subscription *sub,
                                               UA_MonitoredItem *mon,
-                                              const UA_DataValue *value) {
+                                              const UA_DataValue *value,
+                                              size_t memSize) {
     /* Allocate a new notification */
     UA_Notification *newNotification = UA_Notification_new();
     if(!newNotification)
@@ -136,6 +187,7 @@ UA_MonitoredItem_createDataChangeNotification(UA_Server *server, UA_Subscription
 
     /* Prepare the notification */
     newNotification->mon = mon;
+    newNotification->memSize = memSize;
     newNotification->data.dataChange.clientHandle = mon->parameters.clientHandle;
     UA_StatusCode retval = UA_DataValue_copy(value, &newNotification->data.dataChange.value);
     if(retval != UA_STATUSCODE_GOOD) {
@@ -168,8 +220,28 @@ sampleCallbackWithValue(UA_Server *server, UA_Subscription *sub,
     /* The MonitoredItem is attached to a subscription (not server-local).
      * Prepare a notification and enqueue it. */
     if(sub) {
+        /* Drop the sample if the memory budget of the Session is exhausted.
+         * The last value is not updated, so that the change is detected again
+         * with the next sample. MonitoredItems sampled on write retry on a
+         * timer. */
+        size_t memSize = sizeof(UA_Notification) +
+            UA_calcSizeBinary(value, &UA_TYPES[UA_TYPES_DATAVALUE]);
+        if(!UA_Subscription_reserveMemory(server, sub, memSize)) {
+            UA_LOG_DEBUG_SUBSCRIPTION(&server->config.logger, sub,
+                                      "MonitoredItem %" PRIi32 " | "
+                                      "Session memory budget exhausted. "
+                                      "Drop the sample.", mon->monitoredItemId);
+#ifdef UA_ENABLE_DIAGNOSTICS
+            sub->monitoringQueueOverflowCount++;
+#endif
+            UA_DataValue_clear(value);
+            UA_MonitoredItem_retrySample(server, mon);
+            return UA_STATUSCODE_GOOD;
+        }
+
         UA_StatusCode retval =
-            UA_MonitoredItem_createDataChangeNotification(server, sub, mon, value);
+            UA_MonitoredItem_createDataChangeNotification(server, sub, mon,
+                                                          value, memSize);
         if(retval != UA_STATUSCODE_GOOD)
             return retval;
     }
@@ -220,10 +292,21 @@ monitoredItem_sampleCallback(UA_Server *server, UA_MonitoredItem *monitoredItem)
 
     UA_assert(monitoredItem->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER);
 
+    /* Values from DataSources can be shared with MonitoredItems on the same
+     * node that were sampled within half the sampling interval. But only if
+     * the value was read after the own last sample. */
+    UA_DateTime now = UA_DateTime_nowMonotonic();
+    UA_Double maxAge = monitoredItem->parameters.samplingInterval / 2.0;
+    UA_Double sinceLast = (UA_Double)(now - monitoredItem->lastSampled - 1) /
+        (UA_Double)UA_DATETIME_MSEC;
+    if(maxAge > sinceLast)
+        maxAge = sinceLast;
+    monitoredItem->lastSampled = now;
+
     /* Sample the value. The sample can still point into the node. */
-    UA_DataValue value = UA_Server_readWithSession(server, session,
-                                                   &monitoredItem->itemToMonitor,
-                                                   monitoredItem->timestampsToReturn);
+    UA_DataValue value =
+        UA_Server_readWithSession(server, session, &monitoredItem->itemToMonitor,
+                                  monitoredItem->timestampsToReturn, maxAge);
 
     /* Operate on the sample. The sample is consumed when the status is good. */
     UA_StatusCode res = sampleCallbackWithValue(server, sub, monitoredItem, &value);
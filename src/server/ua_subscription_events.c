@@ -208,6 +208,20 @@ UA_MonitoredItem_addEvent(UA_Server *server, UA_MonitoredItem *mon,
     notification->data.event.clientHandle = mon->parameters.clientHandle;
     notification->mon = mon;
 
+    /* Drop the event if the memory budget of the Session is exhausted */
+    notification->memSize = UA_Notification_memSize(notification);
+    if(!UA_Subscription_reserveMemory(server, sub, notification->memSize)) {
+        UA_LOG_DEBUG_SUBSCRIPTION(&server->config.logger, sub,
+                                  "MonitoredItem %" PRIi32 " | "
+                                  "Session memory budget exhausted. "
+                                  "Drop the event.", mon->monitoredItemId);
+#ifdef UA_ENABLE_DIAGNOSTICS
+        sub->eventQueueOverFlowCount++;
+#endif
+        UA_Notification_delete(notification);
+        return UA_STATUSCODE_GOOD;
+    }
+
     UA_Notification_enqueueAndTrigger(server, notification);
     return UA_STATUSCODE_GOOD;
 }
@@ -82,6 +82,9 @@ createEventOverflowNotification(UA_Server *server, UA_Subscription *sub,
     TAILQ_INSERT_BEFORE(indicator, overflowNotification, localEntry);
     ++mon->eventOverflows;
     ++mon->queueSize;
+    overflowNotification->memSize = UA_Notification_memSize(overflowNotification);
+    if(mon->subscription)
+        UA_Subscription_addMemoryUsage(mon->subscription, overflowNotification->memSize);
 
     /* Test for consistency */
     UA_assert(mon->queueSize >= mon->eventOverflows);
@@ -167,6 +170,18 @@ UA_MonitoredItem_removeOverflowInfoBits(UA_MonitoredItem *mon) {
         (UA_STATUSCODE_INFOTYPE_DATAVALUE | UA_STATUSCODE_INFOBITS_OVERFLOW);
 }
 
+size_t
+UA_Notification_memSize(const UA_Notification *n) {
+    size_t size = sizeof(UA_Notification);
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+    if(n->mon && n->mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER)
+        return size + UA_calcSizeBinary(&n->data.event,
+                                        &UA_TYPES[UA_TYPES_EVENTFIELDLIST]);
+#endif
+    return size + UA_calcSizeBinary(&n->data.dataChange.value,
+                                    &UA_TYPES[UA_TYPES_DATAVALUE]);
+}
+
 UA_Notification *
 UA_Notification_new(void) {
     UA_Notification *n = (UA_Notification*)UA_calloc(1, sizeof(UA_Notification));
@@ -214,6 +229,12 @@ UA_Notification_enqueueMon(UA_Server *server, UA_Notification *n) {
     TAILQ_INSERT_TAIL(&mon->queue, n, localEntry);
     ++mon->queueSize;
 
+    /* Account the memory towards the Session */
+    if(n->memSize == 0)
+        n->memSize = UA_Notification_memSize(n);
+    if(mon->subscription)
+        UA_Subscription_addMemoryUsage(mon->subscription, n->memSize);
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
     if(n->isOverflowEvent)
         ++mon->eventOverflows;
@@ -337,6 +358,8 @@ UA_Notification_dequeueMon(UA_Notification *n) {
 
     TAILQ_REMOVE(&mon->queue, n, localEntry);
     --mon->queueSize;
+    if(mon->subscription)
+        UA_Subscription_removeMemoryUsage(mon->subscription, n->memSize);
 
     /* Test for consistency */
     UA_assert(mon->queueSize >= mon->eventOverflows);
@@ -707,6 +730,43 @@ UA_MonitoredItem_ensureQueueSpace(UA_Server *server, UA_MonitoredItem *mon) {
     }
 }
 
+/* The value attribute of a variable changes only with a write if it is stored
+ * in the node and has no onRead callback. Such MonitoredItems are attached to
+ * the node and sampled when the value is written. The sampling interval
+ * becomes a rate limit. Polling a static variable with the
+ * StatusValueTimestamp trigger reports the changing "now" timestamps. So that
+ * case remains polled. */
+static UA_Boolean
+isWriteTriggered(const UA_Node *node, const UA_MonitoredItem *mon) {
+    if(!node || node->head.nodeClass != UA_NODECLASS_VARIABLE ||
+       mon->itemToMonitor.attributeId != UA_ATTRIBUTEID_VALUE)
+        return false;
+
+    const UA_VariableNode *vn = &node->variableNode;
+#if UA_MULTITHREADING >= 100
+    if(vn->async)
+        return false;
+#endif
+    if(vn->valueBackend.backendType != UA_VALUEBACKENDTYPE_NONE &&
+       vn->valueBackend.backendType != UA_VALUEBACKENDTYPE_INTERNAL)
+        return false;
+    if(vn->valueBackend.backendType == UA_VALUEBACKENDTYPE_NONE &&
+       vn->valueSource != UA_VALUESOURCE_DATA)
+        return false;
+    if(vn->value.data.callback.onRead)
+        return false;
+
+    const UA_ExtensionObject *filter = &mon->parameters.filter;
+    if(!vn->isDynamic &&
+       filter->content.decoded.type == &UA_TYPES[UA_TYPES_DATACHANGEFILTER]) {
+        const UA_DataChangeFilter *dcf = (const UA_DataChangeFilter*)
+            filter->content.decoded.data;
+        if(dcf->trigger == UA_DATACHANGETRIGGER_STATUSVALUETIMESTAMP)
+            return false;
+    }
+    return true;
+}
+
 UA_StatusCode
 UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
     UA_LOCK_ASSERT(&server->serviceMutex, 1);
@@ -715,12 +775,21 @@ UA_MonitoredItem_registerSampling(UA_Server *server, UA_MonitoredItem *mon) {
 
     UA_assert(mon->next == (UA_MonitoredItem*)~0); /* Not registered in a node */
 
-    /* Only DataChange MonitoredItems with a positive sampling interval have a
-     * repeated callback. Other MonitoredItems are attached to the Node in a
-     * linked list of backpointers. */
+    /* Only DataChange MonitoredItems with a positive sampling interval on
+     * values that can change without a write have a repeated callback. Other
+     * MonitoredItems are attached to the Node in a linked list of
+     * backpointers. */
+    UA_Boolean attach = (mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER ||
+                         mon->parameters.samplingInterval == 0.0);
+    if(!attach) {
+        const UA_Node *node = UA_NODESTORE_GET(server, &mon->itemToMonitor.nodeId);
+        attach = isWriteTriggered(node, mon);
+        if(node)
+            UA_NODESTORE_RELEASE(server, node);
+    }
+
     UA_StatusCode res;
-    if(mon->itemToMonitor.attributeId == UA_ATTRIBUTEID_EVENTNOTIFIER ||
-       mon->parameters.samplingInterval == 0.0) {
+    if(attach) {
         UA_Subscription *sub = mon->subscription;
         UA_Session *session = &server->adminSession;
         if(sub)
@@ -747,6 +816,12 @@ UA_MonitoredItem_unregisterSampling(UA_Server *server, UA_MonitoredItem *mon) {
 
     mon->sampleCallbackIsRegistered = false;
 
+    /* Remove the pending rate-limited sample */
+    if(mon->rateLimitCallbackId > 0) {
+        removeCallback(server, mon->rateLimitCallbackId);
+        mon->rateLimitCallbackId = 0;
+    }
+
     /* Check for mon->next and not the samplingInterval. Because that might
      * currently be changed. */
     if(mon->next != (UA_MonitoredItem*)~0) {
@@ -763,6 +838,103 @@ UA_MonitoredItem_unregisterSampling(UA_Server *server, UA_MonitoredItem *mon) {
     }
 }
 
+static void
+rateLimitedSampleCallback(UA_Server *server, UA_MonitoredItem *mon) {
+    UA_LOCK(&server->serviceMutex);
+    mon->rateLimitCallbackId = 0;
+    monitoredItem_sampleCallback(server, mon);
+    UA_UNLOCK(&server->serviceMutex);
+}
+
+UA_Boolean
+UA_MonitoredItem_rateLimit(UA_Server *server, UA_MonitoredItem *mon) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+    if(mon->parameters.samplingInterval <= 0.0)
+        return true;
+
+    /* A sample is already scheduled. It reads the latest value. */
+    if(mon->rateLimitCallbackId > 0)
+        return false;
+
+    UA_DateTime now = UA_DateTime_nowMonotonic();
+    UA_DateTime next = mon->lastSampled + (UA_DateTime)
+        (mon->parameters.samplingInterval * (UA_Double)UA_DATETIME_MSEC);
+    if(now >= next) {
+        mon->lastSampled = now;
+        return true;
+    }
+
+    /* Sample at the end of the interval. Sample right away if that fails. */
+    UA_EventLoop *el = server->config.eventLoop;
+    UA_StatusCode res =
+        el->addTimedCallback(el, (UA_Callback)rateLimitedSampleCallback,
+                             server, mon, next, &mon->rateLimitCallbackId);
+    if(res != UA_STATUSCODE_GOOD) {
+        mon->rateLimitCallbackId = 0;
+        mon->lastSampled = now;
+        return true;
+    }
+    return false;
+}
+
+void
+UA_MonitoredItem_retrySample(UA_Server *server, UA_MonitoredItem *mon) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    /* Polled MonitoredItems sample again with the repeated callback. Or a
+     * sample is already scheduled. */
+    if(mon->next == (UA_MonitoredItem*)~0 || mon->rateLimitCallbackId > 0)
+        return;
+
+    /* Retry after the sampling interval. Without a sampling interval, retry
+     * after the publishing interval when the memory of sent notifications
+     * was released. */
+    UA_Double interval = mon->parameters.samplingInterval;
+    if(interval <= 0.0 && mon->subscription)
+        interval = mon->subscription->publishingInterval;
+    UA_DateTime next = UA_DateTime_nowMonotonic() +
+        (UA_DateTime)(interval * (UA_Double)UA_DATETIME_MSEC);
+    UA_EventLoop *el = server->config.eventLoop;
+    UA_StatusCode res =
+        el->addTimedCallback(el, (UA_Callback)rateLimitedSampleCallback,
+                             server, mon, next, &mon->rateLimitCallbackId);
+    if(res != UA_STATUSCODE_GOOD)
+        mon->rateLimitCallbackId = 0;
+}
+
+void
+UA_MonitoredItem_resetNodeSampling(UA_Server *server, const UA_NodeId *nodeId) {
+    UA_LOCK_ASSERT(&server->serviceMutex, 1);
+
+    /* Move the attached MonitoredItems that are no longer triggered by a write
+     * to a repeated callback. One at a time, as this changes the list. */
+    while(true) {
+        const UA_Node *node = UA_NODESTORE_GET(server, nodeId);
+        if(!node)
+            return;
+        UA_MonitoredItem *mon = node->head.monitoredItems;
+        for(; mon != NULL; mon = mon->next) {
+            if(mon->itemToMonitor.attributeId != UA_ATTRIBUTEID_EVENTNOTIFIER &&
+               mon->parameters.samplingInterval > 0.0 &&
+               !isWriteTriggered(node, mon))
+                break;
+        }
+        UA_NODESTORE_RELEASE(server, node);
+        if(!mon)
+            return;
+        UA_MonitoredItem_unregisterSampling(server, mon);
+        UA_StatusCode res = UA_MonitoredItem_registerSampling(server, mon);
+        if(res != UA_STATUSCODE_GOOD) {
+            UA_LOG_WARNING_SUBSCRIPTION(&server->config.logger, mon->subscription,
+                                        "MonitoredItem %" PRIi32 " | "
+                                        "Could not register the sampling with "
+                                        "the statuscode %s", mon->monitoredItemId,
+                                        UA_StatusCode_name(res));
+            mon->monitoringMode = UA_MONITORINGMODE_DISABLED;
+        }
+    }
+}
+
 UA_StatusCode
 UA_MonitoredItem_removeLink(UA_Subscription *sub, UA_MonitoredItem *mon, UA_UInt32 linkId) {
     /* Find the index */
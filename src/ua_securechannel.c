@@ -32,7 +32,6 @@ UA_SecureChannel_init(UA_SecureChannel *channel) {
     memset(channel, 0, sizeof(UA_SecureChannel));
     channel->state = UA_SECURECHANNELSTATE_FRESH;
     SIMPLEQ_INIT(&channel->completeChunks);
-    SIMPLEQ_INIT(&channel->decryptedChunks);
 }
 
 UA_StatusCode
@@ -125,8 +124,7 @@ UA_SecureChannel_sendError(UA_SecureChannel *channel, UA_TcpErrorMessage *error)
 
 static void
 UA_Chunk_delete(UA_Chunk *chunk) {
-    if(chunk->copied)
-        UA_ByteString_clear(&chunk->bytes);
+    UA_free(chunk->copied);
     UA_free(chunk);
 }
 
@@ -142,7 +140,9 @@ deleteChunks(UA_ChunkQueue *queue) {
 void
 UA_SecureChannel_deleteBuffered(UA_SecureChannel *channel) {
     deleteChunks(&channel->completeChunks);
-    deleteChunks(&channel->decryptedChunks);
+    UA_ByteString_clear(&channel->decryptedMessage);
+    channel->decryptedMessageCapacity = 0;
+    channel->decryptedChunksCount = 0;
     UA_ByteString_clear(&channel->incompleteChunk);
 }
 
@@ -696,63 +696,60 @@ unpackPayloadMSG(UA_SecureChannel *channel, UA_Chunk *chunk) {
     return UA_STATUSCODE_GOOD;
 }
 
+/* Append the payload of a decrypted chunk to the message. The buffer grows
+ * geometrically so that the reassembly is amortized linear in the message
+ * size. */
 static UA_StatusCode
-assembleProcessMessage(UA_SecureChannel *channel, void *application,
-                       UA_ProcessMessageCallback callback) {
-    UA_Chunk *chunk = SIMPLEQ_FIRST(&channel->decryptedChunks);
-    UA_assert(chunk != NULL);
-
-    UA_StatusCode res = UA_STATUSCODE_GOOD;
-    if(chunk->chunkType == UA_CHUNKTYPE_FINAL) {
-        SIMPLEQ_REMOVE_HEAD(&channel->decryptedChunks, pointers);
-        UA_assert(chunk->chunkType == UA_CHUNKTYPE_FINAL);
-        res = callback(application, channel, chunk->messageType,
-                       chunk->requestId, &chunk->bytes);
-        UA_Chunk_delete(chunk);
-        return res;
+appendDecryptedChunk(UA_SecureChannel *channel, const UA_ByteString *payload) {
+    UA_ByteString *msg = &channel->decryptedMessage;
+    size_t needed = msg->length + payload->length;
+    if(needed > channel->decryptedMessageCapacity) {
+        size_t capacity = channel->decryptedMessageCapacity * 2;
+        if(capacity < needed)
+            capacity = needed;
+        if(channel->config.localMaxMessageSize != 0 &&
+           capacity > channel->config.localMaxMessageSize)
+            capacity = channel->config.localMaxMessageSize;
+        UA_Byte *data = (UA_Byte*)UA_realloc(msg->data, capacity);
+        UA_CHECK_MEM(data, return UA_STATUSCODE_BADOUTOFMEMORY);
+        msg->data = data;
+        channel->decryptedMessageCapacity = capacity;
     }
+    if(payload->length > 0)
+        memcpy(&msg->data[msg->length], payload->data, payload->length);
+    msg->length = needed;
+    return UA_STATUSCODE_GOOD;
+}
 
-    UA_UInt32 requestId = chunk->requestId;
-    UA_MessageType messageType = chunk->messageType;
-    UA_ChunkType chunkType = chunk->chunkType;
-    UA_assert(chunkType == UA_CHUNKTYPE_INTERMEDIATE);
-
-    size_t messageSize = 0;
-    SIMPLEQ_FOREACH(chunk, &channel->decryptedChunks, pointers) {
-        /* Consistency check */
-        if(requestId != chunk->requestId)
-            return UA_STATUSCODE_BADINTERNALERROR;
-        if(chunkType != chunk->chunkType && chunk->chunkType != UA_CHUNKTYPE_FINAL)
-            return UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
-        if(chunk->messageType != messageType)
-            return UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
+static void
+resetDecryptedMessage(UA_SecureChannel *channel) {
+    UA_ByteString_clear(&channel->decryptedMessage);
+    channel->decryptedMessageCapacity = 0;
+    channel->decryptedChunksCount = 0;
+}
 
-        /* Sum up the lengths */
-        messageSize += chunk->bytes.length;
-        if(chunk->chunkType == UA_CHUNKTYPE_FINAL)
-            break;
+/* Process the final chunk of a message. Messages with a single chunk are
+ * decoded directly from the chunk. Otherwise the final chunk completes the
+ * message assembled from the intermediate chunks. */
+static UA_StatusCode
+processFinalChunk(UA_SecureChannel *channel, void *application,
+                  UA_ProcessMessageCallback callback, UA_Chunk *chunk) {
+    if(channel->decryptedChunksCount == 1) {
+        channel->decryptedChunksCount = 0;
+        return callback(application, channel, chunk->messageType,
+                        chunk->requestId, &chunk->bytes);
     }
 
-    /* Allocate memory for the full message */
-    UA_ByteString payload;
-    res = UA_ByteString_allocBuffer(&payload, messageSize);
+    UA_StatusCode res = appendDecryptedChunk(channel, &chunk->bytes);
     UA_CHECK_STATUS(res, return res);
 
-    /* Assemble the full message */
-    size_t offset = 0;
-    while(true) {
-        chunk = SIMPLEQ_FIRST(&channel->decryptedChunks);
-        memcpy(&payload.data[offset], chunk->bytes.data, chunk->bytes.length);
-        offset += chunk->bytes.length;
-        SIMPLEQ_REMOVE_HEAD(&channel->decryptedChunks, pointers);
-        UA_ChunkType ct = chunk->chunkType;
-        UA_Chunk_delete(chunk);
-        if(ct == UA_CHUNKTYPE_FINAL)
-            break;
-    }
-
-    /* Process the assembled message */
-    res = callback(application, channel, messageType, requestId, &payload);
+    /* Detach the message from the channel before the callback. So that
+     * processing is reentrant. */
+    UA_ByteString payload = channel->decryptedMessage;
+    channel->decryptedMessage = UA_BYTESTRING_NULL;
+    resetDecryptedMessage(channel);
+    res = callback(application, channel, chunk->messageType,
+                   chunk->requestId, &payload);
     UA_ByteString_clear(&payload);
     return res;
 }
@@ -767,26 +764,71 @@ persistCompleteChunks(UA_ChunkQueue *queue) {
         UA_StatusCode res = UA_ByteString_copy(&chunk->bytes, &copy);
         UA_CHECK_STATUS(res, return res);
         chunk->bytes = copy;
-        chunk->copied = true;
+        chunk->copied = copy.data;
     }
     return UA_STATUSCODE_GOOD;
 }
 
 static UA_StatusCode
-persistIncompleteChunk(UA_SecureChannel *channel, const UA_ByteString *buffer,
-                       size_t offset) {
-    UA_assert(channel->incompleteChunk.length == 0);
-    UA_assert(offset < buffer->length);
-    size_t length = buffer->length - offset;
-    UA_StatusCode res = UA_ByteString_allocBuffer(&channel->incompleteChunk, length);
+appendIncompleteChunk(UA_SecureChannel *channel, const UA_Byte *data, size_t length) {
+    if(length == 0)
+        return UA_STATUSCODE_GOOD;
+    UA_ByteString *inc = &channel->incompleteChunk;
+    UA_Byte *t = (UA_Byte*)UA_realloc(inc->data, inc->length + length);
+    UA_CHECK_MEM(t, return UA_STATUSCODE_BADOUTOFMEMORY);
+    memcpy(&t[inc->length], data, length);
+    inc->data = t;
+    inc->length += length;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Take only as many bytes from the buffer as are missing for the buffered
+ * half-received chunk. The remainder of the buffer is then processed in place.
+ * Returns with *complete == false if the buffer is used up. */
+static UA_StatusCode
+completeIncompleteChunk(UA_SecureChannel *channel, const UA_ByteString *buffer,
+                        size_t *offset, UA_Boolean *complete) {
+    UA_ByteString *inc = &channel->incompleteChunk;
+    *complete = false;
+
+    /* Complete the message header first */
+    if(inc->length < UA_SECURECHANNEL_MESSAGEHEADER_LENGTH) {
+        size_t missing = UA_SECURECHANNEL_MESSAGEHEADER_LENGTH - inc->length;
+        if(missing > buffer->length)
+            missing = buffer->length;
+        UA_StatusCode res = appendIncompleteChunk(channel, buffer->data, missing);
+        UA_CHECK_STATUS(res, return res);
+        *offset = missing;
+        if(inc->length < UA_SECURECHANNEL_MESSAGEHEADER_LENGTH)
+            return UA_STATUSCODE_GOOD;
+    }
+
+    /* Decoding cannot fail */
+    UA_TcpMessageHeader hdr;
+    size_t hdrOffset = 0;
+    UA_StatusCode res =
+        UA_decodeBinaryInternal(inc, &hdrOffset, &hdr,
+                                &UA_TRANSPORT[UA_TRANSPORT_TCPMESSAGEHEADER], NULL);
+    UA_assert(res == UA_STATUSCODE_GOOD);
+    if(hdr.messageSize < UA_SECURECHANNEL_MESSAGE_MIN_LENGTH)
+        return UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
+    if(hdr.messageSize > channel->config.recvBufferSize)
+        return UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
+
+    /* Append the missing part of the chunk */
+    size_t missing = hdr.messageSize - inc->length;
+    if(missing > buffer->length - *offset)
+        missing = buffer->length - *offset;
+    res = appendIncompleteChunk(channel, &buffer->data[*offset], missing);
     UA_CHECK_STATUS(res, return res);
-    memcpy(channel->incompleteChunk.data, &buffer->data[offset], length);
+    *offset += missing;
+    *complete = (inc->length == hdr.messageSize);
     return UA_STATUSCODE_GOOD;
 }
 
-/* Processes chunks and puts them into the payloads queue. Once a final chunk is
- * put into the queue, the message is assembled and the callback is called. The
- * queue will be cleared for the next message. */
+/* Processes the complete chunks in order. The payload of intermediate chunks is
+ * appended to the decrypted message. Once a final chunk arrives, the callback
+ * is called with the full message. */
 static UA_StatusCode
 processChunks(UA_SecureChannel *channel, void *application,
               UA_ProcessMessageCallback callback) {
@@ -802,7 +844,16 @@ processChunks(UA_SecureChannel *channel, void *application,
                channel->state != UA_SECURECHANNELSTATE_OPN_SENT &&
                channel->state != UA_SECURECHANNELSTATE_ACK_SENT)
                 res = UA_STATUSCODE_BADINVALIDSTATE;
-            else
+            else if(channel->admitOPN)
+                res = channel->admitOPN(application, channel);
+
+            /* Processing the OPN is postponed. Keep the chunk in the queue. */
+            if(res == UA_STATUSCODE_GOODCALLAGAIN) {
+                SIMPLEQ_INSERT_HEAD(&channel->completeChunks, chunk, pointers);
+                return UA_STATUSCODE_GOOD;
+            }
+
+            if(res == UA_STATUSCODE_GOOD)
                 res = unpackPayloadOPN(channel, chunk, application);
         } else if(chunk->messageType == UA_MESSAGETYPE_MSG ||
                   chunk->messageType == UA_MESSAGETYPE_CLO) {
@@ -820,40 +871,41 @@ processChunks(UA_SecureChannel *channel, void *application,
             return res;
         }
 
-        /* Add to the decrypted-chunk queue */
-        SIMPLEQ_INSERT_TAIL(&channel->decryptedChunks, chunk, pointers);
+        /* Abort the message, remove the decrypted payload
+         * TODO: Log a warning with the error code */
+        if(chunk->chunkType == UA_CHUNKTYPE_ABORT) {
+            resetDecryptedMessage(channel);
+            UA_Chunk_delete(chunk);
+            continue;
+        }
+
+        /* Consistency check with the previous chunks of the message */
+        if(channel->decryptedChunksCount > 0) {
+            if(chunk->requestId != channel->decryptedRequestId)
+                res = UA_STATUSCODE_BADINTERNALERROR;
+            else if(chunk->messageType != channel->decryptedMessageType)
+                res = UA_STATUSCODE_BADTCPMESSAGETYPEINVALID;
+        }
+        channel->decryptedRequestId = chunk->requestId;
+        channel->decryptedMessageType = chunk->messageType;
 
         /* Check the resource limits */
         channel->decryptedChunksCount++;
-        channel->decryptedChunksLength += chunk->bytes.length;
         if((channel->config.localMaxChunkCount != 0 &&
             channel->decryptedChunksCount > channel->config.localMaxChunkCount) ||
            (channel->config.localMaxMessageSize != 0 &&
-            channel->decryptedChunksLength > channel->config.localMaxMessageSize)) {
-            return UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
-        }
-
-        /* Waiting for additional chunks */
-        if(chunk->chunkType == UA_CHUNKTYPE_INTERMEDIATE)
-            continue;
-
-        /* Final chunk or abort. Reset the counters. */
-        channel->decryptedChunksCount = 0;
-        channel->decryptedChunksLength = 0;
-
-        /* Abort the message, remove all decrypted chunks
-         * TODO: Log a warning with the error code */
-        if(chunk->chunkType == UA_CHUNKTYPE_ABORT) {
-            while((chunk = SIMPLEQ_FIRST(&channel->decryptedChunks))) {
-                SIMPLEQ_REMOVE_HEAD(&channel->decryptedChunks, pointers);
-                UA_Chunk_delete(chunk);
-            }
-            continue;
-        }
-
-        /* The decrypted queue contains a full message. Process it. */
-        UA_assert(chunk->chunkType == UA_CHUNKTYPE_FINAL);
-        res = assembleProcessMessage(channel, application, callback);
+            channel->decryptedMessage.length + chunk->bytes.length >
+            channel->config.localMaxMessageSize))
+            res = UA_STATUSCODE_BADTCPMESSAGETOOLARGE;
+
+        /* Append intermediate chunks to the message. Waiting for additional
+         * chunks. */
+        if(res == UA_STATUSCODE_GOOD &&
+           chunk->chunkType == UA_CHUNKTYPE_INTERMEDIATE)
+            res = appendDecryptedChunk(channel, &chunk->bytes);
+        else if(res == UA_STATUSCODE_GOOD)
+            res = processFinalChunk(channel, application, callback, chunk);
+        UA_Chunk_delete(chunk);
         UA_CHECK_STATUS(res, return res);
     }
 
@@ -926,35 +978,47 @@ extractCompleteChunk(UA_SecureChannel *channel, const UA_ByteString *buffer,
     chunk->messageType = msgType;
     chunk->chunkType = chunkType;
     chunk->requestId = 0;
-    chunk->copied = false;
+    chunk->copied = NULL;
 
     SIMPLEQ_INSERT_TAIL(&channel->completeChunks, chunk, pointers);
     return UA_STATUSCODE_GOOD;
 }
 
+UA_StatusCode
+UA_SecureChannel_processCompleteChunks(UA_SecureChannel *channel, void *application,
+                                       UA_ProcessMessageCallback callback) {
+    UA_StatusCode res = processChunks(channel, application, callback);
+    UA_CHECK_STATUS(res, return res);
+    return persistCompleteChunks(&channel->completeChunks);
+}
+
 UA_StatusCode
 UA_SecureChannel_processBuffer(UA_SecureChannel *channel, void *application,
                                UA_ProcessMessageCallback callback,
                                const UA_ByteString *buffer) {
-    /* Prepend the incomplete last chunk. This is usually done in the
+    /* Complete the buffered half-received chunk. This is usually done in the
      * networklayer. But we test for a buffered incomplete chunk here again to
-     * work around "lazy" network layers. */
-    UA_ByteString appended = channel->incompleteChunk;
-    if(appended.length > 0) {
-        channel->incompleteChunk = UA_BYTESTRING_NULL;
-        UA_Byte *t = (UA_Byte*)UA_realloc(appended.data, appended.length + buffer->length);
-        UA_CHECK_MEM(t, UA_ByteString_clear(&appended);
-                     return UA_STATUSCODE_BADOUTOFMEMORY);
-        memcpy(&t[appended.length], buffer->data, buffer->length);
-        appended.data = t;
-        appended.length += buffer->length;
-        buffer = &appended;
+     * work around "lazy" network layers. Only the missing bytes are copied.
+     * The remainder of the buffer is processed in place. */
+    UA_ByteString appended = UA_BYTESTRING_NULL;
+    size_t offset = 0;
+    UA_Boolean done = false;
+    UA_StatusCode res = UA_STATUSCODE_GOOD;
+    if(channel->incompleteChunk.length > 0) {
+        UA_Boolean complete = false;
+        res = completeIncompleteChunk(channel, buffer, &offset, &complete);
+        UA_CHECK_STATUS(res, return res);
+        if(complete) {
+            appended = channel->incompleteChunk;
+            channel->incompleteChunk = UA_BYTESTRING_NULL;
+            size_t appendedOffset = 0;
+            res = extractCompleteChunk(channel, &appended, &appendedOffset, &done);
+            UA_CHECK_STATUS(res, goto cleanup);
+            UA_assert(appendedOffset == appended.length);
+        }
     }
 
     /* Loop over the received chunks */
-    size_t offset = 0;
-    UA_Boolean done = false;
-    UA_StatusCode res;
     while(!done) {
         res = extractCompleteChunk(channel, buffer, &offset, &done);
         UA_CHECK_STATUS(res, goto cleanup);
@@ -963,7 +1027,9 @@ UA_SecureChannel_processBuffer(UA_SecureChannel *channel, void *application,
     /* Buffer half-received chunk. Before processing the messages so that
      * processing is reentrant. */
     if(offset < buffer->length) {
-        res = persistIncompleteChunk(channel, buffer, offset);
+        UA_assert(channel->incompleteChunk.length == 0);
+        res = appendIncompleteChunk(channel, &buffer->data[offset],
+                                    buffer->length - offset);
         UA_CHECK_STATUS(res, goto cleanup);
     }
 
@@ -975,7 +1041,6 @@ UA_SecureChannel_processBuffer(UA_SecureChannel *channel, void *application,
     /* Persist full chunks that still point to the buffer. Can only return
      * UA_STATUSCODE_BADOUTOFMEMORY as an error code. So merging res works. */
     res |= persistCompleteChunks(&channel->completeChunks);
-    res |= persistCompleteChunks(&channel->decryptedChunks);
 
  cleanup:
     UA_ByteString_clear(&appended);
@@ -71,8 +71,9 @@ typedef struct UA_Chunk {
     UA_MessageType messageType;
     UA_ChunkType chunkType;
     UA_UInt32 requestId;
-    UA_Boolean copied; /* Do the bytes point to a buffer from the network or was
-                        * memory allocated for the chunk separately */
+    UA_Byte *copied; /* Memory allocated for the chunk separately. NULL if the
+                      * bytes point to a buffer from the network. Kept apart
+                      * as the bytes are advanced during unpacking. */
 } UA_Chunk;
 
 typedef SIMPLEQ_HEAD(UA_ChunkQueue, UA_Chunk) UA_ChunkQueue;
@@ -145,16 +146,29 @@ struct UA_SecureChannel {
      * problems in the client in the past.) */
     UA_ChunkQueue completeChunks; /* Received full chunks that have not been
                                    * decrypted so far */
-    UA_ChunkQueue decryptedChunks; /* Received chunks that were decrypted but
-                                    * not processed */
+
+    /* The payload of intermediate chunks is appended to the decryptedMessage
+     * right after decryption. So every chunk is copied only once, also if the
+     * message spans several received buffers. Messages with a single chunk are
+     * processed directly from the receive buffer. */
+    UA_ByteString decryptedMessage;
+    size_t decryptedMessageCapacity;
     size_t decryptedChunksCount;
-    size_t decryptedChunksLength;
+    UA_UInt32 decryptedRequestId;
+    UA_MessageType decryptedMessageType;
+
     UA_ByteString incompleteChunk; /* A half-received chunk (TCP is a
                                     * streaming protocol) is stored here */
 
     UA_CertificateVerification *certificateVerification;
     UA_StatusCode (*processOPNHeader)(void *application, UA_SecureChannel *channel,
                                       const UA_AsymmetricAlgorithmSecurityHeader *asymHeader);
+
+    /* Called before an OPN chunk is decrypted. If UA_STATUSCODE_GOODCALLAGAIN
+     * is returned, the chunk and all following chunks remain queued until
+     * UA_SecureChannel_processBuffer or UA_SecureChannel_processCompleteChunks
+     * is called again. */
+    UA_StatusCode (*admitOPN)(void *application, UA_SecureChannel *channel);
 };
 
 void UA_SecureChannel_init(UA_SecureChannel *channel);
@@ -278,6 +292,13 @@ UA_SecureChannel_processBuffer(UA_SecureChannel *channel, void *application,
                                UA_ProcessMessageCallback callback,
                                const UA_ByteString *buffer);
 
+/* Process the complete chunks that are already queued in the channel (e.g.
+ * after an OPN was postponed by admitOPN). A buffered half-received chunk is
+ * left untouched. */
+UA_StatusCode
+UA_SecureChannel_processCompleteChunks(UA_SecureChannel *channel, void *application,
+                                       UA_ProcessMessageCallback callback);
+
 /* Internal methods in ua_securechannel_crypto.h */
 
 void
@@ -194,6 +194,29 @@ UA_dump_hex_pkg(UA_Byte* buffer, size_t bufferLen);
             (CURSOR) < (arraySize); \
             (CURSOR) = (CURSOR) + (chunkSize), (SIZE) = (arraySize) - (CURSOR) <= (chunkSize) ? (arraySize) - (CURSOR) : (chunkSize))
 
+#if UA_MULTITHREADING >= 100
+/* Atomic pointer operations for lock-free data structures. Both return the
+ * previous value at the address. The compare-and-swap only writes if the
+ * previous value equals the expected value. */
+static UA_INLINE void *
+UA_atomic_xchg(void * volatile *addr, void *newptr) {
+#ifdef _MSC_VER
+    return InterlockedExchangePointer(addr, newptr);
+#else
+    return __atomic_exchange_n(addr, newptr, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static UA_INLINE void *
+UA_atomic_cmpxchg(void * volatile *addr, void *expected, void *newptr) {
+#ifdef _MSC_VER
+    return InterlockedCompareExchangePointer(addr, newptr, expected);
+#else
+    return __sync_val_compare_and_swap(addr, expected, newptr);
+#endif
+}
+#endif
+
 /* Unions that represent any of the supported request or response message */
 typedef union {
     UA_RequestHeader requestHeader;
@@ -6,6 +6,7 @@
 #include <open62541/transport_generated_handling.h>
 #include <open62541/types_generated.h>
 #include <open62541/server_config_default.h>
+#include <open62541/plugin/securitypolicy_default.h>
 
 #include "ua_securechannel.h"
 #include "ua_types_encoding_binary.h"
@@ -534,6 +535,177 @@ START_TEST(SecureChannel_assemblePartialChunks) {
     ck_assert_int_eq(chunks_processed, 5);
 } END_TEST
 
+/* Encode a MSG chunk with the given payload (SecurityMode None) */
+static size_t
+encodeMsgChunk(UA_Byte *buf, UA_ChunkType chunkType, UA_UInt32 sequenceNumber,
+               UA_UInt32 requestId, const UA_Byte *payload, size_t payloadLength) {
+    UA_ByteString b = {UA_SECURECHANNEL_MESSAGE_MIN_LENGTH + 8 + payloadLength, buf};
+    UA_Byte *pos = buf;
+    const UA_Byte *end = &buf[b.length];
+    UA_UInt32 typeAndChunk = UA_MESSAGETYPE_MSG + chunkType;
+    UA_UInt32 messageSize = (UA_UInt32)b.length;
+    UA_UInt32 zero = 0;
+    UA_StatusCode res = UA_UInt32_encodeBinary(&typeAndChunk, &pos, end);
+    res |= UA_UInt32_encodeBinary(&messageSize, &pos, end);
+    res |= UA_UInt32_encodeBinary(&zero, &pos, end); /* SecureChannelId */
+    res |= UA_UInt32_encodeBinary(&zero, &pos, end); /* TokenId */
+    res |= UA_UInt32_encodeBinary(&sequenceNumber, &pos, end);
+    res |= UA_UInt32_encodeBinary(&requestId, &pos, end);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    memcpy(pos, payload, payloadLength);
+    return b.length;
+}
+
+static UA_ByteString assembledMessage;
+
+static UA_StatusCode
+assemble_callback(void *application, UA_SecureChannel *channel,
+                  UA_MessageType messageType, UA_UInt32 requestId,
+                  UA_ByteString *message) {
+    ck_assert_uint_eq(messageType, UA_MESSAGETYPE_MSG);
+    ck_assert_uint_eq(requestId, 7);
+    int *messages_processed = (int *)application;
+    ++*messages_processed;
+    UA_ByteString_clear(&assembledMessage);
+    return UA_ByteString_copy(message, &assembledMessage);
+}
+
+/* A message of several chunks is received in small pieces that split the
+ * chunks (and their headers) at arbitrary positions */
+START_TEST(SecureChannel_assembleMultiChunkMessage) {
+    testChannel.securityMode = UA_MESSAGESECURITYMODE_NONE;
+    testChannel.securityToken.createdAt = UA_DateTime_nowMonotonic();
+    testChannel.securityToken.revisedLifetime = 600000;
+
+    UA_Byte payload[300];
+    for(size_t i = 0; i < sizeof(payload); i++)
+        payload[i] = (UA_Byte)i;
+
+    /* Three chunks with 100 bytes payload each and an aborted message */
+    UA_Byte stream[1024];
+    size_t len = 0;
+    len += encodeMsgChunk(&stream[len], UA_CHUNKTYPE_INTERMEDIATE, 1, 5,
+                          payload, 50);
+    len += encodeMsgChunk(&stream[len], UA_CHUNKTYPE_ABORT, 2, 5,
+                          payload, 10);
+    len += encodeMsgChunk(&stream[len], UA_CHUNKTYPE_INTERMEDIATE, 3, 7,
+                          payload, 100);
+    len += encodeMsgChunk(&stream[len], UA_CHUNKTYPE_INTERMEDIATE, 4, 7,
+                          &payload[100], 100);
+    len += encodeMsgChunk(&stream[len], UA_CHUNKTYPE_FINAL, 5, 7,
+                          &payload[200], 100);
+
+    int messages_processed = 0;
+    const size_t pieces[] = {3, 7, 50, 1, 90, 130, 4, 200};
+    size_t offset = 0;
+    for(size_t i = 0; offset < len; i++) {
+        UA_ByteString buffer;
+        buffer.data = &stream[offset];
+        buffer.length = (i < sizeof(pieces) / sizeof(size_t)) ? pieces[i] : len - offset;
+        if(buffer.length > len - offset)
+            buffer.length = len - offset;
+        offset += buffer.length;
+        UA_StatusCode retval =
+            UA_SecureChannel_processBuffer(&testChannel, &messages_processed,
+                                           assemble_callback, &buffer);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        if(offset < len)
+            ck_assert_int_eq(messages_processed, 0);
+    }
+
+    ck_assert_int_eq(messages_processed, 1);
+    ck_assert_uint_eq(assembledMessage.length, sizeof(payload));
+    ck_assert(memcmp(assembledMessage.data, payload, sizeof(payload)) == 0);
+    UA_ByteString_clear(&assembledMessage);
+} END_TEST
+
+static UA_StatusCode admitResult;
+
+static UA_StatusCode
+admit_callback(void *application, UA_SecureChannel *channel) {
+    return admitResult;
+}
+
+static UA_StatusCode
+opn_callback(void *application, UA_SecureChannel *channel,
+             UA_MessageType messageType, UA_UInt32 requestId,
+             UA_ByteString *message) {
+    ck_assert_uint_eq(messageType, UA_MESSAGETYPE_OPN);
+    ck_assert_uint_eq(requestId, 9);
+    int *messages_processed = (int *)application;
+    ++*messages_processed;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* Encode an OPN chunk for the SecurityPolicy#None */
+static size_t
+encodeOpnChunk(UA_Byte *buf, size_t bufLength, UA_UInt32 requestId) {
+    UA_AsymmetricAlgorithmSecurityHeader asymHeader;
+    UA_AsymmetricAlgorithmSecurityHeader_init(&asymHeader);
+    asymHeader.securityPolicyUri =
+        UA_STRING("http://opcfoundation.org/UA/SecurityPolicy#None");
+    UA_Byte *pos = &buf[UA_SECURECHANNEL_MESSAGEHEADER_LENGTH];
+    const UA_Byte *end = &buf[bufLength];
+    UA_UInt32 zero = 0;
+    UA_UInt32 sequenceNumber = 1;
+    UA_UInt32 payload = 0xdeadbeef;
+    UA_StatusCode res = UA_UInt32_encodeBinary(&zero, &pos, end); /* ChannelId */
+    res |= UA_encodeBinaryInternal(&asymHeader,
+                &UA_TRANSPORT[UA_TRANSPORT_ASYMMETRICALGORITHMSECURITYHEADER],
+                &pos, &end, NULL, NULL);
+    res |= UA_UInt32_encodeBinary(&sequenceNumber, &pos, end);
+    res |= UA_UInt32_encodeBinary(&requestId, &pos, end);
+    res |= UA_UInt32_encodeBinary(&payload, &pos, end);
+    UA_UInt32 messageSize = (UA_UInt32)(pos - buf);
+    UA_UInt32 typeAndChunk = UA_MESSAGETYPE_OPN + UA_CHUNKTYPE_FINAL;
+    pos = buf;
+    res |= UA_UInt32_encodeBinary(&typeAndChunk, &pos, end);
+    res |= UA_UInt32_encodeBinary(&messageSize, &pos, end);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    return messageSize;
+}
+
+/* An OPN postponed by admitOPN is processed from the queue. A half-received
+ * chunk behind it does not block the processing. */
+START_TEST(SecureChannel_processPostponedOPN) {
+    UA_SecurityPolicy nonePolicy;
+    UA_SecurityPolicy_None(&nonePolicy, UA_BYTESTRING_NULL, NULL);
+    UA_SecureChannel channel;
+    UA_SecureChannel_init(&channel);
+    channel.config = UA_ConnectionConfig_default;
+    UA_SecureChannel_setSecurityPolicy(&channel, &nonePolicy, &UA_BYTESTRING_NULL);
+    channel.state = UA_SECURECHANNELSTATE_ACK_SENT;
+    channel.admitOPN = admit_callback;
+
+    UA_Byte stream[256];
+    size_t len = encodeOpnChunk(stream, sizeof(stream), 9);
+    size_t len2 = encodeOpnChunk(&stream[len], sizeof(stream) - len, 9);
+    ck_assert_uint_gt(len2, 12);
+
+    /* The OPN is postponed. The first bytes of the next chunk are buffered. */
+    int messages_processed = 0;
+    admitResult = UA_STATUSCODE_GOODCALLAGAIN;
+    UA_ByteString buffer = {len + 12, stream};
+    UA_StatusCode retval =
+        UA_SecureChannel_processBuffer(&channel, &messages_processed,
+                                       opn_callback, &buffer);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(messages_processed, 0);
+    ck_assert(!SIMPLEQ_EMPTY(&channel.completeChunks));
+    ck_assert_uint_eq(channel.incompleteChunk.length, 12);
+
+    /* Admitted later */
+    admitResult = UA_STATUSCODE_GOOD;
+    retval = UA_SecureChannel_processCompleteChunks(&channel, &messages_processed,
+                                                    opn_callback);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(messages_processed, 1);
+    ck_assert(SIMPLEQ_EMPTY(&channel.completeChunks));
+    ck_assert_uint_eq(channel.incompleteChunk.length, 12);
+
+    UA_SecureChannel_clear(&channel);
+    nonePolicy.clear(&nonePolicy);
+} END_TEST
 
 static Suite *
 testSuite_SecureChannel(void) {
@@ -579,6 +751,8 @@ testSuite_SecureChannel(void) {
     tcase_add_checked_fixture(tc_processBuffer, setup_key_sizes, teardown_key_sizes);
     tcase_add_checked_fixture(tc_processBuffer, setup_secureChannel, teardown_secureChannel);
     tcase_add_test(tc_processBuffer, SecureChannel_assemblePartialChunks);
+    tcase_add_test(tc_processBuffer, SecureChannel_assembleMultiChunkMessage);
+    tcase_add_test(tc_processBuffer, SecureChannel_processPostponedOPN);
     suite_add_tcase(s, tc_processBuffer);
 
     return s;
@@ -141,6 +141,59 @@ START_TEST(Client_read_async) {
         UA_Client_delete(client);
 } END_TEST
 
+START_TEST(Client_read_async_window) {
+        UA_Client *client = UA_Client_new();
+        UA_ClientConfig *clientConfig = UA_Client_getConfig(client);
+        UA_ClientConfig_setDefault(clientConfig);
+        clientConfig->maxRequestsInFlight = 5;
+
+        UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+        UA_UInt16 asyncCounter = 0;
+
+        UA_ReadRequest rr;
+        UA_ReadRequest_init(&rr);
+
+        UA_ReadValueId rvid;
+        UA_ReadValueId_init(&rvid);
+        rvid.attributeId = UA_ATTRIBUTEID_VALUE;
+        rvid.nodeId = UA_NODEID_NUMERIC(0,
+                UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME);
+
+        rr.nodesToRead = &rvid;
+        rr.nodesToReadSize = 1;
+
+        /* Send 100 requests. Only five of them are sent right away. */
+        UA_UInt32 reqId = 0;
+        for (size_t i = 0; i < 100; i++) {
+            retval = __UA_Client_AsyncService(client, &rr,
+                    &UA_TYPES[UA_TYPES_READREQUEST],
+                    (UA_ClientAsyncServiceCallback) asyncReadCallback,
+                    &UA_TYPES[UA_TYPES_READRESPONSE], &asyncCounter, &reqId);
+            ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        }
+        ck_assert_uint_eq(client->asyncServiceCallsInFlight, 5);
+        ck_assert(!TAILQ_EMPTY(&client->asyncServiceQueue));
+
+        /* Queued requests can be modified */
+        retval = UA_Client_modifyAsyncCallback(client, reqId, &asyncCounter,
+                    (UA_ClientAsyncServiceCallback) asyncReadCallback);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+        /* The queued requests are sent as the responses arrive */
+        while(asyncCounter < 100) {
+            retval |= UA_Client_run_iterate(client, 999);
+            ck_assert_uint_le(client->asyncServiceCallsInFlight, 5);
+        }
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        ck_assert_uint_eq(client->asyncServiceCallsInFlight, 0);
+        ck_assert(TAILQ_EMPTY(&client->asyncServiceQueue));
+
+        UA_Client_disconnect(client);
+        UA_Client_delete(client);
+} END_TEST
+
 START_TEST(Client_read_async_timed) {
         UA_Client *client = UA_Client_new();
         UA_ClientConfig *clientConfig = UA_Client_getConfig(client);
@@ -249,6 +302,7 @@ static Suite* testSuite_Client(void) {
     tcase_add_checked_fixture(tc_client, setup, teardown);
     tcase_add_test(tc_client, Client_read_async);
     tcase_add_test(tc_client, Client_read_async_timed);
+    tcase_add_test(tc_client, Client_read_async_window);
     tcase_add_test(tc_client, Client_connectivity_check);
     tcase_add_test(tc_client, Client_highlevel_async_readValue);
 
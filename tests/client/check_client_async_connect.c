@@ -10,6 +10,7 @@
 #include "open62541/common.h"
 
 #include "client/ua_client_internal.h"
+#include "server/ua_server_internal.h"
 
 #include <check.h>
 #include <stdlib.h>
@@ -199,6 +200,112 @@ START_TEST(Client_run_iterate) {
 }
 END_TEST
 
+#define HANDSHAKE_CLIENTS 4
+
+/* Several clients open a SecureChannel at the same time. Only one handshake
+ * is processed per server iteration. The others are queued. */
+START_TEST(Client_connect_async_handshakeLimit) {
+    UA_Server_getConfig(server)->maxHandshakesPerIteration = 1;
+
+    UA_Client *clients[HANDSHAKE_CLIENTS];
+    for(size_t i = 0; i < HANDSHAKE_CLIENTS; i++) {
+        clients[i] = UA_Client_new();
+        UA_ClientConfig_setDefault(UA_Client_getConfig(clients[i]));
+        UA_StatusCode retval =
+            UA_Client_connectAsync(clients[i], "opc.tcp://localhost:4840");
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* Let all clients send their HEL, then answer them with the server. The
+     * clients do not iterate meanwhile, so no OPN is sent yet. */
+    for(size_t i = 0; i < HANDSHAKE_CLIENTS; i++) {
+        while(clients[i]->channel.state < UA_SECURECHANNELSTATE_HEL_SENT)
+            UA_Client_run_iterate(clients[i], 0);
+    }
+    for(size_t i = 0; i < 10; i++)
+        UA_Server_run_iterate(server, false);
+
+    /* All OPN requests arrive within the same server iteration */
+    for(size_t i = 0; i < HANDSHAKE_CLIENTS; i++) {
+        while(clients[i]->channel.state < UA_SECURECHANNELSTATE_OPN_SENT)
+            UA_Client_run_iterate(clients[i], 0);
+    }
+
+    size_t activated = 0;
+    for(size_t round = 0; round < 1000 && activated < HANDSHAKE_CLIENTS; round++) {
+        UA_Server_run_iterate(server, false);
+        activated = 0;
+        for(size_t i = 0; i < HANDSHAKE_CLIENTS; i++) {
+            UA_StatusCode retval = UA_Client_run_iterate(clients[i], 0);
+            ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+            UA_SessionState ss;
+            UA_Client_getState(clients[i], NULL, &ss, NULL);
+            if(ss == UA_SESSIONSTATE_ACTIVATED)
+                activated++;
+        }
+    }
+    ck_assert_uint_eq(activated, HANDSHAKE_CLIENTS);
+
+    /* Handshakes were deferred. None remains in the queue. */
+    UA_ServerStatistics stats = UA_Server_getStatistics(server);
+    ck_assert_uint_gt(stats.scs.deferredHandshakeCount, 0);
+    ck_assert_uint_eq(stats.scs.queuedHandshakeCount, 0);
+
+    for(size_t i = 0; i < HANDSHAKE_CLIENTS; i++) {
+        UA_Client_disconnectAsync(clients[i]);
+        while(clients[i]->channel.state != UA_SECURECHANNELSTATE_CLOSED) {
+            UA_Server_run_iterate(server, false);
+            UA_Client_run_iterate(clients[i], 0);
+        }
+        UA_Client_delete(clients[i]);
+    }
+}
+END_TEST
+
+/* Renewing the token of an open SecureChannel is not throttled, even if the
+ * handshake limit of the iteration is used up */
+START_TEST(Client_connect_async_renewNotThrottled) {
+    UA_Server_getConfig(server)->maxHandshakesPerIteration = 1;
+
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+    UA_StatusCode retval = UA_Client_connectAsync(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_SessionState ss = UA_SESSIONSTATE_CLOSED;
+    for(size_t round = 0; round < 1000 && ss != UA_SESSIONSTATE_ACTIVATED; round++) {
+        UA_Server_run_iterate(server, false);
+        UA_Client_run_iterate(client, 0);
+        UA_Client_getState(client, NULL, &ss, NULL);
+    }
+    ck_assert_uint_eq(ss, UA_SESSIONSTATE_ACTIVATED);
+
+    UA_UInt32 tokenId = client->channel.securityToken.tokenId;
+    client->nextChannelRenewal = 0;
+    retval = UA_Client_renewSecureChannel(client);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* The limit is used up when the renewal arrives */
+    UA_ServerStatistics before = UA_Server_getStatistics(server);
+    for(size_t round = 0; round < 100 &&
+            client->channel.securityToken.tokenId == tokenId; round++) {
+        server->handshakesThisIteration = 1;
+        UA_Server_run_iterate(server, false);
+        UA_Client_run_iterate(client, 0);
+    }
+    ck_assert_uint_ne(client->channel.securityToken.tokenId, tokenId);
+    UA_ServerStatistics after = UA_Server_getStatistics(server);
+    ck_assert_uint_eq(after.scs.deferredHandshakeCount,
+                      before.scs.deferredHandshakeCount);
+
+    UA_Client_disconnectAsync(client);
+    while(client->channel.state != UA_SECURECHANNELSTATE_CLOSED) {
+        UA_Server_run_iterate(server, false);
+        UA_Client_run_iterate(client, 0);
+    }
+    UA_Client_delete(client);
+}
+END_TEST
+
 static Suite* testSuite_Client(void) {
     Suite *s = suite_create("Client");
     TCase *tc_client_connect = tcase_create("Client Connect Async");
@@ -208,6 +315,8 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_client_connect, Client_no_connection);
     tcase_add_test(tc_client_connect, Client_without_run_iterate);
     tcase_add_test(tc_client_connect, Client_run_iterate);
+    tcase_add_test(tc_client_connect, Client_connect_async_handshakeLimit);
+    tcase_add_test(tc_client_connect, Client_connect_async_renewNotThrottled);
     suite_add_tcase(s,tc_client_connect);
     return s;
 }
@@ -1516,6 +1516,95 @@ START_TEST(Client_subscription_transfer) {
 }
 END_TEST
 
+static UA_Boolean republishSent;
+static UA_Boolean republishReceived;
+static UA_UInt32 republishSequenceNumber;
+static UA_RepublishResponse republishResponse;
+
+static void
+republishCallback(UA_Client *client, void *userdata, UA_UInt32 requestId,
+                  void *r) {
+    UA_RepublishResponse_copy((const UA_RepublishResponse *)r, &republishResponse);
+    republishReceived = true;
+}
+
+/* Request the retransmission of the message before it is acknowledged by the
+ * next PublishRequest */
+static void
+republishDataChangeHandler(UA_Client *client, UA_UInt32 subId, void *subContext,
+                           UA_UInt32 monId, void *monContext, UA_DataValue *value) {
+    if(republishSent)
+        return;
+    UA_Client_Subscription *sub = LIST_FIRST(&client->subscriptions);
+    ck_assert_ptr_ne(sub, NULL);
+    republishSequenceNumber = sub->sequenceNumber;
+
+    UA_RepublishRequest request;
+    UA_RepublishRequest_init(&request);
+    request.subscriptionId = subId;
+    request.retransmitSequenceNumber = republishSequenceNumber;
+    UA_StatusCode retval =
+        __UA_Client_AsyncService(client, &request, &UA_TYPES[UA_TYPES_REPUBLISHREQUEST],
+                                 republishCallback,
+                                 &UA_TYPES[UA_TYPES_REPUBLISHRESPONSE], NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    republishSent = true;
+}
+
+START_TEST(Client_subscription_republish) {
+    republishSent = false;
+    republishReceived = false;
+    UA_RepublishResponse_init(&republishResponse);
+
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+    UA_CreateSubscriptionResponse response =
+        UA_Client_Subscriptions_create(client, request, NULL, NULL, NULL);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+
+    /* Monitor the server state */
+    UA_MonitoredItemCreateRequest monRequest =
+        UA_MonitoredItemCreateRequest_default(UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_STATE));
+    UA_MonitoredItemCreateResult monResponse =
+        UA_Client_MonitoredItems_createDataChange(client, response.subscriptionId,
+                                                  UA_TIMESTAMPSTORETURN_BOTH, monRequest,
+                                                  NULL, republishDataChangeHandler, NULL);
+    ck_assert_uint_eq(monResponse.statusCode, UA_STATUSCODE_GOOD);
+
+    for(size_t i = 0; i < 100 && !republishReceived; i++) {
+        UA_fakeSleep((UA_UInt32)publishingInterval + 1);
+        retval = UA_Client_run_iterate(client, (UA_UInt32)(publishingInterval + 100));
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+    ck_assert(republishReceived);
+
+    /* The retransmitted message is decoded like the original one */
+    ck_assert_uint_eq(republishResponse.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    UA_NotificationMessage *msg = &republishResponse.notificationMessage;
+    ck_assert_uint_eq(msg->sequenceNumber, republishSequenceNumber);
+    ck_assert_uint_eq(msg->notificationDataSize, 1);
+    ck_assert_uint_eq(msg->notificationData[0].encoding, UA_EXTENSIONOBJECT_DECODED);
+    ck_assert_ptr_eq(msg->notificationData[0].content.decoded.type,
+                     &UA_TYPES[UA_TYPES_DATACHANGENOTIFICATION]);
+    UA_DataChangeNotification *dcn = (UA_DataChangeNotification*)
+        msg->notificationData[0].content.decoded.data;
+    ck_assert_uint_eq(dcn->monitoredItemsSize, 1);
+    UA_Variant *v = &dcn->monitoredItems[0].value.value;
+    ck_assert(UA_Variant_hasScalarType(v, &UA_TYPES[UA_TYPES_SERVERSTATE]) ||
+              UA_Variant_hasScalarType(v, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)v->data, UA_SERVERSTATE_RUNNING);
+    UA_RepublishResponse_clear(&republishResponse);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+END_TEST
+
 #ifdef UA_ENABLE_METHODCALLS
 START_TEST(Client_methodcall) {
     UA_Client *client = UA_Client_new();
@@ -1602,6 +1691,7 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_client, Client_subscription_reconnect);
     tcase_add_test(tc_client, Client_subscription_transfer);
     tcase_add_test(tc_client, Client_subscription_writeBurst);
+    tcase_add_test(tc_client, Client_subscription_republish);
     suite_add_tcase(s,tc_client);
 
 #ifdef UA_ENABLE_METHODCALLS
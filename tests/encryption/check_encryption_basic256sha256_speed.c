@@ -0,0 +1,154 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/* Measure the throughput of large chunked responses on a loopback
+ * SecureChannel with Basic256Sha256 and SignAndEncrypt */
+
+#include <open62541/client.h>
+#include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
+#include <open62541/plugin/securitypolicy.h>
+#include <open62541/plugin/pki_default.h>
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "certificates.h"
+#include "check.h"
+#include "thread_wrapper.h"
+
+#define PAYLOADSIZE (16 * 1024 * 1024) /* Bytes of the variable value */
+#define READS 8                        /* Number of reads of the variable */
+
+UA_Server *server;
+UA_Boolean running;
+THREAD_HANDLE server_thread;
+static UA_NodeId payloadNodeId;
+
+THREAD_CALLBACK(serverloop) {
+    while(running)
+        UA_Server_run_iterate(server, true);
+    return 0;
+}
+
+static void setup(void) {
+    running = true;
+
+    UA_ByteString certificate;
+    certificate.length = CERT_DER_LENGTH;
+    certificate.data = CERT_DER_DATA;
+
+    UA_ByteString privateKey;
+    privateKey.length = KEY_DER_LENGTH;
+    privateKey.data = KEY_DER_DATA;
+
+    server = UA_Server_new();
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    UA_ServerConfig_setDefaultWithSecurityPolicies(config, 4840, &certificate, &privateKey,
+                                                   NULL, 0, NULL, 0, NULL, 0);
+    config->certificateVerification.clear(&config->certificateVerification);
+    UA_CertificateVerification_AcceptAll(&config->certificateVerification);
+    config->logger.log = NULL;
+
+    /* Set the ApplicationUri used in the certificate */
+    UA_String_clear(&config->applicationDescription.applicationUri);
+    config->applicationDescription.applicationUri =
+        UA_STRING_ALLOC("urn:unconfigured:application");
+
+    /* Add a variable with a large value */
+    UA_ByteString payload;
+    UA_StatusCode res = UA_ByteString_allocBuffer(&payload, PAYLOADSIZE);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < PAYLOADSIZE; i++)
+        payload.data[i] = (UA_Byte)i;
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Variant_setScalar(&attr.value, &payload, &UA_TYPES[UA_TYPES_BYTESTRING]);
+    attr.dataType = UA_TYPES[UA_TYPES_BYTESTRING].typeId;
+    payloadNodeId = UA_NODEID_STRING(1, "Payload");
+    res = UA_Server_addVariableNode(server, payloadNodeId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                    UA_QUALIFIEDNAME(1, "Payload"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_ByteString_clear(&payload);
+
+    UA_Server_run_startup(server);
+    THREAD_CREATE(server_thread, serverloop);
+}
+
+static void teardown(void) {
+    running = false;
+    THREAD_JOIN(server_thread);
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+}
+
+START_TEST(encryption_readSpeed) {
+    UA_ByteString certificate;
+    certificate.length = CERT_DER_LENGTH;
+    certificate.data = CERT_DER_DATA;
+
+    UA_ByteString privateKey;
+    privateKey.length = KEY_DER_LENGTH;
+    privateKey.data = KEY_DER_DATA;
+
+    UA_Client *client = UA_Client_new();
+    ck_assert(client != NULL);
+    UA_ClientConfig *cc = UA_Client_getConfig(client);
+    UA_ClientConfig_setDefaultEncryption(cc, certificate, privateKey,
+                                         NULL, 0, NULL, 0);
+    cc->certificateVerification.clear(&cc->certificateVerification);
+    UA_CertificateVerification_AcceptAll(&cc->certificateVerification);
+    cc->securityPolicyUri =
+        UA_STRING_ALLOC("http://opcfoundation.org/UA/SecurityPolicy#Basic256Sha256");
+    cc->securityMode = UA_MESSAGESECURITYMODE_SIGNANDENCRYPT;
+    cc->logger.log = NULL;
+
+    UA_StatusCode res = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    clock_t begin = clock();
+    for(size_t i = 0; i < READS; i++) {
+        UA_Variant val;
+        res = UA_Client_readValueAttribute(client, payloadNodeId, &val);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+        ck_assert(UA_Variant_hasScalarType(&val, &UA_TYPES[UA_TYPES_BYTESTRING]));
+        ck_assert_uint_eq(((UA_ByteString*)val.data)->length, PAYLOADSIZE);
+        UA_Variant_clear(&val);
+    }
+    clock_t finish = clock();
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    double megabytes = (double)READS * PAYLOADSIZE / (1024.0 * 1024.0);
+    printf("%u reads of %u bytes with Basic256Sha256/SignAndEncrypt in %f s "
+           "(%f MB/s)\n", (unsigned)READS, (unsigned)PAYLOADSIZE, time_spent,
+           megabytes / time_spent);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+END_TEST
+
+static Suite* testSuite_encryption_speed(void) {
+    Suite *s = suite_create("Speed Test Encryption Basic256Sha256");
+    TCase *tc = tcase_create("Read");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, encryption_readSpeed);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_encryption_speed();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
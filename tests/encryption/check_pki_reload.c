@@ -0,0 +1,241 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/plugin/log_stdout.h>
+#include <open62541/plugin/pki_default.h>
+#include <open62541/plugin/create_certificate.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+#include <check.h>
+
+#include "../../plugins/crypto/ua_pki_cache.h"
+#include "testing_clock.h"
+
+static char baseDir[] = "/tmp/open62541_pki_XXXXXX";
+static char trustDir[128];
+static char issuerDir[128];
+static char crlDir[128];
+#ifdef UA_ENABLE_CERT_REJECTED_DIR
+static char rejectedDir[128];
+#endif
+static char certFile[256];
+static char replacementDir[128];
+static char replacementFile[256];
+static char oldTrustDir[128];
+static char oldCertFile[256];
+
+static UA_ByteString certificate;
+static UA_ByteString privateKey;
+static UA_CertificateVerification cv;
+
+static void setup(void) {
+    ck_assert_ptr_ne(mkdtemp(baseDir), NULL);
+    snprintf(trustDir, sizeof(trustDir), "%s/trusted", baseDir);
+    snprintf(issuerDir, sizeof(issuerDir), "%s/issuer", baseDir);
+    snprintf(crlDir, sizeof(crlDir), "%s/crl", baseDir);
+    snprintf(certFile, sizeof(certFile), "%s/client.der", trustDir);
+    snprintf(replacementDir, sizeof(replacementDir), "%s/trusted.new", baseDir);
+    snprintf(replacementFile, sizeof(replacementFile), "%s/client.der", replacementDir);
+    snprintf(oldTrustDir, sizeof(oldTrustDir), "%s/trusted.old", baseDir);
+    snprintf(oldCertFile, sizeof(oldCertFile), "%s/client.der", oldTrustDir);
+    ck_assert_int_eq(mkdir(trustDir, 0700), 0);
+    ck_assert_int_eq(mkdir(issuerDir, 0700), 0);
+    ck_assert_int_eq(mkdir(crlDir, 0700), 0);
+#ifdef UA_ENABLE_CERT_REJECTED_DIR
+    snprintf(rejectedDir, sizeof(rejectedDir), "%s/rejected", baseDir);
+    ck_assert_int_eq(mkdir(rejectedDir, 0700), 0);
+#endif
+
+    UA_String subject[2] = {UA_STRING_STATIC("O=open62541"),
+                            UA_STRING_STATIC("CN=open62541Client@localhost")};
+    UA_String subjectAltName[1] = {
+        UA_STRING_STATIC("URI:urn:open62541.client.application")
+    };
+    UA_StatusCode res =
+        UA_CreateCertificate(UA_Log_Stdout, subject, 2, subjectAltName, 1,
+                             0, UA_CERTIFICATEFORMAT_DER,
+                             &privateKey, &certificate);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    memset(&cv, 0, sizeof(UA_CertificateVerification));
+#ifdef UA_ENABLE_CERT_REJECTED_DIR
+    res = UA_CertificateVerification_CertFolders(&cv, trustDir, issuerDir,
+                                                 crlDir, rejectedDir);
+#else
+    res = UA_CertificateVerification_CertFolders(&cv, trustDir, issuerDir, crlDir);
+#endif
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+static void teardown(void) {
+    cv.clear(&cv);
+    UA_ByteString_clear(&certificate);
+    UA_ByteString_clear(&privateKey);
+    unlink(certFile);
+    unlink(replacementFile);
+    unlink(oldCertFile);
+    rmdir(trustDir);
+    rmdir(replacementDir);
+    rmdir(oldTrustDir);
+    rmdir(issuerDir);
+    rmdir(crlDir);
+#ifdef UA_ENABLE_CERT_REJECTED_DIR
+    /* Remove the rejected certificates */
+    DIR *dir = opendir(rejectedDir);
+    ck_assert_ptr_ne(dir, NULL);
+    char rejectedFile[512];
+    struct dirent *de;
+    while((de = readdir(dir))) {
+        if(de->d_name[0] == '.')
+            continue;
+        snprintf(rejectedFile, sizeof(rejectedFile), "%s/%s", rejectedDir, de->d_name);
+        unlink(rejectedFile);
+    }
+    closedir(dir);
+    rmdir(rejectedDir);
+#endif
+    rmdir(baseDir);
+    memcpy(&baseDir[sizeof(baseDir) - 7], "XXXXXX", 6);
+}
+
+static void
+writeCertificate(const char *path) {
+    FILE *fp = fopen(path, "wb");
+    ck_assert_ptr_ne(fp, NULL);
+    ck_assert_uint_eq(fwrite(certificate.data, 1, certificate.length, fp),
+                      certificate.length);
+    fclose(fp);
+}
+
+static void
+writeTrustedCertificate(void) {
+    writeCertificate(certFile);
+}
+
+START_TEST(Pki_reloadOnFolderChange) {
+    /* Not in the trust list. The result is cached. */
+    UA_StatusCode res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(cv.verifyCertificate(cv.context, &certificate), res);
+
+    /* The new file in the trust list folder is detected */
+    writeTrustedCertificate();
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Removed from the trust list */
+    ck_assert_int_eq(unlink(certFile), 0);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+} END_TEST
+
+START_TEST(Pki_reloadOnFolderReplaced) {
+    UA_StatusCode res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+
+    /* Rename a prepared folder into the place of the trust list folder */
+    ck_assert_int_eq(mkdir(replacementDir, 0700), 0);
+    writeCertificate(replacementFile);
+    ck_assert_int_eq(rename(trustDir, oldTrustDir), 0);
+    ck_assert_int_eq(rename(replacementDir, trustDir), 0);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* The replaced folder is watched. Changes in the old folder are not
+     * relevant. */
+    writeCertificate(oldCertFile);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(unlink(certFile), 0);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+
+    /* The folder is deleted and created again */
+    ck_assert_int_eq(rmdir(trustDir), 0);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(mkdir(trustDir, 0700), 0);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+    writeTrustedCertificate();
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+} END_TEST
+
+START_TEST(Pki_explicitReload) {
+    UA_StatusCode res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_ne(res, UA_STATUSCODE_GOOD);
+
+    writeTrustedCertificate();
+    res = UA_CertificateVerification_Reload(&cv);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = cv.verifyCertificate(cv.context, &certificate);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Only the PKI plugins with a trust store can be reloaded */
+    UA_CertificateVerification acceptAll;
+    memset(&acceptAll, 0, sizeof(UA_CertificateVerification));
+    UA_CertificateVerification_AcceptAll(&acceptAll);
+    res = UA_CertificateVerification_Reload(&acceptAll);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADINTERNALERROR);
+    acceptAll.clear(&acceptAll);
+} END_TEST
+
+/* Cached results expire after the lifetime of the cache or earlier, when the
+ * certificate expires */
+START_TEST(Pki_cacheExpiry) {
+    UA_PKICache cache;
+    UA_PKICache_init(&cache);
+    UA_StatusCode res = UA_STATUSCODE_BADINTERNALERROR;
+
+    /* The certificate expires in two seconds */
+    UA_PKICache_store(&cache, &certificate, UA_STATUSCODE_GOOD, 2 * UA_DATETIME_SEC);
+    ck_assert(UA_PKICache_lookup(&cache, &certificate, &res));
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_fakeSleep(2001);
+    ck_assert(!UA_PKICache_lookup(&cache, &certificate, &res));
+
+    /* Capped at the lifetime of the cache */
+    UA_PKICache_store(&cache, &certificate, UA_STATUSCODE_GOOD,
+                      2 * UA_PKICACHE_LIFETIME);
+    UA_fakeSleep((UA_UInt32)(UA_PKICACHE_LIFETIME / UA_DATETIME_MSEC) - 1);
+    ck_assert(UA_PKICache_lookup(&cache, &certificate, &res));
+    UA_fakeSleep(2);
+    ck_assert(!UA_PKICache_lookup(&cache, &certificate, &res));
+
+    /* Already expired */
+    UA_PKICache_store(&cache, &certificate, UA_STATUSCODE_GOOD, 0);
+    ck_assert(!UA_PKICache_lookup(&cache, &certificate, &res));
+
+    UA_PKICache_clear(&cache);
+} END_TEST
+
+static Suite *testSuite_pki_reload(void) {
+    Suite *s = suite_create("PKI Reload");
+    TCase *tc_reload = tcase_create("Reload the trust store");
+    tcase_add_checked_fixture(tc_reload, setup, teardown);
+    tcase_add_test(tc_reload, Pki_reloadOnFolderChange);
+    tcase_add_test(tc_reload, Pki_reloadOnFolderReplaced);
+    tcase_add_test(tc_reload, Pki_explicitReload);
+    tcase_add_test(tc_reload, Pki_cacheExpiry);
+    suite_add_tcase(s, tc_reload);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_pki_reload();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,176 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information. */
+
+/* Measure the throughput of async method calls. A pool of worker threads
+ * processes the calls and returns the results concurrently. */
+
+#include <open62541/server_config_default.h>
+#include <open62541/client.h>
+#include <open62541/client_config_default.h>
+
+#include "testing_clock.h"
+#include "thread_wrapper.h"
+
+#include <check.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WORKERS 4
+#define REQUESTS 100 /* Number of CallRequests */
+#define CALLS 100    /* Method calls per CallRequest */
+
+static UA_Server *server;
+static UA_Boolean running;
+static UA_Boolean workersRunning;
+static THREAD_HANDLE server_thread;
+static THREAD_HANDLE workers[WORKERS];
+static size_t responses;
+static size_t goodResults;
+
+static UA_StatusCode
+methodCallback(UA_Server *serverArg,
+               const UA_NodeId *sessionId, void *sessionHandle,
+               const UA_NodeId *methodId, void *methodContext,
+               const UA_NodeId *objectId, void *objectContext,
+               size_t inputSize, const UA_Variant *input,
+               size_t outputSize, UA_Variant *output) {
+    return UA_STATUSCODE_GOOD;
+}
+
+THREAD_CALLBACK(serverloop) {
+    while(running)
+        UA_Server_run_iterate(server, true);
+    return 0;
+}
+
+THREAD_CALLBACK(workerLoop) {
+    while(workersRunning) {
+        UA_AsyncOperationType type;
+        const UA_AsyncOperationRequest *request = NULL;
+        void *context = NULL;
+        if(!UA_Server_getAsyncOperationNonBlocking(server, &type, &request,
+                                                   &context, NULL)) {
+            UA_realSleep(1);
+            continue;
+        }
+        UA_AsyncOperationResponse response;
+        response.callMethodResult = UA_Server_call(server, &request->callMethodRequest);
+        UA_Server_setAsyncOperationResult(server, &response, context);
+        UA_CallMethodResult_clear(&response.callMethodResult);
+    }
+    return 0;
+}
+
+static void
+callResponseCallback(UA_Client *client, void *userdata,
+                     UA_UInt32 requestId, UA_CallResponse *cr) {
+    responses++;
+    for(size_t i = 0; i < cr->resultsSize; i++) {
+        if(cr->results[i].statusCode == UA_STATUSCODE_GOOD)
+            goodResults++;
+    }
+}
+
+static UA_Double
+wallTime(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (UA_Double)ts.tv_sec + (UA_Double)ts.tv_nsec / 1e9;
+}
+
+static void setup(void) {
+    responses = 0;
+    goodResults = 0;
+    server = UA_Server_new();
+    UA_ServerConfig_setDefault(UA_Server_getConfig(server));
+
+    UA_MethodAttributes methodAttr = UA_MethodAttributes_default;
+    methodAttr.executable = true;
+    methodAttr.userExecutable = true;
+    UA_StatusCode res =
+        UA_Server_addMethodNode(server, UA_NODEID_STRING(1, "asyncMethod"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                UA_QUALIFIEDNAME(1, "asyncMethod"),
+                                methodAttr, &methodCallback,
+                                0, NULL, 0, NULL, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_setMethodNodeAsync(server, UA_NODEID_STRING(1, "asyncMethod"), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Server_run_startup(server);
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+    workersRunning = true;
+    for(size_t i = 0; i < WORKERS; i++)
+        THREAD_CREATE(workers[i], workerLoop);
+}
+
+static void teardown(void) {
+    workersRunning = false;
+    for(size_t i = 0; i < WORKERS; i++)
+        THREAD_JOIN(workers[i]);
+    running = false;
+    THREAD_JOIN(server_thread);
+    UA_Server_run_shutdown(server);
+    UA_Server_delete(server);
+}
+
+START_TEST(asyncMethodSpeed) {
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_CallMethodRequest items[CALLS];
+    for(size_t i = 0; i < CALLS; i++) {
+        UA_CallMethodRequest_init(&items[i]);
+        items[i].objectId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+        items[i].methodId = UA_NODEID_STRING(1, "asyncMethod");
+    }
+    UA_CallRequest request;
+    UA_CallRequest_init(&request);
+    request.methodsToCall = items;
+    request.methodsToCallSize = CALLS;
+
+    UA_Double begin = wallTime();
+    for(size_t i = 0; i < REQUESTS; i++) {
+        retval = UA_Client_sendAsyncRequest(client, &request, &UA_TYPES[UA_TYPES_CALLREQUEST],
+                                            (UA_ClientAsyncServiceCallback)callResponseCallback,
+                                            &UA_TYPES[UA_TYPES_CALLRESPONSE], NULL, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* Wait for all responses. Give up after 60s. */
+    while(responses < REQUESTS && wallTime() - begin < 60.0)
+        UA_Client_run_iterate(client, 10);
+    UA_Double duration = wallTime() - begin;
+
+    ck_assert_uint_eq(responses, REQUESTS);
+    ck_assert_uint_eq(goodResults, REQUESTS * CALLS);
+    printf("%u async method calls with %u workers in %f s (%f calls/s)\n",
+           (unsigned)(REQUESTS * CALLS), (unsigned)WORKERS, duration,
+           (UA_Double)(REQUESTS * CALLS) / duration);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+static Suite * testSuite_asyncMethodSpeed(void) {
+    Suite *s = suite_create("Async Method Speed");
+    TCase *tc = tcase_create("Async Method Speed");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, asyncMethodSpeed);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_asyncMethodSpeed();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
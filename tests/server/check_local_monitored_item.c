@@ -118,6 +118,100 @@ START_TEST(Server_LocalMonitoredItem) {
 }
 END_TEST
 
+static UA_UInt32 lastWrittenValue = 0;
+
+static void
+recordValueCallback(UA_Server *thisServer, UA_UInt32 monitoredItemId,
+                    void *monitoredItemContext, const UA_NodeId *nodeId,
+                    void *nodeContext, UA_UInt32 attributeId,
+                    const UA_DataValue *value) {
+    lastWrittenValue = *((UA_UInt32*)value->value.data);
+    callbackCount++;
+}
+
+static void
+writeUInt32(UA_UInt32 value) {
+    UA_Variant val;
+    UA_Variant_setScalar(&val, &value, &UA_TYPES[UA_TYPES_UINT32]);
+    ASSERT_STATUSCODE(UA_Server_writeValue(server, outNodeId, val), UA_STATUSCODE_GOOD);
+}
+
+/* Values stored in the node are sampled when written. The sampling interval
+ * limits the rate of the samples. */
+START_TEST(Server_LocalMonitoredItemWriteTriggered) {
+    callbackCount = 0;
+
+    UA_MonitoredItemCreateRequest monitorRequest =
+        UA_MonitoredItemCreateRequest_default(outNodeId);
+    monitorRequest.requestedParameters.samplingInterval = 100.0;
+    monitorRequest.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    UA_MonitoredItemCreateResult result =
+        UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_BOTH,
+                                                monitorRequest, NULL,
+                                                &recordValueCallback);
+    ASSERT_STATUSCODE(result.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(callbackCount, 1);
+    ck_assert_uint_eq(lastWrittenValue, 40);
+
+    /* Within the sampling interval. The sample is taken at its end. */
+    UA_fakeSleep(10);
+    writeUInt32(41);
+    writeUInt32(42);
+    ck_assert_uint_eq(callbackCount, 1);
+    UA_fakeSleep(100);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(callbackCount, 2);
+    ck_assert_uint_eq(lastWrittenValue, 42);
+
+    /* Without a write nothing is sampled */
+    UA_fakeSleep(1000);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(callbackCount, 2);
+
+    /* After the sampling interval the write is sampled right away */
+    writeUInt32(43);
+    ck_assert_uint_eq(callbackCount, 3);
+    ck_assert_uint_eq(lastWrittenValue, 43);
+}
+END_TEST
+
+static UA_UInt32 onReadCount = 0;
+
+static void
+countOnRead(UA_Server *s, const UA_NodeId *sessionId, void *sessionContext,
+            const UA_NodeId *nodeId, void *nodeContext,
+            const UA_NumericRange *range, const UA_DataValue *value) {
+    onReadCount++;
+}
+
+/* With an onRead callback the value can change without a write. The
+ * MonitoredItem is polled again. */
+START_TEST(Server_LocalMonitoredItemOnReadPolled) {
+    callbackCount = 0;
+
+    UA_MonitoredItemCreateRequest monitorRequest =
+        UA_MonitoredItemCreateRequest_default(outNodeId);
+    monitorRequest.requestedParameters.samplingInterval = 100.0;
+    monitorRequest.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    UA_MonitoredItemCreateResult result =
+        UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_BOTH,
+                                                monitorRequest, NULL,
+                                                &recordValueCallback);
+    ASSERT_STATUSCODE(result.statusCode, UA_STATUSCODE_GOOD);
+
+    UA_ValueCallback callback;
+    memset(&callback, 0, sizeof(UA_ValueCallback));
+    callback.onRead = countOnRead;
+    ASSERT_STATUSCODE(UA_Server_setVariableNode_valueCallback(server, outNodeId, callback),
+                      UA_STATUSCODE_GOOD);
+
+    onReadCount = 0;
+    UA_fakeSleep(101);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(onReadCount, 1);
+}
+END_TEST
+
 /* Custom datatype with a String NodeId */
 typedef struct {
     UA_Float p;
@@ -273,18 +367,76 @@ START_TEST(Server_LocalMonitoredItemIndexRangeOutOfBounds) {
 }
 END_TEST
 
+static void
+writeUInt32Range(UA_UInt32 value, char *range) {
+    UA_WriteValue wv;
+    UA_WriteValue_init(&wv);
+    wv.nodeId = outNodeId;
+    wv.attributeId = UA_ATTRIBUTEID_VALUE;
+    wv.indexRange = UA_STRING(range);
+    wv.value.hasValue = true;
+    UA_Variant_setArray(&wv.value.value, &value, 1, &UA_TYPES[UA_TYPES_UINT32]);
+    ASSERT_STATUSCODE(UA_Server_write(server, &wv), UA_STATUSCODE_GOOD);
+}
+
+/* Writes with an IndexRange only sample the MonitoredItems that surveil an
+ * overlapping range. The trigger includes the timestamp. So every sample would
+ * generate a notification. */
+START_TEST(Server_LocalMonitoredItemIndexRangeWrite) {
+    callbackCount = 0;
+    expectedDataValueStatus = UA_STATUSCODE_GOOD;
+
+    UA_DataChangeFilter filter;
+    UA_DataChangeFilter_init(&filter);
+    filter.trigger = UA_DATACHANGETRIGGER_STATUSVALUETIMESTAMP;
+    UA_MonitoredItemCreateRequest monitorRequest =
+        UA_MonitoredItemCreateRequest_default(outNodeId);
+    monitorRequest.requestedParameters.samplingInterval = 0.0;
+    monitorRequest.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    monitorRequest.itemToMonitor.indexRange = UA_STRING("0:1");
+    UA_ExtensionObject_setValue(&monitorRequest.requestedParameters.filter,
+                                &filter, &UA_TYPES[UA_TYPES_DATACHANGEFILTER]);
+    UA_MonitoredItemCreateResult result = UA_Server_createDataChangeMonitoredItem(
+        server, UA_TIMESTAMPSTORETURN_BOTH, monitorRequest, NULL,
+        &dataChangeNotificationValidateStatusCallback);
+    ASSERT_STATUSCODE(result.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(callbackCount, 1);
+
+    /* Outside of the surveilled range */
+    UA_fakeSleep(10);
+    writeUInt32Range(50, "2");
+    ck_assert_uint_eq(callbackCount, 1);
+
+    /* Inside the surveilled range */
+    UA_fakeSleep(10);
+    writeUInt32Range(51, "1");
+    ck_assert_uint_eq(callbackCount, 2);
+
+    /* Without an IndexRange */
+    UA_fakeSleep(10);
+    UA_UInt32 values[3] = {1, 2, 3};
+    UA_Variant v;
+    UA_Variant_setArray(&v, values, 3, &UA_TYPES[UA_TYPES_UINT32]);
+    ASSERT_STATUSCODE(UA_Server_writeValue(server, outNodeId, v), UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(callbackCount, 3);
+}
+END_TEST
+
 static Suite * testSuite_Client(void) {
     Suite *s = suite_create("Local Monitored Item");
     TCase *tc_server = tcase_create("Local Monitored Item Basic");
     tcase_add_checked_fixture(tc_server, setup, teardown);
     tcase_add_test(tc_server, Server_LocalMonitoredItem);
     tcase_add_test(tc_server, Server_LocalMonitoredItem_CustomType);
+    tcase_add_test(tc_server, Server_LocalMonitoredItemWriteTriggered);
+    tcase_add_test(tc_server, Server_LocalMonitoredItemOnReadPolled);
     suite_add_tcase(s, tc_server);
 
     TCase *tc_server_indexrange = tcase_create("Local Monitored Item Index Range");
     tcase_add_checked_fixture(tc_server_indexrange, setupIndexRange, teardown);
     tcase_add_test(tc_server_indexrange, Server_LocalMonitoredItemIndexRange);
     tcase_add_test(tc_server_indexrange, Server_LocalMonitoredItemIndexRangeOutOfBounds);
+    tcase_add_test(tc_server_indexrange, Server_LocalMonitoredItemIndexRangeWrite);
     suite_add_tcase(s, tc_server_indexrange);
 
     return s;
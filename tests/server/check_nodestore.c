@@ -257,6 +257,75 @@ START_TEST(profileGetDelete) {
 }
 END_TEST
 
+/* A single target is stored inline. An array of size one that was set up
+ * without the inline flag remains valid. */
+START_TEST(referenceTargetRepresentation) {
+    UA_Node *n = createNode(0, 2253);
+    UA_ExpandedNodeId t1 = UA_EXPANDEDNODEID_NUMERIC(0, 1);
+    UA_ExpandedNodeId t2 = UA_EXPANDEDNODEID_STRING(1, "target2");
+
+    /* The first target is inline */
+    UA_StatusCode res = UA_Node_addReference(n, 0, true, &t1, 0);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_NodeReferenceKind *rk = &n->head.references[0];
+    ck_assert_uint_eq(rk->targetsSize, 1);
+    ck_assert(rk->hasRefInline);
+
+    /* The second target moves both targets into an array */
+    res = UA_Node_addReference(n, 0, true, &t2, 0);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    rk = &n->head.references[0];
+    ck_assert_uint_eq(rk->targetsSize, 2);
+    ck_assert(!rk->hasRefInline);
+    ck_assert_ptr_ne(UA_NodeReferenceKind_findTarget(rk, &t1), NULL);
+    ck_assert_ptr_ne(UA_NodeReferenceKind_findTarget(rk, &t2), NULL);
+
+    /* The remaining target moves back inline */
+    res = UA_Node_deleteReference(n, 0, true, &t1);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    rk = &n->head.references[0];
+    ck_assert_uint_eq(rk->targetsSize, 1);
+    ck_assert(rk->hasRefInline);
+    const UA_ReferenceTarget *rt = UA_NodeReferenceKind_iterate(rk, NULL);
+    ck_assert_ptr_ne(rt, NULL);
+    ck_assert(UA_NodePointer_equal(rt->targetId,
+                                   UA_NodePointer_fromExpandedNodeId(&t2)));
+    ck_assert_ptr_eq(UA_NodeReferenceKind_iterate(rk, rt), NULL);
+    UA_Node_deleteReferences(n);
+
+    /* Set up an array with a single target without the inline flag */
+    UA_ReferenceTarget *array = (UA_ReferenceTarget*)
+        UA_calloc(1, sizeof(UA_ReferenceTarget));
+    ck_assert_ptr_ne(array, NULL);
+    res = UA_NodePointer_copy(UA_NodePointer_fromExpandedNodeId(&t1),
+                              &array[0].targetId);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    n->head.references = (UA_NodeReferenceKind*)
+        UA_calloc(1, sizeof(UA_NodeReferenceKind));
+    ck_assert_ptr_ne(n->head.references, NULL);
+    n->head.referencesSize = 1;
+    rk = &n->head.references[0];
+    rk->targets.array = array;
+    rk->targetsSize = 1;
+    ck_assert_ptr_eq(UA_NodeReferenceKind_iterate(rk, NULL), &array[0]);
+    ck_assert_ptr_eq(UA_NodeReferenceKind_findTarget(rk, &t1), &array[0]);
+
+    /* Grow and shrink the array */
+    res = UA_Node_addReference(n, 0, true, &t2, 0);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    rk = &n->head.references[0];
+    ck_assert_uint_eq(rk->targetsSize, 2);
+    ck_assert(!rk->hasRefInline);
+    res = UA_Node_deleteReference(n, 0, true, &t2);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Node_deleteReference(n, 0, true, &t1);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(n->head.referencesSize, 0);
+
+    ns.deleteNode(ns.context, n);
+}
+END_TEST
+
 static Suite * namespace_suite (void) {
     Suite *s = suite_create ("UA_NodeStore");
 
@@ -275,6 +344,11 @@ static Suite * namespace_suite (void) {
     tcase_add_test (tc_replace, replaceOldNode);
     suite_add_tcase (s, tc_replace);
 
+    TCase *tc_refs = tcase_create("References");
+    tcase_add_checked_fixture(tc_refs, setupZipTree, teardown);
+    tcase_add_test (tc_refs, referenceTargetRepresentation);
+    suite_add_tcase (s, tc_refs);
+
     TCase* tc_iterate = tcase_create ("Iterate-ZipTree");
     tcase_add_checked_fixture(tc_iterate, setupZipTree, teardown);
     tcase_add_test (tc_iterate, iterateOverUA_NodeStoreShallNotVisitEmptyNodes);
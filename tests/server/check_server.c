@@ -58,6 +58,200 @@ START_TEST(checkGetNamespaceById) {
     UA_String_clear(&searchResultNamespace);
 } END_TEST
 
+static size_t
+browseForwardCount(const UA_NodeId nodeId) {
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = nodeId;
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    size_t count = br.referencesSize;
+    UA_BrowseResult_clear(&br);
+    return count;
+}
+
+START_TEST(checkNodestoreMemoryUsage) {
+    UA_NodestoreMemoryUsage before = UA_Server_getNodestoreMemoryUsage(server);
+    ck_assert_uint_gt(before.total.nodes, 0);
+    ck_assert_uint_gt(before.total.references, 0);
+    ck_assert_uint_eq(before.total.nodes,
+                      before.objects.nodes + before.variables.nodes +
+                      before.methods.nodes + before.objectTypes.nodes +
+                      before.variableTypes.nodes + before.referenceTypes.nodes +
+                      before.dataTypes.nodes + before.views.nodes);
+    ck_assert_uint_eq(before.total.referenceMemory,
+                      before.objects.referenceMemory + before.variables.referenceMemory +
+                      before.methods.referenceMemory + before.objectTypes.referenceMemory +
+                      before.variableTypes.referenceMemory +
+                      before.referenceTypes.referenceMemory +
+                      before.dataTypes.referenceMemory + before.views.referenceMemory);
+
+    /* Add a variable with a string NodeId */
+    UA_NodeId varId = UA_NODEID_STRING(1, "Plant.Area1.Motor1.Speed");
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, varId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "Speed"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_NodestoreMemoryUsage added = UA_Server_getNodestoreMemoryUsage(server);
+    ck_assert_uint_eq(added.variables.nodes, before.variables.nodes + 1);
+    ck_assert_uint_gt(added.variables.nodeMemory, before.variables.nodeMemory);
+    ck_assert_uint_gt(added.total.references, before.total.references);
+    size_t varRefs = browseForwardCount(varId);
+
+    /* Add a second target to a ReferenceKind with a single (inline) target.
+     * Then remove the targets one by one. */
+    UA_ExpandedNodeId target2 = UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_PROPERTYTYPE);
+    res = UA_Server_addReference(server, varId,
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION),
+                                 target2, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(browseForwardCount(varId), varRefs + 1);
+    res = UA_Server_deleteReference(server, varId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION),
+                                    true, target2, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(browseForwardCount(varId), varRefs);
+    UA_NodestoreMemoryUsage after = UA_Server_getNodestoreMemoryUsage(server);
+    ck_assert_uint_eq(after.total.referenceMemory, added.total.referenceMemory);
+
+    res = UA_Server_deleteReference(server, varId,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION),
+                                    true, UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(browseForwardCount(varId), varRefs - 1);
+
+    res = UA_Server_deleteNode(server, varId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    after = UA_Server_getNodestoreMemoryUsage(server);
+    ck_assert_uint_eq(after.total.nodes, before.total.nodes);
+    ck_assert_uint_eq(after.total.referenceMemory, before.total.referenceMemory);
+} END_TEST
+
+static UA_NodeId
+addNamedVariable(UA_UInt32 parentId, UA_UInt32 id, char *name) {
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US", name);
+    UA_NodeId nodeId = UA_NODEID_NUMERIC(1, id);
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, nodeId, UA_NODEID_NUMERIC(1, parentId),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                  UA_QUALIFIEDNAME(1, name),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    return nodeId;
+}
+
+START_TEST(checkInternedStrings) {
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    for(UA_UInt32 i = 1; i <= 2; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "Motor%u", (unsigned)i);
+        UA_StatusCode res =
+            UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, i),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                    UA_QUALIFIEDNAME(1, name),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                    oattr, NULL, NULL);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+    UA_NodeId t1 = addNamedVariable(1, 11, "Temperature");
+    UA_NodeId t2 = addNamedVariable(2, 12, "Temperature");
+
+    /* Both nodes share the same strings */
+    UA_LOCK(&server->serviceMutex);
+    const UA_Node *n1 = UA_NODESTORE_GET(server, &t1);
+    const UA_Node *n2 = UA_NODESTORE_GET(server, &t2);
+    ck_assert(n1->head.internedBrowseName);
+    ck_assert_ptr_eq(n1->head.browseName.name.data, n2->head.browseName.name.data);
+    ck_assert(n1->head.displayName->interned);
+    ck_assert_ptr_eq(n1->head.displayName->localizedText.text.data,
+                     n2->head.displayName->localizedText.text.data);
+    UA_NODESTORE_RELEASE(server, n1);
+    UA_NODESTORE_RELEASE(server, n2);
+    UA_UNLOCK(&server->serviceMutex);
+
+    /* Resolve the BrowsePath via the interned names */
+    UA_QualifiedName path[2] = {UA_QUALIFIEDNAME(1, "Motor2"),
+                                UA_QUALIFIEDNAME(1, "Temperature")};
+    UA_BrowsePathResult bpr =
+        UA_Server_browseSimplifiedBrowsePath(server,
+                                             UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                             2, path);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(bpr.targetsSize, 1);
+    ck_assert(UA_NodeId_equal(&bpr.targets[0].targetId.nodeId, &t2));
+    UA_BrowsePathResult_clear(&bpr);
+
+    /* No match for a name that is not in the pool */
+    path[1] = UA_QUALIFIEDNAME(1, "Pressure");
+    bpr = UA_Server_browseSimplifiedBrowsePath(server,
+                                               UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                               2, path);
+    ck_assert_uint_eq(bpr.statusCode, UA_STATUSCODE_BADNOMATCH);
+    UA_BrowsePathResult_clear(&bpr);
+
+    /* Writing the DisplayName of one node does not change the other */
+    UA_LocalizedText dn = UA_LOCALIZEDTEXT("en-US", "Temp");
+    UA_StatusCode res = UA_Server_writeDisplayName(server, t1, dn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_LocalizedText out;
+    res = UA_Server_readDisplayName(server, t2, &out);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_String expected = UA_STRING("Temperature");
+    ck_assert(UA_String_equal(&out.text, &expected));
+    UA_LocalizedText_clear(&out);
+
+    /* The pooled string is removed with the last node */
+    UA_String name = UA_STRING("Temperature");
+    ck_assert_uint_eq(UA_Server_deleteNode(server, t1, true), UA_STATUSCODE_GOOD);
+    ck_assert_ptr_ne(UA_StringPool_find(server->stringPool, &name), NULL);
+    ck_assert_uint_eq(UA_Server_deleteNode(server, t2, true), UA_STATUSCODE_GOOD);
+    ck_assert_ptr_eq(UA_StringPool_find(server->stringPool, &name), NULL);
+} END_TEST
+
+#if UA_MULTITHREADING >= 100
+#define POOL_THREADS 8
+#define POOL_ROUNDS 100000
+
+/* Intern and release the same string concurrently. The pool keeps its own
+ * lock as nodes are also cleared without the service mutex. */
+UA_THREAD_CALLBACK(internReleaseLoop) {
+    UA_StringPool *pool = (UA_StringPool*)context;
+    UA_String name = UA_STRING("SharedName");
+    for(size_t i = 0; i < POOL_ROUNDS; i++) {
+        UA_String s;
+        UA_String_copy(&name, &s);
+        if(UA_StringPool_intern(pool, &s))
+            UA_StringPool_release(&s);
+        else
+            UA_String_clear(&s);
+    }
+    return NULL;
+}
+
+START_TEST(checkInternedStringsConcurrent) {
+    UA_StringPool *pool = UA_StringPool_new();
+    ck_assert_ptr_ne(pool, NULL);
+    UA_Thread threads[POOL_THREADS];
+    for(size_t i = 0; i < POOL_THREADS; i++)
+        UA_THREAD_CREATE(&threads[i], internReleaseLoop, pool);
+    for(size_t i = 0; i < POOL_THREADS; i++)
+        UA_THREAD_JOIN(&threads[i]);
+    UA_String name = UA_STRING("SharedName");
+    ck_assert_ptr_eq(UA_StringPool_find(pool, &name), NULL);
+    UA_StringPool_delete(pool);
+} END_TEST
+#endif
+
 static void timedCallbackHandler(UA_Server *s, void *data) {
     *((UA_Boolean*)data) = false;  // stop the server via a timedCallback
 }
@@ -81,6 +275,11 @@ int main(void) {
     tcase_add_test(tc_call, checkGetNamespaceByName);
     tcase_add_test(tc_call, checkGetNamespaceById);
     tcase_add_test(tc_call, checkServer_run);
+    tcase_add_test(tc_call, checkNodestoreMemoryUsage);
+    tcase_add_test(tc_call, checkInternedStrings);
+#if UA_MULTITHREADING >= 100
+    tcase_add_test(tc_call, checkInternedStringsConcurrent);
+#endif
     suite_add_tcase(s, tc_call);
 
     SRunner *sr = srunner_create(s);
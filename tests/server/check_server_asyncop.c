@@ -8,6 +8,7 @@
 #include <open62541/server.h>
 #include <open62541/client.h>
 #include <open62541/client_config_default.h>
+#include <open62541/client_highlevel.h>
 #include <open62541/client_highlevel_async.h>
 #include <open62541/plugin/log_stdout.h>
 #include "testing_clock.h"
@@ -20,6 +21,11 @@ THREAD_HANDLE server_thread;
 static UA_Server *server;
 static size_t clientCounter;
 
+/* Set by the sync method. The async method is expected to be executed with
+ * the same session. */
+static UA_NodeId clientSessionId;
+static volatile UA_Boolean otherSession;
+
 static UA_StatusCode
 methodCallback(UA_Server *serverArg,
          const UA_NodeId *sessionId, void *sessionHandle,
@@ -27,6 +33,20 @@ methodCallback(UA_Server *serverArg,
          const UA_NodeId *objectId, void *objectContext,
          size_t inputSize, const UA_Variant *input,
          size_t outputSize, UA_Variant *output) {
+    if(!UA_NodeId_isNull(&clientSessionId) &&
+       !UA_NodeId_equal(sessionId, &clientSessionId))
+        otherSession = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+syncMethodCallback(UA_Server *serverArg,
+                   const UA_NodeId *sessionId, void *sessionHandle,
+                   const UA_NodeId *methodId, void *methodContext,
+                   const UA_NodeId *objectId, void *objectContext,
+                   size_t inputSize, const UA_Variant *input,
+                   size_t outputSize, UA_Variant *output) {
+    clientSessionId = *sessionId; /* The SessionId is a Guid */
     return UA_STATUSCODE_GOOD;
 }
 
@@ -37,19 +57,61 @@ clientReceiveCallback(UA_Client *client, void *userdata,
     clientCounter++;
 }
 
+static UA_ReadResponse readResponse;
+
+static void
+clientReadCallback(UA_Client *client, void *userdata,
+                   UA_UInt32 requestId, UA_ReadResponse *rr) {
+    UA_ReadResponse_copy(rr, &readResponse);
+    clientCounter++;
+}
+
+static UA_StatusCode writeResult;
+
+static void
+clientWriteCallback(UA_Client *client, void *userdata,
+                    UA_UInt32 requestId, UA_WriteResponse *wr) {
+    writeResult = wr->responseHeader.serviceResult;
+    if(writeResult == UA_STATUSCODE_GOOD && wr->resultsSize == 1)
+        writeResult = wr->results[0];
+    clientCounter++;
+}
+
+/* Track the number of concurrent executions of the limited method */
+static volatile size_t limitedRunning;
+static volatile size_t limitedMaxRunning;
+
+static UA_StatusCode
+limitedMethodCallback(UA_Server *serverArg,
+                      const UA_NodeId *sessionId, void *sessionHandle,
+                      const UA_NodeId *methodId, void *methodContext,
+                      const UA_NodeId *objectId, void *objectContext,
+                      size_t inputSize, const UA_Variant *input,
+                      size_t outputSize, UA_Variant *output) {
+    limitedRunning++;
+    if(limitedRunning > limitedMaxRunning)
+        limitedMaxRunning = limitedRunning;
+    UA_realSleep(10);
+    limitedRunning--;
+    return UA_STATUSCODE_GOOD;
+}
+
 THREAD_CALLBACK(serverloop) {
     while(running)
         UA_Server_run_iterate(server, true);
     return 0;
 }
 
-static void setup(void) {
+static void setupWithWorkers(UA_UInt16 workers) {
     clientCounter = 0;
+    clientSessionId = UA_NODEID_NULL;
+    otherSession = false;
     running = true;
     server = UA_Server_new();
     UA_ServerConfig *config = UA_Server_getConfig(server);
     UA_ServerConfig_setDefault(config);
     config->asyncOperationTimeout = 2000.0; /* 2 seconds */
+    config->asyncOperationWorkers = workers;
 
     UA_MethodAttributes methodAttr = UA_MethodAttributes_default;
     methodAttr.executable = true;
@@ -61,7 +123,7 @@ static void setup(void) {
                             UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
                             UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
                             UA_QUALIFIEDNAME(1, "method"),
-                            methodAttr, &methodCallback,
+                            methodAttr, &syncMethodCallback,
                             0, NULL, 0, NULL, NULL, NULL);
     ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
 
@@ -76,10 +138,57 @@ static void setup(void) {
     res = UA_Server_setMethodNodeAsync(server, UA_NODEID_STRING(1, "asyncMethod"), true);
     ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
 
+    /* Asynchronous Variable */
+    UA_VariableAttributes varAttr = UA_VariableAttributes_default;
+    varAttr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_Int32 value = 42;
+    UA_Variant_setScalar(&varAttr.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    res = UA_Server_addVariableNode(server, UA_NODEID_STRING(1, "asyncVariable"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                    UA_QUALIFIEDNAME(1, "asyncVariable"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    varAttr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_setVariableNodeAsync(server, UA_NODEID_STRING(1, "asyncVariable"), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Asynchronous static variable from ns0 */
+    res = UA_Server_setVariableNodeAsync(server,
+        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_PRODUCTNAME), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Asynchronous Method with a concurrency limit */
+    res = UA_Server_addMethodNode(server, UA_NODEID_STRING(1, "limitedMethod"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                  UA_QUALIFIEDNAME(1, "limitedMethod"),
+                                  methodAttr, &limitedMethodCallback,
+                                  0, NULL, 0, NULL, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_setMethodNodeAsync(server, UA_NODEID_STRING(1, "limitedMethod"), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_setMethodNodeAsyncConcurrency(server,
+                                                  UA_NODEID_STRING(1, "limitedMethod"), 1);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* The limit can only be set for methods */
+    res = UA_Server_setMethodNodeAsyncConcurrency(server,
+                                                  UA_NODEID_STRING(1, "asyncVariable"), 1);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODECLASSINVALID);
+
     UA_Server_run_startup(server);
     THREAD_CREATE(server_thread, serverloop);
 }
 
+static void setup(void) {
+    setupWithWorkers(0);
+}
+
+static void setupWorkers(void) {
+    setupWithWorkers(4);
+}
+
 static void teardown(void) {
     running = false;
     THREAD_JOIN(server_thread);
@@ -246,6 +355,230 @@ START_TEST(Async_timeout_worker) {
     UA_Client_delete(client);
 } END_TEST
 
+START_TEST(Async_read) {
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig *clientConfig = UA_Client_getConfig(client);
+    UA_ClientConfig_setDefault(clientConfig);
+
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Stop the server thread. Iterate manually from now on */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    /* Read the async variables and a sync attribute in one request */
+    UA_ReadValueId rvi[3];
+    UA_ReadValueId_init(&rvi[0]);
+    rvi[0].nodeId = UA_NODEID_STRING(1, "asyncVariable");
+    rvi[0].attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadValueId_init(&rvi[1]);
+    rvi[1].nodeId = UA_NODEID_STRING(1, "asyncVariable");
+    rvi[1].attributeId = UA_ATTRIBUTEID_BROWSENAME;
+    UA_ReadValueId_init(&rvi[2]);
+    rvi[2].nodeId =
+        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_BUILDINFO_PRODUCTNAME);
+    rvi[2].attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_SERVER;
+    request.nodesToRead = rvi;
+    request.nodesToReadSize = 3;
+    UA_ReadResponse_init(&readResponse);
+    retval = UA_Client_sendAsyncReadRequest(client, &request, clientReadCallback,
+                                            NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* No response until the async operations are done */
+    UA_Server_run_iterate(server, true);
+    UA_Client_run_iterate(client, 0);
+    ck_assert_uint_eq(clientCounter, 0);
+
+    /* Process the async reads for the server */
+    UA_DateTime workerTime = 0;
+    for(size_t i = 0; i < 2; i++) {
+        UA_AsyncOperationType aot;
+        const UA_AsyncOperationRequest *opRequest;
+        void *context = NULL;
+        UA_Boolean haveAsync =
+            UA_Server_getAsyncOperationNonBlocking(server, &aot, &opRequest,
+                                                   &context, NULL);
+        ck_assert_uint_eq(haveAsync, true);
+        ck_assert_int_eq(aot, UA_ASYNCOPERATIONTYPE_READ);
+        ck_assert(UA_NodeId_equal(&opRequest->readValueId.nodeId, &rvi[2 * i].nodeId));
+        UA_AsyncOperationResponse response;
+        response.readResult =
+            UA_Server_read(server, &opRequest->readValueId, UA_TIMESTAMPSTORETURN_BOTH);
+        ck_assert(response.readResult.hasServerTimestamp);
+        workerTime = response.readResult.serverTimestamp;
+        UA_Server_setAsyncOperationResult(server, &response, context);
+        UA_DataValue_clear(&response.readResult);
+    }
+
+    /* Iterate and pick up the async response to be sent out */
+    UA_fakeSleep(1000);
+    UA_Server_run_iterate(server, true);
+    UA_Client_run_iterate(client, 0);
+    ck_assert_uint_eq(clientCounter, 1);
+
+    /* The results are in the order of the request */
+    ck_assert_uint_eq(readResponse.resultsSize, 3);
+    UA_DataValue *res = readResponse.results;
+    ck_assert(UA_Variant_hasScalarType(&res[0].value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)res[0].value.data, 42);
+    ck_assert(res[0].hasServerTimestamp);
+    ck_assert(!res[0].hasSourceTimestamp);
+    ck_assert_int_eq(res[0].serverTimestamp, workerTime);
+    ck_assert(UA_Variant_hasScalarType(&res[1].value, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]));
+
+    /* The timestamps of the static variable are set when the result is
+     * integrated, as for synchronous reads */
+    ck_assert(UA_Variant_hasScalarType(&res[2].value, &UA_TYPES[UA_TYPES_STRING]));
+    ck_assert(res[2].hasServerTimestamp);
+    ck_assert_int_gt(res[2].serverTimestamp, workerTime);
+    UA_ReadResponse_clear(&readResponse);
+
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+START_TEST(Async_write) {
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig *clientConfig = UA_Client_getConfig(client);
+    UA_ClientConfig_setDefault(clientConfig);
+
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* Stop the server thread. Iterate manually from now on */
+    running = false;
+    THREAD_JOIN(server_thread);
+
+    UA_Int32 value = 23;
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &value, &UA_TYPES[UA_TYPES_INT32]);
+    writeResult = UA_STATUSCODE_BADINTERNALERROR;
+    retval = UA_Client_writeValueAttribute_async(client, UA_NODEID_STRING(1, "asyncVariable"),
+                                                 &v, clientWriteCallback, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* No response until the async operation is done */
+    UA_Server_run_iterate(server, true);
+    UA_Client_run_iterate(client, 0);
+    ck_assert_uint_eq(clientCounter, 0);
+
+    /* The value is written by the worker */
+    UA_AsyncOperationType aot;
+    const UA_AsyncOperationRequest *opRequest;
+    void *context = NULL;
+    UA_Boolean haveAsync =
+        UA_Server_getAsyncOperationNonBlocking(server, &aot, &opRequest, &context, NULL);
+    ck_assert_uint_eq(haveAsync, true);
+    ck_assert_int_eq(aot, UA_ASYNCOPERATIONTYPE_WRITE);
+    UA_AsyncOperationResponse response;
+    response.writeResult = UA_Server_write(server, &opRequest->writeValue);
+    UA_Server_setAsyncOperationResult(server, &response, context);
+
+    UA_fakeSleep(1000);
+    UA_Server_run_iterate(server, true);
+    UA_Client_run_iterate(client, 0);
+    ck_assert_uint_eq(clientCounter, 1);
+    ck_assert_uint_eq(writeResult, UA_STATUSCODE_GOOD);
+
+    UA_Variant out;
+    retval = UA_Server_readValue(server, UA_NODEID_STRING(1, "asyncVariable"), &out);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(*(UA_Int32*)out.data, 23);
+    UA_Variant_clear(&out);
+
+    running = true;
+    THREAD_CREATE(server_thread, serverloop);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+/* The operations are executed by the worker threads of the server */
+START_TEST(Async_serverWorkers) {
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig *clientConfig = UA_Client_getConfig(client);
+    UA_ClientConfig_setDefault(clientConfig);
+
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    /* The sync call sets the SessionId of the client */
+    retval = UA_Client_call(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                            UA_NODEID_STRING(1, "method"), 0, NULL, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(!UA_NodeId_isNull(&clientSessionId));
+
+    for(size_t i = 0; i < 10; i++) {
+        retval = UA_Client_call_async(client,
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                      UA_NODEID_STRING(1, "asyncMethod"),
+                                      0, NULL, clientReceiveCallback, NULL, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    UA_Int32 value = 23;
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &value, &UA_TYPES[UA_TYPES_INT32]);
+    writeResult = UA_STATUSCODE_BADINTERNALERROR;
+    retval = UA_Client_writeValueAttribute_async(client, UA_NODEID_STRING(1, "asyncVariable"),
+                                                 &v, clientWriteCallback, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    for(size_t i = 0; i < 500 && clientCounter < 11; i++)
+        UA_Client_run_iterate(client, 10);
+    ck_assert_uint_eq(clientCounter, 11);
+    ck_assert_uint_eq(writeResult, UA_STATUSCODE_GOOD);
+
+    /* The workers executed the async method with the session of the client */
+    ck_assert(!otherSession);
+
+    UA_Variant out;
+    retval = UA_Server_readValue(server, UA_NODEID_STRING(1, "asyncVariable"), &out);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&out, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)out.data, 23);
+    UA_Variant_clear(&out);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
+/* The limited method is never executed by more than one worker at a time */
+START_TEST(Async_concurrencyLimit) {
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig *clientConfig = UA_Client_getConfig(client);
+    UA_ClientConfig_setDefault(clientConfig);
+
+    UA_StatusCode retval = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    limitedRunning = 0;
+    limitedMaxRunning = 0;
+    for(size_t i = 0; i < 8; i++) {
+        retval = UA_Client_call_async(client,
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                      UA_NODEID_STRING(1, "limitedMethod"),
+                                      0, NULL, clientReceiveCallback, NULL, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    for(size_t i = 0; i < 500 && clientCounter < 8; i++)
+        UA_Client_run_iterate(client, 10);
+    ck_assert_uint_eq(clientCounter, 8);
+    ck_assert_uint_eq(limitedMaxRunning, 1);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+} END_TEST
+
 static Suite* method_async_suite(void) {
     /* set up unit test for internal data structures */
     Suite *s = suite_create("Async Method");
@@ -255,8 +588,16 @@ static Suite* method_async_suite(void) {
     tcase_add_test(tc_manager, Async_call);
     tcase_add_test(tc_manager, Async_timeout);
     tcase_add_test(tc_manager, Async_timeout_worker);
+    tcase_add_test(tc_manager, Async_read);
+    tcase_add_test(tc_manager, Async_write);
     suite_add_tcase(s, tc_manager);
 
+    TCase* tc_workers = tcase_create("AsyncServerWorkers");
+    tcase_add_checked_fixture(tc_workers, setupWorkers, teardown);
+    tcase_add_test(tc_workers, Async_serverWorkers);
+    tcase_add_test(tc_workers, Async_concurrencyLimit);
+    suite_add_tcase(s, tc_workers);
+
     return s;
 }
 
@@ -79,12 +79,108 @@ START_TEST(monitorIntegerNoChanges) {
 }
 END_TEST
 
+#define ARRAY_LENGTH 100000
+
+static UA_MonitoredItem *
+addDoubleArrayMonitoredItem(UA_Double deadband) {
+    UA_Double *array = (UA_Double*)
+        UA_Array_new(ARRAY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+    for(size_t i = 0; i < ARRAY_LENGTH; i++)
+        array[i] = (UA_Double)i * 0.5;
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Variant_setArray(&attr.value, array, ARRAY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+    attr.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US","spectrum");
+    UA_NodeId arrayNodeId = UA_NODEID_STRING(1, "spectrum");
+    UA_StatusCode retval =
+        UA_Server_addVariableNode(server, arrayNodeId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "spectrum"),
+                                  UA_NODEID_NULL, attr, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_Array_delete(array, ARRAY_LENGTH, &UA_TYPES[UA_TYPES_DOUBLE]);
+
+    UA_DataChangeFilter filter;
+    UA_DataChangeFilter_init(&filter);
+    filter.trigger = UA_DATACHANGETRIGGER_STATUSVALUE;
+    filter.deadbandType = (deadband > 0.0) ?
+        UA_DEADBANDTYPE_ABSOLUTE : UA_DEADBANDTYPE_NONE;
+    filter.deadbandValue = deadband;
+
+    UA_MonitoredItemCreateRequest item;
+    UA_MonitoredItemCreateRequest_init(&item);
+    item.itemToMonitor.nodeId = arrayNodeId;
+    item.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+    item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    UA_ExtensionObject_setValue(&item.requestedParameters.filter, &filter,
+                                &UA_TYPES[UA_TYPES_DATACHANGEFILTER]);
+    UA_MonitoredItemCreateResult res =
+        UA_Server_createDataChangeMonitoredItem(server, UA_TIMESTAMPSTORETURN_NEITHER,
+                                                item, NULL, dataChangeNotificationCallback);
+    ck_assert_uint_eq(res.statusCode, UA_STATUSCODE_GOOD);
+    return LIST_FIRST(&server->localMonitoredItems);
+}
+
+static void
+sampleDoubleArray(UA_MonitoredItem *mon) {
+    /* The initial value is reported when the MonitoredItem is created */
+    callbackCount = 0;
+
+    clock_t begin, finish;
+    begin = clock();
+
+    for(int i = 0; i < 100; i++) {
+        UA_MonitoredItem_sampleCallback(server, mon);
+    }
+
+    finish = clock();
+
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    printf("duration was %f s\n", time_spent);
+
+    ck_assert_uint_eq(callbackCount, 0);
+}
+
+START_TEST(monitorDoubleArrayNoChanges) {
+    sampleDoubleArray(addDoubleArrayMonitoredItem(0.0));
+}
+END_TEST
+
+START_TEST(monitorDoubleArrayDeadband) {
+    UA_MonitoredItem *mon = addDoubleArrayMonitoredItem(0.1);
+    sampleDoubleArray(mon);
+
+    /* A change of a single element outside the deadband is detected */
+    UA_Variant value;
+    UA_Variant_init(&value);
+    UA_StatusCode retval =
+        UA_Server_readValue(server, UA_NODEID_STRING(1, "spectrum"), &value);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ((UA_Double*)value.data)[ARRAY_LENGTH - 1] += 0.05;
+    retval = UA_Server_writeValue(server, UA_NODEID_STRING(1, "spectrum"), value);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_MonitoredItem_sampleCallback(server, mon);
+    ck_assert_uint_eq(callbackCount, 0);
+
+    ((UA_Double*)value.data)[ARRAY_LENGTH - 1] += 0.1;
+    retval = UA_Server_writeValue(server, UA_NODEID_STRING(1, "spectrum"), value);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    UA_MonitoredItem_sampleCallback(server, mon);
+    ck_assert_uint_eq(callbackCount, 1);
+    UA_Variant_clear(&value);
+}
+END_TEST
+
 static Suite * monitoring_speed_suite (void) {
     Suite *s = suite_create ("Monitoring Speed");
 
     TCase* tc_datachange = tcase_create ("DataChange");
     tcase_add_checked_fixture(tc_datachange, setup, teardown);
     tcase_add_test (tc_datachange, monitorIntegerNoChanges);
+    tcase_add_test (tc_datachange, monitorDoubleArrayNoChanges);
+    tcase_add_test (tc_datachange, monitorDoubleArrayDeadband);
     suite_add_tcase (s, tc_datachange);
 
     return s;
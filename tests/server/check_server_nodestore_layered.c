@@ -0,0 +1,240 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+#include <open62541/plugin/nodestore_default.h>
+
+#include <check.h>
+#include <stdlib.h>
+
+static UA_Nodestore base;
+static UA_Server *server1;
+static UA_Server *server2;
+static int templateContext;
+
+static UA_Server *
+newLayeredServer(void) {
+    UA_ServerConfig config;
+    memset(&config, 0, sizeof(UA_ServerConfig));
+    UA_ServerConfig_setDefault(&config);
+    config.nodestore.clear(config.nodestore.context);
+    UA_StatusCode res = UA_Nodestore_HashMapLayered(&config.nodestore, &base);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    return UA_Server_newWithConfig(&config);
+}
+
+/* Freeze the nodes of a template server. Then create two servers on top. */
+static void setup(void) {
+    UA_Server *tmpl = UA_Server_new();
+    ck_assert_ptr_ne(tmpl, NULL);
+    UA_StatusCode res =
+        UA_Server_setNodeContext(tmpl, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                 &templateContext);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Nodestore_HashMapFrozen(&base, &UA_Server_getConfig(tmpl)->nodestore);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_Server_delete(tmpl);
+
+    server1 = newLayeredServer();
+    ck_assert_ptr_ne(server1, NULL);
+    server2 = newLayeredServer();
+    ck_assert_ptr_ne(server2, NULL);
+}
+
+static void teardown(void) {
+    UA_Server_delete(server1);
+    UA_Server_delete(server2);
+    base.clear(base.context);
+}
+
+static size_t
+countObjectsFolderChildren(UA_Server *server) {
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    bd.includeSubtypes = true;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    size_t count = br.referencesSize;
+    UA_BrowseResult_clear(&br);
+    return count;
+}
+
+/* Count the nodes of the layered server that are not shared with the base */
+static void
+countCopies(void *ctx, const UA_Node *node) {
+    const UA_Node *shared =
+        base.getNode(base.context, &node->head.nodeId, ~(UA_UInt32)0,
+                     UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    if(shared != node)
+        (*(size_t*)ctx)++;
+    if(shared)
+        base.releaseNode(base.context, shared);
+}
+
+/* Initializing the namespace zero on top of the template writes nothing that
+ * the template already has. So no node is copied into the upper layer. */
+START_TEST(initSharesNs0) {
+    UA_Nodestore *ns = &UA_Server_getConfig(server1)->nodestore;
+    size_t copies = 0;
+    ns->iterate(ns->context, countCopies, &copies);
+    ck_assert_uint_eq(copies, 0);
+} END_TEST
+
+START_TEST(frozenIsReadOnly) {
+    UA_Node *node = base.newNode(base.context, UA_NODECLASS_OBJECT);
+    node->head.nodeId = UA_NODEID_NUMERIC(1, 1);
+    ck_assert_uint_eq(base.insertNode(base.context, node, NULL),
+                      UA_STATUSCODE_BADNOTWRITABLE);
+    UA_NodeId id = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    ck_assert_uint_eq(base.removeNode(base.context, &id),
+                      UA_STATUSCODE_BADNOTWRITABLE);
+
+    /* The context of the template server is not frozen into the base */
+    const UA_Node *frozen =
+        base.getNode(base.context, &id, ~(UA_UInt32)0,
+                     UA_REFERENCETYPESET_ALL, UA_BROWSEDIRECTION_BOTH);
+    ck_assert_ptr_ne(frozen, NULL);
+    ck_assert_ptr_eq(frozen->head.context, NULL);
+    base.releaseNode(base.context, frozen);
+
+    /* Layering requires a frozen base */
+    UA_Nodestore ns;
+    UA_Nodestore_HashMap(&ns);
+    UA_Nodestore layered;
+    ck_assert_uint_eq(UA_Nodestore_HashMapLayered(&layered, &ns),
+                      UA_STATUSCODE_BADINVALIDARGUMENT);
+    ns.clear(ns.context);
+} END_TEST
+
+START_TEST(readSharedNodes) {
+    UA_Variant value;
+    UA_StatusCode res =
+        UA_Server_readValue(server1, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_NAMESPACEARRAY),
+                            &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(value.arrayLength, 2);
+    UA_Variant_clear(&value);
+
+    /* The DataSource is set up for the layered server */
+    res = UA_Server_readValue(server2, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME),
+                              &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_DATETIME]));
+    UA_Variant_clear(&value);
+
+    UA_QualifiedName bn;
+    res = UA_Server_readBrowseName(server2, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), &bn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_QualifiedName expected = UA_QUALIFIEDNAME(0, "Objects");
+    ck_assert(UA_QualifiedName_equal(&bn, &expected));
+    UA_QualifiedName_clear(&bn);
+} END_TEST
+
+START_TEST(editsAreLocal) {
+    size_t children = countObjectsFolderChildren(server2);
+
+    /* Adding a node edits the (shared) Objects folder */
+    UA_ObjectAttributes attr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server1, UA_NODEID_NUMERIC(1, 1000),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, "object"),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(countObjectsFolderChildren(server1), children + 1);
+    ck_assert_uint_eq(countObjectsFolderChildren(server2), children);
+
+    /* Write an attribute of a shared node */
+    UA_LocalizedText dn = UA_LOCALIZEDTEXT("en-US", "Changed");
+    res = UA_Server_writeDisplayName(server1, UA_NODEID_NUMERIC(0, UA_NS0ID_TYPESFOLDER), dn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_LocalizedText out;
+    res = UA_Server_readDisplayName(server2, UA_NODEID_NUMERIC(0, UA_NS0ID_TYPESFOLDER), &out);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(!UA_String_equal(&out.text, &dn.text));
+    UA_LocalizedText_clear(&out);
+
+    /* Delete a shared node */
+    res = UA_Server_deleteNode(server1, UA_NODEID_NUMERIC(0, UA_NS0ID_VIEWSFOLDER), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_NodeClass nc;
+    res = UA_Server_readNodeClass(server1, UA_NODEID_NUMERIC(0, UA_NS0ID_VIEWSFOLDER), &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    res = UA_Server_readNodeClass(server2, UA_NODEID_NUMERIC(0, UA_NS0ID_VIEWSFOLDER), &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(nc, UA_NODECLASS_OBJECT);
+
+    /* A deleted shared node can be added again */
+    res = UA_Server_addObjectNode(server1, UA_NODEID_NUMERIC(0, UA_NS0ID_VIEWSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ROOTFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(0, "Views"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* Adding a node with the NodeId of a shared node fails */
+    res = UA_Server_addObjectNode(server2, UA_NODEID_NUMERIC(0, UA_NS0ID_VIEWSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ROOTFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(0, "Views"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDEXISTS);
+} END_TEST
+
+START_TEST(addReferenceType) {
+    UA_ReferenceTypeAttributes attr = UA_ReferenceTypeAttributes_default;
+    attr.inverseName = UA_LOCALIZEDTEXT("", "IsCustomOf");
+    UA_StatusCode res =
+        UA_Server_addReferenceTypeNode(server1, UA_NODEID_NUMERIC(1, 2000),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_NONHIERARCHICALREFERENCES),
+                                       UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                       UA_QUALIFIEDNAME(1, "HasCustom"), attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    res = UA_Server_addReference(server1, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                 UA_NODEID_NUMERIC(1, 2000),
+                                 UA_EXPANDEDNODEID_NUMERIC(0, UA_NS0ID_TYPESFOLDER), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.referenceTypeId = UA_NODEID_NUMERIC(1, 2000);
+    UA_BrowseResult br = UA_Server_browse(server1, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(br.referencesSize, 1);
+    UA_BrowseResult_clear(&br);
+} END_TEST
+
+static Suite *testSuite_layered(void) {
+    Suite *s = suite_create("Layered Nodestore");
+    TCase *tc = tcase_create("Layered Nodestore");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, initSharesNs0);
+    tcase_add_test(tc, frozenIsReadOnly);
+    tcase_add_test(tc, readSharedNodes);
+    tcase_add_test(tc, editsAreLocal);
+    tcase_add_test(tc, addReferenceType);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_layered();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
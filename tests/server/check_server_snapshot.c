@@ -0,0 +1,279 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include <check.h>
+#include <stdlib.h>
+#include <time.h>
+
+static UA_ByteString snapshot;
+static UA_UInt16 nsIndex;
+
+/* Create a server with a custom namespace and a variable. Then take the
+ * snapshot. */
+static void setup(void) {
+    clock_t begin = clock();
+    UA_Server *server = UA_Server_new();
+    ck_assert_ptr_ne(server, NULL);
+    printf("Server creation from scratch:\t %f s\n",
+           (double)(clock() - begin) / CLOCKS_PER_SEC);
+
+    nsIndex = UA_Server_addNamespace(server, "urn:test:snapshot");
+
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Int32 value = 42;
+    UA_Variant_setScalar(&attr.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+    attr.displayName = UA_LOCALIZEDTEXT("en-US", "the answer");
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, UA_NODEID_NUMERIC(nsIndex, 1000),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(nsIndex, "the answer"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* An object in ns1 that references the variable */
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    oattr.displayName = UA_LOCALIZEDTEXT("en-US", "the device");
+    res = UA_Server_addObjectNode(server, UA_NODEID_STRING(1, "device"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "device"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                  oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_addReference(server, UA_NODEID_STRING(1, "device"),
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+                                 UA_EXPANDEDNODEID_NUMERIC(nsIndex, 1000), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    res = UA_Server_saveNodestoreSnapshot(server, &snapshot);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_gt(snapshot.length, 0);
+    UA_Server_delete(server);
+}
+
+static void teardown(void) {
+    UA_ByteString_clear(&snapshot);
+}
+
+static UA_Server *
+newServerFromSnapshot(const UA_ByteString *s) {
+    UA_ServerConfig config;
+    memset(&config, 0, sizeof(UA_ServerConfig));
+    UA_ServerConfig_setDefault(&config);
+    config.nodestoreSnapshot = *s;
+    return UA_Server_newWithConfig(&config);
+}
+
+START_TEST(restoreSnapshot) {
+    clock_t begin = clock();
+    UA_Server *server = newServerFromSnapshot(&snapshot);
+    ck_assert_ptr_ne(server, NULL);
+    printf("Server creation from snapshot:\t %f s\n",
+           (double)(clock() - begin) / CLOCKS_PER_SEC);
+
+    /* The namespace is restored */
+    size_t foundIndex = 0;
+    UA_StatusCode res =
+        UA_Server_getNamespaceByName(server, UA_STRING("urn:test:snapshot"), &foundIndex);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(foundIndex, nsIndex);
+
+    /* The variable and its value are restored */
+    UA_Variant value;
+    res = UA_Server_readValue(server, UA_NODEID_NUMERIC(nsIndex, 1000), &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)value.data, 42);
+    UA_Variant_clear(&value);
+
+    UA_QualifiedName bn;
+    res = UA_Server_readBrowseName(server, UA_NODEID_NUMERIC(nsIndex, 1000), &bn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_QualifiedName expected = UA_QUALIFIEDNAME(nsIndex, "the answer");
+    ck_assert(UA_QualifiedName_equal(&bn, &expected));
+    UA_QualifiedName_clear(&bn);
+
+    UA_LocalizedText dn;
+    res = UA_Server_readDisplayName(server, UA_NODEID_NUMERIC(nsIndex, 1000), &dn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_LocalizedText expectedDn = UA_LOCALIZEDTEXT("en-US", "the answer");
+    ck_assert(UA_String_equal(&dn.text, &expectedDn.text));
+    ck_assert(UA_String_equal(&dn.locale, &expectedDn.locale));
+    UA_LocalizedText_clear(&dn);
+
+    UA_Byte accessLevel = 0;
+    res = UA_Server_readAccessLevel(server, UA_NODEID_NUMERIC(nsIndex, 1000),
+                                    &accessLevel);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(accessLevel,
+                      UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE);
+
+    /* The object in ns1 is restored */
+    UA_NodeId deviceId = UA_NODEID_STRING(1, "device");
+    res = UA_Server_readDisplayName(server, deviceId, &dn);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_String expectedText = UA_STRING("the device");
+    ck_assert(UA_String_equal(&dn.text, &expectedText));
+    UA_LocalizedText_clear(&dn);
+
+    UA_NodeClass nc = UA_NODECLASS_UNSPECIFIED;
+    res = UA_Server_readNodeClass(server, deviceId, &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_int_eq(nc, UA_NODECLASS_OBJECT);
+
+    /* The references in both directions are restored */
+    UA_NodeId varId = UA_NODEID_NUMERIC(nsIndex, 1000);
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    bd.includeSubtypes = true;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    UA_Boolean foundVar = false, foundDevice = false;
+    for(size_t i = 0; i < br.referencesSize; i++) {
+        if(UA_NodeId_equal(&br.references[i].nodeId.nodeId, &varId))
+            foundVar = true;
+        if(UA_NodeId_equal(&br.references[i].nodeId.nodeId, &deviceId))
+            foundDevice = true;
+    }
+    ck_assert(foundVar);
+    ck_assert(foundDevice);
+    UA_BrowseResult_clear(&br);
+
+    /* Inverse references of the variable: Organizes from the ObjectsFolder,
+     * HasComponent from the ns1 object */
+    bd.nodeId = varId;
+    bd.browseDirection = UA_BROWSEDIRECTION_INVERSE;
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(br.referencesSize, 2);
+    UA_NodeId objectsId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    UA_NodeId organizesId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    UA_NodeId hasComponentId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+    foundVar = false;
+    foundDevice = false;
+    for(size_t i = 0; i < br.referencesSize; i++) {
+        UA_ReferenceDescription *rd = &br.references[i];
+        ck_assert(!rd->isForward);
+        if(UA_NodeId_equal(&rd->nodeId.nodeId, &objectsId) &&
+           UA_NodeId_equal(&rd->referenceTypeId, &organizesId))
+            foundVar = true;
+        if(UA_NodeId_equal(&rd->nodeId.nodeId, &deviceId) &&
+           UA_NodeId_equal(&rd->referenceTypeId, &hasComponentId))
+            foundDevice = true;
+    }
+    ck_assert(foundVar);
+    ck_assert(foundDevice);
+    UA_BrowseResult_clear(&br);
+
+    /* The snapshot of the restored server is identical */
+    UA_ByteString snapshot2;
+    res = UA_Server_saveNodestoreSnapshot(server, &snapshot2);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_ByteString_equal(&snapshot2, &snapshot));
+    UA_ByteString_clear(&snapshot2);
+
+    /* The DataSources of namespace zero are set again */
+    res = UA_Server_readValue(server,
+                              UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME),
+                              &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasScalarType(&value, &UA_TYPES[UA_TYPES_DATETIME]));
+    UA_Variant_clear(&value);
+
+    /* Alias types are restored from the DataType of the node */
+    res = UA_Server_readValue(server,
+                              UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERCAPABILITIES_LOCALEIDARRAY),
+                              &value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(UA_Variant_hasArrayType(&value, &UA_TYPES[UA_TYPES_LOCALEID]));
+    UA_Variant_clear(&value);
+
+    /* Nodes can be added as usual */
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    res = UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(nsIndex, 1001),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(nsIndex, "object"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                  oattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
+START_TEST(rejectCorruptSnapshot) {
+    UA_ByteString corrupt = snapshot;
+    corrupt.length = snapshot.length / 2;
+    UA_Server *server = newServerFromSnapshot(&corrupt);
+    ck_assert_ptr_eq(server, NULL);
+
+    UA_Byte garbage[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    corrupt.data = garbage;
+    corrupt.length = sizeof(garbage);
+    server = newServerFromSnapshot(&corrupt);
+    ck_assert_ptr_eq(server, NULL);
+}
+END_TEST
+
+START_TEST(keepApplicationUri) {
+    UA_ServerConfig config;
+    memset(&config, 0, sizeof(UA_ServerConfig));
+    UA_ServerConfig_setDefault(&config);
+    UA_String_clear(&config.applicationDescription.applicationUri);
+    config.applicationDescription.applicationUri =
+        UA_STRING_ALLOC("urn:test:snapshot:otherserver");
+    config.nodestoreSnapshot = snapshot;
+    UA_Server *server = UA_Server_newWithConfig(&config);
+    ck_assert_ptr_ne(server, NULL);
+
+    /* Namespace 1 is the ApplicationUri of the running server */
+    UA_String ns1 = UA_STRING_NULL;
+    UA_StatusCode res = UA_Server_getNamespaceByIndex(server, 1, &ns1);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_String expected = UA_STRING("urn:test:snapshot:otherserver");
+    ck_assert(UA_String_equal(&ns1, &expected));
+    UA_String_clear(&ns1);
+
+    /* The other namespaces are restored */
+    size_t foundIndex = 0;
+    res = UA_Server_getNamespaceByName(server, UA_STRING("urn:test:snapshot"),
+                                       &foundIndex);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(foundIndex, nsIndex);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
+static Suite *testSuite_snapshot(void) {
+    Suite *s = suite_create("Nodestore Snapshot");
+    TCase *tc = tcase_create("Snapshot");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, restoreSnapshot);
+    tcase_add_test(tc, rejectCorruptSnapshot);
+    tcase_add_test(tc, keepApplicationUri);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_snapshot();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -49,12 +49,170 @@ START_TEST(addVariable) {
 }
 END_TEST
 
+#define BULK_NODES 3000
+
+/* The parent object is the last item of the batch */
+START_TEST(addVariablesBulk) {
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    UA_Int32 myInteger = 42;
+    UA_Variant_setScalar(&vattr.value, &myInteger, &UA_TYPES[UA_TYPES_INT32]);
+    vattr.displayName = UA_LOCALIZEDTEXT("en-US","the answer");
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    oattr.displayName = UA_LOCALIZEDTEXT("en-US","parent");
+
+    UA_NodeId parentId = UA_NODEID_NUMERIC(1, 50000);
+    UA_AddNodesItem *items = (UA_AddNodesItem*)
+        UA_calloc(BULK_NODES + 1, sizeof(UA_AddNodesItem));
+    UA_AddNodesResult *results = (UA_AddNodesResult*)
+        UA_calloc(BULK_NODES + 1, sizeof(UA_AddNodesResult));
+    ck_assert_ptr_ne(items, NULL);
+    ck_assert_ptr_ne(results, NULL);
+    for(size_t i = 0; i < BULK_NODES; i++) {
+        items[i].nodeClass = UA_NODECLASS_VARIABLE;
+        items[i].requestedNewNodeId.nodeId = UA_NODEID_NUMERIC(1, 50001 + (UA_UInt32)i);
+        items[i].parentNodeId.nodeId = parentId;
+        items[i].referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+        items[i].browseName = UA_QUALIFIEDNAME(1, "the answer");
+        items[i].typeDefinition.nodeId =
+            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE);
+        UA_ExtensionObject_setValueNoDelete(&items[i].nodeAttributes, &vattr,
+                                            &UA_TYPES[UA_TYPES_VARIABLEATTRIBUTES]);
+    }
+    UA_AddNodesItem *parent = &items[BULK_NODES];
+    parent->nodeClass = UA_NODECLASS_OBJECT;
+    parent->requestedNewNodeId.nodeId = parentId;
+    parent->parentNodeId.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    parent->referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    parent->browseName = UA_QUALIFIEDNAME(1, "parent");
+    parent->typeDefinition.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE);
+    UA_ExtensionObject_setValueNoDelete(&parent->nodeAttributes, &oattr,
+                                        &UA_TYPES[UA_TYPES_OBJECTATTRIBUTES]);
+
+    clock_t begin = clock();
+    UA_StatusCode res =
+        UA_Server_addNodes_bulk(server, BULK_NODES + 1, items, NULL, results);
+    clock_t finish = clock();
+    printf("%i nodes (bulk):\t Duration was %f s\n", BULK_NODES,
+           (double)(finish - begin) / CLOCKS_PER_SEC);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i <= BULK_NODES; i++) {
+        ck_assert_uint_eq(results[i].statusCode, UA_STATUSCODE_GOOD);
+        ck_assert(UA_NodeId_equal(&results[i].addedNodeId,
+                                  &items[i].requestedNewNodeId.nodeId));
+    }
+
+    /* The deferred forward references from the parent are in place */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = parentId;
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(br.referencesSize, BULK_NODES);
+    UA_BrowseResult_clear(&br);
+
+    UA_Array_delete(results, BULK_NODES + 1, &UA_TYPES[UA_TYPES_ADDNODESRESULT]);
+    UA_free(items);
+}
+END_TEST
+
+/* Nodes that fail are removed without affecting the remaining batch */
+START_TEST(addVariablesBulkInvalidParent) {
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    UA_AddNodesItem items[2];
+    UA_AddNodesResult results[2];
+    memset(items, 0, sizeof(items));
+    for(size_t i = 0; i < 2; i++) {
+        items[i].nodeClass = UA_NODECLASS_VARIABLE;
+        items[i].requestedNewNodeId.nodeId = UA_NODEID_NUMERIC(1, 60000 + (UA_UInt32)i);
+        items[i].referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+        items[i].browseName = UA_QUALIFIEDNAME(1, "var");
+        UA_ExtensionObject_setValueNoDelete(&items[i].nodeAttributes, &vattr,
+                                            &UA_TYPES[UA_TYPES_VARIABLEATTRIBUTES]);
+    }
+    items[0].parentNodeId.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    items[1].parentNodeId.nodeId = UA_NODEID_NUMERIC(1, 12345); /* unknown */
+
+    UA_StatusCode res = UA_Server_addNodes_bulk(server, 2, items, NULL, results);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(results[0].statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_ne(results[1].statusCode, UA_STATUSCODE_GOOD);
+
+    UA_NodeClass nc;
+    res = UA_Server_readNodeClass(server, items[0].requestedNewNodeId.nodeId, &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_readNodeClass(server, items[1].requestedNewNodeId.nodeId, &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+
+    UA_AddNodesResult_clear(&results[0]);
+    UA_AddNodesResult_clear(&results[1]);
+}
+END_TEST
+
+/* The children of a node that fails are not added either */
+START_TEST(addNodesBulkFailedParent) {
+    UA_ObjectAttributes oattr = UA_ObjectAttributes_default;
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    UA_AddNodesItem items[2];
+    UA_AddNodesResult results[2];
+    memset(items, 0, sizeof(items));
+
+    /* The object has a VariableType as its type definition */
+    UA_NodeId objectId = UA_NODEID_NUMERIC(1, 61000);
+    items[0].nodeClass = UA_NODECLASS_OBJECT;
+    items[0].requestedNewNodeId.nodeId = objectId;
+    items[0].parentNodeId.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    items[0].referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    items[0].browseName = UA_QUALIFIEDNAME(1, "object");
+    items[0].typeDefinition.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE);
+    UA_ExtensionObject_setValueNoDelete(&items[0].nodeAttributes, &oattr,
+                                        &UA_TYPES[UA_TYPES_OBJECTATTRIBUTES]);
+
+    items[1].nodeClass = UA_NODECLASS_VARIABLE;
+    items[1].requestedNewNodeId.nodeId = UA_NODEID_NUMERIC(1, 61001);
+    items[1].parentNodeId.nodeId = objectId;
+    items[1].referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT);
+    items[1].browseName = UA_QUALIFIEDNAME(1, "var");
+    items[1].typeDefinition.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE);
+    UA_ExtensionObject_setValueNoDelete(&items[1].nodeAttributes, &vattr,
+                                        &UA_TYPES[UA_TYPES_VARIABLEATTRIBUTES]);
+
+    UA_StatusCode res = UA_Server_addNodes_bulk(server, 2, items, NULL, results);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(results[0].statusCode, UA_STATUSCODE_BADTYPEDEFINITIONINVALID);
+    ck_assert_uint_eq(results[1].statusCode, UA_STATUSCODE_BADPARENTNODEIDINVALID);
+    ck_assert(UA_NodeId_isNull(&results[0].addedNodeId));
+    ck_assert(UA_NodeId_isNull(&results[1].addedNodeId));
+
+    UA_NodeClass nc;
+    res = UA_Server_readNodeClass(server, items[0].requestedNewNodeId.nodeId, &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+    res = UA_Server_readNodeClass(server, items[1].requestedNewNodeId.nodeId, &nc);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+
+    /* No reference to the removed object remains */
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    for(size_t i = 0; i < br.referencesSize; i++)
+        ck_assert(!UA_NodeId_equal(&br.references[i].nodeId.nodeId, &objectId));
+    UA_BrowseResult_clear(&br);
+}
+END_TEST
+
 static Suite * service_speed_suite (void) {
     Suite *s = suite_create ("Service Speed");
 
     TCase* tc_addnodes = tcase_create ("AddNodes");
     tcase_add_checked_fixture(tc_addnodes, setup, teardown);
     tcase_add_test(tc_addnodes, addVariable);
+    tcase_add_test(tc_addnodes, addVariablesBulk);
+    tcase_add_test(tc_addnodes, addVariablesBulkInvalidParent);
+    tcase_add_test(tc_addnodes, addNodesBulkFailedParent);
     suite_add_tcase(s, tc_addnodes);
 
     return s;
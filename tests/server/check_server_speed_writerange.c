@@ -0,0 +1,104 @@
+/* This work is licensed under a Creative Commons CCZero 1.0 Universal License.
+ * See http://creativecommons.org/publicdomain/zero/1.0/ for more information. */
+
+/* Measure how fast small IndexRanges of a large array variable are written */
+
+#include <open62541/server.h>
+#include <open62541/server_config_default.h>
+
+#include <check.h>
+#include <stdio.h>
+#include <time.h>
+
+#define ARRAYSIZE 100000 /* Elements of the array variable */
+#define RANGESIZE 10     /* Elements written at once */
+#define WRITES 10000     /* Number of range writes */
+
+static UA_Server *server;
+static UA_NodeId arrayNodeId;
+
+static void setup(void) {
+    server = UA_Server_new();
+    UA_ServerConfig_setDefault(UA_Server_getConfig(server));
+    /* Disable logging */
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->logger.log = NULL;
+
+    UA_Double *array = (UA_Double*)UA_Array_new(ARRAYSIZE, &UA_TYPES[UA_TYPES_DOUBLE]);
+    ck_assert(array != NULL);
+    UA_VariableAttributes attr = UA_VariableAttributes_default;
+    UA_Variant_setArray(&attr.value, array, ARRAYSIZE, &UA_TYPES[UA_TYPES_DOUBLE]);
+    attr.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    attr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    arrayNodeId = UA_NODEID_STRING(1, "LargeArray");
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, arrayNodeId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "LargeArray"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    UA_Array_delete(array, ARRAYSIZE, &UA_TYPES[UA_TYPES_DOUBLE]);
+}
+
+static void teardown(void) {
+    UA_Server_delete(server);
+}
+
+START_TEST(writeRangeSpeed) {
+    UA_Double values[RANGESIZE];
+    char range[32];
+    UA_WriteValue wv;
+    UA_WriteValue_init(&wv);
+    wv.nodeId = arrayNodeId;
+    wv.attributeId = UA_ATTRIBUTEID_VALUE;
+    wv.value.hasValue = true;
+    UA_Variant_setArray(&wv.value.value, values, RANGESIZE, &UA_TYPES[UA_TYPES_DOUBLE]);
+
+    clock_t begin = clock();
+    for(size_t i = 0; i < WRITES; i++) {
+        size_t first = (i * RANGESIZE) % ARRAYSIZE;
+        for(size_t j = 0; j < RANGESIZE; j++)
+            values[j] = (UA_Double)(i + j);
+        UA_snprintf(range, sizeof(range), "%u:%u", (unsigned)first,
+                    (unsigned)(first + RANGESIZE - 1));
+        wv.indexRange = UA_STRING(range);
+        UA_StatusCode res = UA_Server_write(server, &wv);
+        ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    }
+    clock_t finish = clock();
+    double time_spent = (double)(finish - begin) / CLOCKS_PER_SEC;
+    printf("%u range writes into an array of %u elements in %f s (%f writes/s)\n",
+           (unsigned)WRITES, (unsigned)ARRAYSIZE, time_spent,
+           (double)WRITES / time_spent);
+
+    /* The last write is visible */
+    UA_Variant out;
+    UA_StatusCode res = UA_Server_readValue(server, arrayNodeId, &out);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(out.arrayLength, ARRAYSIZE);
+    size_t last = ((WRITES - 1) * RANGESIZE) % ARRAYSIZE;
+    ck_assert(((UA_Double*)out.data)[last] == (UA_Double)(WRITES - 1));
+    UA_Variant_clear(&out);
+}
+END_TEST
+
+static Suite * testSuite_writeRangeSpeed(void) {
+    Suite *s = suite_create("Speed Test Range Writes");
+    TCase *tc = tcase_create("Write Range");
+    tcase_add_checked_fixture(tc, setup, teardown);
+    tcase_add_test(tc, writeRangeSpeed);
+    suite_add_tcase(s, tc);
+    return s;
+}
+
+int main(void) {
+    Suite *s = testSuite_writeRangeSpeed();
+    SRunner *sr = srunner_create(s);
+    srunner_set_fork_status(sr, CK_NOFORK);
+    srunner_run_all(sr, CK_NORMAL);
+    int number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1089,6 +1089,317 @@ START_TEST(CheckDescriptionLocalization) {
     UA_LocalizedText_clear(&lt);
 } END_TEST
 
+static size_t batchCalls;
+static size_t batchItems;
+
+/* Returns the identifier of the numeric NodeId. Or a slice of the array
+ * {0,1,2,3,4} if a range is requested. */
+static UA_StatusCode
+readBatchValues(UA_Server *server_, const UA_NodeId *sessionId,
+                void *sessionContext, size_t itemsSize,
+                const UA_DataSourceReadItem *items,
+                UA_Boolean sourceTimeStamp, UA_DataValue *values) {
+    batchCalls++;
+    batchItems += itemsSize;
+    for(size_t i = 0; i < itemsSize; i++) {
+        if(items[i].range) {
+            UA_Int32 arr[5] = {0, 1, 2, 3, 4};
+            UA_Variant v;
+            UA_Variant_setArray(&v, arr, 5, &UA_TYPES[UA_TYPES_INT32]);
+            values[i].status = UA_Variant_copyRange(&v, &values[i].value, *items[i].range);
+        } else {
+            UA_UInt32 id = items[i].nodeId->identifier.numeric;
+            UA_Variant_setScalarCopy(&values[i].value, &id, &UA_TYPES[UA_TYPES_UINT32]);
+        }
+        values[i].hasValue = true;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+START_TEST(ReadBatchedDataSourceValues) {
+    UA_DataSource ds;
+    ds.read = NULL;
+    ds.write = NULL;
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    for(UA_UInt32 i = 1; i <= 4; i++) {
+        /* Without a read method, the DataSource is set after the batch method */
+        UA_NodeId nodeId = UA_NODEID_NUMERIC(1, 1000 + i);
+        UA_StatusCode retval =
+            UA_Server_addVariableNode(server, nodeId,
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                      UA_QUALIFIEDNAME(1, "batched"),
+                                      UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                      vattr, NULL, NULL);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        retval = UA_Server_setVariableNode_dataSourceBatch(server, nodeId,
+                                                           readBatchValues);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+        retval = UA_Server_setVariableNode_dataSource(server, nodeId, ds);
+        ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    }
+
+    /* The batch method can only be set for variables */
+    UA_StatusCode retval =
+        UA_Server_setVariableNode_dataSourceBatch(server,
+                                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                                  readBatchValues);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_BADNODECLASSINVALID);
+
+    /* Mix the batched reads with other reads */
+    UA_ReadValueId rvis[6];
+    for(size_t i = 0; i < 6; i++) {
+        UA_ReadValueId_init(&rvis[i]);
+        rvis[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    rvis[0].nodeId = UA_NODEID_NUMERIC(1, 1001);
+    rvis[1].nodeId = UA_NODEID_STRING(1, "the.answer");
+    rvis[2].nodeId = UA_NODEID_NUMERIC(1, 1002);
+    rvis[3].nodeId = UA_NODEID_NUMERIC(1, 1003);
+    rvis[3].indexRange = UA_STRING("1:2");
+    rvis[4].nodeId = UA_NODEID_STRING(1, "cpu.temperature");
+    rvis[5].nodeId = UA_NODEID_NUMERIC(1, 1004);
+    rvis[5].attributeId = UA_ATTRIBUTEID_BROWSENAME;
+
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_SOURCE;
+    request.nodesToReadSize = 6;
+    request.nodesToRead = rvis;
+    UA_ReadResponse response;
+    UA_ReadResponse_init(&response);
+
+    batchCalls = 0;
+    batchItems = 0;
+    UA_LOCK(&server->serviceMutex);
+    Service_Read(server, &server->adminSession, &request, &response);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response.resultsSize, 6);
+    ck_assert_uint_eq(batchCalls, 1);
+    ck_assert_uint_eq(batchItems, 3);
+
+    /* Results in the order of the request */
+    UA_DataValue *res = response.results;
+    ck_assert(UA_Variant_hasScalarType(&res[0].value, &UA_TYPES[UA_TYPES_UINT32]));
+    ck_assert_uint_eq(*(UA_UInt32*)res[0].value.data, 1001);
+    ck_assert(res[0].hasSourceTimestamp);
+    ck_assert_int_eq(*(UA_Int32*)res[1].value.data, 42);
+    ck_assert_uint_eq(*(UA_UInt32*)res[2].value.data, 1002);
+    ck_assert_uint_eq(res[3].value.arrayLength, 2);
+    ck_assert_int_eq(((UA_Int32*)res[3].value.data)[0], 1);
+    ck_assert(UA_Variant_hasScalarType(&res[4].value, &UA_TYPES[UA_TYPES_FLOAT]));
+    ck_assert(UA_Variant_hasScalarType(&res[5].value, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]));
+    UA_ReadResponse_clear(&response);
+
+    /* Single reads use the batch method if there is no read method */
+    UA_Variant value;
+    retval = UA_Server_readValue(server, UA_NODEID_NUMERIC(1, 1004), &value);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(*(UA_UInt32*)value.data, 1004);
+    ck_assert_uint_eq(batchCalls, 2);
+    UA_Variant_clear(&value);
+} END_TEST
+
+static size_t counterReads;
+
+static UA_StatusCode
+readCounter(UA_Server *server_, const UA_NodeId *sessionId, void *sessionContext,
+            const UA_NodeId *nodeId, void *nodeContext,
+            UA_Boolean sourceTimeStamp, const UA_NumericRange *range,
+            UA_DataValue *dataValue) {
+    counterReads++;
+    UA_UInt32 count = (UA_UInt32)counterReads;
+    UA_Variant_setScalarCopy(&dataValue->value, &count, &UA_TYPES[UA_TYPES_UINT32]);
+    dataValue->hasValue = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_StatusCode
+writeCounter(UA_Server *server_, const UA_NodeId *sessionId, void *sessionContext,
+             const UA_NodeId *nodeId, void *nodeContext,
+             const UA_NumericRange *range, const UA_DataValue *data) {
+    return UA_STATUSCODE_GOOD;
+}
+
+static UA_UInt32
+readCounterInSession(UA_Session *session, UA_Double maxAge) {
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = UA_NODEID_STRING(1, "counter");
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_NEITHER;
+    request.maxAge = maxAge;
+    request.nodesToReadSize = 1;
+    request.nodesToRead = &rvi;
+    UA_ReadResponse response;
+    UA_ReadResponse_init(&response);
+    UA_LOCK(&server->serviceMutex);
+    Service_Read(server, session, &request, &response);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(response.resultsSize, 1);
+    ck_assert(UA_Variant_hasScalarType(&response.results[0].value,
+                                       &UA_TYPES[UA_TYPES_UINT32]));
+    ck_assert(!response.results[0].hasSourceTimestamp);
+    UA_UInt32 count = *(UA_UInt32*)response.results[0].value.data;
+    UA_ReadResponse_clear(&response);
+    return count;
+}
+
+static UA_UInt32
+readCounterWithMaxAge(UA_Double maxAge) {
+    return readCounterInSession(&server->adminSession, maxAge);
+}
+
+START_TEST(ReadDataSourceValueWithMaxAge) {
+    UA_DataSource ds;
+    memset(&ds, 0, sizeof(UA_DataSource));
+    ds.read = readCounter;
+    ds.write = writeCounter;
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    vattr.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+    UA_StatusCode retval =
+        UA_Server_addDataSourceVariableNode(server, UA_NODEID_STRING(1, "counter"),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                            UA_QUALIFIEDNAME(1, "counter"),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                            vattr, ds, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    counterReads = 0;
+
+    /* MaxAge zero always reads from the DataSource */
+    ck_assert_uint_eq(readCounterWithMaxAge(0.0), 1);
+    ck_assert_uint_eq(readCounterWithMaxAge(0.0), 2);
+
+    /* The second read is served from the cache */
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 3);
+    UA_fakeSleep(500);
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 3);
+    ck_assert_uint_eq(counterReads, 3);
+
+    /* The cached value is too old */
+    ck_assert_uint_eq(readCounterWithMaxAge(100.0), 4);
+    UA_fakeSleep(1500);
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 5);
+
+    /* Writing the value invalidates the cache */
+    UA_Variant v;
+    UA_UInt32 val = 0;
+    UA_Variant_setScalar(&v, &val, &UA_TYPES[UA_TYPES_UINT32]);
+    retval = UA_Server_writeValue(server, UA_NODEID_STRING(1, "counter"), v);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 6);
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 6);
+
+    /* The cached value is shared with other sessions. One DataSource read
+     * for both sessions. */
+    UA_Session session2;
+    UA_Session_init(&session2);
+    session2.sessionId = UA_NODEID_NUMERIC(1, 4242);
+    ck_assert_uint_eq(readCounterInSession(&session2, 1000.0), 6);
+    ck_assert_uint_eq(counterReads, 6);
+
+    /* Session-specific values are cached per session */
+    retval = UA_Server_setVariableNode_sessionSpecificValue(server,
+                                                            UA_NODEID_STRING(1, "counter"),
+                                                            true);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(readCounterInSession(&session2, 1000.0), 7);
+    ck_assert_uint_eq(readCounterInSession(&session2, 1000.0), 7);
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 8);
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 8);
+    ck_assert_uint_eq(readCounterInSession(&session2, 1000.0), 7);
+    UA_LOCK(&server->serviceMutex);
+    UA_Session_clear(&session2, server);
+    UA_UNLOCK(&server->serviceMutex);
+
+    /* No caching if disabled */
+    UA_Server_getConfig(server)->maxValueCacheSize = 0;
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 9);
+    ck_assert_uint_eq(readCounterWithMaxAge(1000.0), 10);
+} END_TEST
+
+static size_t textReads;
+
+static UA_StatusCode
+readLongText(UA_Server *server_, const UA_NodeId *sessionId, void *sessionContext,
+             const UA_NodeId *nodeId, void *nodeContext,
+             UA_Boolean sourceTimeStamp, const UA_NumericRange *range,
+             UA_DataValue *dataValue) {
+    textReads++;
+    UA_String text;
+    text.length = 2048;
+    text.data = (UA_Byte*)UA_malloc(text.length);
+    if(!text.data)
+        return UA_STATUSCODE_BADOUTOFMEMORY;
+    memset(text.data, 'x', text.length);
+    UA_Variant_setScalarCopy(&dataValue->value, &text, &UA_TYPES[UA_TYPES_STRING]);
+    UA_String_clear(&text);
+    dataValue->hasValue = true;
+    return UA_STATUSCODE_GOOD;
+}
+
+/* The memory limit of the value cache includes the nested content of the
+ * values */
+START_TEST(ReadDataSourceValueCacheMemory) {
+    UA_DataSource ds;
+    ds.read = readLongText;
+    ds.write = NULL;
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    UA_NodeId textId = UA_NODEID_STRING(1, "longtext");
+    UA_StatusCode retval =
+        UA_Server_addDataSourceVariableNode(server, textId,
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                            UA_QUALIFIEDNAME(1, "longtext"),
+                                            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                            vattr, ds, NULL, NULL);
+    ck_assert_uint_eq(retval, UA_STATUSCODE_GOOD);
+
+    UA_ReadValueId rvi;
+    UA_ReadValueId_init(&rvi);
+    rvi.nodeId = textId;
+    rvi.attributeId = UA_ATTRIBUTEID_VALUE;
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.maxAge = 1000.0;
+    request.nodesToReadSize = 1;
+    request.nodesToRead = &rvi;
+
+    /* The value does not fit into the cache */
+    UA_Server_getConfig(server)->maxValueCacheSize = 1024;
+    textReads = 0;
+    for(size_t i = 0; i < 2; i++) {
+        UA_ReadResponse response;
+        UA_ReadResponse_init(&response);
+        UA_LOCK(&server->serviceMutex);
+        Service_Read(server, &server->adminSession, &request, &response);
+        UA_UNLOCK(&server->serviceMutex);
+        ck_assert_uint_eq(response.resultsSize, 1);
+        ck_assert(UA_Variant_hasScalarType(&response.results[0].value,
+                                           &UA_TYPES[UA_TYPES_STRING]));
+        UA_ReadResponse_clear(&response);
+    }
+    ck_assert_uint_eq(textReads, 2);
+    ck_assert_uint_eq(server->valueCache.count, 0);
+
+    /* With enough memory, the second read is served from the cache */
+    UA_Server_getConfig(server)->maxValueCacheSize = 4096;
+    for(size_t i = 0; i < 2; i++) {
+        UA_ReadResponse response;
+        UA_ReadResponse_init(&response);
+        UA_LOCK(&server->serviceMutex);
+        Service_Read(server, &server->adminSession, &request, &response);
+        UA_UNLOCK(&server->serviceMutex);
+        UA_ReadResponse_clear(&response);
+    }
+    ck_assert_uint_eq(textReads, 3);
+    ck_assert_uint_gt(server->valueCache.memory, 2048);
+} END_TEST
+
 static Suite * testSuite_services_attributes(void) {
     Suite *s = suite_create("services_attributes_read");
 
@@ -1123,6 +1434,9 @@ static Suite * testSuite_services_attributes(void) {
     tcase_add_test(tc_readSingleAttributes, ReadSingleDataSourceAttributeDataTypeWithoutTimestamp);
     tcase_add_test(tc_readSingleAttributes, ReadSingleDataSourceAttributeArrayDimensionsWithoutTimestamp);
     tcase_add_test(tc_readSingleAttributes, ReadSingleAttributeDataTypeDefinitionWithoutTimestamp);
+    tcase_add_test(tc_readSingleAttributes, ReadBatchedDataSourceValues);
+    tcase_add_test(tc_readSingleAttributes, ReadDataSourceValueWithMaxAge);
+    tcase_add_test(tc_readSingleAttributes, ReadDataSourceValueCacheMemory);
 
     suite_add_tcase(s, tc_readSingleAttributes);
 
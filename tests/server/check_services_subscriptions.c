@@ -310,6 +310,99 @@ START_TEST(Server_publishCallback) {
 }
 END_TEST
 
+static size_t
+countPublishGroups(void) {
+    size_t count = 0;
+    UA_PublishGroup *pg;
+    LIST_FOREACH(pg, &server->publishGroups, listEntry)
+        count++;
+    return count;
+}
+
+START_TEST(Server_publishGroup) {
+    /* Two subscriptions with the same interval share the publish callback */
+    createSubscription();
+    UA_UInt32 subscriptionId1 = subscriptionId;
+    createSubscription();
+    UA_UInt32 subscriptionId2 = subscriptionId;
+
+    UA_Subscription *sub1 = UA_Session_getSubscriptionById(session, subscriptionId1);
+    UA_Subscription *sub2 = UA_Session_getSubscriptionById(session, subscriptionId2);
+    ck_assert_ptr_ne(sub1, NULL);
+    ck_assert_ptr_ne(sub2, NULL);
+    ck_assert_ptr_ne(sub1->publishGroup, NULL);
+    ck_assert_ptr_eq(sub1->publishGroup, sub2->publishGroup);
+    ck_assert_uint_eq(sub1->publishGroup->subscriptionsSize, 2);
+    ck_assert_uint_eq(countPublishGroups(), 1);
+
+    /* Both subscriptions are published in the same callback */
+    UA_fakeSleep((UA_UInt32)sub1->publishingInterval + 1);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(sub1->currentKeepAliveCount, sub1->maxKeepAliveCount + 1);
+    ck_assert_uint_eq(sub2->currentKeepAliveCount, sub2->maxKeepAliveCount + 1);
+
+    /* Changing the interval moves the subscription to a new group */
+    UA_ModifySubscriptionRequest request;
+    UA_ModifySubscriptionRequest_init(&request);
+    request.subscriptionId = subscriptionId2;
+    request.requestedPublishingInterval = sub1->publishingInterval * 2;
+    request.requestedLifetimeCount = 1000;
+    request.requestedMaxKeepAliveCount = 10;
+
+    UA_ModifySubscriptionResponse response;
+    UA_ModifySubscriptionResponse_init(&response);
+    UA_LOCK(&server->serviceMutex);
+    Service_ModifySubscription(server, session, &request, &response);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert(response.revisedPublishingInterval == sub2->publishingInterval);
+    UA_ModifySubscriptionResponse_clear(&response);
+
+    ck_assert_ptr_ne(sub2->publishGroup, sub1->publishGroup);
+    ck_assert(sub2->publishGroup->publishingInterval == sub2->publishingInterval);
+    ck_assert_uint_eq(sub1->publishGroup->subscriptionsSize, 1);
+    ck_assert_uint_eq(sub2->publishGroup->subscriptionsSize, 1);
+    ck_assert_uint_eq(countPublishGroups(), 2);
+
+    /* A subscription that joins in the middle of an interval skips the first
+     * tick of the group. It starts counting from a full interval. */
+    UA_UInt32 halfInterval = (UA_UInt32)sub1->publishingInterval / 2;
+    UA_fakeSleep(halfInterval);
+    createSubscription();
+    UA_UInt32 subscriptionId3 = subscriptionId;
+    UA_Subscription *sub3 = UA_Session_getSubscriptionById(session, subscriptionId3);
+    ck_assert_ptr_eq(sub3->publishGroup, sub1->publishGroup);
+    UA_UInt32 keepAlive1 = sub1->currentKeepAliveCount;
+    UA_UInt32 keepAlive3 = sub3->currentKeepAliveCount;
+    UA_fakeSleep((UA_UInt32)sub1->publishingInterval - halfInterval + 1);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_ne(sub1->currentKeepAliveCount, keepAlive1);
+    ck_assert_uint_eq(sub3->currentKeepAliveCount, keepAlive3);
+    UA_fakeSleep((UA_UInt32)sub1->publishingInterval + 1);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_ne(sub3->currentKeepAliveCount, keepAlive3);
+
+    /* The group is removed with its last subscription */
+    UA_UInt32 delIds[2] = {subscriptionId1, subscriptionId3};
+    UA_DeleteSubscriptionsRequest del_request;
+    UA_DeleteSubscriptionsRequest_init(&del_request);
+    del_request.subscriptionIdsSize = 2;
+    del_request.subscriptionIds = delIds;
+
+    UA_DeleteSubscriptionsResponse del_response;
+    UA_DeleteSubscriptionsResponse_init(&del_response);
+    UA_LOCK(&server->serviceMutex);
+    Service_DeleteSubscriptions(server, session, &del_request, &del_response);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(del_response.resultsSize, 2);
+    ck_assert_uint_eq(del_response.results[0], UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(del_response.results[1], UA_STATUSCODE_GOOD);
+    UA_DeleteSubscriptionsResponse_clear(&del_response);
+
+    ck_assert_uint_eq(countPublishGroups(), 1);
+}
+END_TEST
+
 START_TEST(Server_createMonitoredItems) {
     createSubscription();
     createMonitoredItem();
@@ -622,6 +715,152 @@ START_TEST(Server_deleteMonitoredItems) {
 }
 END_TEST
 
+START_TEST(Server_memoryBudget) {
+    createSubscription();
+    UA_Subscription *sub = UA_Session_getSubscriptionById(session, subscriptionId);
+    ck_assert_ptr_ne(sub, NULL);
+
+    /* Monitor the current time. Every sample creates a notification. */
+    UA_CreateMonitoredItemsRequest request;
+    UA_CreateMonitoredItemsRequest_init(&request);
+    request.subscriptionId = subscriptionId;
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_SERVER;
+    UA_MonitoredItemCreateRequest item;
+    UA_MonitoredItemCreateRequest_init(&item);
+    item.itemToMonitor.nodeId =
+        UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER_SERVERSTATUS_CURRENTTIME);
+    item.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+    item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    item.requestedParameters.queueSize = 10;
+    item.requestedParameters.discardOldest = true;
+    request.itemsToCreateSize = 1;
+    request.itemsToCreate = &item;
+
+    UA_CreateMonitoredItemsResponse response;
+    UA_CreateMonitoredItemsResponse_init(&response);
+    UA_LOCK(&server->serviceMutex);
+    Service_CreateMonitoredItems(server, session, &request, &response);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(response.resultsSize, 1);
+    ck_assert_uint_eq(response.results[0].statusCode, UA_STATUSCODE_GOOD);
+    UA_MonitoredItem *mon =
+        UA_Subscription_getMonitoredItem(sub, response.results[0].monitoredItemId);
+    UA_CreateMonitoredItemsResponse_clear(&response);
+    ck_assert_ptr_ne(mon, NULL);
+    UA_assert(mon);
+
+    /* The initial notification is accounted in the Subscription and Session */
+    ck_assert_uint_eq(mon->queueSize, 1);
+    size_t usage = session->totalMemoryUsage;
+    ck_assert_uint_gt(usage, 0);
+    ck_assert_uint_eq(sub->memoryUsage, usage);
+
+    /* The budget is exhausted. New samples are dropped. */
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    config->maxSessionMemoryUsage = usage;
+    UA_fakeSleep(1);
+    UA_MonitoredItem_sampleCallback(server, mon);
+    ck_assert_uint_eq(mon->queueSize, 1);
+    ck_assert_uint_eq(session->totalMemoryUsage, usage);
+
+    /* Enough space for one more notification */
+    config->maxSessionMemoryUsage = 2 * usage;
+    UA_fakeSleep(1);
+    UA_MonitoredItem_sampleCallback(server, mon);
+    UA_fakeSleep(1);
+    UA_MonitoredItem_sampleCallback(server, mon);
+    ck_assert_uint_eq(mon->queueSize, 2);
+    ck_assert_uint_le(session->totalMemoryUsage, config->maxSessionMemoryUsage);
+
+    /* The memory is released with the Subscription */
+    UA_DeleteSubscriptionsRequest del_request;
+    UA_DeleteSubscriptionsRequest_init(&del_request);
+    del_request.subscriptionIdsSize = 1;
+    del_request.subscriptionIds = &subscriptionId;
+    UA_DeleteSubscriptionsResponse del_response;
+    UA_DeleteSubscriptionsResponse_init(&del_response);
+    UA_LOCK(&server->serviceMutex);
+    Service_DeleteSubscriptions(server, session, &del_request, &del_response);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(del_response.resultsSize, 1);
+    ck_assert_uint_eq(del_response.results[0], UA_STATUSCODE_GOOD);
+    UA_DeleteSubscriptionsResponse_clear(&del_response);
+    ck_assert_uint_eq(session->totalMemoryUsage, 0);
+}
+END_TEST
+
+START_TEST(Server_memoryBudgetWriteTriggered) {
+    /* A variable with the value stored in the node is sampled on write */
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    UA_Int32 val = 0;
+    UA_Variant_setScalar(&vattr.value, &val, &UA_TYPES[UA_TYPES_INT32]);
+    UA_NodeId varId = UA_NODEID_STRING(1, "budget");
+    UA_StatusCode res =
+        UA_Server_addVariableNode(server, varId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "budget"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                  vattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    createSubscription();
+    UA_Subscription *sub = UA_Session_getSubscriptionById(session, subscriptionId);
+    ck_assert_ptr_ne(sub, NULL);
+
+    UA_CreateMonitoredItemsRequest request;
+    UA_CreateMonitoredItemsRequest_init(&request);
+    request.subscriptionId = subscriptionId;
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_SERVER;
+    UA_MonitoredItemCreateRequest item;
+    UA_MonitoredItemCreateRequest_init(&item);
+    item.itemToMonitor.nodeId = varId;
+    item.itemToMonitor.attributeId = UA_ATTRIBUTEID_VALUE;
+    item.monitoringMode = UA_MONITORINGMODE_REPORTING;
+    item.requestedParameters.samplingInterval = 100.0;
+    item.requestedParameters.queueSize = 10;
+    item.requestedParameters.discardOldest = true;
+    request.itemsToCreateSize = 1;
+    request.itemsToCreate = &item;
+
+    UA_CreateMonitoredItemsResponse response;
+    UA_CreateMonitoredItemsResponse_init(&response);
+    UA_LOCK(&server->serviceMutex);
+    Service_CreateMonitoredItems(server, session, &request, &response);
+    UA_UNLOCK(&server->serviceMutex);
+    ck_assert_uint_eq(response.resultsSize, 1);
+    ck_assert_uint_eq(response.results[0].statusCode, UA_STATUSCODE_GOOD);
+    UA_MonitoredItem *mon =
+        UA_Subscription_getMonitoredItem(sub, response.results[0].monitoredItemId);
+    UA_CreateMonitoredItemsResponse_clear(&response);
+    ck_assert_ptr_ne(mon, NULL);
+    UA_assert(mon);
+    ck_assert_ptr_ne(mon->next, (UA_MonitoredItem*)~0); /* Attached to the node */
+    ck_assert_uint_eq(mon->queueSize, 1);
+
+    /* The budget is exhausted. The sample of the write is dropped. */
+    UA_ServerConfig *config = UA_Server_getConfig(server);
+    size_t usage = session->totalMemoryUsage;
+    config->maxSessionMemoryUsage = usage;
+    UA_fakeSleep(101);
+    val = 1;
+    UA_Variant value;
+    UA_Variant_setScalar(&value, &val, &UA_TYPES[UA_TYPES_INT32]);
+    res = UA_Server_writeValue(server, varId, value);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(mon->queueSize, 1);
+    ck_assert_uint_eq(session->totalMemoryUsage, usage);
+
+    /* The sample is retried without another write */
+    config->maxSessionMemoryUsage = 2 * usage;
+    UA_fakeSleep(101);
+    UA_Server_run_iterate(server, false);
+    ck_assert_uint_eq(mon->queueSize, 2);
+    ck_assert(UA_Variant_hasScalarType(&mon->lastValue.value, &UA_TYPES[UA_TYPES_INT32]));
+    ck_assert_int_eq(*(UA_Int32*)mon->lastValue.value.data, 1);
+}
+END_TEST
+
 START_TEST(Server_lifeTimeCount) {
     /* Create a subscription */
     UA_CreateSubscriptionRequest request;
@@ -868,10 +1107,13 @@ static Suite* testSuite_Client(void) {
     tcase_add_test(tc_server, Server_overflow);
     tcase_add_test(tc_server, Server_setMonitoringMode);
     tcase_add_test(tc_server, Server_deleteMonitoredItems);
+    tcase_add_test(tc_server, Server_memoryBudget);
+    tcase_add_test(tc_server, Server_memoryBudgetWriteTriggered);
     tcase_add_test(tc_server, Server_republish);
     tcase_add_test(tc_server, Server_republish_invalid);
     tcase_add_test(tc_server, Server_deleteSubscription);
     tcase_add_test(tc_server, Server_publishCallback);
+    tcase_add_test(tc_server, Server_publishGroup);
     tcase_add_test(tc_server, Server_lifeTimeCount);
     tcase_add_test(tc_server, Server_invalidPublishingInterval);
 #endif /* UA_ENABLE_SUBSCRIPTIONS */
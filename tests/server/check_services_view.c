@@ -271,6 +271,72 @@ START_TEST(Service_Browse_ReferenceTypes) {
 }
 END_TEST
 
+static UA_Boolean
+isSubtypeOf(UA_Server *server, UA_NodeId type, UA_UInt32 supertype) {
+    UA_NodeId supertypeId = UA_NODEID_NUMERIC(0, supertype);
+    UA_LOCK(&server->serviceMutex);
+    UA_Boolean res = isNodeInTree_singleRef(server, &type, &supertypeId,
+                                            UA_REFERENCETYPEINDEX_HASSUBTYPE);
+    UA_UNLOCK(&server->serviceMutex);
+    return res;
+}
+
+START_TEST(Service_Browse_SubtypeCache) {
+    UA_Server *server = UA_Server_new();
+    UA_ServerConfig_setDefault(UA_Server_getConfig(server));
+
+    UA_NodeId myInt = UA_NODEID_STRING(1, "MyInt");
+    UA_NodeId mySubInt = UA_NODEID_STRING(1, "MySubInt");
+    UA_DataTypeAttributes attr = UA_DataTypeAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addDataTypeNode(server, myInt, UA_NODEID_NUMERIC(0, UA_NS0ID_INT32),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                  UA_QUALIFIEDNAME(1, "MyInt"), attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    ck_assert(isSubtypeOf(server, myInt, UA_NS0ID_INT32));
+    ck_assert(isSubtypeOf(server, myInt, UA_NS0ID_INTEGER));
+    ck_assert(isSubtypeOf(server, myInt, UA_NS0ID_BASEDATATYPE));
+    ck_assert(!isSubtypeOf(server, myInt, UA_NS0ID_DOUBLE));
+
+    /* Subtype of a cached type */
+    res = UA_Server_addDataTypeNode(server, mySubInt, myInt,
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                    UA_QUALIFIEDNAME(1, "MySubInt"), attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(isSubtypeOf(server, mySubInt, UA_NS0ID_INTEGER));
+
+    /* Move MyInt below Double. The cached entries of MyInt and its subtypes
+     * are updated. */
+    res = UA_Server_deleteReference(server, UA_NODEID_NUMERIC(0, UA_NS0ID_INT32),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE), true,
+                                    UA_EXPANDEDNODEID_NODEID(myInt), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(!isSubtypeOf(server, mySubInt, UA_NS0ID_INTEGER));
+    ck_assert(!isSubtypeOf(server, myInt, UA_NS0ID_NUMBER));
+
+    res = UA_Server_addReference(server, UA_NODEID_NUMERIC(0, UA_NS0ID_DOUBLE),
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                 UA_EXPANDEDNODEID_NODEID(myInt), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(isSubtypeOf(server, mySubInt, UA_NS0ID_DOUBLE));
+    ck_assert(isSubtypeOf(server, mySubInt, UA_NS0ID_NUMBER));
+    ck_assert(!isSubtypeOf(server, mySubInt, UA_NS0ID_INTEGER));
+
+    /* Re-create a deleted type with a different supertype */
+    res = UA_Server_deleteNode(server, mySubInt, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_addDataTypeNode(server, mySubInt, UA_NODEID_NUMERIC(0, UA_NS0ID_INT32),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_HASSUBTYPE),
+                                    UA_QUALIFIEDNAME(1, "MySubInt"), attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert(isSubtypeOf(server, mySubInt, UA_NS0ID_INTEGER));
+    ck_assert(!isSubtypeOf(server, mySubInt, UA_NS0ID_DOUBLE));
+
+    UA_Server_delete(server);
+}
+END_TEST
+
 START_TEST(Service_Browse_Recursive) {
     UA_Server *server = UA_Server_new();
     UA_ServerConfig_setDefault(UA_Server_getConfig(server));
@@ -303,6 +369,164 @@ START_TEST(Service_Browse_Recursive) {
 }
 END_TEST
 
+typedef struct {
+    size_t count;
+    size_t limit;
+    size_t expectedSize;
+    UA_ExpandedNodeId *expected;
+} RecursiveCallbackContext;
+
+static UA_StatusCode
+browseRecursiveCallback(UA_Server *server, const UA_ExpandedNodeId *nodeId,
+                        void *context) {
+    RecursiveCallbackContext *ctx = (RecursiveCallbackContext*)context;
+    /* The server is unlocked during the callback */
+    UA_NodeClass nodeClass = UA_NODECLASS_UNSPECIFIED;
+    UA_StatusCode res = UA_Server_readNodeClass(server, nodeId->nodeId, &nodeClass);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(nodeClass, UA_NODECLASS_VARIABLE);
+    UA_Boolean found = false;
+    for(size_t i = 0; i < ctx->expectedSize; i++)
+        found |= UA_ExpandedNodeId_equal(nodeId, &ctx->expected[i]);
+    ck_assert(found);
+    ctx->count++;
+    if(ctx->limit > 0 && ctx->count >= ctx->limit)
+        return UA_STATUSCODE_BADSHUTDOWN;
+    return UA_STATUSCODE_GOOD;
+}
+
+START_TEST(Service_Browse_RecursiveCallback) {
+    UA_Server *server = UA_Server_new();
+    UA_ServerConfig_setDefault(UA_Server_getConfig(server));
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    bd.includeSubtypes = true;
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.nodeClassMask = UA_NODECLASS_VARIABLE;
+
+    RecursiveCallbackContext ctx;
+    memset(&ctx, 0, sizeof(RecursiveCallbackContext));
+    UA_StatusCode res =
+        UA_Server_browseRecursive(server, &bd, &ctx.expectedSize, &ctx.expected);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_gt(ctx.expectedSize, 10);
+
+    /* The same nodes are found. Every node is reported once. */
+    res = UA_Server_browseRecursiveCallback(server, &bd, browseRecursiveCallback, &ctx);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(ctx.count, ctx.expectedSize);
+
+    /* The callback stops the browse */
+    ctx.count = 0;
+    ctx.limit = 3;
+    res = UA_Server_browseRecursiveCallback(server, &bd, browseRecursiveCallback, &ctx);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADSHUTDOWN);
+    ck_assert_uint_eq(ctx.count, 3);
+
+    /* Unknown starting node */
+    bd.nodeId = UA_NODEID_STRING(1, "DoesNotExist");
+    res = UA_Server_browseRecursiveCallback(server, &bd, browseRecursiveCallback, &ctx);
+    ck_assert_uint_eq(res, UA_STATUSCODE_BADNODEIDUNKNOWN);
+
+    UA_Array_delete(ctx.expected, ctx.expectedSize, &UA_TYPES[UA_TYPES_EXPANDEDNODEID]);
+    UA_Server_delete(server);
+}
+END_TEST
+
+typedef struct {
+    size_t count;
+    UA_NodeId reported[8];
+} ReportedNodesContext;
+
+static UA_StatusCode
+collectRecursiveCallback(UA_Server *server, const UA_ExpandedNodeId *nodeId,
+                         void *context) {
+    ReportedNodesContext *ctx = (ReportedNodesContext*)context;
+    ck_assert_uint_lt(ctx->count, 8);
+    for(size_t i = 0; i < ctx->count; i++)
+        ck_assert(!UA_NodeId_equal(&nodeId->nodeId, &ctx->reported[i]));
+    ctx->reported[ctx->count++] = nodeId->nodeId; /* no allocated members */
+    return UA_STATUSCODE_GOOD;
+}
+
+static void
+addRecursiveTestObject(UA_Server *server, UA_UInt32 id, char *name) {
+    UA_ObjectAttributes attr = UA_ObjectAttributes_default;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, UA_NODEID_NUMERIC(1, id),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, name),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+START_TEST(Service_Browse_RecursiveCallbackBoth) {
+    UA_Server *server = UA_Server_new();
+    UA_ServerConfig_setDefault(UA_Server_getConfig(server));
+
+    /* Start <-> Cycle <- Parent. The Parent is only reached by following the
+     * inverse references of the Cycle node that was already reached in the
+     * forward direction. */
+    addRecursiveTestObject(server, 70000, "Start");
+    addRecursiveTestObject(server, 70001, "Cycle");
+    addRecursiveTestObject(server, 70002, "Parent");
+    UA_ExpandedNodeId cycleId = UA_EXPANDEDNODEID_NUMERIC(1, 70001);
+    UA_ExpandedNodeId startId = UA_EXPANDEDNODEID_NUMERIC(1, 70000);
+    UA_StatusCode res =
+        UA_Server_addReference(server, UA_NODEID_NUMERIC(1, 70000),
+                               UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                               cycleId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_addReference(server, UA_NODEID_NUMERIC(1, 70001),
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                 startId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    res = UA_Server_addReference(server, UA_NODEID_NUMERIC(1, 70002),
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                 cycleId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = UA_NODEID_NUMERIC(1, 70000);
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HIERARCHICALREFERENCES);
+    bd.includeSubtypes = true;
+    bd.browseDirection = UA_BROWSEDIRECTION_BOTH;
+    bd.nodeClassMask = UA_NODECLASS_OBJECT;
+
+    /* Forward: Cycle, Start. Inverse: ObjectsFolder, Root, Parent. Cycle and
+     * Start are not reported again. */
+    ReportedNodesContext ctx;
+    memset(&ctx, 0, sizeof(ReportedNodesContext));
+    res = UA_Server_browseRecursiveCallback(server, &bd, collectRecursiveCallback, &ctx);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(ctx.count, 5);
+    UA_NodeId parentId = UA_NODEID_NUMERIC(1, 70002);
+    UA_NodeId rootId = UA_NODEID_NUMERIC(0, UA_NS0ID_ROOTFOLDER);
+    UA_Boolean foundParent = false, foundRoot = false;
+    for(size_t i = 0; i < ctx.count; i++) {
+        foundParent |= UA_NodeId_equal(&ctx.reported[i], &parentId);
+        foundRoot |= UA_NodeId_equal(&ctx.reported[i], &rootId);
+    }
+    ck_assert(foundParent);
+    ck_assert(foundRoot);
+
+    /* Only the forward direction */
+    memset(&ctx, 0, sizeof(ReportedNodesContext));
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    res = UA_Server_browseRecursiveCallback(server, &bd, collectRecursiveCallback, &ctx);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(ctx.count, 2);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
 START_TEST(Service_Browse_Localization) {
     UA_Server *server = UA_Server_new();
     UA_ServerConfig_setDefault(UA_Server_getConfig(server));
@@ -367,6 +591,132 @@ START_TEST(Service_Browse_Localization) {
 }
 END_TEST
 
+static void
+addCacheTestObject(UA_Server *server, UA_NodeId parentId, UA_NodeId objectId,
+                   char *name) {
+    UA_ObjectAttributes attr = UA_ObjectAttributes_default;
+    attr.displayName = UA_LOCALIZEDTEXT("en-US", name);
+    attr.writeMask = UA_WRITEMASK_DISPLAYNAME;
+    UA_StatusCode res =
+        UA_Server_addObjectNode(server, objectId, parentId,
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                UA_QUALIFIEDNAME(1, name),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+}
+
+START_TEST(Service_Browse_Cache) {
+    UA_Server *server = UA_Server_new();
+    UA_ServerConfig_setDefault(UA_Server_getConfig(server));
+
+    UA_NodeId folderId = UA_NODEID_STRING(1, "CacheFolder");
+    UA_NodeId child1 = UA_NODEID_STRING(1, "Child1");
+    UA_NodeId child2 = UA_NODEID_STRING(1, "Child2");
+    addCacheTestObject(server, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                       folderId, "CacheFolder");
+    addCacheTestObject(server, folderId, child1, "Child1");
+
+    UA_BrowseDescription bd;
+    UA_BrowseDescription_init(&bd);
+    bd.nodeId = folderId;
+    bd.resultMask = UA_BROWSERESULTMASK_ALL;
+    bd.browseDirection = UA_BROWSEDIRECTION_FORWARD;
+    bd.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+
+    /* The second browse is answered from the cache */
+    UA_ServerStatistics before = UA_Server_getStatistics(server);
+    UA_BrowseResult br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(br.referencesSize, 1);
+    UA_BrowseResult_clear(&br);
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.statusCode, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(br.referencesSize, 1);
+    ck_assert(UA_NodeId_equal(&br.references[0].nodeId.nodeId, &child1));
+    UA_NodeId objectType = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE);
+    ck_assert(UA_NodeId_equal(&br.references[0].typeDefinition.nodeId, &objectType));
+    UA_BrowseResult_clear(&br);
+    UA_ServerStatistics after = UA_Server_getStatistics(server);
+    ck_assert_uint_eq(after.bcs.hits, before.bcs.hits + 1);
+    ck_assert_uint_eq(after.bcs.misses, before.bcs.misses + 1);
+    ck_assert_uint_ge(after.bcs.entries, 1);
+    ck_assert_uint_gt(after.bcs.memory, 0);
+
+    /* A cached result that exceeds maxReferences is not used */
+    addCacheTestObject(server, folderId, child2, "Child2");
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.referencesSize, 2);
+    UA_BrowseResult_clear(&br);
+    br = UA_Server_browse(server, 1, &bd);
+    ck_assert_uint_eq(br.referencesSize, 1);
+    ck_assert_uint_gt(br.continuationPoint.length, 0);
+    UA_BrowseResult next = UA_Server_browseNext(server, false, &br.continuationPoint);
+    ck_assert_uint_eq(next.referencesSize, 1);
+    UA_BrowseResult_clear(&next);
+    UA_BrowseResult_clear(&br);
+
+    /* Changed attributes are visible */
+    UA_LocalizedText renamed = UA_LOCALIZEDTEXT("en-US", "Renamed");
+    UA_StatusCode res = UA_Server_writeDisplayName(server, child2, renamed);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.referencesSize, 2);
+    UA_Boolean found = false;
+    for(size_t i = 0; i < br.referencesSize; i++)
+        found |= UA_String_equal(&br.references[i].displayName.text, &renamed.text);
+    ck_assert(found);
+    UA_BrowseResult_clear(&br);
+
+    /* Deleted nodes are gone */
+    res = UA_Server_deleteNode(server, child1, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.referencesSize, 1);
+    ck_assert(UA_NodeId_equal(&br.references[0].nodeId.nodeId, &child2));
+    UA_BrowseResult_clear(&br);
+
+    /* Adding a node elsewhere and writing a value do not invalidate the cached
+     * result. Only changes of the browsed node and its targets do. */
+    br = UA_Server_browse(server, 0, &bd);
+    UA_BrowseResult_clear(&br);
+    UA_Int32 value = 5;
+    UA_Variant v;
+    UA_Variant_setScalar(&v, &value, &UA_TYPES[UA_TYPES_INT32]);
+    UA_VariableAttributes vattr = UA_VariableAttributes_default;
+    res = UA_Server_addVariableNode(server, UA_NODEID_STRING(1, "CacheVar"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                    UA_QUALIFIEDNAME(1, "CacheVar"),
+                                    UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE),
+                                    vattr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    before = UA_Server_getStatistics(server);
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.referencesSize, 1);
+    UA_BrowseResult_clear(&br);
+    res = UA_Server_writeValue(server, UA_NODEID_STRING(1, "CacheVar"), v);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.referencesSize, 1);
+    UA_BrowseResult_clear(&br);
+    after = UA_Server_getStatistics(server);
+    ck_assert_uint_eq(after.bcs.hits, before.bcs.hits + 2);
+    ck_assert_uint_eq(after.bcs.misses, before.bcs.misses);
+
+    /* A new reference of the browsed node is visible */
+    res = UA_Server_addReference(server, folderId,
+                                 UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                 UA_EXPANDEDNODEID_STRING(1, "CacheVar"), true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    br = UA_Server_browse(server, 0, &bd);
+    ck_assert_uint_eq(br.referencesSize, 2);
+    UA_BrowseResult_clear(&br);
+
+    UA_Server_delete(server);
+}
+END_TEST
+
 START_TEST(Service_TranslateBrowsePathsToNodeIds) {
     UA_Client *client = UA_Client_new();
     UA_ClientConfig_setDefault(UA_Client_getConfig(client));
@@ -482,6 +832,82 @@ START_TEST(Service_TranslateBrowsePathsNoMatches) {
 }
 END_TEST
 
+static UA_StatusCode
+translateCachePath(UA_Client *client, UA_NodeId *target) {
+    UA_RelativePathElement rpe;
+    UA_RelativePathElement_init(&rpe);
+    rpe.referenceTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES);
+    rpe.targetName = UA_QUALIFIEDNAME(1, "CachePath");
+    UA_BrowsePath browsePath;
+    UA_BrowsePath_init(&browsePath);
+    browsePath.startingNode = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
+    browsePath.relativePath.elements = &rpe;
+    browsePath.relativePath.elementsSize = 1;
+
+    UA_TranslateBrowsePathsToNodeIdsRequest request;
+    UA_TranslateBrowsePathsToNodeIdsRequest_init(&request);
+    request.browsePaths = &browsePath;
+    request.browsePathsSize = 1;
+    UA_TranslateBrowsePathsToNodeIdsResponse response =
+        UA_Client_Service_translateBrowsePathsToNodeIds(client, request);
+    ck_assert_uint_eq(response.responseHeader.serviceResult, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(response.resultsSize, 1);
+    UA_StatusCode res = response.results[0].statusCode;
+    if(res == UA_STATUSCODE_GOOD) {
+        ck_assert_uint_eq(response.results[0].targetsSize, 1);
+        UA_NodeId_copy(&response.results[0].targets[0].targetId.nodeId, target);
+    }
+    UA_TranslateBrowsePathsToNodeIdsResponse_clear(&response);
+    return res;
+}
+
+START_TEST(Service_TranslateBrowsePathsCache) {
+    UA_Client *client = UA_Client_new();
+    UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+    UA_StatusCode res = UA_Client_connect(client, "opc.tcp://localhost:4840");
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+
+    /* A BrowsePath without a match is cached as well */
+    UA_NodeId target = UA_NODEID_NULL;
+    UA_ServerStatistics before = UA_Server_getStatistics(server_translate_browse);
+    ck_assert_uint_eq(translateCachePath(client, &target), UA_STATUSCODE_BADNOMATCH);
+    ck_assert_uint_eq(translateCachePath(client, &target), UA_STATUSCODE_BADNOMATCH);
+    UA_ServerStatistics after = UA_Server_getStatistics(server_translate_browse);
+    ck_assert_uint_eq(after.bcs.pathHits, before.bcs.pathHits + 1);
+    ck_assert_uint_ge(after.bcs.pathEntries, 1);
+    ck_assert_uint_gt(after.bcs.pathMemory, 0);
+
+    /* Adding the target node invalidates the cache */
+    UA_NodeId objectId = UA_NODEID_STRING(1, "CachePath");
+    UA_ObjectAttributes attr = UA_ObjectAttributes_default;
+    res = UA_Server_addObjectNode(server_translate_browse, objectId,
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES),
+                                  UA_QUALIFIEDNAME(1, "CachePath"),
+                                  UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE),
+                                  attr, NULL, NULL);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(translateCachePath(client, &target), UA_STATUSCODE_GOOD);
+    ck_assert(UA_NodeId_equal(&target, &objectId));
+    UA_NodeId_clear(&target);
+
+    before = UA_Server_getStatistics(server_translate_browse);
+    ck_assert_uint_eq(translateCachePath(client, &target), UA_STATUSCODE_GOOD);
+    ck_assert(UA_NodeId_equal(&target, &objectId));
+    UA_NodeId_clear(&target);
+    after = UA_Server_getStatistics(server_translate_browse);
+    ck_assert_uint_eq(after.bcs.pathHits, before.bcs.pathHits + 1);
+
+    /* Deleting the target node invalidates the cache */
+    res = UA_Server_deleteNode(server_translate_browse, objectId, true);
+    ck_assert_uint_eq(res, UA_STATUSCODE_GOOD);
+    ck_assert_uint_eq(translateCachePath(client, &target), UA_STATUSCODE_BADNOMATCH);
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+}
+END_TEST
+
 START_TEST(BrowseSimplifiedBrowsePath) {
     UA_QualifiedName objectsName = UA_QUALIFIEDNAME(0, "Objects");
     UA_BrowsePathResult bpr =
@@ -504,7 +930,11 @@ static Suite *testSuite_Service_TranslateBrowsePathsToNodeIds(void) {
     tcase_add_test(tc_browse, Service_Browse_ReferenceTypes);
     tcase_add_test(tc_browse, Service_Browse_WithMaxResults);
     tcase_add_test(tc_browse, Service_Browse_Recursive);
+    tcase_add_test(tc_browse, Service_Browse_RecursiveCallback);
+    tcase_add_test(tc_browse, Service_Browse_RecursiveCallbackBoth);
+    tcase_add_test(tc_browse, Service_Browse_SubtypeCache);
     tcase_add_test(tc_browse, Service_Browse_Localization);
+    tcase_add_test(tc_browse, Service_Browse_Cache);
     suite_add_tcase(s, tc_browse);
 
     TCase *tc_translate = tcase_create("TranslateBrowsePathsToNodeIds");
@@ -512,6 +942,7 @@ static Suite *testSuite_Service_TranslateBrowsePathsToNodeIds(void) {
     tcase_add_test(tc_translate, Service_TranslateBrowsePathsToNodeIds);
     tcase_add_test(tc_translate, Service_TranslateBrowsePathsWithHashCollision);
     tcase_add_test(tc_translate, Service_TranslateBrowsePathsNoMatches);
+    tcase_add_test(tc_translate, Service_TranslateBrowsePathsCache);
     tcase_add_test(tc_translate, BrowseSimplifiedBrowsePath);
 
     suite_add_tcase(s, tc_translate);